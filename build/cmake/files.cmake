@@ -454,6 +454,7 @@ set(BASE_CMN_SRC
     src/common/textbuf.cpp
     src/common/textfile.cpp
     src/common/threadinfo.cpp
+    src/common/threadpool.cpp
     src/common/time.cpp
     src/common/timercmn.cpp
     src/common/timerimpl.cpp
@@ -604,6 +605,7 @@ set(BASE_CMN_HDR
     wx/textbuf.h
     wx/textfile.h
     wx/thread.h
+    wx/threadpool.h
     wx/thrimpl.cpp
     wx/time.h
     wx/timer.h
@@ -784,6 +786,7 @@ set(GUI_CMN_SRC
     src/common/imagpnm.cpp
     src/common/imagtga.cpp
     src/common/imagtiff.cpp
+    src/common/imageloader.cpp
     src/common/imagxpm.cpp
     src/common/layout.cpp
     src/common/lboxcmn.cpp
@@ -1095,6 +1098,7 @@ set(GUI_CMN_HDR
     wx/imagpnm.h
     wx/imagtga.h
     wx/imagtiff.h
+    wx/imageloader.h
     wx/imagxpm.h
     wx/itemattr.h
     wx/listbase.h
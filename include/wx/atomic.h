@@ -21,6 +21,11 @@
 //  - wxAtomicDec must return a zero value if the value is zero once
 //  decremented else it must return any non-zero value (the true value is OK
 //  but not necessary).
+//  - wxAtomicCompareAndSwap must replace the value with the new one only if it
+//  is equal to the old one and return true if it did it, it must also act as
+//  a full memory barrier.
+//  - wxAtomicGet must return the current value and also act as a full memory
+//  barrier.
 
 #if wxUSE_THREADS
 
@@ -41,6 +46,22 @@ inline wxUint32 wxAtomicDec (wxUint32 &value)
     return __sync_sub_and_fetch(&value, 1);
 }
 
+inline bool wxAtomicCompareAndSwap (wxUint32 &value, wxUint32 oldValue, wxUint32 newValue)
+{
+    return __sync_bool_compare_and_swap(&value, oldValue, newValue);
+}
+
+inline wxUint32 wxAtomicGet (wxUint32 &value)
+{
+    return __sync_fetch_and_add(&value, 0);
+}
+
+template <typename T>
+inline bool wxAtomicCompareAndSwap (T* &ptr, T* oldValue, T* newValue)
+{
+    return __sync_bool_compare_and_swap(&ptr, oldValue, newValue);
+}
+
 
 #elif defined(__WINDOWS__)
 
@@ -57,6 +78,24 @@ inline wxUint32 wxAtomicDec (wxUint32 &value)
     return InterlockedDecrement ((LONG*)&value);
 }
 
+inline bool wxAtomicCompareAndSwap (wxUint32 &value, wxUint32 oldValue, wxUint32 newValue)
+{
+    return InterlockedCompareExchange ((LONG*)&value, (LONG)newValue, (LONG)oldValue)
+                == (LONG)oldValue;
+}
+
+inline wxUint32 wxAtomicGet (wxUint32 &value)
+{
+    return InterlockedCompareExchange ((LONG*)&value, 0, 0);
+}
+
+template <typename T>
+inline bool wxAtomicCompareAndSwap (T* &ptr, T* oldValue, T* newValue)
+{
+    return InterlockedCompareExchangePointer ((PVOID*)&ptr, newValue, oldValue)
+                == oldValue;
+}
+
 #elif defined(__DARWIN__)
 
 #include "libkern/OSAtomic.h"
@@ -70,6 +109,23 @@ inline wxUint32 wxAtomicDec (wxUint32 &value)
     return OSAtomicDecrement32 ((int32_t*)&value);
 }
 
+inline bool wxAtomicCompareAndSwap (wxUint32 &value, wxUint32 oldValue, wxUint32 newValue)
+{
+    return OSAtomicCompareAndSwap32Barrier ((int32_t)oldValue, (int32_t)newValue,
+                                            (int32_t*)&value);
+}
+
+inline wxUint32 wxAtomicGet (wxUint32 &value)
+{
+    return OSAtomicAdd32Barrier (0, (int32_t*)&value);
+}
+
+template <typename T>
+inline bool wxAtomicCompareAndSwap (T* &ptr, T* oldValue, T* newValue)
+{
+    return OSAtomicCompareAndSwapPtrBarrier (oldValue, newValue, (void**)&ptr);
+}
+
 #elif defined (__SOLARIS__)
 
 #include <atomic.h>
@@ -84,6 +140,22 @@ inline wxUint32 wxAtomicDec (wxUint32 &value)
     return atomic_add_32_nv ((uint32_t*)&value, (uint32_t)-1);
 }
 
+inline bool wxAtomicCompareAndSwap (wxUint32 &value, wxUint32 oldValue, wxUint32 newValue)
+{
+    return atomic_cas_32 ((uint32_t*)&value, oldValue, newValue) == oldValue;
+}
+
+inline wxUint32 wxAtomicGet (wxUint32 &value)
+{
+    return atomic_add_32_nv ((uint32_t*)&value, 0);
+}
+
+template <typename T>
+inline bool wxAtomicCompareAndSwap (T* &ptr, T* oldValue, T* newValue)
+{
+    return atomic_cas_ptr ((void*)&ptr, oldValue, newValue) == oldValue;
+}
+
 #else // unknown platform
 
 // it will result in inclusion if the generic implementation code a bit later in this page
@@ -97,6 +169,27 @@ inline wxUint32 wxAtomicDec (wxUint32 &value)
 inline void wxAtomicInc (wxUint32 &value) { ++value; }
 inline wxUint32 wxAtomicDec (wxUint32 &value) { return --value; }
 
+inline bool wxAtomicCompareAndSwap (wxUint32 &value, wxUint32 oldValue, wxUint32 newValue)
+{
+    if ( value != oldValue )
+        return false;
+
+    value = newValue;
+    return true;
+}
+
+inline wxUint32 wxAtomicGet (wxUint32 &value) { return value; }
+
+template <typename T>
+inline bool wxAtomicCompareAndSwap (T* &ptr, T* oldValue, T* newValue)
+{
+    if ( ptr != oldValue )
+        return false;
+
+    ptr = newValue;
+    return true;
+}
+
 #endif // !wxUSE_THREADS
 
 // ----------------------------------------------------------------------------
@@ -132,6 +225,12 @@ public:
         return --m_value;
     }
 
+    wxInt32 Get()
+    {
+        wxCriticalSectionLocker lock(m_locker);
+        return m_value;
+    }
+
 private:
     volatile wxInt32  m_value;
     wxCriticalSection m_locker;
@@ -139,6 +238,7 @@ private:
 
 inline void wxAtomicInc(wxAtomicInt32 &value) { value.Inc(); }
 inline wxInt32 wxAtomicDec(wxAtomicInt32 &value) { return value.Dec(); }
+inline wxInt32 wxAtomicGet(wxAtomicInt32 &value) { return value.Get(); }
 
 #else // !wxNEEDS_GENERIC_ATOMIC_OPS
 
@@ -146,6 +246,11 @@ inline wxInt32 wxAtomicDec(wxAtomicInt32 &value) { return value.Dec(); }
 
 inline void wxAtomicInc(wxInt32 &value) { wxAtomicInc((wxUint32&)value); }
 inline wxInt32 wxAtomicDec(wxInt32 &value) { return wxAtomicDec((wxUint32&)value); }
+inline bool wxAtomicCompareAndSwap(wxInt32 &value, wxInt32 oldValue, wxInt32 newValue)
+{
+    return wxAtomicCompareAndSwap((wxUint32&)value, (wxUint32)oldValue, (wxUint32)newValue);
+}
+inline wxInt32 wxAtomicGet(wxInt32 &value) { return wxAtomicGet((wxUint32&)value); }
 
 typedef wxInt32 wxAtomicInt32;
 
@@ -126,6 +126,12 @@ public:
 
     virtual void Resort() = 0;
 
+    // called before and after a group of changes notified between the calls
+    // to wxDataViewModel::BeginBatch() and EndBatch(), which can be used to
+    // update the view only once at the end
+    virtual void BeginBatch() { }
+    virtual void EndBatch() { }
+
     void SetOwner( wxDataViewModel *owner ) { m_owner = owner; }
     wxDataViewModel *GetOwner() const       { return m_owner; }
 
@@ -269,6 +275,12 @@ public:
     // delegated action
     virtual void Resort();
 
+    // notify about many changes at once: the notifiers may postpone updating
+    // the view until the outermost EndBatch() call
+    void BeginBatch();
+    void EndBatch();
+    int GetBatchCount() const { return m_batchCount; }
+
     void AddNotifier( wxDataViewModelNotifier *notifier );
     void RemoveNotifier( wxDataViewModelNotifier *notifier );
 
@@ -297,6 +309,9 @@ protected:
 
 private:
     wxDataViewModelNotifiers  m_notifiers;
+
+    // the nesting level of BeginBatch() calls
+    int m_batchCount;
 };
 
 // ----------------------------------------------------------------------------
@@ -696,6 +711,13 @@ public:
     // Return true if multi column sort is currently allowed.
     virtual bool IsMultiColumnSortAllowed() const { return false; }
 
+    // This must be overridden to return true if the control supports updating
+    // the best column widths incrementally, which is not the case by default.
+    virtual bool EnableIncrementalColumnWidths(bool enable = true)
+    {
+        return !enable;
+    }
+
     // This should also be overridden to actually use the specified column for
     // sorting if using multiple columns is supported.
     virtual void ToggleSortByColumn(int WXUNUSED(column)) { }
@@ -73,6 +73,9 @@ class WXDLLIMPEXP_FWD_BASE wxEventFilter;
 
 class WXDLLIMPEXP_FWD_BASE wxMSVC_FWD_MULTIPLE_BASES wxEvtHandler;
 class wxEventConnectionRef;
+class wxDynamicEventsIndex;
+class wxPendingEventsCoalescing;
+struct wxPendingEventNode;
 
 // ----------------------------------------------------------------------------
 // Event types
@@ -3662,6 +3665,13 @@ public:
 
     void DeletePendingEvents();
 
+    // Enable or disable coalescing of the queued events of the given type: if
+    // it's enabled, queuing an event of this type replaces the event of the
+    // same type and with the same id queued before, if it hasn't been
+    // processed yet. This is safe to call from any thread.
+    void EnableEventsCoalescing(wxEventType eventType, bool enable = true);
+    bool IsEventsCoalescingEnabled(wxEventType eventType) const;
+
 #if wxUSE_THREADS
     bool ProcessThreadEvent(const wxEvent& event);
         // NOTE: uses AddPendingEvent(); call only from secondary threads
@@ -3986,10 +3996,32 @@ protected:
     typedef wxVector<wxDynamicEventTableEntry*> DynamicEvents;
     DynamicEvents* m_dynamicEvents;
 
-    wxList*             m_pendingEvents;
+    // Positions of the entries of m_dynamicEvents indexed by their event type,
+    // only created if there are many of them, see SearchDynamicEventTable().
+    wxDynamicEventsIndex* m_dynamicEventsIndex;
+
+    // The events added by QueueEvent(), possibly from other threads, in the
+    // reverse order of their addition. Adding an event to this list doesn't
+    // require locking if atomic operations are available and all of them are
+    // moved to m_pendingEvents at once when the events are processed.
+    wxPendingEventNode* m_queuedEvents;
+
+    // The events to process, in the order of their addition, protected by
+    // m_pendingEventsLock.
+    wxPendingEventNode* m_pendingEvents;
+    wxPendingEventNode* m_pendingEventsLast;
+
+    // Non-NULL if EnableEventsCoalescing() was called, protected by
+    // m_pendingEventsLock.
+    wxPendingEventsCoalescing* m_pendingEventsCoalescing;
+
+    // Non-zero if this handler is in the list of the handlers with pending
+    // events maintained by wxApp.
+    wxUint32            m_hasPendingEvents;
 
 #if wxUSE_THREADS
-    // critical section protecting m_pendingEvents
+    // critical section protecting m_pendingEvents and, if there are no
+    // atomic operations, m_queuedEvents too
     wxCriticalSection m_pendingEventsLock;
 #endif // wxUSE_THREADS
 
@@ -4028,6 +4060,19 @@ private:
     // try to process events in all handlers chained to this one
     bool DoTryChain(wxEvent& event);
 
+    // return the positions in m_dynamicEvents of the entries for the given
+    // event type, creating m_dynamicEventsIndex if necessary
+    const wxVector<size_t>* GetDynamicEventsPositions(wxEventType eventType);
+
+    // helpers of QueueEvent() and ProcessPendingEvents() managing the lists of
+    // the pending events and the m_hasPendingEvents flag, TakeQueuedEvents()
+    // must be called with m_pendingEventsLock locked
+    void PushQueuedEvent(wxPendingEventNode* node);
+    void TakeQueuedEvents();
+    bool ChangeHasPendingEvents(bool hasPendingEvents);
+    void RemoveFromPendingEventHandlers();
+    void ResetHasPendingEvents();
+
     // Head of the event filter linked list.
     static wxEventFilter* ms_filterList;
 
@@ -274,6 +274,7 @@ public:
 
     virtual bool AllowMultiColumnSort(bool allow) wxOVERRIDE;
     virtual bool IsMultiColumnSortAllowed() const wxOVERRIDE { return m_allowMultiColumnSort; }
+    virtual bool EnableIncrementalColumnWidths(bool enable = true) wxOVERRIDE;
     virtual void ToggleSortByColumn(int column) wxOVERRIDE;
 
 #if wxUSE_DRAG_AND_DROP
@@ -298,6 +299,17 @@ public:
     // This method is only available in the generic versions.
     wxHeaderCtrl* GenericGetHeader() const;
 
+    // Sort the children of the items having at least the given number of them
+    // in a background thread, using the values of the sort column retrieved
+    // from the model in advance, or never do it if the argument is 0 (this is
+    // the default). This can only be used with the models using the default
+    // wxDataViewModel::Compare() implementation, as the values are compared in
+    // the same way as it does it.
+    //
+    // This method is specific to generic wxDataViewCtrl implementation and
+    // should not be used in portable code.
+    void EnableBackgroundSorting(unsigned minChildren = 10000);
+
 protected:
     void EnsureVisibleRowCol( int row, int column );
 
@@ -370,6 +382,11 @@ private:
     void InvalidateColBestWidth(int idx);
     void UpdateColWidths();
 
+    // take into account the given rows in the cached best widths of all the
+    // columns or just the one with the given index
+    void UpdateColBestWidths(unsigned int row, unsigned int count,
+                             int idx = wxNOT_FOUND);
+
     void DoClearColumns();
 
     wxVector<wxDataViewColumn*> m_cols;
@@ -400,6 +417,10 @@ private:
     // if true, allow sorting by more than one column
     bool m_allowMultiColumnSort;
 
+    // if true, the column best widths are only updated to account for the
+    // changed items and are not recomputed when the items are deleted
+    bool m_incrementalColWidths;
+
 private:
     void OnSize( wxSizeEvent &event );
     virtual wxSize GetSizeAvailableForScrollTarget(const wxSize& size) wxOVERRIDE;
@@ -16,6 +16,7 @@
 #if wxUSE_GRID
 
 #include "wx/hashmap.h"
+#include "wx/vector.h"
 
 #include "wx/scrolwin.h"
 
@@ -95,6 +96,7 @@ enum wxGridRenderStyle
 class WXDLLIMPEXP_FWD_CORE wxGrid;
 class WXDLLIMPEXP_FWD_CORE wxGridCellAttr;
 class WXDLLIMPEXP_FWD_CORE wxGridCellAttrProviderData;
+class WXDLLIMPEXP_FWD_CORE wxGridBlockCoords;
 class WXDLLIMPEXP_FWD_CORE wxGridColLabelWindow;
 class WXDLLIMPEXP_FWD_CORE wxGridCornerLabelWindow;
 class WXDLLIMPEXP_FWD_CORE wxGridEvent;
@@ -115,6 +117,7 @@ class WXDLLIMPEXP_FWD_CORE wxDatePickerCtrl;
 #endif
 
 class wxGridFixedIndicesSet;
+class wxGridTypedTableColumn;
 
 class wxGridOperations;
 class wxGridRowOperations;
@@ -894,6 +897,12 @@ public:
     virtual void SetRowAttr(wxGridCellAttr *attr, int row);
     virtual void SetColAttr(wxGridCellAttr *attr, int col);
 
+    // set the attribute for all cells of the given block: the blocks can
+    // overlap, with the attribute set last having higher priority, and have
+    // lower priority than the cell attributes but higher than row/col ones
+    virtual void SetBlockAttr(wxGridCellAttr *attr,
+                              const wxGridBlockCoords& block);
+
     // these functions must be called whenever some rows/cols are deleted
     // because the internal data must be updated then
     void UpdateAttrRows( size_t pos, int numRows );
@@ -1281,6 +1290,8 @@ public:
     virtual void SetAttr(wxGridCellAttr* attr, int row, int col);
     virtual void SetRowAttr(wxGridCellAttr *attr, int row);
     virtual void SetColAttr(wxGridCellAttr *attr, int col);
+    virtual void SetBlockAttr(wxGridCellAttr *attr,
+                              const wxGridBlockCoords& block);
 
 private:
     wxGrid * m_view;
@@ -1349,13 +1360,66 @@ WX_DECLARE_OBJARRAY_WITH_DECL(wxArrayString, wxGridStringArray,
 
 
 
+// ------ wxGridMemoryTableBase
+//
+// Common base class for the tables storing their values in memory: it stores
+// the custom labels and implements adding and removing rows and columns,
+// including updating the labels and notifying the view, in terms of the
+// DoInsertXXX() and DoDeleteXXX() functions which only need to update the
+// values storage
+//
+
+class WXDLLIMPEXP_CORE wxGridMemoryTableBase : public wxGridTableBase
+{
+public:
+    wxGridMemoryTableBase() { }
+
+    // overridden functions from wxGridTableBase
+    //
+    bool InsertRows( size_t pos = 0, size_t numRows = 1 ) wxOVERRIDE;
+    bool AppendRows( size_t numRows = 1 ) wxOVERRIDE;
+    bool DeleteRows( size_t pos = 0, size_t numRows = 1 ) wxOVERRIDE;
+    bool InsertCols( size_t pos = 0, size_t numCols = 1 ) wxOVERRIDE;
+    bool AppendCols( size_t numCols = 1 ) wxOVERRIDE;
+    bool DeleteCols( size_t pos = 0, size_t numCols = 1 ) wxOVERRIDE;
+
+    void SetRowLabelValue( int row, const wxString& ) wxOVERRIDE;
+    void SetColLabelValue( int col, const wxString& ) wxOVERRIDE;
+    void SetCornerLabelValue( const wxString& ) wxOVERRIDE;
+    wxString GetRowLabelValue( int row ) wxOVERRIDE;
+    wxString GetColLabelValue( int col ) wxOVERRIDE;
+    wxString GetCornerLabelValue() const wxOVERRIDE;
+
+protected:
+    // update the storage of the values: the indices passed to these functions
+    // are always valid, with pos being equal to the current number of rows or
+    // columns when appending them
+    virtual void DoInsertRows( size_t pos, size_t numRows ) = 0;
+    virtual void DoDeleteRows( size_t pos, size_t numRows ) = 0;
+    virtual void DoInsertCols( size_t pos, size_t numCols ) = 0;
+    virtual void DoDeleteCols( size_t pos, size_t numCols ) = 0;
+
+private:
+    // These only get used if you set your own labels, otherwise the
+    // GetRow/ColLabelValue functions return wxGridTableBase defaults
+    //
+    wxArrayString     m_rowLabels;
+    wxArrayString     m_colLabels;
+
+    wxString m_cornerLabel;
+
+    wxDECLARE_ABSTRACT_CLASS(wxGridMemoryTableBase);
+    wxDECLARE_NO_COPY_CLASS(wxGridMemoryTableBase);
+};
+
+
 // ------ wxGridStringTable
 //
 // Simplest type of data table for a grid for small tables of strings
 // that are stored in memory
 //
 
-class WXDLLIMPEXP_CORE wxGridStringTable : public wxGridTableBase
+class WXDLLIMPEXP_CORE wxGridStringTable : public wxGridMemoryTableBase
 {
 public:
     wxGridStringTable();
@@ -1371,19 +1435,12 @@ public:
     // overridden functions from wxGridTableBase
     //
     void Clear() wxOVERRIDE;
-    bool InsertRows( size_t pos = 0, size_t numRows = 1 ) wxOVERRIDE;
-    bool AppendRows( size_t numRows = 1 ) wxOVERRIDE;
-    bool DeleteRows( size_t pos = 0, size_t numRows = 1 ) wxOVERRIDE;
-    bool InsertCols( size_t pos = 0, size_t numCols = 1 ) wxOVERRIDE;
-    bool AppendCols( size_t numCols = 1 ) wxOVERRIDE;
-    bool DeleteCols( size_t pos = 0, size_t numCols = 1 ) wxOVERRIDE;
 
-    void SetRowLabelValue( int row, const wxString& ) wxOVERRIDE;
-    void SetColLabelValue( int col, const wxString& ) wxOVERRIDE;
-    void SetCornerLabelValue( const wxString& ) wxOVERRIDE;
-    wxString GetRowLabelValue( int row ) wxOVERRIDE;
-    wxString GetColLabelValue( int col ) wxOVERRIDE;
-    wxString GetCornerLabelValue() const wxOVERRIDE;
+protected:
+    virtual void DoInsertRows( size_t pos, size_t numRows ) wxOVERRIDE;
+    virtual void DoDeleteRows( size_t pos, size_t numRows ) wxOVERRIDE;
+    virtual void DoInsertCols( size_t pos, size_t numCols ) wxOVERRIDE;
+    virtual void DoDeleteCols( size_t pos, size_t numCols ) wxOVERRIDE;
 
 private:
     wxGridStringArray m_data;
@@ -1394,15 +1451,71 @@ private:
     // rows is 0 (see #10818)
     int m_numCols;
 
-    // These only get used if you set your own labels, otherwise the
-    // GetRow/ColLabelValue functions return wxGridTableBase defaults
+    wxDECLARE_DYNAMIC_CLASS_NO_COPY(wxGridStringTable);
+};
+
+
+// ------ wxGridTypedTable
+//
+// Grid table storing the values of each column using the representation
+// corresponding to the column type, e.g. as doubles for wxGRID_VALUE_FLOAT,
+// which is much more compact than wxGridStringTable for big numeric tables
+// and avoids converting the values to and from strings
+//
+
+class WXDLLIMPEXP_CORE wxGridTypedTable : public wxGridMemoryTableBase
+{
+public:
+    wxGridTypedTable();
+    wxGridTypedTable( int numRows, int numCols,
+                      const wxString& typeName = wxGRID_VALUE_STRING );
+    virtual ~wxGridTypedTable();
+
+    // change the type of the given column, converting its existing values
     //
-    wxArrayString     m_rowLabels;
-    wxArrayString     m_colLabels;
+    // the type name may contain the parameters, e.g. "double:6,2", which are
+    // used for the renderer and editor of this column
+    void SetColType( int col, const wxString& typeName );
+    wxString GetColType( int col ) const;
 
-    wxString m_cornerLabel;
+    // these are pure virtual in wxGridTableBase
+    //
+    virtual int GetNumberRows() wxOVERRIDE { return m_numRows; }
+    virtual int GetNumberCols() wxOVERRIDE { return static_cast<int>(m_cols.size()); }
+    virtual wxString GetValue( int row, int col ) wxOVERRIDE;
+    virtual void SetValue( int row, int col, const wxString& s ) wxOVERRIDE;
 
-    wxDECLARE_DYNAMIC_CLASS_NO_COPY(wxGridStringTable);
+    // overridden functions from wxGridTableBase
+    //
+    virtual bool IsEmptyCell( int row, int col ) wxOVERRIDE;
+
+    virtual wxString GetTypeName( int row, int col ) wxOVERRIDE;
+    virtual bool CanGetValueAs( int row, int col, const wxString& typeName ) wxOVERRIDE;
+
+    virtual long GetValueAsLong( int row, int col ) wxOVERRIDE;
+    virtual double GetValueAsDouble( int row, int col ) wxOVERRIDE;
+    virtual bool GetValueAsBool( int row, int col ) wxOVERRIDE;
+
+    virtual void SetValueAsLong( int row, int col, long value ) wxOVERRIDE;
+    virtual void SetValueAsDouble( int row, int col, double value ) wxOVERRIDE;
+    virtual void SetValueAsBool( int row, int col, bool value ) wxOVERRIDE;
+
+    void Clear() wxOVERRIDE;
+
+protected:
+    virtual void DoInsertRows( size_t pos, size_t numRows ) wxOVERRIDE;
+    virtual void DoDeleteRows( size_t pos, size_t numRows ) wxOVERRIDE;
+    virtual void DoInsertCols( size_t pos, size_t numCols ) wxOVERRIDE;
+    virtual void DoDeleteCols( size_t pos, size_t numCols ) wxOVERRIDE;
+
+private:
+    // return the column if the indices are valid or NULL otherwise
+    wxGridTypedTableColumn* GetColumn( int row, int col ) const;
+
+    wxVector<wxGridTypedTableColumn*> m_cols;
+    int m_numRows;
+
+    wxDECLARE_DYNAMIC_CLASS_NO_COPY(wxGridTypedTable);
 };
 
 
@@ -1444,6 +1557,63 @@ struct WXDLLIMPEXP_CORE wxGridSizesInfo
     wxUnsignedToIntHashMap m_customSizes;
 };
 
+// ----------------------------------------------------------------------------
+// wxGridLineEnds stores the end positions of the rows or columns.
+//
+// This is used by wxGrid for its m_rowBottoms and m_colRights members when not
+// all lines have the default size. Notice that GetEnd() must be used instead
+// of indexing them as was possible when they were arrays.
+//
+// The sizes of the lines, in display order, are kept in a Fenwick tree, which
+// allows both finding the end of a line or the line at the given coordinate
+// and changing the size of a line in logarithmic time.
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_CORE wxGridLineEnds
+{
+public:
+    wxGridLineEnds() { }
+
+    bool IsEmpty() const { return m_tree.empty(); }
+    void Clear() { m_tree.clear(); }
+
+    // Recompute the ends of the lines at the given display position and after
+    // it from the sizes of all lines, which are indexed by the display
+    // position or, if the order array is not empty, by order[position], and
+    // for which negative values correspond to the hidden lines.
+    //
+    // The ends of the lines before "from" are supposed to be still valid.
+    void Rebuild(const wxArrayInt& sizes, size_t from = 0)
+        { DoRebuild(sizes, NULL, from); }
+    void Rebuild(const wxArrayInt& sizes, const wxArrayInt& order,
+                 size_t from = 0)
+        { DoRebuild(sizes, order.empty() ? NULL : &order, from); }
+
+    // Change the size of the line at the given display position.
+    void Update(size_t pos, int diff);
+
+    // Get the end of the line at the given display position, i.e. the sum of
+    // the sizes of all lines up to and including it.
+    int GetEnd(size_t pos) const { return GetSum(pos + 1); }
+
+    // Get the display position of the line containing the given coordinate,
+    // i.e. of the first line ending after it, or the number of lines if there
+    // is no such line.
+    size_t FindPos(int coord) const;
+
+private:
+    void DoRebuild(const wxArrayInt& sizes, const wxArrayInt* order,
+                   size_t from);
+
+    // Return the sum of the sizes of the given number of the first lines.
+    int GetSum(size_t count) const;
+
+    // The element with index i contains the sum of the sizes of the lines in
+    // the [i + 1 - lowbit(i + 1), i] range, where lowbit(n) is the lowest
+    // non-zero bit of n.
+    wxVector<int> m_tree;
+};
+
 // ----------------------------------------------------------------------------
 // wxGrid
 // ----------------------------------------------------------------------------
@@ -1947,6 +2117,9 @@ public:
     void     SetRowAttr(int row, wxGridCellAttr *attr);
     void     SetColAttr(int col, wxGridCellAttr *attr);
 
+    // this sets the attribute for all cells of the given block
+    void     SetBlockAttr(const wxGridBlockCoords& block, wxGridCellAttr *attr);
+
     // the grid can cache attributes for the recently used cells (currently it
     // only caches one attribute for the most recently used one) and might
     // notice that its value in the attribute provider has changed -- if this
@@ -2582,7 +2755,7 @@ protected:
     int        m_defaultRowHeight;
     int        m_minAcceptableRowHeight;
     wxArrayInt m_rowHeights;
-    wxArrayInt m_rowBottoms;
+    wxGridLineEnds m_rowBottoms;
 
     // init the m_colWidths/Rights arrays
     void InitColWidths();
@@ -2590,7 +2763,7 @@ protected:
     int        m_defaultColWidth;
     int        m_minAcceptableColWidth;
     wxArrayInt m_colWidths;
-    wxArrayInt m_colRights;
+    wxGridLineEnds m_colRights;
 
     int m_sortCol;
     bool m_sortIsAscending;
@@ -143,6 +143,10 @@ public:
     long InsertItem( long index, const wxString& label );
     long InsertItem( long index, int imageIndex );
     long InsertItem( long index, const wxString& label, int imageIndex );
+
+    // insert many items at once, this is much faster than inserting them one
+    // by one, returns the index of the first inserted item
+    long InsertItems( long index, const wxArrayString& labels, int imageIndex = -1 );
     bool ScrollList( int dx, int dy );
     bool SortItems( wxListCtrlCompare fn, wxIntPtr data );
 
@@ -156,6 +160,11 @@ public:
 
     virtual void EnableBellOnNoMatch(bool on = true) wxOVERRIDE;
 
+    // use an index of the item labels to speed up the incremental search in
+    // big controls, at the price of using more memory
+    void EnableFindIndex(bool enable = true);
+    bool HasFindIndex() const;
+
     // overridden base class virtuals
     // ------------------------------
 
@@ -449,16 +449,167 @@ public:
     void UpdateAttrRowsOrCols( size_t pos, int numRowsOrCols );
 
 private:
+    // Returns the index of the first element of m_rowsOrCols greater than or
+    // equal to the given one.
+    size_t FindIndex(int rowOrCol) const;
+
+    // sorted in increasing order to allow using binary search
     wxArrayInt m_rowsOrCols;
     wxArrayAttrs m_attrs;
 };
 
-// NB: this is just a wrapper around 3 objects: one which stores cell
-//     attributes, and 2 others for row/col ones
+// this class combines several attributes in the order of their priority
+class wxGridCellAttrMerger
+{
+public:
+    wxGridCellAttrMerger() : m_attr(NULL), m_merged(false) { }
+
+    // takes ownership of the attribute reference, which may be NULL
+    void Add(wxGridCellAttr *attr);
+
+    // returns the result which must be DecRef()'d by the caller
+    wxGridCellAttr *Get() const { return m_attr; }
+
+private:
+    wxGridCellAttr *m_attr;
+
+    // true if m_attr was created by us to merge several attributes
+    bool m_merged;
+
+    wxDECLARE_NO_COPY_CLASS(wxGridCellAttrMerger);
+};
+
+struct wxGridBlockCoordsHash
+{
+    wxGridBlockCoordsHash() { }
+
+    unsigned long operator()(const wxGridBlockCoords& coords) const
+    {
+        return ((((unsigned long)coords.GetTopRow() * 31u +
+                    coords.GetLeftCol()) * 31u +
+                        coords.GetBottomRow()) * 31u) +
+                            coords.GetRightCol();
+    }
+};
+
+struct wxGridBlockCoordsEqual
+{
+    wxGridBlockCoordsEqual() { }
+
+    bool operator()(const wxGridBlockCoords& a, const wxGridBlockCoords& b) const
+    {
+        return a == b;
+    }
+};
+
+WX_DECLARE_HASH_MAP(wxGridBlockCoords, size_t,
+                    wxGridBlockCoordsHash, wxGridBlockCoordsEqual,
+                    wxGridBlockCoordsToIndexMap);
+
+// this class stores attributes set for blocks of cells
+//
+// the blocks can overlap, in which case the attribute of the block added last
+// has the highest priority
+//
+// to find the blocks containing the given cell, the blocks are indexed by a
+// segment tree over the rows, storing each block in O(log(B)) nodes for B
+// blocks, and the blocks of each node are indexed by their columns, so that a
+// lookup takes O(log(B)^2 + K*log(B)) time if K blocks contain the cell and
+// the index takes O(B*log(B)) memory
+class WXDLLIMPEXP_ADV wxGridBlockAttrData
+{
+public:
+    wxGridBlockAttrData() : m_numRemoved(0), m_indexValid(true) { }
+    ~wxGridBlockAttrData();
+
+    void SetAttr(wxGridCellAttr *attr, const wxGridBlockCoords& block);
+
+    // adds the attributes of all the blocks containing the given cell to the
+    // merger in the order of their priority
+    void GetAttrs(int row, int col, wxGridCellAttrMerger& merger) const;
+
+    void UpdateAttrRows( size_t pos, int numRows );
+    void UpdateAttrCols( size_t pos, int numCols );
+
+private:
+    void UpdateAttrRowsOrCols( size_t pos, int numRowsOrCols, bool rows );
+
+    // removes the blocks whose attributes were reset from m_blocks and
+    // updates m_blockIndices
+    void Compact();
+
+    // (re)creates the index, this is done lazily when the attributes are
+    // needed to avoid doing it after each change
+    void BuildIndex() const;
+
+    // returns the index of the segment containing the given row or the number
+    // of segments if the row precedes all of them
+    size_t FindSegment(int row) const;
+
+    // computes IndexEntry::maxRight for the entries in [lo, hi) range
+    int BuildMaxRight(size_t lo, size_t hi) const;
+
+    // appends the blocks of the entries in [lo, hi) range, which are among the
+    // first "end" entries of their node, containing the given column to
+    // m_found
+    void FindBlocks(size_t lo, size_t hi, size_t end, int col) const;
+
+    struct Block
+    {
+        wxGridBlockCoords coords;
+
+        // NULL if the attribute of this block was reset
+        wxGridCellAttr *attr;
+    };
+
+    // all blocks in the order in which they were added
+    wxVector<Block> m_blocks;
+
+    // the number of blocks in m_blocks with NULL attr
+    size_t m_numRemoved;
+
+    // the index of the last block with the given coordinates in m_blocks
+    wxGridBlockCoordsToIndexMap m_blockIndices;
+
+    // the leaves of the segment tree are the segments of rows between the
+    // consecutive elements of m_rowStarts, containing the same blocks
+    mutable wxVector<int> m_rowStarts;
+
+    struct IndexEntry
+    {
+        int leftCol,
+            rightCol;
+
+        // the maximal right column of the entries in the implicit binary
+        // tree rooted at this entry, see BuildMaxRight()
+        int maxRight;
+
+        size_t block;
+    };
+
+    // the entries of the segment tree node N, sorted by their left column,
+    // are stored in m_entries at positions from m_nodeOffsets[N] to
+    // m_nodeOffsets[N + 1]
+    mutable wxVector<size_t> m_nodeOffsets;
+    mutable wxVector<IndexEntry> m_entries;
+
+    // the blocks found by GetAttrs(), only used to avoid allocating them
+    // every time
+    mutable wxVector<size_t> m_found;
+
+    mutable bool m_indexValid;
+
+    wxDECLARE_NO_COPY_CLASS(wxGridBlockAttrData);
+};
+
+// NB: this is just a wrapper around 4 objects: one which stores cell
+//     attributes, another one for blocks of cells and 2 others for row/col
+//     ones
 class WXDLLIMPEXP_ADV wxGridCellAttrProviderData
 {
 public:
     wxGridCellAttrData m_cellAttrs;
+    wxGridBlockAttrData m_blockAttrs;
     wxGridRowOrColAttrData m_rowAttrs,
                            m_colAttrs;
 };
@@ -551,8 +702,8 @@ public:
     // Get the height/width of the given row/column
     virtual int GetLineSize(const wxGrid *grid, int line) const = 0;
 
-    // Get wxGrid::m_rowBottoms/m_colRights array
-    virtual const wxArrayInt& GetLineEnds(const wxGrid *grid) const = 0;
+    // Get wxGrid::m_rowBottoms/m_colRights object
+    virtual const wxGridLineEnds& GetLineEnds(const wxGrid *grid) const = 0;
 
     // Get default height row height or column width
     virtual int GetDefaultLineSize(const wxGrid *grid) const = 0;
@@ -649,7 +800,7 @@ public:
         { return grid->GetRowBottom(line); }
     virtual int GetLineSize(const wxGrid *grid, int line) const wxOVERRIDE
         { return grid->GetRowHeight(line); }
-    virtual const wxArrayInt& GetLineEnds(const wxGrid *grid) const wxOVERRIDE
+    virtual const wxGridLineEnds& GetLineEnds(const wxGrid *grid) const wxOVERRIDE
         { return grid->m_rowBottoms; }
     virtual int GetDefaultLineSize(const wxGrid *grid) const wxOVERRIDE
         { return grid->GetDefaultRowSize(); }
@@ -730,7 +881,7 @@ public:
         { return grid->GetColRight(line); }
     virtual int GetLineSize(const wxGrid *grid, int line) const wxOVERRIDE
         { return grid->GetColWidth(line); }
-    virtual const wxArrayInt& GetLineEnds(const wxGrid *grid) const wxOVERRIDE
+    virtual const wxGridLineEnds& GetLineEnds(const wxGrid *grid) const wxOVERRIDE
         { return grid->m_colRights; }
     virtual int GetDefaultLineSize(const wxGrid *grid) const wxOVERRIDE
         { return grid->GetDefaultColSize(); }
@@ -19,6 +19,8 @@
 #include "wx/timer.h"
 #include "wx/settings.h"
 
+#include "wx/generic/private/prefixfind.h"
+
 // ============================================================================
 // private classes
 // ============================================================================
@@ -42,6 +44,180 @@ struct wxColWidthInfo
 
 WX_DEFINE_ARRAY_PTR(wxColWidthInfo *, ColWidthArray);
 
+//-----------------------------------------------------------------------------
+//  wxListObjectPool (internal)
+//-----------------------------------------------------------------------------
+
+// Allocates objects of type T from big chunks of memory instead of allocating
+// each of them separately, which is much faster when creating and destroying
+// many of them. The freed objects memory is reused and all the chunks are
+// released as soon as there are no more objects.
+template <class T>
+class wxListObjectPool
+{
+public:
+    wxListObjectPool()
+    {
+        m_free = NULL;
+        m_freeCount =
+        m_chunkUsed =
+        m_chunkSize =
+        m_count = 0;
+    }
+
+    ~wxListObjectPool()
+    {
+        // don't free the memory of the objects which are still alive, if any
+        if ( !m_count )
+            FreeChunks();
+    }
+
+    void* Alloc(size_t size)
+    {
+        wxASSERT_MSG( size == sizeof(T), "unexpected object size" );
+        wxUnusedVar(size);
+
+        m_count++;
+
+        if ( m_free )
+        {
+            Slot* const slot = m_free;
+            m_free = slot->next;
+            m_freeCount--;
+            return slot;
+        }
+
+        if ( m_chunkUsed == m_chunkSize )
+            AddChunk(CHUNK_SIZE);
+
+        return &m_chunks.back()[m_chunkUsed++];
+    }
+
+    void Free(void* p)
+    {
+        if ( !p )
+            return;
+
+        Slot* const slot = static_cast<Slot*>(p);
+        slot->next = m_free;
+        m_free = slot;
+        m_freeCount++;
+
+        if ( !--m_count )
+            ReleaseChunks();
+    }
+
+    // create a new object using the memory from this pool
+    template <typename A>
+    T* New(A arg)
+    {
+        return new(Alloc(sizeof(T))) T(arg);
+    }
+
+    // destroy an object created by New()
+    void Delete(T* p)
+    {
+        if ( !p )
+            return;
+
+        p->~T();
+        Free(p);
+    }
+
+    // ensure that allocating the given number of objects doesn't need to
+    // allocate memory more than once
+    void Reserve(size_t count)
+    {
+        const size_t avail = m_freeCount + m_chunkSize - m_chunkUsed;
+        if ( avail >= count )
+            return;
+
+        // Don't waste the rest of the current chunk, the new one will be used
+        // only after all its slots.
+        for ( ; m_chunkUsed < m_chunkSize; m_chunkUsed++ )
+        {
+            Slot* const slot = &m_chunks.back()[m_chunkUsed];
+            slot->next = m_free;
+            m_free = slot;
+            m_freeCount++;
+        }
+
+        AddChunk(count - avail);
+    }
+
+private:
+    // the unused slots are linked together
+    union Slot
+    {
+        Slot* next;
+
+        // ensure that the slots are suitably aligned for T
+        double alignDouble;
+        void* alignPtr;
+
+        char data[sizeof(T)];
+    };
+
+    enum { CHUNK_SIZE = 256 };
+
+    void AddChunk(size_t size)
+    {
+        if ( size < CHUNK_SIZE )
+            size = CHUNK_SIZE;
+
+        m_chunks.push_back(new Slot[size]);
+        m_chunkSize = size;
+        m_chunkUsed = 0;
+    }
+
+    void ReleaseChunks()
+    {
+        wxASSERT_MSG( !m_count, "releasing the memory still in use" );
+
+        // Keep the last chunk if it's small to avoid reallocating it
+        // immediately when objects are created and destroyed one by one.
+        Slot* last = NULL;
+        if ( !m_chunks.empty() && m_chunkSize == CHUNK_SIZE )
+        {
+            last = m_chunks.back();
+            m_chunks.pop_back();
+        }
+
+        FreeChunks();
+
+        m_free = NULL;
+        m_freeCount = 0;
+        m_chunkUsed = 0;
+        if ( last )
+            m_chunks.push_back(last);
+        else
+            m_chunkSize = 0;
+    }
+
+    void FreeChunks()
+    {
+        for ( size_t n = 0; n < m_chunks.size(); n++ )
+            delete [] m_chunks[n];
+        m_chunks.clear();
+    }
+
+    // all the allocated chunks, only the last one may be partially used
+    wxVector<Slot*> m_chunks;
+
+    // the list of the freed slots and its length
+    Slot* m_free;
+    size_t m_freeCount;
+
+    // the number of used and all slots in the last chunk
+    size_t m_chunkUsed,
+           m_chunkSize;
+
+    // the number of allocated objects
+    size_t m_count;
+
+    wxDECLARE_NO_COPY_TEMPLATE_CLASS(wxListObjectPool, T);
+};
+
 //-----------------------------------------------------------------------------
 //  wxListItemData (internal)
 //-----------------------------------------------------------------------------
@@ -160,13 +336,13 @@ private:
 //  wxListLineData (internal)
 //-----------------------------------------------------------------------------
 
-WX_DECLARE_LIST(wxListItemData, wxListItemDataList);
+typedef wxVector<wxListItemData*> wxListItemDataArray;
 
 class wxListLineData
 {
 public:
     // the list of subitems: only may have more than one item in report mode
-    wxListItemDataList m_items;
+    wxListItemDataArray m_items;
 
     // this is not used in report view
     struct GeometryInfo
@@ -208,10 +384,12 @@ public:
 public:
     wxListLineData(wxListMainWindow *owner);
 
-    ~wxListLineData()
+    ~wxListLineData();
+
+    // return the item for the given column or NULL if there is none
+    wxListItemData *GetItemData(size_t index) const
     {
-        WX_CLEAR_LIST(wxListItemDataList, m_items);
-        delete m_gi;
+        return index < m_items.size() ? m_items[index] : NULL;
     }
 
     // called by the owner when it toggles report view
@@ -313,18 +491,9 @@ private:
                            int width);
 };
 
-class wxListLineDataArray : public wxVector<wxListLineData*>
-{
-public:
-    void Clear()
-    {
-        for ( size_t n = 0; n < size(); ++n )
-            delete (*this)[n];
-        clear();
-    }
-
-    ~wxListLineDataArray() { Clear(); }
-};
+// the lines are allocated from the pool of wxListMainWindow which destroys
+// them using wxListMainWindow::ClearLines()
+typedef wxVector<wxListLineData*> wxListLineDataArray;
 
 //-----------------------------------------------------------------------------
 //  wxListHeaderWindow (internal)
@@ -499,6 +668,13 @@ public:
     // called by the main control when its mode changes
     void SetReportView(bool inReportView);
 
+    // there can be a lot of lines and items, so they're allocated from the
+    // pools of the control containing them
+    wxListLineData *CreateLineData() { return m_linePool.New(this); }
+    void DestroyLineData(wxListLineData *line) { m_linePool.Delete(line); }
+    wxListItemData *CreateItemData() { return m_itemDataPool.New(this); }
+    void DestroyItemData(wxListItemData *data) { m_itemDataPool.Delete(data); }
+
     // helper to simplify testing for wxLC_XXX flags
     bool HasFlag(int flag) const { return m_parent->HasFlag(flag); }
 
@@ -617,6 +793,17 @@ public:
     // (does nothing on MSW - bell is always rung)
     void EnableBellOnNoMatch( bool on );
 
+    // enable or disable using the index of the item labels for the search
+    void EnableFindIndex( bool enable );
+    bool HasFindIndex() const { return m_findIndexEnabled; }
+
+    // must be called whenever the items or their labels change
+    void InvalidateFindIndex()
+    {
+        if ( m_findIndexEnabled )
+            m_findIndex.Clear();
+    }
+
     void OnMouse( wxMouseEvent &event );
 
     // called to switch the selection from the current item to newCurrent,
@@ -711,6 +898,7 @@ public:
     long FindItem( const wxPoint& pt );
     long HitTest( int x, int y, int &flags ) const;
     void InsertItem( wxListItem &item );
+    long InsertItems( size_t index, const wxArrayString& labels, int image );
     long InsertColumn( long col, const wxListItem &item );
     int GetItemWidthWithImage(wxListItem * item);
     void SortItems( wxListCtrlCompare fn, wxIntPtr data );
@@ -786,6 +974,11 @@ public:
                                    int lineNumber );
 
 protected:
+    // the pools used for allocating the lines and their items, they must be
+    // destroyed after them
+    wxListObjectPool<wxListLineData> m_linePool;
+    wxListObjectPool<wxListItemData> m_itemDataPool;
+
     // the array of all line objects for a non virtual list control (for the
     // virtual list control we only ever use m_lines[0])
     wxListLineDataArray  m_lines;
@@ -825,6 +1018,11 @@ protected:
     // had already beeped for this particular search.
     int                  m_findBell;
 
+    // the index used by PrefixFindItem() if m_findIndexEnabled is true, it is
+    // built when it's needed and cleared whenever the items change
+    mutable wxPrefixFindIndex m_findIndex;
+    bool                 m_findIndexEnabled;
+
     bool                 m_isCreated;
     int                  m_dragCount;
     wxPoint              m_dragStart;
@@ -918,6 +1116,9 @@ private:
     // delete all items but don't refresh: called from dtor
     void DoDeleteAllItems();
 
+    // destroy all the lines and clear m_lines
+    void ClearLines();
+
     // Compute the minimal width needed to fully display the column header.
     int ComputeMinHeaderWidth(const wxListHeaderData* header) const;
 
@@ -0,0 +1,184 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/generic/private/prefixfind.h
+// Purpose:     wxPrefixFindIndex class used for incremental search
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_GENERIC_PRIVATE_PREFIXFIND_H_
+#define _WX_GENERIC_PRIVATE_PREFIXFIND_H_
+
+#include "wx/string.h"
+#include "wx/vector.h"
+
+#include <algorithm>
+
+// ----------------------------------------------------------------------------
+// wxPrefixFindIndex: allows to quickly find the items starting with a prefix
+// ----------------------------------------------------------------------------
+
+// The generic list and tree controls select the next item starting with the
+// characters typed by the user. Checking all the items labels for this is too
+// slow for big controls, so they can optionally use this index, which stores
+// the lower case labels of all items sorted alphabetically together with the
+// positions of the items in the control.
+//
+// The index is built from scratch by calling Add() for all items and Finish()
+// once all of them were added. It has to be rebuilt if the items change.
+class wxPrefixFindIndex
+{
+public:
+    wxPrefixFindIndex() { }
+
+    void Clear()
+    {
+        m_entries.clear();
+        m_blockPositions.clear();
+    }
+
+    bool IsEmpty() const { return m_entries.empty(); }
+
+    void Reserve(size_t count) { m_entries.reserve(count); }
+
+    // Add the item with the given label at the given position.
+    void Add(const wxString& label, size_t pos)
+    {
+        m_entries.push_back(Entry(label.Lower(), pos));
+    }
+
+    // Must be called after adding all items and before calling Find().
+    void Finish()
+    {
+        std::sort(m_entries.begin(), m_entries.end(), EntryLess());
+
+        // Also store the positions of all items starting with the same
+        // character in sorted order, to be able to find the next item
+        // starting with the given character in logarithmic time: this is the
+        // most common search, as it's done when typing the first character,
+        // and the one for which the linear search in Find() is the slowest.
+        const size_t count = m_entries.size();
+        m_blockPositions.resize(count);
+
+        size_t blockStart = 0;
+        for ( size_t n = 0; n < count; n++ )
+        {
+            m_blockPositions[n] = m_entries[n].pos;
+
+            if ( n + 1 == count ||
+                    !HaveSameFirstChar(m_entries[n].key, m_entries[n + 1].key) )
+            {
+                std::sort(m_blockPositions.begin() + blockStart,
+                          m_blockPositions.begin() + n + 1);
+                blockStart = n + 1;
+            }
+        }
+    }
+
+    // Find the position of the first item starting with the given prefix,
+    // which must be already in lower case, at or after the given position or,
+    // if there is none, the first one before it.
+    //
+    // Returns (size_t)-1 if no items start with this prefix.
+    size_t Find(const wxString& prefix, size_t start) const
+    {
+        const size_t notFound = static_cast<size_t>(-1);
+
+        if ( prefix.empty() )
+            return notFound;
+
+        // All items starting with the prefix are in [lo, hi) range: find its
+        // start, i.e. the first key which is not less than the prefix...
+        const size_t len = prefix.length();
+        size_t lo = 0,
+               hi = m_entries.size();
+        while ( lo < hi )
+        {
+            const size_t mid = (lo + hi) / 2;
+            if ( m_entries[mid].key < prefix )
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        // ... and its end, i.e. the first key which doesn't start with it.
+        const size_t first = lo;
+        hi = m_entries.size();
+        while ( lo < hi )
+        {
+            const size_t mid = (lo + hi) / 2;
+            if ( m_entries[mid].key.compare(0, len, prefix) <= 0 )
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        const size_t last = lo;
+        if ( first == last )
+            return notFound;
+
+        if ( len == 1 )
+        {
+            // The range is exactly the block of the items starting with this
+            // character, so we can use the sorted positions.
+            const wxVector<size_t>::const_iterator
+                begin = m_blockPositions.begin() + first,
+                end = m_blockPositions.begin() + last,
+                it = std::lower_bound(begin, end, start);
+
+            return it != end ? *it : *begin;
+        }
+
+        // For the longer prefixes, the number of matching items is usually
+        // small, so just check all of them.
+        size_t posNext = notFound,
+               posMin = notFound;
+        for ( size_t n = first; n < last; n++ )
+        {
+            const size_t pos = m_entries[n].pos;
+            if ( pos >= start && pos < posNext )
+                posNext = pos;
+            if ( pos < posMin )
+                posMin = pos;
+        }
+
+        return posNext != notFound ? posNext : posMin;
+    }
+
+private:
+    struct Entry
+    {
+        Entry(const wxString& key_, size_t pos_) : key(key_), pos(pos_) { }
+
+        wxString key;
+        size_t pos;
+    };
+
+    struct EntryLess
+    {
+        bool operator()(const Entry& e1, const Entry& e2) const
+        {
+            const int rc = e1.key.compare(e2.key);
+            return rc < 0 || (rc == 0 && e1.pos < e2.pos);
+        }
+    };
+
+    static bool HaveSameFirstChar(const wxString& s1, const wxString& s2)
+    {
+        if ( s1.empty() || s2.empty() )
+            return s1.empty() && s2.empty();
+
+        return *s1.begin() == *s2.begin();
+    }
+
+    // The items sorted by their keys and, for the same keys, positions.
+    wxVector<Entry> m_entries;
+
+    // The positions from m_entries, sorted in each block of items starting
+    // with the same character.
+    wxVector<size_t> m_blockPositions;
+
+    wxDECLARE_NO_COPY_CLASS(wxPrefixFindIndex);
+};
+
+#endif // _WX_GENERIC_PRIVATE_PREFIXFIND_H_
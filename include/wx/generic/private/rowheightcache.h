@@ -10,7 +10,6 @@
 #ifndef _WX_PRIVATE_ROWHEIGHTCACHE_H_
 #define _WX_PRIVATE_ROWHEIGHTCACHE_H_
 
-#include "wx/hashmap.h"
 #include "wx/vector.h"
 
 // struct describing a range of rows which contains rows <from> .. <to-1>
@@ -76,9 +75,6 @@ private:
     void CleanUp(unsigned int idx);
 };
 
-WX_DECLARE_HASH_MAP(unsigned int, RowRanges*, wxIntegerHash, wxIntegerEqual,
-    HeightToRowRangesMap);
-
 /**
     HeightCache implements a cache mechanism for wxDataViewCtrl.
 
@@ -87,51 +83,40 @@ WX_DECLARE_HASH_MAP(unsigned int, RowRanges*, wxIntegerHash, wxIntegerEqual,
     * the y-coordinate where a row starts (GetLineStart)
     * and vice versa (GetLineAt)
 
-    The layout of the cache is a hashmap where the keys are all existing row
-    heights in pixels. The values are RowRange objects that represent all rows
-    having the specified height.
+    The heights of the rows are stored in a vector indexed by the row, with
+    the rows whose height is unknown having negative height, and the same
+    heights, with the unknown ones counted as 0, are also stored in a binary
+    indexed (Fenwick) tree, in which each element stores the sum of the
+    heights of the rows in a range ending at the corresponding row.
+
+    This allows to find both the start of the given row, by summing the
+    elements of O(log N) ranges covering all the rows before it, and the row
+    at the given y-coordinate, by descending the tree, in logarithmic time.
 
-    An example:
+    An example for 8 rows of heights h0 .. h7:
     @code
-    {
-    22: RowRange([0..10], [15..17], [20..2000]),
-    42: RowRange([11..12], [18..18]),
-    62: RowRange([13..14], [19..19])
-    }
+    m_heights = [h0, h1,      h2, h3,            h4, h5,      h6, h7]
+    m_tree    = [h0, h0 + h1, h2, h0 + .. + h3,  h4, h4 + h5, h6, h0 + .. + h7]
     @endcode
 
-    Examples
-    ========
-
     GetLineStart
     ------------
-    To retrieve the y-coordinate of item 1000 it is necessary to look into
-    each key of the hashmap *m_heightToRowRange*. Get the row count of
-    indices lower than 1000 (RowRange::CountTo) and multiplies it which the
-    according height.
-
-    RowRange([0..10], [15..17], [20..2000]).CountTo(1000)
-    --> 0..10 are 11 items, 15..17 are 3 items and 20..1000 are 980 items (1000-20)
-    = 11 + 3 + 980 = 994 items
-
-    GetLineStart(1000) --> (22 * 994) + (42 * 3) + (62 * 3) = 22180
-
-    GetLineHeight
-    -------------
-    To retrieve the line height look into each key and check if row is
-    contained in RowRange (RowRange::Has)
+    To retrieve the y-coordinate of row 7 the ranges ending at rows 6, 5 and 3
+    are summed: h6 + (h4 + h5) + (h0 + .. + h3).
 
     GetLineAt
     ---------
-    To retrieve the row that starts at a specific y-coordinate.
-    Look into each key and count all rows.
-    Use bisect algorithm in combination with GetLineStart() to
-    find the appropriate item
+    To retrieve the row containing the given y-coordinate, the tree is
+    descended from the largest range starting at row 0, skipping all the
+    ranges ending before it.
+
+    Invalidating the heights of all the rows starting from the given one,
+    which must be done when rows are inserted or deleted, just truncates the
+    vectors as the elements of the tree never depend on the following rows.
 */
 class WXDLLIMPEXP_CORE HeightCache
 {
 public:
-    ~HeightCache();
     bool GetLineStart(unsigned int row, int& start);
     bool GetLineHeight(unsigned int row, int& height);
     bool GetLineAt(int y, unsigned int& row);
@@ -148,7 +133,14 @@ public:
     void Clear();
 
 private:
-    HeightToRowRangesMap m_heightToRowRange;
+    // Return the sum of the heights of all rows before the given one.
+    int GetSumBefore(unsigned int row) const;
+
+    // The heights of all the rows, negative if not known.
+    wxVector<int> m_heights;
+
+    // Fenwick tree of the known heights, see the class description.
+    wxVector<int> m_tree;
 };
 
 
@@ -26,10 +26,19 @@ public:
     // column of which calculate the width
     explicit wxMaxWidthCalculatorBase(size_t column)
         : m_column(column),
-          m_width(0)
+          m_width(0),
+          m_maxRows(0)
     {
     }
 
+    // Limit the number of the first and last rows checked in addition to the
+    // visible ones: this is useful for virtual controls, for which retrieving
+    // the row values may be much slower than measuring them.
+    void LimitRowsToCheck(size_t maxRows = DEFAULT_MAX_ROWS_TO_CHECK)
+    {
+        m_maxRows = maxRows;
+    }
+
     void UpdateWithWidth(int width)
     {
         m_width = wxMax(m_width, width);
@@ -68,6 +77,9 @@ public:
         size_t top_part_end = wxMin(500, count);
 #endif // wxUSE_STOPWATCH/!wxUSE_STOPWATCH
 
+        if ( m_maxRows && top_part_end > m_maxRows / 2 )
+            top_part_end = m_maxRows / 2;
+
         size_t row = 0;
 
         for ( row = 0; row < top_part_end; row++ )
@@ -112,9 +124,14 @@ public:
     }
 
 private:
+    enum { DEFAULT_MAX_ROWS_TO_CHECK = 200 };
+
     const size_t m_column;
     int m_width;
 
+    // the maximal number of rows to check or 0 if not limited
+    size_t m_maxRows;
+
     wxDECLARE_NO_COPY_CLASS(wxMaxWidthCalculatorBase);
 };
 
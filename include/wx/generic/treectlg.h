@@ -27,6 +27,7 @@ class WXDLLIMPEXP_FWD_CORE wxTreeItemData;
 
 class WXDLLIMPEXP_FWD_CORE wxTreeRenameTimer;
 class WXDLLIMPEXP_FWD_CORE wxTreeFindTimer;
+class wxTreeFindIndex;
 class WXDLLIMPEXP_FWD_CORE wxTreeTextCtrl;
 class WXDLLIMPEXP_FWD_CORE wxTextCtrl;
 
@@ -192,6 +193,16 @@ public:
 
     wxTreeItemId GetNext(const wxTreeItemId& item) const;
 
+    // delete the children of the items when they are collapsed, they must be
+    // added again from wxEVT_TREE_ITEM_EXPANDING handler
+    void EnableOnDemandChildren(bool enable = true) { m_childrenOnDemand = enable; }
+    bool HasOnDemandChildren() const { return m_childrenOnDemand; }
+
+    // use an index of the item labels to speed up the incremental search in
+    // big controls, at the price of using more memory
+    void EnableFindIndex(bool enable = true);
+    bool HasFindIndex() const { return m_findIndex != NULL; }
+
     // implementation only from now on
 
     // overridden base class virtuals
@@ -276,8 +287,15 @@ protected:
     // had already beeped for this particular search.
     int                  m_findBell;
 
+    // the index used by FindItem() if enabled, it is built when it's needed
+    // and cleared whenever the items change
+    wxTreeFindIndex     *m_findIndex;
+
     bool                 m_dropEffectAboveItem;
 
+    // true if the children are deleted when their parent is collapsed
+    bool                 m_childrenOnDemand;
+
     // the common part of all ctors
     void Init();
 
@@ -287,6 +305,9 @@ protected:
     // misc helpers
     void SendDeleteEvent(wxGenericTreeItem *itemBeingDeleted);
 
+    // must be called whenever the items or their labels change
+    void InvalidateFindIndex();
+
     void DrawBorder(const wxTreeItemId& item);
     void DrawLine(const wxTreeItemId& item, bool below);
     void DrawDropEffect(wxGenericTreeItem *item);
@@ -327,6 +348,11 @@ protected:
     void CalculateLevel( wxGenericTreeItem *item, wxDC &dc, int level, int &y );
     void CalculatePositions();
 
+    // update the positions of the given item subtree and of all the items
+    // after it after expanding or collapsing it, which is faster than
+    // CalculatePositions() as the items before it don't change
+    void CalculateSubtreePositions(wxGenericTreeItem *item);
+
     void RefreshSubtree( wxGenericTreeItem *item );
     void RefreshLine( wxGenericTreeItem *item );
 
@@ -53,6 +53,7 @@ public:
 #if wxUSE_STREAMS
     virtual bool SaveFile( wxImage *image, wxOutputStream& stream, bool verbose=true ) wxOVERRIDE;
     virtual bool LoadFile( wxImage *image, wxInputStream& stream, bool verbose=true, int index=-1 ) wxOVERRIDE;
+    virtual bool LoadRows( wxImageRowConsumer& consumer, wxInputStream& stream, bool verbose=true, int index=-1 ) wxOVERRIDE;
 
 protected:
     virtual bool DoCanRead( wxInputStream& stream ) wxOVERRIDE;
@@ -87,6 +88,7 @@ public:
 #if wxUSE_STREAMS
     virtual bool SaveFile( wxImage *image, wxOutputStream& stream, bool verbose=true ) wxOVERRIDE;
     virtual bool LoadFile( wxImage *image, wxInputStream& stream, bool verbose=true, int index=-1 ) wxOVERRIDE;
+    virtual bool LoadRows( wxImageRowConsumer& consumer, wxInputStream& stream, bool verbose=true, int index=-1 ) wxOVERRIDE;
     virtual bool DoLoadFile( wxImage *image, wxInputStream& stream, bool verbose, int index );
 
 protected:
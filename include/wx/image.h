@@ -83,6 +83,19 @@ enum wxImageAlphaBlendMode
     wxIMAGE_ALPHA_BLEND_COMPOSE = 1
 };
 
+// Interleaved pixel formats which can be used with wxImage::GetInterleavedData()
+enum wxImagePixelFormat
+{
+    // R, G, B and A bytes for each pixel, alpha is not premultiplied (this is
+    // the format used by GdkPixbuf)
+    wxIMAGE_PIXEL_FORMAT_RGBA,
+
+    // native endian 32 bit ARGB values with premultiplied alpha, i.e. B, G, R
+    // and A bytes for each pixel on little endian machines (this is the format
+    // used by Cairo, Direct2D and GDI+ PARGB bitmaps)
+    wxIMAGE_PIXEL_FORMAT_BGRA_PREMULTIPLIED
+};
+
 // alpha channel values: fully transparent, default threshold separating
 // transparent pixels from opaque for a few functions dealing with alpha and
 // fully opaque
@@ -107,6 +120,36 @@ class WXDLLIMPEXP_FWD_CORE wxPalette;
 DECLARE_VARIANT_OBJECT_EXPORTED(wxImage,WXDLLIMPEXP_CORE)
 #endif
 
+//-----------------------------------------------------------------------------
+// wxImageRowConsumer
+//-----------------------------------------------------------------------------
+
+#if wxUSE_STREAMS
+
+// Receives the decoded image data from wxImageHandler::LoadRows() one row at a
+// time, allowing to process images without ever keeping all of them in memory.
+class WXDLLIMPEXP_CORE wxImageRowConsumer
+{
+public:
+    wxImageRowConsumer() { }
+    virtual ~wxImageRowConsumer() { }
+
+    // Called once before the first row, hasAlpha is true if the rows will come
+    // with alpha values. Return false to cancel loading.
+    virtual bool OnStart(int width, int height, bool hasAlpha) = 0;
+
+    // Called for each row, from top to bottom: rgb contains 3*width bytes and
+    // alpha either width bytes or is NULL if the image has no alpha. Both
+    // buffers are only valid during this call. Return false to cancel loading.
+    virtual bool OnRow(int y,
+                       const unsigned char* rgb,
+                       const unsigned char* alpha) = 0;
+
+    wxDECLARE_NO_COPY_CLASS(wxImageRowConsumer);
+};
+
+#endif // wxUSE_STREAMS
+
 //-----------------------------------------------------------------------------
 // wxImageHandler
 //-----------------------------------------------------------------------------
@@ -128,6 +171,11 @@ public:
                            bool WXUNUSED(verbose)=true )
         { return false; }
 
+    // decode the image passing its rows to the consumer as soon as they become
+    // available, the default implementation loads the entire image first
+    virtual bool LoadRows( wxImageRowConsumer& consumer, wxInputStream& stream,
+                           bool verbose=true, int index=-1 );
+
     int GetImageCount( wxInputStream& stream );
         // save the stream position, call DoGetImageCount() and restore the position
 
@@ -165,6 +213,11 @@ protected:
 
     // save the stream position, call DoCanRead() and restore the position
     bool CallDoCanRead(wxInputStream& stream);
+
+    // helper for the derived classes LoadRows() implementations: passes the
+    // rows of an already loaded image to the consumer, converting the mask, if
+    // any, to alpha
+    static bool SendImageRows(const wxImage& image, wxImageRowConsumer& consumer);
 #endif // wxUSE_STREAMS
 
     // helper for the derived classes SaveFile() implementations: returns the
@@ -374,6 +427,7 @@ public:
     wxImage Blur(int radius) const;
     wxImage BlurHorizontal(int radius) const;
     wxImage BlurVertical(int radius) const;
+    wxImage GaussianBlur(double sigma) const;
 
     wxImage ShrinkBy( int xFactor , int yFactor ) const ;
 
@@ -466,6 +520,12 @@ public:
     void SetLoadFlags(int flags);
     int GetLoadFlags() const;
 
+    // Maximal number of threads used by the image processing functions such
+    // as Scale(), Blur() or Rotate(): 1 (default) means that everything is
+    // done in the calling thread and 0 means to use as many threads as CPUs.
+    static void SetMaxThreads(int count);
+    static int GetMaxThreads();
+
     static bool CanRead( const wxString& name );
     static int GetImageCount( const wxString& name, wxBitmapType type = wxBITMAP_TYPE_ANY );
     virtual bool LoadFile( const wxString& name, wxBitmapType type = wxBITMAP_TYPE_ANY, int index = -1 );
@@ -476,6 +536,12 @@ public:
     static int GetImageCount( wxInputStream& stream, wxBitmapType type = wxBITMAP_TYPE_ANY );
     virtual bool LoadFile( wxInputStream& stream, wxBitmapType type = wxBITMAP_TYPE_ANY, int index = -1 );
     virtual bool LoadFile( wxInputStream& stream, const wxString& mimetype, int index = -1 );
+
+    // decode the image row by row without creating a wxImage for it
+    static bool LoadRows( wxImageRowConsumer& consumer, wxInputStream& stream,
+                          wxBitmapType type = wxBITMAP_TYPE_ANY, int index = -1 );
+    static bool LoadRows( wxImageRowConsumer& consumer, const wxString& name,
+                          wxBitmapType type = wxBITMAP_TYPE_ANY, int index = -1 );
 #endif
 
     virtual bool SaveFile( const wxString& name ) const;
@@ -515,6 +581,12 @@ public:
     void InitAlpha();
     void ClearAlpha();
 
+    // store the image pixels in the given interleaved format in the buffer
+    // of at least stride*height bytes, stride == 0 means 4*width
+    bool GetInterleavedData(wxImagePixelFormat format,
+                            unsigned char *buffer,
+                            int stride = 0) const;
+
     // return true if this pixel is masked or has alpha less than specified
     // threshold
     bool IsTransparent(int x, int y,
@@ -0,0 +1,158 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/imageloader.h
+// Purpose:     wxImageLoader class for loading images in background threads
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_IMAGELOADER_H_
+#define _WX_IMAGELOADER_H_
+
+#include "wx/defs.h"
+
+#if wxUSE_IMAGE && wxUSE_THREADS && wxUSE_STREAMS
+
+#include "wx/event.h"
+#include "wx/image.h"
+#include "wx/thread.h"
+#include "wx/vector.h"
+
+class WXDLLIMPEXP_FWD_BASE wxThreadPool;
+
+class wxImageLoaderTask;
+
+// ----------------------------------------------------------------------------
+// wxImageLoadedEvent: sent by wxImageLoader when an image is loaded
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_CORE wxImageLoadedEvent : public wxEvent
+{
+public:
+    wxImageLoadedEvent(wxEventType type = wxEVT_NULL,
+                       int id = wxID_ANY,
+                       int requestId = 0,
+                       const wxString& filename = wxString())
+        : wxEvent(id, type),
+          m_requestId(requestId),
+          m_filename(filename)
+    {
+    }
+
+    // the value returned by wxImageLoader::Load() for this image
+    int GetRequestId() const { return m_requestId; }
+
+    const wxString& GetFileName() const { return m_filename; }
+
+    // the loaded image, invalid if loading it failed
+    const wxImage& GetImage() const { return m_image; }
+    bool IsOk() const { return m_image.IsOk(); }
+
+    void SetImage(const wxImage& image) { m_image = image; }
+
+    virtual wxEvent *Clone() const wxOVERRIDE
+        { return new wxImageLoadedEvent(*this); }
+
+private:
+    int m_requestId;
+    wxString m_filename;
+    wxImage m_image;
+
+    wxDECLARE_DYNAMIC_CLASS_NO_ASSIGN(wxImageLoadedEvent);
+};
+
+wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_CORE, wxEVT_IMAGE_LOADED, wxImageLoadedEvent);
+
+typedef void (wxEvtHandler::*wxImageLoadedEventFunction)(wxImageLoadedEvent&);
+
+#define wxImageLoadedEventHandler(func) \
+    wxEVENT_HANDLER_CAST(wxImageLoadedEventFunction, func)
+
+#define EVT_IMAGE_LOADED(id, func) \
+    wx__DECLARE_EVT1(wxEVT_IMAGE_LOADED, id, wxImageLoadedEventHandler(func))
+
+// ----------------------------------------------------------------------------
+// wxImageLoader: loads images using a pool of background threads
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_CORE wxImageLoader
+{
+public:
+    // the events are sent to the given handler which must outlive this object,
+    // numThreads == 0 means to use as many threads as there are CPUs
+    explicit wxImageLoader(wxEvtHandler* handler, int numThreads = 0);
+
+    // cancels all the pending requests and waits for the running ones
+    ~wxImageLoader();
+
+    // queue loading the image from the given file: the images with higher
+    // priority are loaded first and those with the same priority in the order
+    // of the calls to this function
+    //
+    // returns the id of the request, which is always positive, or 0 on error
+    int Load(const wxString& filename,
+             int priority = 0,
+             wxBitmapType type = wxBITMAP_TYPE_ANY,
+             int index = -1);
+
+    // change the priority of the request if it's still pending
+    bool SetPriority(int requestId, int priority);
+
+    // cancel the given request or all of them: no events are sent for the
+    // cancelled requests, even if they are already being loaded
+    bool Cancel(int requestId);
+    void CancelAll();
+
+    // return the number of requests which have not been started yet
+    size_t GetPendingCount() const;
+
+    // set the id used for the events sent by this loader (wxID_ANY by default)
+    void SetId(int id) { m_id = id; }
+    int GetId() const { return m_id; }
+
+private:
+    struct Request
+    {
+        int id;
+        int priority;
+        wxString filename;
+        wxBitmapType type;
+        int index;
+    };
+
+    // called from the pool threads, OnRequestDone() resets the image
+    bool GetNextRequest(Request& req);
+    void OnRequestDone(int requestId, wxImage& image,
+                       const wxString& filename);
+    friend class wxImageLoaderTask;
+
+    // insert the request at the position corresponding to its priority
+    void DoQueue(const Request& req);
+
+    wxEvtHandler* const m_handler;
+    int m_id;
+
+    // the pool running one task per Load() call, each of them loading the
+    // request with the highest priority at the moment when it runs
+    wxThreadPool* const m_pool;
+
+    // protects all the fields below
+    mutable wxMutex m_mutex;
+
+    // the pending requests sorted in the increasing order of their priority,
+    // so that the next one to run is always at the end
+    wxVector<Request> m_pending;
+
+    // the ids of the requests currently being loaded and whether they were
+    // cancelled
+    wxVector<int> m_running;
+    wxVector<bool> m_runningCancelled;
+
+    int m_lastRequestId;
+
+    wxDECLARE_NO_COPY_CLASS(wxImageLoader);
+};
+
+#endif // wxUSE_IMAGE && wxUSE_THREADS && wxUSE_STREAMS
+
+#endif // _WX_IMAGELOADER_H_
@@ -18,6 +18,7 @@
 
 #if wxUSE_THREADS
 
+#include "wx/atomic.h"
 #include "wx/stopwatch.h"
 
 #include "wx/beforestd.h"
@@ -28,7 +29,8 @@ enum wxMessageQueueError
 {
     wxMSGQUEUE_NO_ERROR = 0, // operation completed successfully
     wxMSGQUEUE_TIMEOUT,      // no messages received before timeout expired
-    wxMSGQUEUE_MISC_ERROR    // some unexpected (and fatal) error has occurred
+    wxMSGQUEUE_MISC_ERROR,   // some unexpected (and fatal) error has occurred
+    wxMSGQUEUE_FULL          // the queue is full and the message wasn't posted
 };
 
 // ---------------------------------------------------------------------------
@@ -41,6 +43,10 @@ enum wxMessageQueueError
 // typically there must be some special message indicating that the thread
 // should terminate as there is no other way to gracefully shutdown a thread
 // waiting on the message queue.
+//
+// The queue may be bounded, in which case Post() blocks while the queue is
+// full, providing back pressure to the producers when they are faster than
+// the consumers.
 // ---------------------------------------------------------------------------
 template <typename T>
 class wxMessageQueue
@@ -49,24 +55,96 @@ public:
     // The type of the messages transported by this queue
     typedef T Message;
 
-    // Default ctor creates an initially empty queue
-    wxMessageQueue()
-       : m_conditionNotEmpty(m_mutex)
+    // Default number of iterations to spin for before sleeping on condition.
+    enum { DEFAULT_SPIN_COUNT = 1000 };
+
+    // Default ctor creates an initially empty queue, without any limit on the
+    // number of messages in it by default.
+    explicit wxMessageQueue(size_t capacity = 0)
+       : m_conditionNotEmpty(m_mutex),
+         m_conditionNotFull(m_mutex),
+         m_capacity(capacity),
+         m_count(0),
+         m_waitingReceivers(0),
+         m_waitingPosters(0)
     {
+        // Spinning only makes sense if the other thread can run in parallel.
+        m_spinCount = wxThread::GetCPUCount() > 1 ? DEFAULT_SPIN_COUNT : 0;
     }
 
     // Add a message to this queue and signal the threads waiting for messages.
     //
+    // If the queue is bounded and full, wait until a message is removed from
+    // it before adding this one.
+    //
     // This method is safe to call from multiple threads in parallel.
     wxMessageQueueError Post(const Message& msg)
     {
+        SpinWhile(true);
+
         wxMutexLocker locker(m_mutex);
 
         wxCHECK( locker.IsOk(), wxMSGQUEUE_MISC_ERROR );
 
-        m_messages.push(msg);
+        while ( IsFull() )
+        {
+            const wxCondError result = WaitNotFull();
+
+            wxCHECK( result == wxCOND_NO_ERROR, wxMSGQUEUE_MISC_ERROR );
+        }
+
+        DoPush(msg);
+
+        NotifyReceivers(1);
+
+        return wxMSGQUEUE_NO_ERROR;
+    }
+
+    // Same as Post() but never blocks and returns wxMSGQUEUE_FULL if the
+    // queue is full instead.
+    wxMessageQueueError TryPost(const Message& msg)
+    {
+        wxMutexLocker locker(m_mutex);
+
+        wxCHECK( locker.IsOk(), wxMSGQUEUE_MISC_ERROR );
+
+        if ( IsFull() )
+            return wxMSGQUEUE_FULL;
+
+        DoPush(msg);
+
+        NotifyReceivers(1);
+
+        return wxMSGQUEUE_NO_ERROR;
+    }
+
+    // Add all messages in the given range to the queue, locking it only once
+    // if there is enough space for all of them.
+    //
+    // If the queue is bounded, this method blocks until all the messages are
+    // added to it, adding them in batches as the space becomes available.
+    template <typename Iterator>
+    wxMessageQueueError PostMany(Iterator first, Iterator last)
+    {
+        wxMutexLocker locker(m_mutex);
 
-        m_conditionNotEmpty.Signal();
+        wxCHECK( locker.IsOk(), wxMSGQUEUE_MISC_ERROR );
+
+        while ( first != last )
+        {
+            while ( IsFull() )
+            {
+                const wxCondError result = WaitNotFull();
+
+                wxCHECK( result == wxCOND_NO_ERROR, wxMSGQUEUE_MISC_ERROR );
+            }
+
+            size_t count = 0;
+            for ( ; first != last && !IsFull(); ++first, ++count )
+                DoPush(*first);
+
+            NotifyReceivers(count);
+        }
 
         return wxMSGQUEUE_NO_ERROR;
     }
@@ -81,9 +159,16 @@ public:
 
         wxMutexLocker locker(m_mutex);
 
+        const size_t count = m_messages.size();
+
         std::queue<T> empty;
         std::swap(m_messages, empty);
 
+        for ( size_t n = 0; n < count; n++ )
+            wxAtomicDec(m_count);
+
+        NotifyPosters(count);
+
         return wxMSGQUEUE_NO_ERROR;
     }
 
@@ -94,6 +179,8 @@ public:
     {
         wxCHECK( IsOk(), wxMSGQUEUE_MISC_ERROR );
 
+        SpinWhile(false);
+
         wxMutexLocker locker(m_mutex);
 
         wxCHECK( locker.IsOk(), wxMSGQUEUE_MISC_ERROR );
@@ -101,7 +188,9 @@ public:
         const wxMilliClock_t waitUntil = wxGetLocalTimeMillis() + timeout;
         while ( m_messages.empty() )
         {
+            m_waitingReceivers++;
             wxCondError result = m_conditionNotEmpty.WaitTimeout(timeout);
+            m_waitingReceivers--;
 
             if ( result == wxCOND_NO_ERROR )
                 continue;
@@ -117,8 +206,9 @@ public:
             wxASSERT(timeout > 0);
         }
 
-        msg = m_messages.front();
-        m_messages.pop();
+        DoPop(msg);
+
+        NotifyPosters(1);
 
         return wxMSGQUEUE_NO_ERROR;
     }
@@ -129,27 +219,77 @@ public:
     {
         wxCHECK( IsOk(), wxMSGQUEUE_MISC_ERROR );
 
+        SpinWhile(false);
+
         wxMutexLocker locker(m_mutex);
 
         wxCHECK( locker.IsOk(), wxMSGQUEUE_MISC_ERROR );
 
         while ( m_messages.empty() )
         {
-            wxCondError result = m_conditionNotEmpty.Wait();
+            const wxCondError result = WaitNotEmpty();
 
             wxCHECK( result == wxCOND_NO_ERROR, wxMSGQUEUE_MISC_ERROR );
         }
 
-        msg = m_messages.front();
-        m_messages.pop();
+        DoPop(msg);
+
+        NotifyPosters(1);
 
         return wxMSGQUEUE_NO_ERROR;
     }
 
+    // Wait until at least one message becomes available and append all the
+    // available messages, but not more than maxCount of them unless it is 0,
+    // to the provided vector, locking the queue only once.
+    template <typename Container>
+    wxMessageQueueError ReceiveMany(Container& msgs, size_t maxCount = 0)
+    {
+        wxCHECK( IsOk(), wxMSGQUEUE_MISC_ERROR );
+
+        SpinWhile(false);
+
+        wxMutexLocker locker(m_mutex);
+
+        wxCHECK( locker.IsOk(), wxMSGQUEUE_MISC_ERROR );
+
+        while ( m_messages.empty() )
+        {
+            const wxCondError result = WaitNotEmpty();
+
+            wxCHECK( result == wxCOND_NO_ERROR, wxMSGQUEUE_MISC_ERROR );
+        }
+
+        size_t count = m_messages.size();
+        if ( maxCount && count > maxCount )
+            count = maxCount;
+
+        T msg;
+        for ( size_t n = 0; n < count; n++ )
+        {
+            DoPop(msg);
+            msgs.push_back(msg);
+        }
+
+        NotifyPosters(count);
+
+        return wxMSGQUEUE_NO_ERROR;
+    }
+
+    // Return the maximal number of messages in the queue or 0 if unbounded.
+    size_t GetCapacity() const { return m_capacity; }
+
+    // Set the number of iterations to busy wait for before blocking when the
+    // queue is empty (or full), 0 disables spinning.
+    //
+    // This method is not thread-safe and must be called before the queue is
+    // used by the other threads.
+    void SetSpinCount(unsigned spinCount) { m_spinCount = spinCount; }
+
     // Return false only if there was a fatal error in ctor
     bool IsOk() const
     {
-        return m_conditionNotEmpty.IsOk();
+        return m_conditionNotEmpty.IsOk() && m_conditionNotFull.IsOk();
     }
 
 private:
@@ -157,10 +297,107 @@ private:
     wxMessageQueue(const wxMessageQueue<T>& rhs);
     wxMessageQueue<T>& operator=(const wxMessageQueue<T>& rhs);
 
+    // All the functions below must be called with m_mutex locked, except for
+    // SpinWhile().
+
+    bool IsFull() const
+    {
+        return m_capacity && m_messages.size() >= m_capacity;
+    }
+
+    void DoPush(const T& msg)
+    {
+        m_messages.push(msg);
+        wxAtomicInc(m_count);
+    }
+
+    void DoPop(T& msg)
+    {
+        msg = m_messages.front();
+        m_messages.pop();
+        wxAtomicDec(m_count);
+    }
+
+    wxCondError WaitNotEmpty()
+    {
+        m_waitingReceivers++;
+        const wxCondError result = m_conditionNotEmpty.Wait();
+        m_waitingReceivers--;
+
+        return result;
+    }
+
+    wxCondError WaitNotFull()
+    {
+        m_waitingPosters++;
+        const wxCondError result = m_conditionNotFull.Wait();
+        m_waitingPosters--;
+
+        return result;
+    }
+
+    // Wake up the threads waiting for the given number of messages added to
+    // or removed from the queue, if there are any.
+    void NotifyReceivers(size_t count)
+    {
+        if ( !m_waitingReceivers || !count )
+            return;
+
+        if ( count == 1 )
+            m_conditionNotEmpty.Signal();
+        else
+            m_conditionNotEmpty.Broadcast();
+    }
+
+    void NotifyPosters(size_t count)
+    {
+        if ( !m_waitingPosters || !count )
+            return;
+
+        if ( count == 1 )
+            m_conditionNotFull.Signal();
+        else
+            m_conditionNotFull.Broadcast();
+    }
+
+    // Busy wait, without locking the mutex, while the queue remains full or
+    // empty: as waking up a thread sleeping on a condition is expensive, this
+    // is faster if the other thread is going to change the queue soon.
+    //
+    // Note that this is just an optimization and the queue state still needs
+    // to be checked after locking the mutex.
+    void SpinWhile(bool full) const
+    {
+        if ( full && !m_capacity )
+            return;
+
+        for ( unsigned n = 0; n < m_spinCount; n++ )
+        {
+            const size_t count = static_cast<size_t>(wxAtomicGet(m_count));
+            if ( full ? count < m_capacity : count > 0 )
+                break;
+        }
+    }
+
     mutable wxMutex m_mutex;
     wxCondition     m_conditionNotEmpty;
+    wxCondition     m_conditionNotFull;
 
     std::queue<T>   m_messages;
+
+    // The maximal number of messages or 0 if unbounded.
+    const size_t    m_capacity;
+
+    // The same as m_messages.size() but can be read without locking the
+    // mutex: it is only modified with the mutex locked, but always atomically.
+    mutable wxAtomicInt m_count;
+
+    // The number of threads sleeping on the conditions above, they don't
+    // need to be signalled if there are none.
+    unsigned        m_waitingReceivers;
+    unsigned        m_waitingPosters;
+
+    unsigned        m_spinCount;
 };
 
 #endif // wxUSE_THREADS
@@ -18,7 +18,7 @@ class WXDLLIMPEXP_FWD_CORE wxWindow;
 // wxTextMeasure: class used to measure text extent.
 // ----------------------------------------------------------------------------
 
-class wxTextMeasureBase
+class WXDLLIMPEXP_CORE wxTextMeasureBase
 {
 public:
     // The first ctor argument must be non-NULL, i.e. each object of this class
@@ -65,6 +65,19 @@ public:
     // This is another method which is only used by MeasuringGuard.
     bool IsUsingDCImpl() const { return m_useDCImpl; }
 
+
+    // The extents of the strings measured for the windows (and the DCs for
+    // which it's safe to do it) are kept in a global LRU cache shared by all
+    // objects of this class. This function must be called if the extents of
+    // the same strings in the same fonts can change, e.g. because the screen
+    // resolution changed.
+    static void ClearCache();
+
+    // Return the number of the cache lookups which found the string extent in
+    // the cache and those that didn't, e.g. for benchmarking. Any pointer can
+    // be NULL.
+    static void GetCacheStats(size_t *hits, size_t *misses);
+
 protected:
     // RAII wrapper for the two methods above.
     class MeasuringGuard
@@ -128,6 +141,21 @@ protected:
                            wxCoord *descent = NULL,
                            wxCoord *externalLeading = NULL);
 
+    // Return true and fill in the output parameters if the extent of this
+    // string is already in the cache. The width and height must be non-NULL.
+    bool GetCachedTextExtent(const wxString& string,
+                             wxCoord *width,
+                             wxCoord *height,
+                             wxCoord *descent,
+                             wxCoord *externalLeading);
+
+    // Call DoGetTextExtent() and store its result in the cache if possible.
+    void DoGetAndCacheTextExtent(const wxString& string,
+                                 wxCoord *width,
+                                 wxCoord *height,
+                                 wxCoord *descent,
+                                 wxCoord *externalLeading);
+
     // Get line height: used when the line is empty because CallGetTextExtent()
     // would just return (0, 0) in this case.
     int GetEmptyLineHeight();
@@ -152,6 +180,12 @@ protected:
     // implementation of text measuring itself.
     bool m_useDCImpl;
 
+    // If this is true, the results of DoGetTextExtent() are cached. This is
+    // only the case when measuring text for a window by default, as the
+    // extents may depend on the DC, but the derived classes can set it for
+    // the DCs for which the extents only depend on the font.
+    bool m_useCache;
+
     // This one can be NULL or not.
     const wxFont* const m_font;
 
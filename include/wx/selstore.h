@@ -12,6 +12,7 @@
 #define _WX_SELSTORE_H_
 
 #include "wx/dynarray.h"
+#include "wx/vector.h"
 
 // ----------------------------------------------------------------------------
 // wxSelectedIndices is just a sorted array of indices
@@ -29,23 +30,24 @@ WX_DEFINE_SORTED_EXPORTED_ARRAY_CMP_INT(unsigned, wxUIntCmp, wxSelectedIndices);
 // controls, i.e. it is well suited for storing even when the control contains
 // a huge (practically infinite) number of items.
 //
-// Of course, internally it still has to store the selected items somehow (as
-// an array currently) but the advantage is that it can handle the selection
-// of all items (common operation) efficiently and that it could be made even
-// smarter in the future (e.g. store the selections as an array of ranges +
-// individual items) without changing its API.
+// Internally it stores the ranges of items whose state differs from the
+// default one, which is normally "not selected" but can be "selected" if the
+// most of the items are selected. This allows to handle the selection of all
+// items (common operation) efficiently, as well as selecting or deselecting
+// big ranges of items, and to iterate over the selected items quickly.
 // ----------------------------------------------------------------------------
 
 class WXDLLIMPEXP_CORE wxSelectionStore
 {
 public:
-    wxSelectionStore() : m_itemsSel(wxUIntCmp) { Init(); }
+    wxSelectionStore() : m_root(NULL), m_seed(0x2545f491) { Init(); }
+    ~wxSelectionStore() { DeleteTree(m_root); }
 
     // set the total number of items we handle
     void SetItemCount(unsigned count);
 
     // special case of SetItemCount(0)
-    void Clear() { m_itemsSel.Clear(); m_count = 0; m_defaultState = false; }
+    void Clear() { DeleteTree(m_root); m_root = NULL; Init(); }
 
     // must be called when new items are inserted/added
     void OnItemsInserted(unsigned item, unsigned numItems);
@@ -78,15 +80,15 @@ public:
     // return true if no items are currently selected
     bool IsEmpty() const
     {
-        return m_defaultState ? m_itemsSel.size() == m_count
-                              : m_itemsSel.empty();
+        return m_defaultState ? m_numExceptions == m_count
+                              : m_numExceptions == 0;
     }
 
     // return the total number of selected items
     unsigned GetSelectedCount() const
     {
-        return m_defaultState ? m_count - m_itemsSel.GetCount()
-                              : m_itemsSel.GetCount();
+        return m_defaultState ? m_count - m_numExceptions
+                              : m_numExceptions;
     }
 
     // type of a "cookie" used to preserve the iteration state, this is an
@@ -103,8 +105,63 @@ public:
     unsigned GetNextSelectedItem(IterationState& cookie) const;
 
 private:
+    // range of items from "from" to "to" (exclusive)
+    struct Range
+    {
+        Range(unsigned from_ = 0, unsigned to_ = 0) : from(from_), to(to_) { }
+
+        unsigned from;
+        unsigned to;
+    };
+
+    typedef wxVector<Range> Ranges;
+
+    // node of the tree of ranges, see its definition in selstore.cpp
+    struct Node;
+
     // (re)init
-    void Init() { m_count = 0; m_defaultState = false; }
+    void Init() { m_count = 0; m_defaultState = false; m_numExceptions = 0; }
+
+    // find the first range ending after the given item and return true or
+    // return false if there is none
+    bool FindRange(unsigned item, Range& range) const;
+
+    // return the end of the last range or 0 if there are no ranges
+    unsigned GetRangesEnd() const;
+
+    // functions for working with the tree of ranges
+    Node* NewNode(const Range& range);
+    static void DeleteTree(Node* node);
+    static void AddShift(Node* node, unsigned shift);
+    static void PushShift(Node* node);
+
+    // split the tree into the ranges whose end (if byEnd is true) or start
+    // is less than the given item and all the other ones
+    static void Split(Node* node, unsigned item, bool byEnd,
+                      Node*& left, Node*& right);
+
+    // merge two trees, all ranges of the left one must precede the right ones
+    static Node* Merge(Node* left, Node* right);
+
+    // append the ranges of the given tree to the array in order and delete it
+    static void ExtractRanges(Node* node, Ranges& ranges);
+
+    // create a tree containing the given sorted ranges
+    Node* MakeTree(const Ranges& ranges);
+
+    // make all items in [from, to) range exceptions to the default state if
+    // add is true or make them have the default state otherwise
+    //
+    // returns the number of items which changed state and adds them to the
+    // itemsChanged array if it's non-NULL, unless there are too many of them,
+    // in which case itemsChanged is reset to NULL
+    unsigned SetExceptions(unsigned from, unsigned to, bool add,
+                           wxArrayInt*& itemsChanged);
+
+    // append the ranges of items in [from, to) interval which are not in any
+    // of the given ranges to the complement array
+    void AppendComplement(const Ranges& ranges, unsigned from, unsigned to,
+                          Ranges& complement);
 
     // the total number of items we handle
     unsigned m_count;
@@ -114,11 +171,23 @@ private:
     // handle selection of all items efficiently
     bool m_defaultState;
 
-    // the array of items whose selection state is different from default
-    wxSelectedIndices m_itemsSel;
+    // the ranges of items whose selection state is different from default,
+    // the ranges never overlap nor are adjacent
+    //
+    // they are stored in a treap, i.e. a binary search tree balanced using
+    // random node priorities, so that finding, adding and removing them takes
+    // logarithmic time; and as inserting or deleting items shifts all the
+    // following ranges, each node also stores the shift to apply to its
+    // subtrees lazily, which makes doing it logarithmic too
+    Node* m_root;
+
+    // the state of the random number generator used for node priorities
+    unsigned m_seed;
+
+    // the total number of items in all ranges
+    unsigned m_numExceptions;
 
     wxDECLARE_NO_COPY_CLASS(wxSelectionStore);
 };
 
 #endif // _WX_SELSTORE_H_
-
@@ -0,0 +1,141 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/threadpool.h
+// Purpose:     wxThreadPool class executing tasks in a pool of threads
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_THREADPOOL_H_
+#define _WX_THREADPOOL_H_
+
+#include "wx/defs.h"
+
+#if wxUSE_THREADS
+
+class WXDLLIMPEXP_FWD_BASE wxEvtHandler;
+
+class wxThreadPoolImpl;
+class wxThreadPoolTaskState;
+
+// ----------------------------------------------------------------------------
+// wxThreadPoolTask: base class for the tasks executed by wxThreadPool
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_BASE wxThreadPoolTask
+{
+public:
+    wxThreadPoolTask() { }
+    virtual ~wxThreadPoolTask() { }
+
+    // called in one of the pool threads to perform the task, the task can
+    // submit other tasks to the same pool from here
+    virtual void Run() = 0;
+
+    // called in the main thread after Run() returns if an event handler was
+    // specified when submitting the task, does nothing by default
+    virtual void OnDone() { }
+
+private:
+    wxDECLARE_NO_COPY_CLASS(wxThreadPoolTask);
+};
+
+// ----------------------------------------------------------------------------
+// wxThreadPoolFuture: allows to wait for a task completion or cancel it
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_BASE wxThreadPoolFuture
+{
+public:
+    // default ctor creates an invalid object
+    wxThreadPoolFuture() : m_state(NULL) { }
+
+    wxThreadPoolFuture(const wxThreadPoolFuture& other);
+    wxThreadPoolFuture& operator=(const wxThreadPoolFuture& other);
+    ~wxThreadPoolFuture();
+
+    bool IsOk() const { return m_state != NULL; }
+
+    // return true if the task has finished running or was cancelled
+    bool IsDone() const;
+    bool IsCancelled() const;
+
+    // wait until the task finishes running or is cancelled, return true if it
+    // did run
+    //
+    // if this is called from one of the pool threads, other tasks are
+    // executed by this thread while waiting
+    bool Wait();
+
+    // cancel the task if it hasn't started running yet, return true if it
+    // was cancelled, the tasks submitted to run after it are cancelled too
+    bool Cancel();
+
+    // get the task associated with this future, it remains valid as long as
+    // any future object referencing it exists and can be used to retrieve the
+    // results of the task once IsDone() returns true
+    wxThreadPoolTask* GetTask() const;
+
+private:
+    explicit wxThreadPoolFuture(wxThreadPoolTaskState* state)
+        : m_state(state)
+    {
+    }
+
+    wxThreadPoolTaskState* m_state;
+
+    friend class wxThreadPool;
+};
+
+// ----------------------------------------------------------------------------
+// wxThreadPool: executes the submitted tasks in a pool of threads
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_BASE wxThreadPool
+{
+public:
+    // numThreads == 0 means to use as many threads as there are CPUs
+    explicit wxThreadPool(int numThreads = 0);
+
+    // cancels all the pending tasks and waits for the running ones
+    ~wxThreadPool();
+
+    // return the number of threads in the pool, 0 if they couldn't be created
+    int GetThreadCount() const;
+
+    // submit the task to be executed by one of the pool threads, the pool
+    // takes ownership of the task
+    //
+    // if the handler is specified, the task OnDone() method is called via
+    // CallAfter() on it after the task has run, so it must outlive the task
+    //
+    // the tasks submitted from the main thread are started in the order of
+    // their submission while the tasks submitted from a pool thread are added
+    // to the own queue of this thread and the last of them is started first
+    wxThreadPoolFuture Submit(wxThreadPoolTask* task,
+                              wxEvtHandler* handler = NULL);
+
+    // submit the task to be executed after the given one finishes running, if
+    // it is cancelled this task is cancelled as well
+    wxThreadPoolFuture SubmitAfter(const wxThreadPoolFuture& previous,
+                                   wxThreadPoolTask* task,
+                                   wxEvtHandler* handler = NULL);
+
+    // cancel all the tasks which haven't started running yet
+    void CancelAll();
+
+    // wait until all the submitted tasks have run or were cancelled
+    void WaitAll();
+
+    // return the number of tasks which haven't started running yet
+    size_t GetPendingCount() const;
+
+private:
+    wxThreadPoolImpl* const m_impl;
+
+    wxDECLARE_NO_COPY_CLASS(wxThreadPool);
+};
+
+#endif // wxUSE_THREADS
+
+#endif // _WX_THREADPOOL_H_
@@ -38,5 +38,36 @@ void wxAtomicInc(wxAtomicInt& value);
 */
 wxInt32 wxAtomicDec(wxAtomicInt& value);
 
+/**
+    Atomically replaces the value with @a newValue if it is equal to
+    @a oldValue.
+
+    Returns @true if the value was replaced or @false if it was different from
+    @a oldValue and was left unchanged. This function also acts as a full
+    memory barrier.
+
+    Unlike wxAtomicInc() and wxAtomicDec(), this function is only available if
+    wxHAS_ATOMIC_OPS is defined, i.e. if there is a native implementation of
+    atomic operations for the current platform. Another overload of this
+    function works in the same way with pointers of any type.
+
+    @header{wx/atomic.h}
+
+    @since 3.1.5
+*/
+bool wxAtomicCompareAndSwap(wxAtomicInt& value, wxInt32 oldValue, wxInt32 newValue);
+
+/**
+    Returns the current value in an atomic manner.
+
+    This function can be used to read a value modified by the other atomic
+    functions in another thread and also acts as a full memory barrier.
+
+    @header{wx/atomic.h}
+
+    @since 3.1.5
+*/
+wxInt32 wxAtomicGet(wxAtomicInt& value);
+
 //@}
 
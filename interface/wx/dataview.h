@@ -110,6 +110,53 @@ public:
     */
     void AddNotifier(wxDataViewModelNotifier* notifier);
 
+    /**
+        Start a batch of changes to the model.
+
+        Call this function before notifying the control about many changes
+        using ItemAdded(), ItemDeleted(), ItemChanged(), ValueChanged() or
+        their plural versions and call EndBatch() after doing it. This allows
+        the control to postpone updating its display and, in the generic
+        implementation, moving the changed items to their sorted position, so
+        that this is done only once for all the changes.
+
+        The generic implementation also postpones inserting the added items
+        until the batch ends or the control is notified about a change of
+        another kind, so that all the consecutively added children of the same
+        parent are inserted at once. Until then, the control doesn't know
+        about these items and they can't be e.g. selected or expanded.
+
+        The calls to BeginBatch() and EndBatch() can be nested and must be
+        balanced, the batch ends with the outermost EndBatch() call.
+
+        Notice that the functions notifying about multiple items, such as
+        ItemsAdded(), already batch the notifications about individual items.
+
+        @see GetBatchCount()
+
+        @since 3.1.5
+    */
+    void BeginBatch();
+
+    /**
+        End a batch of changes started with BeginBatch().
+
+        The control is updated to reflect all the changes when the outermost
+        batch ends.
+
+        @since 3.1.5
+    */
+    void EndBatch();
+
+    /**
+        Return the nesting level of BeginBatch() calls.
+
+        This is 0 if no batch is in progress.
+
+        @since 3.1.5
+    */
+    int GetBatchCount() const;
+
     /**
         Change the value of the given item and update the control to reflect
         it.
@@ -1053,6 +1100,27 @@ public:
     */
     bool AllowMultiColumnSort(bool allow);
 
+    /**
+        Enable or disable updating the best column widths incrementally.
+
+        The widths of the columns using ::wxCOL_WIDTH_AUTOSIZE are normally
+        recomputed whenever the items are changed or deleted, which can be
+        slow for big controls. When this mode is enabled, only the changed
+        items are measured and the columns become wider if necessary, but they
+        never become narrower, even if the widest items are deleted. Turning
+        this mode off recomputes the widths from scratch.
+
+        Notice that the widths are always updated incrementally when new items
+        are added, independently of this mode.
+
+        @return @true if the mode was changed or @false if it's not supported
+            by this implementation (currently only the generic version
+            supports it).
+
+        @since 3.1.5
+    */
+    virtual bool EnableIncrementalColumnWidths(bool enable = true);
+
     /**
         Create the control. Useful for two step creation.
     */
@@ -1374,6 +1442,35 @@ public:
     */
     virtual void EditItem(const wxDataViewItem& item, const wxDataViewColumn *column);
 
+    /**
+        Sort the children of big branches in a background thread.
+
+        When the control is sorted by a column, the children of the items
+        having at least @a minChildren of them are sorted in a background
+        thread, keeping the user interface responsive even for the items with
+        a very big number of children, which are shown in their previous order
+        until the sorting is done. The values of the sort column are
+        retrieved from the model in the main thread before starting sorting.
+
+        As the model is not used by the background thread, the values are
+        compared in the same way as the default wxDataViewModel::Compare()
+        does, so this function should not be used with the models overriding
+        it. Only the values of string, numeric, boolean, date and
+        wxDataViewIconText types can be compared, for the other ones the
+        children are still sorted synchronously.
+
+        This method is only available in the generic version of the control,
+        i.e. when @c wxHAS_GENERIC_DATAVIEWCTRL is defined, and only has any
+        effect if @c wxUSE_THREADS is 1.
+
+        @param minChildren The minimal number of children to sort in the
+            background, or 0 to disable background sorting, which is the
+            default.
+
+        @since 3.1.5
+    */
+    void EnableBackgroundSorting(unsigned minChildren = 10000);
+
     /**
        Enable drag operations using the given @a format.
     */
@@ -1780,11 +1877,35 @@ public:
     */
     virtual ~wxDataViewModelNotifier();
 
+    /**
+        Called by owning model when a batch of changes starts.
+
+        The default implementation does nothing, but it can be overridden to
+        postpone updating the view until EndBatch() is called. Notice that
+        the default implementations of ItemsAdded(), ItemsChanged() and
+        ItemsDeleted() call this function as well, so the calls to it may be
+        nested.
+
+        @see wxDataViewModel::BeginBatch()
+
+        @since 3.1.5
+    */
+    virtual void BeginBatch();
+
     /**
         Called by owning model.
     */
     virtual bool Cleared() = 0;
 
+    /**
+        Called by owning model when a batch of changes ends.
+
+        The default implementation does nothing.
+
+        @since 3.1.5
+    */
+    virtual void EndBatch();
+
     /**
         Get owning wxDataViewModel.
     */
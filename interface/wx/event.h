@@ -695,6 +695,48 @@ public:
     */
     void DeletePendingEvents();
 
+    /**
+        Enables or disables coalescing of the queued events of the given type.
+
+        When coalescing is enabled for an event type, queuing an event of this
+        type using QueueEvent() or AddPendingEvent() replaces the event of the
+        same type and with the same id queued before it, if this event hasn't
+        been processed yet. The new event takes the place of the old one in the
+        queue, i.e. it's processed before any other events queued after the old
+        one.
+
+        This is useful for the events which are superseded by the subsequent
+        events of the same kind, e.g. progress notifications sent by a worker
+        thread: only the latest of them is processed, no matter how many of
+        them were sent since the last time the pending events were processed.
+
+        Note that all the events sent by CallAfter() have the same type and
+        id, so enabling coalescing for @c wxEVT_ASYNC_METHOD_CALL would result
+        in only the last of the calls made since the pending events were
+        processed being executed.
+
+        This function can be called from any thread.
+
+        @param eventType
+            The type of the events to coalesce.
+        @param enable
+            If @false, disables coalescing of the events of this type, which is
+            the default for all event types.
+
+        @since 3.1.5
+    */
+    void EnableEventsCoalescing(wxEventType eventType, bool enable = true);
+
+    /**
+        Returns @true if coalescing of the queued events of the given type is
+        enabled.
+
+        @see EnableEventsCoalescing()
+
+        @since 3.1.5
+    */
+    bool IsEventsCoalescingEnabled(wxEventType eventType) const;
+
     //@}
 
 
@@ -1715,9 +1715,12 @@ public:
         Get the attribute to use for the specified cell.
 
         If wxGridCellAttr::Any is used as @a kind value, this function combines
-        the attributes set for this cell using SetAttr() and those for its row
+        the attributes set for this cell using SetAttr(), those for all the
+        blocks containing it (set with SetBlockAttr()) and those for its row
         or column (set with SetRowAttr() or SetColAttr() respectively), with
-        the cell attribute having the highest precedence.
+        the cell attribute having the highest precedence, followed by the
+        block attributes, starting with the most recently set one, and then
+        the column and row attributes.
 
         Notice that the caller must call DecRef() on the returned pointer if it
         is non-@NULL. GetAttrPtr() method can be used to do this automatically.
@@ -1765,6 +1768,29 @@ public:
     /// Set attribute for the specified column.
     virtual void SetColAttr(wxGridCellAttr *attr, int col);
 
+    /**
+        Set attribute for all cells of the specified block.
+
+        Unlike calling SetAttr() for all cells of the block, this function
+        only stores a single attribute, whatever the size of the block, making
+        it appropriate for styling big ranges of cells, e.g. a column
+        subrange spanning thousands of rows. The blocks may overlap and the
+        attribute set for the block last has priority over the attributes of
+        the other blocks. Calling this function again for exactly the same
+        block replaces its attribute, or removes it if @a attr is @NULL.
+
+        The default implementation defers updating its internal index until
+        the attributes are retrieved using GetAttr(), so setting the
+        attributes for many blocks at once is efficient. With N blocks, the
+        index uses O(N log N) memory and finding the K blocks containing the
+        given cell takes O((log N)^2 + K log N) time, so only the cells
+        covered by many overlapping blocks remain expensive.
+
+        @since 3.1.5
+     */
+    virtual void SetBlockAttr(wxGridCellAttr *attr,
+                              const wxGridBlockCoords& block);
+
     //@}
 
     /**
@@ -1881,6 +1907,70 @@ public:
 };
 
 
+/**
+    Base class for the grid tables storing their values in memory.
+
+    This class stores the custom row, column and corner labels and implements
+    inserting, appending and deleting rows and columns, including updating
+    the labels and notifying the grid about the changes, in terms of the
+    pure virtual DoInsertRows(), DoDeleteRows(), DoInsertCols() and
+    DoDeleteCols() functions which only need to update the storage of the
+    values.
+
+    @since 3.1.5
+
+    @library{wxcore}
+    @category{grid}
+ */
+class wxGridMemoryTableBase : public wxGridTableBase
+{
+public:
+    bool InsertRows( size_t pos = 0, size_t numRows = 1 );
+    bool AppendRows( size_t numRows = 1 );
+    bool DeleteRows( size_t pos = 0, size_t numRows = 1 );
+    bool InsertCols( size_t pos = 0, size_t numCols = 1 );
+    bool AppendCols( size_t numCols = 1 );
+    bool DeleteCols( size_t pos = 0, size_t numCols = 1 );
+
+    void SetRowLabelValue( int row, const wxString& );
+    void SetColLabelValue( int col, const wxString& );
+    void SetCornerLabelValue( const wxString& );
+    wxString GetRowLabelValue( int row );
+    wxString GetColLabelValue( int col );
+    wxString GetCornerLabelValue() const;
+
+protected:
+    /**
+        Inserts the given number of rows at the given position.
+
+        @a pos is always valid and is equal to the current number of rows when
+        the rows are appended.
+     */
+    virtual void DoInsertRows( size_t pos, size_t numRows ) = 0;
+
+    /**
+        Deletes the given number of rows starting at the given position.
+
+        The rows to delete are always valid.
+     */
+    virtual void DoDeleteRows( size_t pos, size_t numRows ) = 0;
+
+    /**
+        Inserts the given number of columns at the given position.
+
+        @a pos is always valid and is equal to the current number of columns
+        when the columns are appended.
+     */
+    virtual void DoInsertCols( size_t pos, size_t numCols ) = 0;
+
+    /**
+        Deletes the given number of columns starting at the given position.
+
+        The columns to delete are always valid.
+     */
+    virtual void DoDeleteCols( size_t pos, size_t numCols ) = 0;
+};
+
 /**
     Simplest type of data table for a grid for small tables of strings that are
     stored in memory.
@@ -1888,7 +1978,7 @@ public:
     The number of rows and columns in the table can be specified initially but
     may also be changed later dynamically.
  */
-class wxGridStringTable
+class wxGridStringTable : public wxGridMemoryTableBase
 {
 public:
     /**
@@ -1907,19 +1997,96 @@ public:
     virtual void SetValue( int row, int col, const wxString& s );
 
     void Clear();
-    bool InsertRows( size_t pos = 0, size_t numRows = 1 );
-    bool AppendRows( size_t numRows = 1 );
-    bool DeleteRows( size_t pos = 0, size_t numRows = 1 );
-    bool InsertCols( size_t pos = 0, size_t numCols = 1 );
-    bool AppendCols( size_t numCols = 1 );
-    bool DeleteCols( size_t pos = 0, size_t numCols = 1 );
+};
 
-    void SetRowLabelValue( int row, const wxString& );
-    void SetColLabelValue( int col, const wxString& );
-    void SetCornerLabelValue( const wxString& );
-    wxString GetRowLabelValue( int row );
-    wxString GetColLabelValue( int col );
-    wxString GetCornerLabelValue() const;
+/**
+    Grid table storing the values of each column using the representation
+    corresponding to the type of this column.
+
+    Unlike wxGridStringTable, which stores all values as strings, this class
+    stores the values of the columns of wxGRID_VALUE_NUMBER, wxGRID_VALUE_FLOAT
+    and wxGRID_VALUE_BOOL types as @c long, @c double and @c bool values
+    respectively. This uses much less memory for big numeric tables and
+    allows GetValueAsLong(), GetValueAsDouble() and GetValueAsBool(), which
+    are used by the standard renderers and editors for these types, to return
+    the values directly without parsing them. The values of
+    wxGRID_VALUE_CHOICE columns are stored as indices into the list of all the
+    distinct strings used in the column, which is efficient when there are
+    only a few of them. All the other columns store strings.
+
+    The type of each column is returned by GetTypeName(), so the grid uses the
+    renderers and editors registered for it with wxGrid::RegisterDataType()
+    automatically. The type can be changed using SetColType() and is
+    wxGRID_VALUE_STRING for the columns added by InsertCols() and
+    AppendCols().
+
+    Example of creating a table with numeric columns:
+    @code
+    wxGridTypedTable* table = new wxGridTypedTable(1000000, 3, wxGRID_VALUE_FLOAT);
+    table->SetColType(0, wxGRID_VALUE_NUMBER);
+    table->SetColType(2, "double:8,2");
+    grid->AssignTable(table);
+    @endcode
+
+    @since 3.1.5
+
+    @library{wxcore}
+    @category{grid}
+ */
+class wxGridTypedTable : public wxGridMemoryTableBase
+{
+public:
+    /**
+        Default constructor creates an empty table.
+     */
+    wxGridTypedTable();
+
+    /**
+        Constructor taking the number of rows and columns and the type of all
+        the columns.
+     */
+    wxGridTypedTable( int numRows, int numCols,
+                      const wxString& typeName = wxGRID_VALUE_STRING );
+
+    /**
+        Changes the type of the given column.
+
+        The existing values of the column are converted to the new type.
+
+        @param col
+            Valid column index.
+        @param typeName
+            The name of the type, e.g. wxGRID_VALUE_NUMBER, possibly followed
+            by a colon and the parameters of the renderer and editor used for
+            this type, e.g. @c "double:6,2".
+     */
+    void SetColType( int col, const wxString& typeName );
+
+    /**
+        Returns the type of the given column, as set by SetColType() or
+        specified when creating the table.
+     */
+    wxString GetColType( int col ) const;
+
+    virtual int GetNumberRows();
+    virtual int GetNumberCols();
+    virtual wxString GetValue( int row, int col );
+    virtual void SetValue( int row, int col, const wxString& s );
+
+    virtual bool IsEmptyCell( int row, int col );
+
+    virtual wxString GetTypeName( int row, int col );
+    virtual bool CanGetValueAs( int row, int col, const wxString& typeName );
+
+    virtual long GetValueAsLong( int row, int col );
+    virtual double GetValueAsDouble( int row, int col );
+    virtual bool GetValueAsBool( int row, int col );
+
+    virtual void SetValueAsLong( int row, int col, long value );
+    virtual void SetValueAsDouble( int row, int col, double value );
+    virtual void SetValueAsBool( int row, int col, bool value );
+
+    void Clear();
 };
 
 /**
@@ -2683,6 +2850,19 @@ public:
      */
     virtual void SetColAttr(wxGridCellAttr *attr, int col);
 
+    /**
+        Set attribute of all cells of the specified block.
+
+        By default this function is simply forwarded to
+        wxGridCellAttrProvider::SetBlockAttr().
+
+        The table takes ownership of @a attr, i.e. will call DecRef() on it.
+
+        @since 3.1.5
+     */
+    virtual void SetBlockAttr(wxGridCellAttr *attr,
+                              const wxGridBlockCoords& block);
+
     //@}
 
     /**
@@ -5763,6 +5943,19 @@ public:
     */
     void SetAttr(int row, int col, wxGridCellAttr *attr);
 
+    /**
+        Sets the cell attributes for all cells in the specified block.
+
+        The grid takes ownership of the attribute pointer.
+
+        This is much more efficient than setting the attribute for each cell
+        of a big block individually. See
+        wxGridCellAttrProvider::SetBlockAttr() for more details.
+
+        @since 3.1.5
+    */
+    void SetBlockAttr(const wxGridBlockCoords& block, wxGridCellAttr *attr);
+
     /**
         Sets the cell attributes for all cells in the specified column.
 
@@ -75,6 +75,31 @@ enum wxImageAlphaBlendMode
     wxIMAGE_ALPHA_BLEND_COMPOSE = 1
 };
 
+/**
+    Interleaved pixel formats supported by wxImage::GetInterleavedData().
+
+    @since 3.1.5
+*/
+enum wxImagePixelFormat
+{
+    /**
+        Four bytes per pixel: red, green, blue and alpha, with the alpha not
+        premultiplied.
+
+        This is the format used by @c GdkPixbuf.
+    */
+    wxIMAGE_PIXEL_FORMAT_RGBA,
+
+    /**
+        32 bit ARGB values in native byte order with premultiplied alpha.
+
+        On little endian machines, this means that the bytes are blue, green,
+        red and alpha. This is the format used by Cairo, Direct2D and GDI+
+        bitmaps with premultiplied alpha.
+    */
+    wxIMAGE_PIXEL_FORMAT_BGRA_PREMULTIPLIED
+};
+
 /**
     Possible values for PNG image type option.
 
@@ -142,6 +167,66 @@ enum
 };
 
 
+/**
+    @class wxImageRowConsumer
+
+    Abstract base class for objects receiving the image data decoded by
+    wxImage::LoadRows() or wxImageHandler::LoadRows().
+
+    The image is passed to the consumer one row at a time, which allows
+    processing it, e.g. creating a thumbnail for it or converting it to a
+    different format, without having to keep the entire decoded image in
+    memory.
+
+    @library{wxcore}
+    @category{gdi}
+
+    @since 3.1.5
+*/
+class wxImageRowConsumer
+{
+public:
+    /// Default constructor.
+    wxImageRowConsumer();
+
+    /// Trivial but virtual destructor.
+    virtual ~wxImageRowConsumer();
+
+    /**
+        Called once before any rows are passed to OnRow().
+
+        @param width
+            Width of the image, i.e. the number of pixels in each row.
+        @param height
+            Height of the image, i.e. the number of rows.
+        @param hasAlpha
+            @true if OnRow() will be called with non-@NULL alpha values. Note
+            that the rows can still turn out to be completely opaque.
+        @return @true to continue loading or @false to cancel it.
+    */
+    virtual bool OnStart(int width, int height, bool hasAlpha) = 0;
+
+    /**
+        Called for each row of the image, from top to bottom.
+
+        @param y
+            Index of the row.
+        @param rgb
+            Pointer to the @c 3*width bytes of RGB data of this row.
+        @param alpha
+            Pointer to the @c width alpha values of this row or @NULL if the
+            image has no alpha.
+        @return @true to continue loading or @false to cancel it.
+
+        The data is only valid during this call and must be copied if it is
+        needed later.
+    */
+    virtual bool OnRow(int y,
+                       const unsigned char* rgb,
+                       const unsigned char* alpha) = 0;
+};
+
+
 /**
     @class wxImageHandler
 
@@ -283,6 +368,37 @@ public:
     virtual bool LoadFile(wxImage* image, wxInputStream& stream,
                           bool verbose = true, int index = -1);
 
+    /**
+        Loads an image from a stream, passing its rows to the given consumer.
+
+        The BMP, JPEG, PNG and TIFF handlers decode the image progressively
+        and pass each row to the consumer as soon as it is available, without
+        keeping the entire image in memory, at least for the most common
+        variants of these formats. The default implementation of this function
+        used by the other handlers simply calls LoadFile() and then passes the
+        rows of the loaded image to the consumer, converting its mask to the
+        alpha channel if necessary.
+
+        @param consumer
+            The object receiving the image data.
+        @param stream
+            Opened input stream for reading image data.
+        @param verbose
+            If set to @true, errors reported by the image handler will produce
+            wxLogMessages.
+        @param index
+            The index of the image in the file (starting from zero).
+
+        @return @true if the operation succeeded, @false if an error occurred
+            or if loading was cancelled by the consumer.
+
+        @see wxImage::LoadRows()
+
+        @since 3.1.5
+    */
+    virtual bool LoadRows(wxImageRowConsumer& consumer, wxInputStream& stream,
+                          bool verbose = true, int index = -1);
+
     /**
         Saves an image in the output stream.
 
@@ -810,6 +926,28 @@ public:
     */
     wxImage BlurVertical(int blurRadius) const;
 
+    /**
+        Blurs the image using an approximation of the Gaussian blur.
+
+        The Gaussian blur is approximated by applying the box blur, as done by
+        BlurHorizontal() and BlurVertical(), three times in each direction,
+        with the box sizes chosen to match the given standard deviation. As
+        with the other blur functions, the time taken by this function
+        doesn't depend on the blur size.
+
+        This should not be used when using a single mask colour for
+        transparency.
+
+        @param sigma
+            The standard deviation of the Gaussian distribution, in pixels.
+            Must be non-negative.
+
+        @see Blur()
+
+        @since 3.1.5
+    */
+    wxImage GaussianBlur(double sigma) const;
+
     /**
         Returns a mirrored copy of the image.
         The parameter @a horizontally indicates the orientation.
@@ -1514,6 +1652,48 @@ public:
     virtual bool LoadFile(wxInputStream& stream, const wxString& mimetype,
                           int index = -1);
 
+    /**
+        Decodes an image from an input stream row by row.
+
+        This function doesn't create a wxImage but passes the rows of the
+        image to the provided @a consumer as they are decoded, see
+        wxImageRowConsumer and wxImageHandler::LoadRows(). This is useful for
+        processing big images using only a small amount of memory.
+
+        Unlike LoadFile(), this function doesn't use any image options, such
+        as ::wxIMAGE_OPTION_MAX_WIDTH. The default load flags, see
+        SetDefaultLoadFlags(), determine whether the errors are logged.
+
+        @param consumer
+            The object receiving the image data.
+        @param stream
+            Opened input stream from which to load the image. It must be
+            seekable if @a type is ::wxBITMAP_TYPE_ANY.
+        @param type
+            The type of the image or ::wxBITMAP_TYPE_ANY to determine it
+            automatically.
+        @param index
+            See the description in the LoadFile(wxInputStream&, wxBitmapType, int) overload.
+
+        @return @true if the image was decoded successfully, @false if an
+            error occurred or the consumer cancelled loading.
+
+        @since 3.1.5
+    */
+    static bool LoadRows(wxImageRowConsumer& consumer, wxInputStream& stream,
+                         wxBitmapType type = wxBITMAP_TYPE_ANY, int index = -1);
+
+    /**
+        Decodes an image from a file row by row.
+
+        This is the same as LoadRows(wxImageRowConsumer&, wxInputStream&, wxBitmapType, int)
+        but reads the image from the file with the given name.
+
+        @since 3.1.5
+    */
+    static bool LoadRows(wxImageRowConsumer& consumer, const wxString& name,
+                         wxBitmapType type = wxBITMAP_TYPE_ANY, int index = -1);
+
     /**
         Saves an image in the given stream.
 
@@ -1636,6 +1816,38 @@ public:
     */
     void ClearAlpha();
 
+    /**
+        Stores the image pixels in the given interleaved format.
+
+        wxImage stores the RGB data and the alpha channel separately, see
+        GetData() and GetAlpha(), while the native bitmaps typically use a
+        single buffer with 4 bytes per pixel. This function converts the image
+        pixels to the given format, with the alpha of all pixels being opaque
+        if the image doesn't have alpha channel (notice that the mask is not
+        taken into account), and stores them in the provided buffer.
+
+        As the buffer can be the one used by a native bitmap, this allows to
+        create it from the image without any intermediate copies. The
+        conversion uses multiple threads if allowed by SetMaxThreads().
+
+        @param format
+            The format to use for the pixels.
+        @param buffer
+            The buffer of at least @c stride*height bytes, must be non-@NULL.
+        @param stride
+            The distance between the starts of two consecutive rows in the
+            buffer, in bytes, which must be at least @c 4*width. The default
+            value of 0 means to use exactly @c 4*width.
+
+        @return @true if the data was stored or @false if the image is invalid
+            or the parameters are incorrect.
+
+        @since 3.1.5
+    */
+    bool GetInterleavedData(wxImagePixelFormat format,
+                            unsigned char* buffer,
+                            int stride = 0) const;
+
     /**
         Sets the image data without performing checks.
 
@@ -1699,6 +1911,30 @@ public:
      */
     void SetLoadFlags(int flags);
 
+    /**
+        Sets the maximal number of threads used for image processing.
+
+        By default, all image processing is done in the calling thread.
+        Calling this function with a value greater than 1 allows the functions
+        working with the entire image, such as Scale(), Rescale(), Blur(),
+        BlurHorizontal(), BlurVertical(), GaussianBlur(), Rotate(),
+        ConvertToGreyscale() and RotateHue(), to split the image in bands of rows and to process them
+        in parallel using up to the given number of threads, including the
+        calling one. The special value 0 means to use as many threads as
+        there are CPUs in the system, see wxThread::GetCPUCount().
+
+        Note that additional threads are only used for images big enough for
+        doing it to be worthwhile and that the results are exactly the same
+        as when not using them.
+
+        This function only has effect if wxUSE_THREADS is 1.
+
+        @see GetMaxThreads()
+
+        @since 3.1.5
+     */
+    static void SetMaxThreads(int count);
+
     /**
         Specifies whether there is a mask or not.
 
@@ -1955,6 +2191,15 @@ public:
      */
     static int GetDefaultLoadFlags();
 
+    /**
+        Returns the maximal number of threads used for image processing.
+
+        See SetMaxThreads() for more information.
+
+        @since 3.1.5
+     */
+    static int GetMaxThreads();
+
     //@{
     /**
         If the image file contains more than one image and the image handler is
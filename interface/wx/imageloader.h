@@ -0,0 +1,211 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        imageloader.h
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+    @class wxImageLoadedEvent
+
+    Event sent by wxImageLoader when loading an image requested by calling
+    wxImageLoader::Load() finishes, whether successfully or not.
+
+    @beginEventEmissionTable{wxImageLoadedEvent}
+    @event{EVT_IMAGE_LOADED(id, func)}
+        Process a @c wxEVT_IMAGE_LOADED event.
+    @endEventTable
+
+    @since 3.1.5
+
+    @library{wxcore}
+    @category{events,gdi}
+
+    @see wxImageLoader
+*/
+class wxImageLoadedEvent : public wxEvent
+{
+public:
+    /**
+        Constructor is only used by wxImageLoader itself.
+    */
+    wxImageLoadedEvent(wxEventType type = wxEVT_NULL,
+                       int id = wxID_ANY,
+                       int requestId = 0,
+                       const wxString& filename = wxString());
+
+    /**
+        Returns the identifier of the request, i.e.\ the value returned by
+        wxImageLoader::Load() when it was queued.
+    */
+    int GetRequestId() const;
+
+    /**
+        Returns the name of the file from which the image was loaded.
+    */
+    const wxString& GetFileName() const;
+
+    /**
+        Returns the loaded image.
+
+        The image is invalid if loading it failed.
+    */
+    const wxImage& GetImage() const;
+
+    /**
+        Returns @true if the image was loaded successfully.
+    */
+    bool IsOk() const;
+
+    /**
+        Sets the image carried by this event.
+    */
+    void SetImage(const wxImage& image);
+};
+
+wxEventType wxEVT_IMAGE_LOADED;
+
+/**
+    @class wxImageLoader
+
+    Loads images from files in a pool of background threads.
+
+    This class allows to load many images, e.g.\ thumbnails shown in a
+    directory browser, without blocking the user interface. Each call to
+    Load() queues a request and returns immediately, and when the image is
+    loaded, a wxImageLoadedEvent is sent to the handler specified when
+    creating the loader. The event carries the loaded image, which can be
+    converted to wxBitmap or used in any other way in the main thread.
+
+    Pending requests are processed in the order of their priority, which can
+    be changed using SetPriority() as long as loading the image hasn't started
+    yet, e.g.\ to give precedence to the images which became visible on the
+    screen. Requests with the same priority are processed in the order in
+    which they were made.
+
+    Requests which are not needed any longer can be cancelled using Cancel()
+    or CancelAll(). No events are sent for the cancelled requests, even if
+    loading the image had already started when they were cancelled.
+
+    Example of using this class:
+    @code
+    class MyFrame : public wxFrame
+    {
+    public:
+        MyFrame() : m_loader(this)
+        {
+            Bind(wxEVT_IMAGE_LOADED, &MyFrame::OnImageLoaded, this);
+
+            m_loader.Load("big.jpg");
+        }
+
+    private:
+        void OnImageLoaded(wxImageLoadedEvent& event)
+        {
+            if ( event.IsOk() )
+                m_bitmap = wxBitmap(event.GetImage());
+            else
+                wxLogError("Failed to load \"%s\".", event.GetFileName());
+        }
+
+        wxImageLoader m_loader;
+        wxBitmap m_bitmap;
+    };
+    @endcode
+
+    The images are loaded by the tasks executed by the internal wxThreadPool
+    owned by the loader.
+
+    Note that all the image handlers used for loading the images must be
+    added, e.g.\ by calling wxInitAllImageHandlers(), before the first call to
+    Load() and not modified while any images are being loaded.
+
+    This class is only available if @c wxUSE_THREADS is 1.
+
+    @since 3.1.5
+
+    @library{wxcore}
+    @category{gdi}
+
+    @see wxImage, wxImageLoadedEvent, wxThreadPool
+*/
+class wxImageLoader
+{
+public:
+    /**
+        Creates the loader and starts the threads of its pool.
+
+        @param handler
+            The object to which wxImageLoadedEvent are sent, must be non-@NULL
+            and outlive this object.
+        @param numThreads
+            The number of threads to use, by default as many as the number of
+            CPUs in the system.
+    */
+    explicit wxImageLoader(wxEvtHandler* handler, int numThreads = 0);
+
+    /**
+        Destructor cancels all the requests and waits until the images
+        currently being loaded, if any, are done.
+    */
+    ~wxImageLoader();
+
+    /**
+        Queues loading the image from the given file.
+
+        @param filename
+            Name of the file to load the image from.
+        @param priority
+            The priority of this request: the requests with higher priority
+            are processed before those with lower one.
+        @param type
+            The type of the image, see wxImage::LoadFile().
+        @param index
+            The index of the image in the file, see wxImage::LoadFile().
+        @return
+            Positive identifier of the request, which is also returned by
+            wxImageLoadedEvent::GetRequestId(), or 0 on error.
+    */
+    int Load(const wxString& filename,
+             int priority = 0,
+             wxBitmapType type = wxBITMAP_TYPE_ANY,
+             int index = -1);
+
+    /**
+        Changes the priority of the request.
+
+        @return @true if the priority was changed or @false if loading this
+            image has already started or the request doesn't exist.
+    */
+    bool SetPriority(int requestId, int priority);
+
+    /**
+        Cancels the given request.
+
+        @return @true if the request was cancelled or @false if it has
+            already completed or doesn't exist.
+    */
+    bool Cancel(int requestId);
+
+    /**
+        Cancels all the requests.
+    */
+    void CancelAll();
+
+    /**
+        Returns the number of requests for which loading hasn't started yet.
+    */
+    size_t GetPendingCount() const;
+
+    /**
+        Sets the id used for the events generated by this loader.
+
+        By default, it is @c wxID_ANY.
+    */
+    void SetId(int id);
+
+    /**
+        Returns the id used for the events generated by this loader.
+    */
+    int GetId() const;
+};
@@ -452,6 +452,38 @@ public:
     */
     void EnableBellOnNoMatch(bool on = true);
 
+    /**
+        Enable or disable the index used for searching the items from keyboard.
+
+        By default, searching for the next item starting with the entered
+        text checks the labels of all the items, which can take noticeable time
+        if there are many of them. When this option is enabled, the control
+        keeps an index of the item labels which allows to find the matching
+        item much faster, at the cost of using more memory. The index is built
+        when it's used for the first time and after any change to the items.
+
+        The index is not used for virtual list controls.
+
+        This function is only available in the generic version.
+
+        @see HasFindIndex()
+
+        @since 3.1.5
+    */
+    void EnableFindIndex(bool enable = true);
+
+    /**
+        Returns @true if the index for searching the items from keyboard is
+        used.
+
+        This function is only available in the generic version.
+
+        @see EnableFindIndex()
+
+        @since 3.1.5
+    */
+    bool HasFindIndex() const;
+
     /**
         Finish editing the label.
 
@@ -950,6 +982,32 @@ public:
     long InsertItem(long index, const wxString& label,
                     int imageIndex);
 
+    /**
+        Insert several items at once.
+
+        This is equivalent to calling InsertItem() for each of the labels, but
+        is much faster when inserting many items, as the memory for all of them
+        is allocated at once and the column width is only recomputed when it's
+        needed.
+
+        @param index
+            Index of the first new item, the items are inserted at the end if
+            it is greater than the number of items.
+        @param labels
+            The labels of the new items.
+        @param imageIndex
+            Index into the image list used for all the new items or -1.
+        @return
+            The index of the first inserted item or -1 if no items were
+            inserted.
+
+        This function is only available in the generic version.
+
+        @since 3.1.5
+    */
+    long InsertItems(long index, const wxArrayString& labels,
+                     int imageIndex = -1);
+
     /**
         Returns true if the control doesn't currently contain any items.
 
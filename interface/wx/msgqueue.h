@@ -26,7 +26,16 @@ enum wxMessageQueueError
     wxMSGQUEUE_TIMEOUT,
 
     /// Some unexpected (and fatal) error has occurred.
-    wxMSGQUEUE_MISC_ERROR
+    wxMSGQUEUE_MISC_ERROR,
+
+    /**
+        Indicates that the queue is full and the message couldn't be posted.
+
+        This return value is only used by wxMessageQueue<>::TryPost().
+
+        @since 3.1.5
+     */
+    wxMSGQUEUE_FULL
 };
 
 /**
@@ -43,6 +52,16 @@ enum wxMessageQueueError
     should terminate as there is no other way to gracefully shutdown a thread
     waiting on the message queue.
 
+    The queue can be bounded, i.e. limited to the given number of messages, in
+    which case Post() blocks when the queue is full until another thread
+    receives a message from it. This prevents the producer threads from
+    getting too far ahead of the consumers, which could result in using too
+    much memory otherwise.
+
+    When many messages are exchanged, using PostMany() and ReceiveMany() is
+    more efficient than posting and receiving them one by one, as the queue
+    is locked only once for the entire batch.
+
     @since 2.9.0
 
     @nolibrary
@@ -57,8 +76,13 @@ public:
     /**
         Default and only constructor.
         Use wxMessageQueue::IsOk to check if the object was successfully initialized.
+
+        @param capacity
+            The maximal number of messages in the queue or 0, which is the
+            default, for an unbounded queue. This parameter is new since
+            wxWidgets 3.1.5.
     */
-    wxMessageQueue();
+    explicit wxMessageQueue(size_t capacity = 0);
 
     /**
         Remove all messages from the queue.
@@ -77,15 +101,77 @@ public:
     */
     bool IsOk() const;
 
+    /**
+        Returns the maximal number of messages in the queue.
+
+        Returns 0 if the queue is unbounded.
+
+        @since 3.1.5
+     */
+    size_t GetCapacity() const;
+
+    /**
+        Sets the number of iterations to busy wait for before blocking.
+
+        When the queue is empty, Receive() and the other functions receiving
+        messages don't block immediately but first spin for a short time
+        checking whether a message became available, as this is cheaper than
+        putting the thread to sleep and waking it up if the other thread posts
+        a message soon. The same applies to Post() when a bounded queue is
+        full.
+
+        By default, a small number of iterations is used if the system has
+        more than one CPU and no spinning is done otherwise. Use this function
+        to change this, e.g. pass 0 to disable spinning completely.
+
+        Notice that, unlike all the other functions of this class, this one is
+        not thread-safe and must be called before the queue starts being used
+        by multiple threads.
+
+        @since 3.1.5
+     */
+    void SetSpinCount(unsigned spinCount);
+
     /**
         Add a message to this queue and signal the threads waiting for messages
         (i.e. the threads which called wxMessageQueue::Receive or
         wxMessageQueue::ReceiveTimeout).
 
+        If the queue is bounded and full, this method blocks until there is
+        space for the new message in it.
+
         This method is safe to call from multiple threads in parallel.
     */
     wxMessageQueueError Post(T const& msg);
 
+    /**
+        Add a message to this queue if it is not full.
+
+        This method is the same as Post() but never blocks and returns
+        @b wxMSGQUEUE_FULL if the queue is full.
+
+        @since 3.1.5
+    */
+    wxMessageQueueError TryPost(T const& msg);
+
+    /**
+        Add all messages in the given range to this queue.
+
+        The messages are added to the queue in order while locking it only
+        once, if the queue has enough space for all of them. Otherwise this
+        method blocks until all messages are added, posting them in parts as
+        the space in the queue becomes available.
+
+        @param first
+            Iterator pointing to the first message to post.
+        @param last
+            Iterator pointing one past the last message to post.
+
+        @since 3.1.5
+    */
+    template <typename Iterator>
+    wxMessageQueueError PostMany(Iterator first, Iterator last);
+
     /**
         Block until a message becomes available in the queue.
         Waits indefinitely long or until an error occurs.
@@ -107,5 +193,25 @@ public:
         The message is returned in @a msg.
     */
     wxMessageQueueError ReceiveTimeout(long timeout, T& msg);
+
+    /**
+        Block until at least one message becomes available and receive all of
+        them.
+
+        The messages are appended, in the order in which they were posted, to
+        @a msgs, which can be any container with a @c push_back() method, such
+        as wxVector<T>.
+
+        @param msgs
+            The container to append the messages to, its existing contents is
+            not modified.
+        @param maxCount
+            The maximal number of messages to receive or 0, which is the
+            default, to receive all the messages available in the queue.
+
+        @since 3.1.5
+    */
+    template <typename Container>
+    wxMessageQueueError ReceiveMany(Container& msgs, size_t maxCount = 0);
 };
 
@@ -0,0 +1,265 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        wx/threadpool.h
+// Purpose:     interface of wxThreadPool and related classes
+// Author:      wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+    Base class for the tasks executed by wxThreadPool.
+
+    Derive from this class and override its Run() method to perform the work
+    which needs to be done in background. The results of the task can be
+    stored in the members of the derived class and retrieved using
+    wxThreadPoolFuture::GetTask() once the task is done.
+
+    @since 3.1.5
+
+    @library{wxbase}
+    @category{threading}
+
+    @see wxThreadPool
+ */
+class wxThreadPoolTask
+{
+public:
+    /// Default constructor.
+    wxThreadPoolTask();
+
+    /// Virtual destructor for the base class.
+    virtual ~wxThreadPoolTask();
+
+    /**
+        Perform the task.
+
+        This method is called in one of the pool threads and so must not use
+        any GUI functions. It may submit more tasks to the same pool and wait
+        for them to finish, see wxThreadPoolFuture::Wait().
+
+        Notice that this function should not throw any exceptions: if it does,
+        they're caught by the pool and wxApp::OnUnhandledException() is called.
+     */
+    virtual void Run() = 0;
+
+    /**
+        Called in the main thread after Run() returns.
+
+        This method is only called if an event handler was specified when
+        submitting the task to the pool and is called via
+        wxEvtHandler::CallAfter() on this handler, i.e. during the next event
+        loop iteration after the task finishes running. It is not called if
+        the task was cancelled.
+
+        Default implementation does nothing.
+     */
+    virtual void OnDone();
+};
+
+/**
+    Object allowing to wait for a task submitted to wxThreadPool or to cancel
+    it.
+
+    Objects of this class are returned by wxThreadPool::Submit() and
+    wxThreadPool::SubmitAfter(). They are cheap to copy, as they only
+    reference the shared task state, and remain valid even after the pool
+    itself is destroyed.
+
+    @since 3.1.5
+
+    @library{wxbase}
+    @category{threading}
+ */
+class wxThreadPoolFuture
+{
+public:
+    /**
+        Default constructor creates an invalid object.
+
+        It can only be assigned another object to.
+     */
+    wxThreadPoolFuture();
+
+    /// Return @true if this object references a task.
+    bool IsOk() const;
+
+    /**
+        Return @true if the task has finished running or was cancelled.
+     */
+    bool IsDone() const;
+
+    /**
+        Return @true if the task was cancelled and will never run.
+     */
+    bool IsCancelled() const;
+
+    /**
+        Wait until the task finishes running or is cancelled.
+
+        If this function is called from one of the pool threads, e.g. from
+        another task wxThreadPoolTask::Run(), this thread executes the other
+        pending tasks while waiting instead of just blocking, so that waiting
+        for the sub-tasks submitted from a task can't deadlock the pool.
+
+        @return @true if the task did run or @false if it was cancelled.
+     */
+    bool Wait();
+
+    /**
+        Cancel the task if it hasn't started running yet.
+
+        Cancelling a task also cancels all the tasks submitted to run after
+        it using wxThreadPool::SubmitAfter().
+
+        @return @true if the task was cancelled or @false if it's already
+            running or done.
+     */
+    bool Cancel();
+
+    /**
+        Return the task associated with this object.
+
+        The task remains valid as long as any wxThreadPoolFuture referencing
+        it exists, so it can be used to retrieve the results of the task once
+        IsDone() returns @true.
+     */
+    wxThreadPoolTask* GetTask() const;
+};
+
+/**
+    Pool of threads executing the submitted tasks.
+
+    This class allows to perform many small tasks in background without
+    creating a thread for each of them. The tasks are objects of classes
+    deriving from wxThreadPoolTask and are run by a fixed number of worker
+    threads created when the pool is constructed.
+
+    Each worker thread has its own queue of tasks, which is used for the tasks
+    submitted from this thread (i.e. the sub-tasks of the tasks it runs), while
+    the tasks submitted from any other thread go into a shared queue. When a
+    worker runs out of its own tasks, it takes the task from the shared queue
+    or "steals" it from another worker queue. This allows to efficiently
+    execute divide-and-conquer algorithms in which the tasks submit other
+    tasks and wait for them.
+
+    Example of using this class:
+    @code
+    class ThumbnailTask : public wxThreadPoolTask
+    {
+    public:
+        ThumbnailTask(const wxString& path, wxWindow* win)
+            : m_path(path), m_win(win)
+        {
+        }
+
+        virtual void Run() wxOVERRIDE
+        {
+            // This is executed in a worker thread.
+            if ( m_image.LoadFile(m_path) )
+                m_image.Rescale(64, 64);
+        }
+
+        virtual void OnDone() wxOVERRIDE
+        {
+            // And this one in the main thread, so it's safe to use GUI here.
+            m_win->SetThumbnail(m_image);
+        }
+
+    private:
+        const wxString m_path;
+        wxWindow* const m_win;
+        wxImage m_image;
+    };
+
+    m_pool = new wxThreadPool;
+    for ( size_t n = 0; n < paths.size(); n++ )
+        m_pool->Submit(new ThumbnailTask(paths[n], this), this);
+    @endcode
+
+    @since 3.1.5
+
+    @library{wxbase}
+    @category{threading}
+
+    @see wxThread, wxImageLoader
+ */
+class wxThreadPool
+{
+public:
+    /**
+        Create the pool with the given number of threads.
+
+        @param numThreads
+            The number of the worker threads to create or 0 to use the
+            number of CPUs as returned by wxThread::GetCPUCount().
+     */
+    explicit wxThreadPool(int numThreads = 0);
+
+    /**
+        Destroy the pool.
+
+        All the tasks which haven't started running yet are cancelled and the
+        destructor waits until all the running tasks finish.
+     */
+    ~wxThreadPool();
+
+    /**
+        Return the number of threads in the pool.
+
+        This may be less than the number passed to the constructor, or even
+        0, if creating the threads failed. In the latter case the submitted
+        tasks are never run.
+     */
+    int GetThreadCount() const;
+
+    /**
+        Submit the task for execution by one of the pool threads.
+
+        The tasks submitted from the threads not belonging to the pool are
+        started in the order of their submission. The tasks submitted from
+        the pool threads, i.e. from the other tasks, are started in the
+        reverse order, as this is usually more efficient.
+
+        @param task
+            The task to execute, the pool takes ownership of it and deletes
+            it once the task is done and no wxThreadPoolFuture refers to it
+            any more. Must be non-@NULL.
+        @param handler
+            If non-@NULL, wxThreadPoolTask::OnDone() is called via
+            wxEvtHandler::CallAfter() on this handler after the task runs.
+            The handler must remain alive until then.
+        @return Object which can be used to wait for the task or cancel it.
+     */
+    wxThreadPoolFuture Submit(wxThreadPoolTask* task,
+                              wxEvtHandler* handler = NULL);
+
+    /**
+        Submit the task to run after another task finishes.
+
+        This is similar to Submit() but the task is only scheduled for
+        execution when the @a previous task finishes running. If the previous
+        task is cancelled, this task is cancelled as well. If the previous
+        task is already done, this is equivalent to Submit().
+     */
+    wxThreadPoolFuture SubmitAfter(const wxThreadPoolFuture& previous,
+                                   wxThreadPoolTask* task,
+                                   wxEvtHandler* handler = NULL);
+
+    /**
+        Cancel all the tasks which haven't started running yet.
+
+        The tasks which are already running are not affected.
+     */
+    void CancelAll();
+
+    /**
+        Wait until all the submitted tasks run or are cancelled.
+
+        This function must not be called from the pool threads.
+     */
+    void WaitAll();
+
+    /**
+        Return the number of tasks which haven't started running yet.
+     */
+    size_t GetPendingCount() const;
+};
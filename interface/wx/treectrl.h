@@ -358,6 +358,24 @@ public:
     */
     void EnableBellOnNoMatch(bool on = true);
 
+    /**
+        Enable or disable the index used for searching the items from keyboard.
+
+        By default, searching for the next item starting with the entered
+        text checks the labels of all the items, which can take noticeable time
+        if there are many of them. When this option is enabled, the control
+        keeps an index of the item labels which allows to find the matching
+        item much faster, at the cost of using more memory. The index is built
+        when it's used for the first time and after any change to the items.
+
+        This function is only available in the generic version.
+
+        @see HasFindIndex()
+
+        @since 3.1.5
+    */
+    void EnableFindIndex(bool enable = true);
+
     /**
         Ends label editing. If @a cancelEdit is @true, the edit will be
         cancelled.
@@ -369,6 +387,25 @@ public:
     */
     virtual void EndEditLabel(const wxTreeItemId& item, bool discardChanges = false);
 
+    /**
+        Enables or disables creating the children of the items on demand.
+
+        When this mode is enabled, the children of an item are deleted when it
+        is collapsed, but the item keeps showing the expansion button. The
+        children must then be added again by the wxEVT_TREE_ITEM_EXPANDING
+        event handler, which allows to use the control for showing huge trees
+        while only keeping the expanded branches in memory. Use
+        SetItemHasChildren() for the items which have children which haven't
+        been added yet.
+
+        This function is only available in the generic version.
+
+        @see HasOnDemandChildren()
+
+        @since 3.1.5
+    */
+    void EnableOnDemandChildren(bool enable = true);
+
     /**
         Scrolls and/or expands items to ensure that the given item is visible.
 
@@ -413,6 +450,30 @@ public:
     virtual bool GetBoundingRect(const wxTreeItemId& item, wxRect& rect,
                                  bool textOnly = false) const;
 
+    /**
+        Returns @true if the index for searching the items from keyboard is
+        used.
+
+        This function is only available in the generic version.
+
+        @see EnableFindIndex()
+
+        @since 3.1.5
+    */
+    bool HasFindIndex() const;
+
+    /**
+        Returns @true if the children are deleted when their parent is
+        collapsed.
+
+        This function is only available in the generic version.
+
+        @see EnableOnDemandChildren()
+
+        @since 3.1.5
+    */
+    bool HasOnDemandChildren() const;
+
     /**
         Returns the buttons image list (from which application-defined button
         images are taken).
@@ -587,12 +587,19 @@ void wxAppConsoleBase::DeletePendingEvents()
     wxCHECK_RET( m_handlersWithPendingDelayedEvents.IsEmpty(),
                  "this helper list should be empty" );
 
-    for (unsigned int i=0; i<m_handlersWithPendingEvents.GetCount(); i++)
-        m_handlersWithPendingEvents[i]->DeletePendingEvents();
-
-    m_handlersWithPendingEvents.Clear();
-
+    // Clear the list before deleting the events of the handlers in it, as
+    // they can add themselves to it again if more events are queued for them
+    // by the other threads in the meanwhile.
+    wxEvtHandlerArray handlers;
+    handlers.swap(m_handlersWithPendingEvents);
+
+    // Also don't keep our lock while doing it, as the handlers lock their own
+    // one and then ours in their ProcessPendingEvents(), so doing it in the
+    // other order here could result in a deadlock.
     wxLEAVE_CRIT_SECT(m_handlersWithPendingEventsLocker);
+
+    for (unsigned int i=0; i<handlers.GetCount(); i++)
+        handlers[i]->DeletePendingEvents();
 }
 
 // ----------------------------------------------------------------------------
@@ -98,32 +98,50 @@ wxFont wxDataViewItemAttr::GetEffectiveFont(const wxFont& font) const
 
 bool wxDataViewModelNotifier::ItemsAdded( const wxDataViewItem &parent, const wxDataViewItemArray &items )
 {
+    // Update the view only once after processing all the items.
+    BeginBatch();
+
+    bool ret = true;
     size_t count = items.GetCount();
     size_t i;
-    for (i = 0; i < count; i++)
-        if (!ItemAdded( parent, items[i] )) return false;
+    for (i = 0; i < count && ret; i++)
+        ret = ItemAdded( parent, items[i] );
 
-    return true;
+    EndBatch();
+
+    return ret;
 }
 
 bool wxDataViewModelNotifier::ItemsDeleted( const wxDataViewItem &parent, const wxDataViewItemArray &items )
 {
+    // Update the view only once after processing all the items.
+    BeginBatch();
+
+    bool ret = true;
     size_t count = items.GetCount();
     size_t i;
-    for (i = 0; i < count; i++)
-        if (!ItemDeleted( parent, items[i] )) return false;
+    for (i = 0; i < count && ret; i++)
+        ret = ItemDeleted( parent, items[i] );
 
-    return true;
+    EndBatch();
+
+    return ret;
 }
 
 bool wxDataViewModelNotifier::ItemsChanged( const wxDataViewItemArray &items )
 {
+    // Update the view only once after processing all the items.
+    BeginBatch();
+
+    bool ret = true;
     size_t count = items.GetCount();
     size_t i;
-    for (i = 0; i < count; i++)
-        if (!ItemChanged( items[i] )) return false;
+    for (i = 0; i < count && ret; i++)
+        ret = ItemChanged( items[i] );
 
-    return true;
+    EndBatch();
+
+    return ret;
 }
 
 // ---------------------------------------------------------
@@ -132,6 +150,7 @@ bool wxDataViewModelNotifier::ItemsChanged( const wxDataViewItemArray &items )
 
 wxDataViewModel::wxDataViewModel()
 {
+    m_batchCount = 0;
 }
 
 wxDataViewModel::~wxDataViewModel()
@@ -303,10 +322,42 @@ void wxDataViewModel::Resort()
     }
 }
 
+void wxDataViewModel::BeginBatch()
+{
+    if ( m_batchCount++ )
+        return;
+
+    wxDataViewModelNotifiers::iterator iter;
+    for (iter = m_notifiers.begin(); iter != m_notifiers.end(); ++iter)
+    {
+        wxDataViewModelNotifier* notifier = *iter;
+        notifier->BeginBatch();
+    }
+}
+
+void wxDataViewModel::EndBatch()
+{
+    wxCHECK_RET( m_batchCount > 0, wxS("EndBatch() without BeginBatch()") );
+
+    if ( --m_batchCount )
+        return;
+
+    wxDataViewModelNotifiers::iterator iter;
+    for (iter = m_notifiers.begin(); iter != m_notifiers.end(); ++iter)
+    {
+        wxDataViewModelNotifier* notifier = *iter;
+        notifier->EndBatch();
+    }
+}
+
 void wxDataViewModel::AddNotifier( wxDataViewModelNotifier *notifier )
 {
     m_notifiers.push_back( notifier );
     notifier->SetOwner( this );
+
+    // Keep BeginBatch() and EndBatch() calls balanced for this notifier too.
+    if ( m_batchCount )
+        notifier->BeginBatch();
 }
 
 void wxDataViewModel::RemoveNotifier( wxDataViewModelNotifier *notifier )
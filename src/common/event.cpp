@@ -42,6 +42,8 @@
     #endif // wxUSE_GUI
 #endif
 
+#include "wx/atomic.h"
+#include "wx/hashmap.h"
 #include "wx/thread.h"
 
 #if wxUSE_BASE
@@ -1138,13 +1140,154 @@ void wxEventHashTable::GrowEventTypeTable()
 // wxEvtHandler
 // ----------------------------------------------------------------------------
 
+// The index of the dynamic event handlers is only used if there are at least
+// this many of them, as for a few handlers just checking all of them is
+// faster than looking up the event type in the index.
+static const size_t wxDYNAMIC_EVENTS_INDEX_MIN_SIZE = 16;
+
+// The positions in m_dynamicEvents of all the entries for the given event type
+// in the order of their addition, i.e. in the same order as in the vector.
+WX_DECLARE_HASH_MAP(wxEventType, wxVector<size_t>,
+                    wxIntegerHash, wxIntegerEqual,
+                    wxDynamicEventsIndexBase);
+
+class wxDynamicEventsIndex : public wxDynamicEventsIndexBase
+{
+};
+
+// An element of the lists of pending events.
+struct wxPendingEventNode
+{
+    explicit wxPendingEventNode(wxEvent *event_)
+        : event(event_), next(NULL), coalescing(false)
+    {
+    }
+
+    wxEvent *event;
+    wxPendingEventNode *next;
+
+    // True if this node is in wxPendingEventsCoalescing::m_nodes.
+    bool coalescing;
+};
+
+// The data used for coalescing the pending events: the event types for which
+// it's enabled and the pending events of these types indexed by their type and
+// id, so that a newer event can be quickly found and replaced.
+class wxPendingEventsCoalescing
+{
+public:
+    wxPendingEventsCoalescing() { }
+
+    bool IsEnabled(wxEventType eventType) const
+    {
+        for ( size_t n = 0; n < m_eventTypes.size(); n++ )
+        {
+            if ( m_eventTypes[n] == eventType )
+                return true;
+        }
+
+        return false;
+    }
+
+    void Enable(wxEventType eventType, bool enable)
+    {
+        for ( size_t n = 0; n < m_eventTypes.size(); n++ )
+        {
+            if ( m_eventTypes[n] == eventType )
+            {
+                if ( !enable )
+                    m_eventTypes.erase(m_eventTypes.begin() + n);
+                return;
+            }
+        }
+
+        if ( enable )
+            m_eventTypes.push_back(eventType);
+    }
+
+    // Either replace the event of the existing pending node with the same key
+    // with the event of the given node and return true or remember the given
+    // node, which must be added to the pending events list, and return false.
+    bool Coalesce(wxPendingEventNode *node)
+    {
+        if ( !IsEnabled(node->event->GetEventType()) )
+            return false;
+
+        wxPendingEventNode*& existing = m_nodes[Key(*node->event)];
+        if ( existing )
+        {
+            delete existing->event;
+            existing->event = node->event;
+            delete node;
+
+            return true;
+        }
+
+        existing = node;
+        node->coalescing = true;
+
+        return false;
+    }
+
+    // Must be called before deleting the node if it's coalescing.
+    void Remove(wxPendingEventNode *node)
+    {
+        m_nodes.erase(Key(*node->event));
+    }
+
+    void Clear() { m_nodes.clear(); }
+
+private:
+    struct Key
+    {
+        explicit Key(const wxEvent& event)
+            : eventType(event.GetEventType()), id(event.GetId())
+        {
+        }
+
+        wxEventType eventType;
+        int id;
+    };
+
+    struct KeyHash
+    {
+        KeyHash() { }
+        size_t operator()(const Key& key) const
+        {
+            return wx_truncate_cast(size_t, key.eventType) * 31 +
+                   static_cast<unsigned>(key.id);
+        }
+    };
+
+    struct KeyEqual
+    {
+        KeyEqual() { }
+        bool operator()(const Key& a, const Key& b) const
+        {
+            return a.eventType == b.eventType && a.id == b.id;
+        }
+    };
+
+    WX_DECLARE_HASH_MAP(Key, wxPendingEventNode*, KeyHash, KeyEqual, Nodes);
+
+    wxVector<wxEventType> m_eventTypes;
+    Nodes m_nodes;
+
+    wxDECLARE_NO_COPY_CLASS(wxPendingEventsCoalescing);
+};
+
 wxEvtHandler::wxEvtHandler()
 {
     m_nextHandler = NULL;
     m_previousHandler = NULL;
     m_enabled = true;
     m_dynamicEvents = NULL;
+    m_dynamicEventsIndex = NULL;
+    m_queuedEvents = NULL;
     m_pendingEvents = NULL;
+    m_pendingEventsLast = NULL;
+    m_pendingEventsCoalescing = NULL;
+    m_hasPendingEvents = 0;
 
     // no client data (yet)
     m_clientData = NULL;
@@ -1180,6 +1323,7 @@ wxEvtHandler::~wxEvtHandler()
             delete entry;
         }
         delete m_dynamicEvents;
+        delete m_dynamicEventsIndex;
     }
 
     // Remove us from the list of the pending events if necessary.
@@ -1188,6 +1332,8 @@ wxEvtHandler::~wxEvtHandler()
 
     DeletePendingEvents();
 
+    delete m_pendingEventsCoalescing;
+
     // we only delete object data, not untyped
     if ( m_clientDataType == wxClientData_Object )
         delete m_clientObject;
@@ -1267,6 +1413,130 @@ bool wxEvtHandler::ProcessThreadEvent(const wxEvent& event)
 
 #endif // wxUSE_THREADS
 
+// ----------------------------------------------------------------------------
+// pending events
+// ----------------------------------------------------------------------------
+
+void wxEvtHandler::PushQueuedEvent(wxPendingEventNode *node)
+{
+#ifdef wxHAS_ATOMIC_OPS
+    // This can be called from many threads at once, so avoid locking here.
+    // Notice that there is no ABA problem because the events are never
+    // removed from this list one by one, but always all at once.
+    do
+    {
+        node->next = m_queuedEvents;
+    } while ( !wxAtomicCompareAndSwap(m_queuedEvents, node->next, node) );
+#else // !wxHAS_ATOMIC_OPS
+    wxCriticalSectionLocker lock(m_pendingEventsLock);
+
+    node->next = m_queuedEvents;
+    m_queuedEvents = node;
+#endif // wxHAS_ATOMIC_OPS/!wxHAS_ATOMIC_OPS
+}
+
+void wxEvtHandler::TakeQueuedEvents()
+{
+    wxPendingEventNode *queued;
+
+#ifdef wxHAS_ATOMIC_OPS
+    do
+    {
+        queued = m_queuedEvents;
+    } while ( queued &&
+                !wxAtomicCompareAndSwap(m_queuedEvents, queued,
+                                        (wxPendingEventNode *)NULL) );
+#else // !wxHAS_ATOMIC_OPS
+    wxCriticalSectionLocker lock(m_pendingEventsLock);
+
+    queued = m_queuedEvents;
+    m_queuedEvents = NULL;
+#endif // wxHAS_ATOMIC_OPS/!wxHAS_ATOMIC_OPS
+
+    if ( !queued )
+        return;
+
+    // The queued events are in the reverse order, so reverse them before
+    // appending them to the pending events list.
+    wxPendingEventNode * last = queued;
+    wxPendingEventNode *first = NULL;
+    while ( queued )
+    {
+        wxPendingEventNode * const next = queued->next;
+        queued->next = first;
+        first = queued;
+        queued = next;
+    }
+
+    if ( m_pendingEventsCoalescing )
+    {
+        // Append the events one by one, as some of them may replace the
+        // already pending ones instead of being appended.
+        for ( wxPendingEventNode *node = first; node; )
+        {
+            wxPendingEventNode * const next = node->next;
+            node->next = NULL;
+
+            if ( !m_pendingEventsCoalescing->Coalesce(node) )
+            {
+                if ( m_pendingEventsLast )
+                    m_pendingEventsLast->next = node;
+                else
+                    m_pendingEvents = node;
+
+                m_pendingEventsLast = node;
+            }
+
+            node = next;
+        }
+
+        return;
+    }
+
+    if ( m_pendingEventsLast )
+        m_pendingEventsLast->next = first;
+    else
+        m_pendingEvents = first;
+
+    m_pendingEventsLast = last;
+}
+
+bool wxEvtHandler::ChangeHasPendingEvents(bool hasPendingEvents)
+{
+#ifdef wxHAS_ATOMIC_OPS
+    return wxAtomicCompareAndSwap(m_hasPendingEvents,
+                                  hasPendingEvents ? 0u : 1u,
+                                  hasPendingEvents ? 1u : 0u);
+#else // !wxHAS_ATOMIC_OPS
+    wxCriticalSectionLocker lock(m_pendingEventsLock);
+
+    if ( (m_hasPendingEvents != 0) == hasPendingEvents )
+        return false;
+
+    m_hasPendingEvents = hasPendingEvents;
+    return true;
+#endif // wxHAS_ATOMIC_OPS/!wxHAS_ATOMIC_OPS
+}
+
+void wxEvtHandler::RemoveFromPendingEventHandlers()
+{
+    wxTheApp->RemovePendingEventHandler(this);
+
+    ResetHasPendingEvents();
+}
+
+void wxEvtHandler::ResetHasPendingEvents()
+{
+    // Another thread could have queued an event after we had taken the queued
+    // events but before we reset the flag, in which case
+    // it didn't add us to the list of the handlers with pending events and we
+    // need to do it ourselves. Notice that if the event is queued after we
+    // reset the flag, only one of us will manage to set it again.
+    ChangeHasPendingEvents(false);
+    if ( m_queuedEvents && ChangeHasPendingEvents(true) )
+        wxTheApp->AppendPendingEventHandler(this);
+}
+
 void wxEvtHandler::QueueEvent(wxEvent *event)
 {
     wxCHECK_RET( event, "NULL event can't be posted" );
@@ -1283,26 +1553,20 @@ void wxEvtHandler::QueueEvent(wxEvent *event)
         return;
     }
 
-    // 1) Add this event to our list of pending events
-    wxENTER_CRIT_SECT( m_pendingEventsLock );
-
-    if ( !m_pendingEvents )
-        m_pendingEvents = new wxList;
-
-    m_pendingEvents->Append(event);
+    // 1) Add this event to our list of queued events
+    PushQueuedEvent(new wxPendingEventNode(event));
 
     // 2) Add this event handler to list of event handlers that
-    //    have pending events.
-
-    wxTheApp->AppendPendingEventHandler(this);
-
-    // only release m_pendingEventsLock now because otherwise there is a race
-    // condition as described in the ticket #9093: we could process the event
-    // just added to m_pendingEvents in our ProcessPendingEvents() below before
-    // we had time to append this pointer to wxHandlersWithPendingEvents list; thus
-    // breaking the invariant that a handler should be in the list iff it has
-    // any pending events to process
-    wxLEAVE_CRIT_SECT( m_pendingEventsLock );
+    //    have pending events, unless it is already there: this ensures that we
+    //    only need to lock this list once for all the events queued before
+    //    they are processed.
+    //
+    //    Notice that we must do it after adding the event, as otherwise we
+    //    could be removed from this list in our ProcessPendingEvents() before
+    //    the event is added, breaking the invariant that a handler should be
+    //    in the list iff it has any pending events to process (see #9093).
+    if ( ChangeHasPendingEvents(true) )
+        wxTheApp->AppendPendingEventHandler(this);
 
     // 3) Inform the system that new pending events are somewhere,
     //    and that these should be processed in idle time.
@@ -1311,9 +1575,54 @@ void wxEvtHandler::QueueEvent(wxEvent *event)
 
 void wxEvtHandler::DeletePendingEvents()
 {
-    if (m_pendingEvents)
-        m_pendingEvents->DeleteContents(true);
-    wxDELETE(m_pendingEvents);
+    wxCRIT_SECT_LOCKER(lock, m_pendingEventsLock);
+
+    TakeQueuedEvents();
+
+    while ( m_pendingEvents )
+    {
+        wxPendingEventNode * const node = m_pendingEvents;
+        m_pendingEvents = node->next;
+
+        delete node->event;
+        delete node;
+    }
+
+    m_pendingEventsLast = NULL;
+
+    if ( m_pendingEventsCoalescing )
+        m_pendingEventsCoalescing->Clear();
+
+    // Don't just reset the flag, as another thread could have queued an event
+    // after we took them above, in which case we must remain in the list of
+    // the handlers with pending events (or be added to it again).
+    ResetHasPendingEvents();
+}
+
+void wxEvtHandler::EnableEventsCoalescing(wxEventType eventType, bool enable)
+{
+    wxCRIT_SECT_LOCKER(lock, m_pendingEventsLock);
+
+    if ( !m_pendingEventsCoalescing )
+    {
+        if ( !enable )
+            return;
+
+        m_pendingEventsCoalescing = new wxPendingEventsCoalescing;
+    }
+
+    // Notice that we don't need to do anything with the already pending
+    // events: they will just never be replaced if coalescing is disabled and
+    // only the events queued from now on will replace each other otherwise.
+    m_pendingEventsCoalescing->Enable(eventType, enable);
+}
+
+bool wxEvtHandler::IsEventsCoalescingEnabled(wxEventType eventType) const
+{
+    wxCRIT_SECT_LOCKER(lock, const_cast<wxEvtHandler*>(this)->m_pendingEventsLock);
+
+    return m_pendingEventsCoalescing &&
+                m_pendingEventsCoalescing->IsEnabled(eventType);
 }
 
 void wxEvtHandler::ProcessPendingEvents()
@@ -1332,22 +1641,32 @@ void wxEvtHandler::ProcessPendingEvents()
 
     wxENTER_CRIT_SECT( m_pendingEventsLock );
 
+    // get all the events queued since the last call at once
+    TakeQueuedEvents();
+
     // this method is only called by wxApp if this handler does have
-    // pending events
-    wxCHECK_RET( m_pendingEvents && !m_pendingEvents->IsEmpty(),
-                 "should have pending events if called" );
+    // pending events, unless they were deleted by DeletePendingEvents() since
+    // then, in which case we just need to remove ourselves from its list
+    if ( !m_pendingEvents )
+    {
+        RemoveFromPendingEventHandlers();
+
+        wxLEAVE_CRIT_SECT( m_pendingEventsLock );
+
+        return;
+    }
 
-    wxList::compatibility_iterator node = m_pendingEvents->GetFirst();
-    wxEvent* pEvent = static_cast<wxEvent *>(node->GetData());
+    wxPendingEventNode *node = m_pendingEvents,
+                       *prev = NULL;
 
     // find the first event which can be processed now:
     wxEventLoopBase* evtLoop = wxEventLoopBase::GetActive();
     if (evtLoop && evtLoop->IsYielding())
     {
-        while (node && pEvent && !evtLoop->IsEventAllowedInsideYield(pEvent->GetEventCategory()))
+        while (node && !evtLoop->IsEventAllowedInsideYield(node->event->GetEventCategory()))
         {
-            node = node->GetNext();
-            pEvent = node ? static_cast<wxEvent *>(node->GetData()) : NULL;
+            prev = node;
+            node = node->next;
         }
 
         if (!node)
@@ -1355,6 +1674,12 @@ void wxEvtHandler::ProcessPendingEvents()
             // all our events are NOT processable now... signal this:
             wxTheApp->DelayPendingEventHandler(this);
 
+            // we're not in the list of the handlers with pending events any
+            // more, so reset the flag to ensure that QueueEvent() adds us to
+            // it again if another event is queued while yielding, as it may
+            // be processable
+            ResetHasPendingEvents();
+
             // see the comment at the beginning of evtloop.h header for the
             // logic behind YieldFor() and behind DelayPendingEventHandler()
 
@@ -1364,18 +1689,29 @@ void wxEvtHandler::ProcessPendingEvents()
         }
     }
 
-    wxEventPtr event(pEvent);
+    wxEventPtr event(node->event);
 
     // it's important we remove event from list before processing it, else a
     // nested event loop, for example from a modal dialog, might process the
     // same event again.
-    m_pendingEvents->Erase(node);
+    if ( prev )
+        prev->next = node->next;
+    else
+        m_pendingEvents = node->next;
+
+    if ( node == m_pendingEventsLast )
+        m_pendingEventsLast = prev;
+
+    if ( node->coalescing )
+        m_pendingEventsCoalescing->Remove(node);
 
-    if ( m_pendingEvents->IsEmpty() )
+    delete node;
+
+    if ( !m_pendingEvents )
     {
         // if there are no more pending events left, we don't need to
         // stay in this list
-        wxTheApp->RemovePendingEventHandler(this);
+        RemoveFromPendingEventHandlers();
     }
 
     wxLEAVE_CRIT_SECT( m_pendingEventsLock );
@@ -1741,6 +2077,30 @@ bool wxEvtHandler::SearchEventTable(wxEventTable& table, wxEvent& event)
     return false;
 }
 
+const wxVector<size_t>*
+wxEvtHandler::GetDynamicEventsPositions(wxEventType eventType)
+{
+    if ( !m_dynamicEventsIndex )
+    {
+        m_dynamicEventsIndex = new wxDynamicEventsIndex;
+
+        const DynamicEvents& dynamicEvents = *m_dynamicEvents;
+        for ( size_t n = 0; n < dynamicEvents.size(); n++ )
+        {
+            if ( dynamicEvents[n] )
+            {
+                (*m_dynamicEventsIndex)[dynamicEvents[n]->m_eventType]
+                    .push_back(n);
+            }
+        }
+    }
+
+    const wxDynamicEventsIndex::const_iterator
+        it = m_dynamicEventsIndex->find(eventType);
+
+    return it == m_dynamicEventsIndex->end() ? NULL : &it->second;
+}
+
 void wxEvtHandler::DoBind(int id,
                           int lastId,
                           wxEventType eventType,
@@ -1765,6 +2125,11 @@ void wxEvtHandler::DoBind(int id,
     // than inserting the element at the front.
     m_dynamicEvents->push_back(entry);
 
+    // Keep the index up to date if we have it, this doesn't invalidate the
+    // positions of the existing entries.
+    if ( m_dynamicEventsIndex )
+        (*m_dynamicEventsIndex)[eventType].push_back(m_dynamicEvents->size() - 1);
+
     // Make sure we get to know when a sink is destroyed
     wxEvtHandler *eventSink = func->GetEvtHandler();
     if ( eventSink && eventSink != this )
@@ -1867,43 +2232,87 @@ bool wxEvtHandler::SearchDynamicEventTable( wxEvent& event )
     // but not yet pruned entries from the caller, but here we do want to know
     // about them, so iterate directly. Remember to do it in the reverse order
     // to honour the order of handlers connection.
-    for ( size_t n = dynamicEvents.size(); n; n-- )
+    if ( dynamicEvents.size() >= wxDYNAMIC_EVENTS_INDEX_MIN_SIZE )
     {
-        wxDynamicEventTableEntry* const entry = dynamicEvents[n - 1];
-
-        if ( !entry )
+        // There are many handlers, so only check the ones for this event
+        // type. Notice that the event handlers called below can bind or
+        // unbind other handlers, or even make us rebuild the index when
+        // pruning the deleted entries in a nested call to this function, so
+        // look up the positions again after calling each of them and don't
+        // keep any references to the index.
+        const wxEventType eventType = event.GetEventType();
+        for ( size_t k = static_cast<size_t>(-1); ; )
         {
-            // This entry must have been unbound at some time in the past, so
-            // skip it now and really remove it from the vector below, once we
-            // finish iterating.
-            needToPruneDeleted = true;
-            continue;
-        }
+            const wxVector<size_t>* const
+                positions = GetDynamicEventsPositions(eventType);
+            if ( !positions )
+                break;
+
+            if ( k > positions->size() )
+                k = positions->size();
+            if ( !k )
+                break;
+
+            wxDynamicEventTableEntry* const
+                entry = dynamicEvents[(*positions)[--k]];
+
+            if ( !entry )
+            {
+                needToPruneDeleted = true;
+                continue;
+            }
 
-        if ( event.GetEventType() == entry->m_eventType )
-        {
             wxEvtHandler *handler = entry->m_fn->GetEvtHandler();
             if ( !handler )
                handler = this;
             if ( ProcessEventIfMatchesId(*entry, handler, event) )
             {
-                // It's important to skip pruning of the unbound event entries
-                // below because this object itself could have been deleted by
-                // the event handler making m_dynamicEvents a dangling pointer
-                // which can't be accessed any longer in the code below.
-                //
-                // In practice, it hopefully shouldn't be a problem to wait
-                // until we get an event that we don't handle before pruning
-                // because this should happen soon enough and even if it
-                // doesn't the worst possible outcome is slightly increased
-                // memory consumption while not skipping pruning can result in
-                // hard to reproduce (because they require the disconnection
-                // and deletion happen at the same time which is not always the
-                // case) crashes.
+                // Don't prune the unbound entries, see the comment below.
                 return true;
             }
         }
     }
+    else // Not many handlers, just check all of them.
+    {
+        for ( size_t n = dynamicEvents.size(); n; n-- )
+        {
+            wxDynamicEventTableEntry* const entry = dynamicEvents[n - 1];
+
+            if ( !entry )
+            {
+                // This entry must have been unbound at some time in the past,
+                // so skip it now and really remove it from the vector below,
+                // once we finish iterating.
+                needToPruneDeleted = true;
+                continue;
+            }
+
+            if ( event.GetEventType() == entry->m_eventType )
+            {
+                wxEvtHandler *handler = entry->m_fn->GetEvtHandler();
+                if ( !handler )
+                   handler = this;
+                if ( ProcessEventIfMatchesId(*entry, handler, event) )
+                {
+                    // It's important to skip pruning of the unbound event
+                    // entries below because this object itself could have
+                    // been deleted by the event handler making
+                    // m_dynamicEvents a dangling pointer which can't be
+                    // accessed any longer in the code below.
+                    //
+                    // In practice, it hopefully shouldn't be a problem to wait
+                    // until we get an event that we don't handle before
+                    // pruning because this should happen soon enough and even
+                    // if it doesn't the worst possible outcome is slightly
+                    // increased memory consumption while not skipping pruning
+                    // can result in hard to reproduce (because they require
+                    // the disconnection and deletion happen at the same time
+                    // which is not always the case) crashes.
+                    return true;
+                }
+            }
+        }
+    }
 
     if ( needToPruneDeleted )
     {
@@ -1916,6 +2325,10 @@ bool wxEvtHandler::SearchDynamicEventTable( wxEvent& event )
 
         wxASSERT( nNew != dynamicEvents.size() );
         dynamicEvents.resize(nNew);
+
+        // The positions of the entries have changed, so the index will need
+        // to be rebuilt when it's used the next time.
+        wxDELETE(m_dynamicEventsIndex);
     }
 
     return false;
@@ -1231,6 +1231,162 @@ bool wxBMPHandler::LoadFile(wxImage *image, wxInputStream& stream,
     return LoadDib(image, stream, verbose, true/*isBmp*/);
 }
 
+namespace
+{
+
+inline wxUint16 GetLE16(const wxUint8* p)
+{
+    return (wxUint16)(p[0] | (p[1] << 8));
+}
+
+inline wxUint32 GetLE32(const wxUint8* p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((wxUint32)p[3] << 24);
+}
+
+} // anonymous namespace
+
+bool wxBMPHandler::LoadRows(wxImageRowConsumer& consumer, wxInputStream& stream,
+                            bool verbose, int index)
+{
+    // Only uncompressed bitmaps without alpha can be decoded row by row: RLE
+    // compressed ones can jump between rows and we only know if the alpha
+    // channel of 32bpp bitmaps is really used after reading all of them. So
+    // read the BITMAPFILEHEADER and BITMAPINFOHEADER first to check if we can
+    // do it, and put them back into the stream if not.
+    const size_t sizeHeaders = 14 + 40;
+    wxUint8 hdr[sizeHeaders] = { 0 };
+    const size_t sizeRead = stream.Read(hdr, sizeHeaders).LastRead();
+
+    const wxFileOffset posStart = stream.IsSeekable()
+                                    ? stream.TellI() - (wxFileOffset)sizeRead
+                                    : wxInvalidOffset;
+
+    const wxUint32 hdrSize = GetLE32(hdr + 14);
+    const int width = (wxInt32)GetLE32(hdr + 18);
+    int height = (wxInt32)GetLE32(hdr + 22);
+    const int bpp = GetLE16(hdr + 28);
+    const wxUint32 comp = GetLE32(hdr + 30);
+    const wxUint32 offset = GetLE32(hdr + 10);
+    wxUint32 ncolors = GetLE32(hdr + 46);
+
+    const bool isTopDown = height < 0;
+    if ( isTopDown )
+        height = -height;
+
+    if ( ncolors == 0 && bpp < 16 )
+        ncolors = 1 << bpp;
+
+    if ( sizeRead != sizeHeaders ||
+            hdr[0] != 'B' || hdr[1] != 'M' ||
+            hdrSize < 40 || comp != BI_RGB ||
+            (bpp != 1 && bpp != 4 && bpp != 8 && bpp != 16 && bpp != 24) ||
+            width <= 0 || width > 32767 || height <= 0 || height > 32767 ||
+            (bpp < 16 && ncolors > (1u << bpp)) ||
+            (!isTopDown && posStart == wxInvalidOffset) )
+    {
+        stream.Ungetch(hdr, sizeRead);
+        return wxImageHandler::LoadRows(consumer, stream, verbose, index);
+    }
+
+    wxFileOffset pos = sizeHeaders;
+    if ( hdrSize > 40 )
+    {
+        if ( stream.SeekI(hdrSize - 40, wxFromCurrent) == wxInvalidOffset )
+            return false;
+
+        pos += hdrSize - 40;
+    }
+
+    // unused palette entries are black, as in DoLoadDib()
+    BMPPalette cmap[256];
+    memset(cmap, 0, sizeof(cmap));
+    if ( bpp < 16 )
+    {
+        for ( wxUint32 n = 0; n < ncolors; n++ )
+        {
+            wxUint8 entry[4];
+            if ( !stream.ReadAll(entry, 4) )
+                return false;
+
+            cmap[n].b = entry[0];
+            cmap[n].g = entry[1];
+            cmap[n].r = entry[2];
+        }
+
+        pos += 4 * ncolors;
+    }
+
+    // NOTE: seeking a positive amount in wxFromCurrent mode also works for
+    //       non-seekable streams
+    if ( isTopDown && offset > pos &&
+            stream.SeekI(offset - pos, wxFromCurrent) == wxInvalidOffset )
+        return false;
+
+    if ( !consumer.OnStart(width, height, false) )
+        return false;
+
+    const int linesize = ((width * bpp + 31) / 32) * 4;
+    wxScopedArray<wxUint8> line(linesize);
+    wxScopedArray<unsigned char> rgb(3 * width);
+
+    for ( int y = 0; y < height; y++ )
+    {
+        // rows of the bottom-up bitmaps are stored in the reverse order, so
+        // we need to seek to each of them
+        if ( !isTopDown &&
+                stream.SeekI(posStart + offset + (wxFileOffset)(height - 1 - y) * linesize)
+                    == wxInvalidOffset )
+            return false;
+
+        if ( !stream.ReadAll(line.get(), linesize) )
+            return false;
+
+        unsigned char* dst = rgb.get();
+        for ( int x = 0; x < width; x++ )
+        {
+            switch ( bpp )
+            {
+                case 1:
+                case 4:
+                case 8:
+                    {
+                        const int bit = x * bpp;
+                        const int shift = 8 - bpp - bit % 8;
+                        const int mask = (1 << bpp) - 1;
+                        const BMPPalette&
+                            c = cmap[(line[bit / 8] >> shift) & mask];
+                        *dst++ = c.r;
+                        *dst++ = c.g;
+                        *dst++ = c.b;
+                    }
+                    break;
+
+                case 16:
+                    {
+                        // 5 bits per component in BI_RGB format
+                        const wxUint16 w = GetLE16(&line[2 * x]);
+                        *dst++ = (unsigned char)(((w >> 10) & 0x1f) << 3);
+                        *dst++ = (unsigned char)(((w >> 5) & 0x1f) << 3);
+                        *dst++ = (unsigned char)((w & 0x1f) << 3);
+                    }
+                    break;
+
+                case 24:
+                    *dst++ = line[3 * x + 2];
+                    *dst++ = line[3 * x + 1];
+                    *dst++ = line[3 * x];
+                    break;
+            }
+        }
+
+        if ( !consumer.OnRow(y, rgb.get(), NULL) )
+            return false;
+    }
+
+    return true;
+}
+
 bool wxBMPHandler::DoCanRead(wxInputStream& stream)
 {
     unsigned char hdr[2];
@@ -1549,6 +1705,13 @@ bool wxICOHandler::LoadFile(wxImage *image, wxInputStream& stream,
     return DoLoadFile(image, stream, verbose, index);
 }
 
+bool wxICOHandler::LoadRows(wxImageRowConsumer& consumer, wxInputStream& stream,
+                            bool verbose, int index)
+{
+    // icons can't be streamed, don't use wxBMPHandler version
+    return wxImageHandler::LoadRows(consumer, stream, verbose, index);
+}
+
 bool wxICOHandler::DoLoadFile(wxImage *image, wxInputStream& stream,
                             bool verbose, int index)
 {
@@ -25,12 +25,21 @@
     #include "wx/colour.h"
 #endif
 
+#include "wx/thread.h"
 #include "wx/wfstream.h"
 #include "wx/xpmdecod.h"
 
 // For memcpy
 #include <string.h>
 
+// SSE2 is always available when targeting x86-64 and may be enabled for x86
+// too, use it for the resampling code if the compiler allows it.
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define wxHAS_SSE2_RESAMPLE
+    #include <emmintrin.h>
+#endif
+
 // make the code compile with either wxFile*Stream or wxFFile*Stream:
 #define HAS_FILE_STREAMS (wxUSE_STREAMS && (wxUSE_FILE || wxUSE_FFILE))
 
@@ -130,6 +139,130 @@ wxImageRefData::~wxImageRefData()
 }
 
 
+//-----------------------------------------------------------------------------
+// helpers for parallel processing of the image data
+//-----------------------------------------------------------------------------
+
+namespace
+{
+
+// The maximal number of threads to use, see wxImage::SetMaxThreads().
+int gs_maxThreads = 1;
+
+// Base class for the operations which can be performed independently on
+// different bands of the image, i.e. ranges of its rows (or columns).
+class wxImageBandProcessor
+{
+public:
+    // Process the items (rows or columns) in [start, end) range.
+    virtual void ProcessBand(int start, int end) = 0;
+
+protected:
+    ~wxImageBandProcessor() { }
+};
+
+#if wxUSE_THREADS
+
+class wxImageBandThread : public wxThread
+{
+public:
+    wxImageBandThread(wxImageBandProcessor& processor, int start, int end)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_processor(processor),
+          m_start(start),
+          m_end(end)
+    {
+    }
+
+protected:
+    virtual ExitCode Entry() wxOVERRIDE
+    {
+        m_processor.ProcessBand(m_start, m_end);
+        return NULL;
+    }
+
+private:
+    wxImageBandProcessor& m_processor;
+    const int m_start,
+              m_end;
+
+    wxDECLARE_NO_COPY_CLASS(wxImageBandThread);
+};
+
+#endif // wxUSE_THREADS
+
+// Call the processor for all items in [0, count) range, splitting them in
+// several bands processed by different threads if allowed and if the total
+// number of pixels to process is big enough for this to be worth it.
+//
+// As the bands are processed independently, the results are always the same
+// as when doing everything in the current thread.
+void ProcessImageBands(wxImageBandProcessor& processor,
+                       int count,
+                       size_t pixelsPerItem)
+{
+    int numThreads = 1;
+
+#if wxUSE_THREADS
+    numThreads = gs_maxThreads;
+    if ( numThreads == 0 )
+        numThreads = wxThread::GetCPUCount();
+
+    // Creating a thread is not free, so don't do it for less than this
+    // number of pixels.
+    static const size_t MIN_PIXELS_PER_THREAD = 65536;
+
+    const size_t maxUseful = pixelsPerItem*count / MIN_PIXELS_PER_THREAD;
+    if ( static_cast<size_t>(numThreads) > maxUseful )
+        numThreads = static_cast<int>(maxUseful);
+
+    if ( numThreads > count )
+        numThreads = count;
+#else // !wxUSE_THREADS
+    wxUnusedVar(pixelsPerItem);
+#endif // wxUSE_THREADS/!wxUSE_THREADS
+
+    if ( numThreads <= 1 )
+    {
+        processor.ProcessBand(0, count);
+        return;
+    }
+
+#if wxUSE_THREADS
+    wxVector<wxThread*> threads;
+    threads.reserve(numThreads - 1);
+
+    // Use the current thread for the first band and the new threads for all
+    // the other ones.
+    for ( int n = 1; n < numThreads; n++ )
+    {
+        const int start = static_cast<int>(static_cast<size_t>(count)*n / numThreads);
+        const int end = static_cast<int>(static_cast<size_t>(count)*(n + 1) / numThreads);
+
+        wxThread* const thread = new wxImageBandThread(processor, start, end);
+        if ( thread->Run() != wxTHREAD_NO_ERROR )
+        {
+            // Not much we can do about it, but we can still do the work.
+            delete thread;
+            processor.ProcessBand(start, end);
+            continue;
+        }
+
+        threads.push_back(thread);
+    }
+
+    processor.ProcessBand(0, count / numThreads);
+
+    for ( size_t n = 0; n < threads.size(); n++ )
+    {
+        threads[n]->Wait();
+        delete threads[n];
+    }
+#endif // wxUSE_THREADS
+}
+
+} // anonymous namespace
+
 //-----------------------------------------------------------------------------
 // wxImage
 //-----------------------------------------------------------------------------
@@ -220,6 +353,8 @@ void wxImage::Destroy()
 
 void wxImage::Clear(unsigned char value)
 {
+    AllocExclusive();
+
     memset(M_IMGDATA->m_data, value, M_IMGDATA->m_width*M_IMGDATA->m_height*3);
 }
 
@@ -499,6 +634,77 @@ wxImage::Scale( int width, int height, wxImageResizeQuality quality ) const
     return image;
 }
 
+namespace
+{
+
+class ResampleNearestProcessor : public wxImageBandProcessor
+{
+public:
+    ResampleNearestProcessor(const unsigned char* source_data,
+                             const unsigned char* source_alpha,
+                             unsigned long old_width,
+                             unsigned char* target_data,
+                             unsigned char* target_alpha,
+                             int width,
+                             unsigned long x_delta,
+                             unsigned long y_delta)
+        : m_source_data(source_data),
+          m_source_alpha(source_alpha),
+          m_old_width(old_width),
+          m_target_data(target_data),
+          m_target_alpha(target_alpha),
+          m_width(width),
+          m_x_delta(x_delta),
+          m_y_delta(y_delta)
+    {
+    }
+
+    virtual void ProcessBand(int start, int end) wxOVERRIDE
+    {
+        const size_t offset = static_cast<size_t>(start)*m_width;
+        unsigned char* dest_pixel = m_target_data + 3*offset;
+        unsigned char* target_alpha = m_target_alpha ? m_target_alpha + offset
+                                                     : NULL;
+
+        unsigned long y = start*m_y_delta;
+        for (int j = start; j < end; j++)
+        {
+            const unsigned char* src_line = &m_source_data[(y>>16)*m_old_width*3];
+            const unsigned char* src_alpha_line = m_source_alpha ? &m_source_alpha[(y>>16)*m_old_width] : 0 ;
+
+            unsigned long x = 0;
+            for (int i = 0; i < m_width; i++)
+            {
+                const unsigned char* src_pixel = &src_line[(x>>16)*3];
+                const unsigned char* src_alpha_pixel = m_source_alpha ? &src_alpha_line[(x>>16)] : 0 ;
+                dest_pixel[0] = src_pixel[0];
+                dest_pixel[1] = src_pixel[1];
+                dest_pixel[2] = src_pixel[2];
+                dest_pixel += 3;
+                if ( m_source_alpha )
+                    *(target_alpha++) = *src_alpha_pixel ;
+                x += m_x_delta;
+            }
+
+            y += m_y_delta;
+        }
+    }
+
+private:
+    const unsigned char* const m_source_data;
+    const unsigned char* const m_source_alpha;
+    const unsigned long m_old_width;
+    unsigned char* const m_target_data;
+    unsigned char* const m_target_alpha;
+    const int m_width;
+    const unsigned long m_x_delta;
+    const unsigned long m_y_delta;
+
+    wxDECLARE_NO_COPY_CLASS(ResampleNearestProcessor);
+};
+
+} // anonymous namespace
+
 wxImage wxImage::ResampleNearest(int width, int height) const
 {
     wxImage image;
@@ -532,30 +738,10 @@ wxImage wxImage::ResampleNearest(int width, int height) const
     const unsigned long x_delta = (old_width  << 16) / width;
     const unsigned long y_delta = (old_height << 16) / height;
 
-    unsigned char* dest_pixel = target_data;
-
-    unsigned long y = 0;
-    for (int j = 0; j < height; j++)
-    {
-        const unsigned char* src_line = &source_data[(y>>16)*old_width*3];
-        const unsigned char* src_alpha_line = source_alpha ? &source_alpha[(y>>16)*old_width] : 0 ;
-
-        unsigned long x = 0;
-        for (int i = 0; i < width; i++)
-        {
-            const unsigned char* src_pixel = &src_line[(x>>16)*3];
-            const unsigned char* src_alpha_pixel = source_alpha ? &src_alpha_line[(x>>16)] : 0 ;
-            dest_pixel[0] = src_pixel[0];
-            dest_pixel[1] = src_pixel[1];
-            dest_pixel[2] = src_pixel[2];
-            dest_pixel += 3;
-            if ( source_alpha )
-                *(target_alpha++) = *src_alpha_pixel ;
-            x += x_delta;
-        }
-
-        y += y_delta;
-    }
+    ResampleNearestProcessor processor(source_data, source_alpha, old_width,
+                                       target_data, target_alpha, width,
+                                       x_delta, y_delta);
+    ProcessImageBands(processor, height, width);
 
     return image;
 }
@@ -614,105 +800,6 @@ void ResampleBoxPrecalc(wxVector<BoxPrecalc>& boxes, int oldDim)
 
 } // anonymous namespace
 
-wxImage wxImage::ResampleBox(int width, int height) const
-{
-    // This function implements a simple pre-blur/box averaging method for
-    // downsampling that gives reasonably smooth results To scale the image
-    // down we will need to gather a grid of pixels of the size of the scale
-    // factor in each direction and then do an averaging of the pixels.
-
-    wxImage ret_image(width, height, false);
-
-    wxVector<BoxPrecalc> vPrecalcs(height);
-    wxVector<BoxPrecalc> hPrecalcs(width);
-
-    ResampleBoxPrecalc(vPrecalcs, M_IMGDATA->m_height);
-    ResampleBoxPrecalc(hPrecalcs, M_IMGDATA->m_width);
-
-
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_data = ret_image.GetData();
-    unsigned char* dst_alpha = NULL;
-
-    if ( src_alpha )
-    {
-        ret_image.SetAlpha();
-        dst_alpha = ret_image.GetAlpha();
-    }
-
-    int averaged_pixels, src_pixel_index;
-    double sum_r, sum_g, sum_b, sum_a;
-
-    for ( int y = 0; y < height; y++ )         // Destination image - Y direction
-    {
-        // Source pixel in the Y direction
-        const BoxPrecalc& vPrecalc = vPrecalcs[y];
-
-        for ( int x = 0; x < width; x++ )      // Destination image - X direction
-        {
-            // Source pixel in the X direction
-            const BoxPrecalc& hPrecalc = hPrecalcs[x];
-
-            // Box of pixels to average
-            averaged_pixels = 0;
-            sum_r = sum_g = sum_b = sum_a = 0.0;
-
-            for ( int j = vPrecalc.boxStart; j <= vPrecalc.boxEnd; ++j )
-            {
-                for ( int i = hPrecalc.boxStart; i <= hPrecalc.boxEnd; ++i )
-                {
-                    // Calculate the actual index in our source pixels
-                    src_pixel_index = j * M_IMGDATA->m_width + i;
-
-                    if (src_alpha)
-                    {
-                        sum_r += src_data[src_pixel_index * 3 + 0] * src_alpha[src_pixel_index];
-                        sum_g += src_data[src_pixel_index * 3 + 1] * src_alpha[src_pixel_index];
-                        sum_b += src_data[src_pixel_index * 3 + 2] * src_alpha[src_pixel_index];
-                        sum_a += src_alpha[src_pixel_index];
-                    }
-                    else
-                    {
-                        sum_r += src_data[src_pixel_index * 3 + 0];
-                        sum_g += src_data[src_pixel_index * 3 + 1];
-                        sum_b += src_data[src_pixel_index * 3 + 2];
-                    }
-
-                    averaged_pixels++;
-                }
-            }
-
-            // Calculate the average from the sum and number of averaged pixels
-            if (src_alpha)
-            {
-                if (sum_a)
-                {
-                    dst_data[0] = (unsigned char)(sum_r / sum_a);
-                    dst_data[1] = (unsigned char)(sum_g / sum_a);
-                    dst_data[2] = (unsigned char)(sum_b / sum_a);
-                }
-                else
-                {
-                    dst_data[0] = 0;
-                    dst_data[1] = 0;
-                    dst_data[2] = 0;
-                }
-                *dst_alpha++ = (unsigned char)(sum_a / averaged_pixels);
-            }
-            else
-            {
-                dst_data[0] = (unsigned char)(sum_r / averaged_pixels);
-                dst_data[1] = (unsigned char)(sum_g / averaged_pixels);
-                dst_data[2] = (unsigned char)(sum_b / averaged_pixels);
-            }
-            dst_data += 3;
-        }
-    }
-
-    return ret_image;
-}
-
 namespace
 {
 
@@ -773,85 +860,6 @@ void ResampleBilinearPrecalc(wxVector<BilinearPrecalc>& precalcs, int oldDim)
 
 } // anonymous namespace
 
-wxImage wxImage::ResampleBilinear(int width, int height) const
-{
-    // This function implements a Bilinear algorithm for resampling.
-    wxImage ret_image(width, height, false);
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_data = ret_image.GetData();
-    unsigned char* dst_alpha = NULL;
-
-    if ( src_alpha )
-    {
-        ret_image.SetAlpha();
-        dst_alpha = ret_image.GetAlpha();
-    }
-
-    wxVector<BilinearPrecalc> vPrecalcs(height);
-    wxVector<BilinearPrecalc> hPrecalcs(width);
-    ResampleBilinearPrecalc(vPrecalcs, M_IMGDATA->m_height);
-    ResampleBilinearPrecalc(hPrecalcs, M_IMGDATA->m_width);
-
-    // initialize alpha values to avoid g++ warnings about possibly
-    // uninitialized variables
-    double r1, g1, b1, a1 = 0;
-    double r2, g2, b2, a2 = 0;
-
-    for ( int dsty = 0; dsty < height; dsty++ )
-    {
-        // We need to calculate the source pixel to interpolate from - Y-axis
-        const BilinearPrecalc& vPrecalc = vPrecalcs[dsty];
-        const int y_offset1 = vPrecalc.offset1;
-        const int y_offset2 = vPrecalc.offset2;
-        const double dy = vPrecalc.dd;
-        const double dy1 = vPrecalc.dd1;
-
-
-        for ( int dstx = 0; dstx < width; dstx++ )
-        {
-            // X-axis of pixel to interpolate from
-            const BilinearPrecalc& hPrecalc = hPrecalcs[dstx];
-
-            const int x_offset1 = hPrecalc.offset1;
-            const int x_offset2 = hPrecalc.offset2;
-            const double dx = hPrecalc.dd;
-            const double dx1 = hPrecalc.dd1;
-
-            int src_pixel_index00 = y_offset1 * M_IMGDATA->m_width + x_offset1;
-            int src_pixel_index01 = y_offset1 * M_IMGDATA->m_width + x_offset2;
-            int src_pixel_index10 = y_offset2 * M_IMGDATA->m_width + x_offset1;
-            int src_pixel_index11 = y_offset2 * M_IMGDATA->m_width + x_offset2;
-
-            // first line
-            r1 = src_data[src_pixel_index00 * 3 + 0] * dx1 + src_data[src_pixel_index01 * 3 + 0] * dx;
-            g1 = src_data[src_pixel_index00 * 3 + 1] * dx1 + src_data[src_pixel_index01 * 3 + 1] * dx;
-            b1 = src_data[src_pixel_index00 * 3 + 2] * dx1 + src_data[src_pixel_index01 * 3 + 2] * dx;
-            if ( src_alpha )
-                a1 = src_alpha[src_pixel_index00] * dx1 + src_alpha[src_pixel_index01] * dx;
-
-            // second line
-            r2 = src_data[src_pixel_index10 * 3 + 0] * dx1 + src_data[src_pixel_index11 * 3 + 0] * dx;
-            g2 = src_data[src_pixel_index10 * 3 + 1] * dx1 + src_data[src_pixel_index11 * 3 + 1] * dx;
-            b2 = src_data[src_pixel_index10 * 3 + 2] * dx1 + src_data[src_pixel_index11 * 3 + 2] * dx;
-            if ( src_alpha )
-                a2 = src_alpha[src_pixel_index10] * dx1 + src_alpha[src_pixel_index11] * dx;
-
-            // result lines
-
-            dst_data[0] = static_cast<unsigned char>(r1 * dy1 + r2 * dy + .5);
-            dst_data[1] = static_cast<unsigned char>(g1 * dy1 + g2 * dy + .5);
-            dst_data[2] = static_cast<unsigned char>(b1 * dy1 + b2 * dy + .5);
-            dst_data += 3;
-
-            if ( src_alpha )
-                *dst_alpha++ = static_cast<unsigned char>(a1 * dy1 + a2 * dy +.5);
-        }
-    }
-
-    return ret_image;
-}
-
 // The following two local functions are for the B-spline weighting of the
 // bicubic sampling algorithm
 static inline double spline_cube(double value)
@@ -923,368 +931,780 @@ void ResampleBicubicPrecalc(wxVector<BicubicPrecalc> &aWeight, int oldDim)
 
 } // anonymous namespace
 
-// This is the bicubic resampling algorithm
-wxImage wxImage::ResampleBicubic(int width, int height) const
-{
-    // This function implements a Bicubic B-Spline algorithm for resampling.
-    // This method is certainly a little slower than wxImage's default pixel
-    // replication method, however for most reasonably sized images not being
-    // upsampled too much on a fairly average CPU this difference is hardly
-    // noticeable and the results are far more pleasing to look at.
-    //
-    // This particular bicubic algorithm does pixel weighting according to a
-    // B-Spline that basically implements a Gaussian bell-like weighting
-    // kernel. Because of this method the results may appear a bit blurry when
-    // upsampling by large factors.  This is basically because a slight
-    // gaussian blur is being performed to get the smooth look of the upsampled
-    // image.
-
-    // Edge pixels: 3-4 possible solutions
-    // - (Wrap/tile) Wrap the image, take the color value from the opposite
-    // side of the image.
-    // - (Mirror)    Duplicate edge pixels, so that pixel at coordinate (2, n),
-    // where n is nonpositive, will have the value of (2, 1).
-    // - (Ignore)    Simply ignore the edge pixels and apply the kernel only to
-    // pixels which do have all neighbours.
-    // - (Clamp)     Choose the nearest pixel along the border. This takes the
-    // border pixels and extends them out to infinity.
-    //
-    // NOTE: below the y_offset and x_offset variables are being set for edge
-    // pixels using the "Mirror" method mentioned above
+// ----------------------------------------------------------------------------
+// Separable resampling
+// ----------------------------------------------------------------------------
 
-    wxImage ret_image;
+// All the filters used by Resample{Box,Bilinear,Bicubic}() are separable, i.e.
+// each destination pixel is a weighted sum of a rectangle of source pixels and
+// the weight of each of them is the product of its horizontal and vertical
+// weights. So instead of computing the full 2D sum for every destination
+// pixel, we first combine all the source rows contributing to the current
+// destination row into a single row and then apply the horizontal weights to
+// it. The weights themselves only depend on the position along the axis and
+// are computed once for all rows or columns.
+//
+// The intermediate row stores 4 floats (R, G, B, A) per pixel, allowing to
+// process the entire pixel at once using SSE2 when it's available.
 
-    ret_image.Create(width, height, false);
+namespace
+{
 
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_data = ret_image.GetData();
-    unsigned char* dst_alpha = NULL;
+// Contributions of the source pixels along one axis: the destination pixel n
+// is computed from the source pixels offsets[n*taps + k] weighted by
+// weights[n*taps + k] for all k in [0, taps).
+struct ResampleAxis
+{
+    ResampleAxis() : taps(0) { }
 
-    if ( src_alpha )
-    {
-        ret_image.SetAlpha();
-        dst_alpha = ret_image.GetAlpha();
-    }
+    int GetSize() const { return taps ? offsets.size() / taps : 0; }
 
-    // Precalculate weights
-    wxVector<BicubicPrecalc> vPrecalcs(height);
-    wxVector<BicubicPrecalc> hPrecalcs(width);
+    int taps;
+    wxVector<int> offsets;
+    wxVector<float> weights;
 
-    ResampleBicubicPrecalc(vPrecalcs, M_IMGDATA->m_height);
-    ResampleBicubicPrecalc(hPrecalcs, M_IMGDATA->m_width);
+    // Number of the source pixels averaged for each destination pixel, only
+    // used by the box filter.
+    wxVector<int> counts;
+};
 
-    for ( int dsty = 0; dsty < height; dsty++ )
-    {
-        // We need to calculate the source pixel to interpolate from - Y-axis
-        const BicubicPrecalc& vPrecalc = vPrecalcs[dsty];
+void InitBoxAxis(ResampleAxis& axis, int oldDim, int newDim)
+{
+    wxVector<BoxPrecalc> boxes(newDim);
+    ResampleBoxPrecalc(boxes, oldDim);
 
-        for ( int dstx = 0; dstx < width; dstx++ )
-        {
-            // X-axis of pixel to interpolate from
-            const BicubicPrecalc& hPrecalc = hPrecalcs[dstx];
+    int taps = 1;
+    for ( int n = 0; n < newDim; n++ )
+        taps = wxMax(taps, boxes[n].boxEnd - boxes[n].boxStart + 1);
 
-            // Sums for each color channel
-            double sum_r = 0, sum_g = 0, sum_b = 0, sum_a = 0;
+    axis.taps = taps;
+    axis.offsets.resize(newDim*taps);
+    axis.weights.resize(newDim*taps);
+    axis.counts.resize(newDim);
 
-            // Here we actually determine the RGBA values for the destination pixel
-            for ( int k = -1; k <= 2; k++ )
-            {
-                // Y offset
-                const int y_offset = vPrecalc.offset[k + 1];
+    for ( int n = 0; n < newDim; n++ )
+    {
+        const BoxPrecalc& box = boxes[n];
+        const int count = box.boxEnd - box.boxStart + 1;
 
-                // Loop across the X axis
-                for ( int i = -1; i <= 2; i++ )
-                {
-                    // X offset
-                    const int x_offset = hPrecalc.offset[i + 1];
-
-                    // Calculate the exact position where the source data
-                    // should be pulled from based on the x_offset and y_offset
-                    int src_pixel_index = y_offset*M_IMGDATA->m_width + x_offset;
-
-                    // Calculate the weight for the specified pixel according
-                    // to the bicubic b-spline kernel we're using for
-                    // interpolation
-                    const double
-                        pixel_weight = vPrecalc.weight[k + 1] * hPrecalc.weight[i + 1];
-
-                    // Create a sum of all velues for each color channel
-                    // adjusted for the pixel's calculated weight
-                    if ( src_alpha )
-                    {
-                        const unsigned char a = src_alpha[src_pixel_index];
-                        sum_r += src_data[src_pixel_index * 3 + 0] * pixel_weight * a;
-                        sum_g += src_data[src_pixel_index * 3 + 1] * pixel_weight * a;
-                        sum_b += src_data[src_pixel_index * 3 + 2] * pixel_weight * a;
-                        sum_a += a * pixel_weight;
-                    }
-                    else
-                    {
-                        sum_r += src_data[src_pixel_index * 3 + 0] * pixel_weight;
-                        sum_g += src_data[src_pixel_index * 3 + 1] * pixel_weight;
-                        sum_b += src_data[src_pixel_index * 3 + 2] * pixel_weight;
-                    }
-                }
-            }
+        axis.counts[n] = count;
 
-            // Put the data into the destination image.  The summed values are
-            // of double data type and are rounded here for accuracy
-            if ( src_alpha )
-            {
-                if ( sum_a )
-                {
-                     dst_data[0] = (unsigned char)(sum_r / sum_a + 0.5);
-                     dst_data[1] = (unsigned char)(sum_g / sum_a + 0.5);
-                     dst_data[2] = (unsigned char)(sum_b / sum_a + 0.5);
-                }
-                else
-                {
-                    dst_data[0] = 0;
-                    dst_data[1] = 0;
-                    dst_data[2] = 0;
-                }
-                *dst_alpha++ = (unsigned char)sum_a;
-            }
-            else
-            {
-                dst_data[0] = (unsigned char)(sum_r + 0.5);
-                dst_data[1] = (unsigned char)(sum_g + 0.5);
-                dst_data[2] = (unsigned char)(sum_b + 0.5);
-            }
-            dst_data += 3;
+        // The boxes don't all have the same size, so pad the smaller ones
+        // with null weights (applied to a valid pixel).
+        for ( int k = 0; k < taps; k++ )
+        {
+            axis.offsets[n*taps + k] = box.boxStart + (k < count ? k : 0);
+            axis.weights[n*taps + k] = k < count ? 1.0f : 0.0f;
         }
     }
-
-    return ret_image;
 }
 
-// Blur in the horizontal direction
-wxImage wxImage::BlurHorizontal(int blurRadius) const
+void InitBilinearAxis(ResampleAxis& axis, int oldDim, int newDim)
 {
-    wxImage ret_image(MakeEmptyClone());
-
-    wxCHECK( ret_image.IsOk(), ret_image );
+    wxVector<BilinearPrecalc> precalcs(newDim);
+    ResampleBilinearPrecalc(precalcs, oldDim);
 
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    unsigned char* dst_data = ret_image.GetData();
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_alpha = ret_image.GetAlpha();
-
-    // number of pixels we average over
-    const int blurArea = blurRadius*2 + 1;
-
-    // Horizontal blurring algorithm - average all pixels in the specified blur
-    // radius in the X or horizontal direction
-    for ( int y = 0; y < M_IMGDATA->m_height; y++ )
-    {
-        // Variables used in the blurring algorithm
-        long sum_r = 0,
-             sum_g = 0,
-             sum_b = 0,
-             sum_a = 0;
-
-        long pixel_idx;
-        const unsigned char *src;
-        unsigned char *dst;
-
-        // Calculate the average of all pixels in the blur radius for the first
-        // pixel of the row
-        for ( int kernel_x = -blurRadius; kernel_x <= blurRadius; kernel_x++ )
-        {
-            // To deal with the pixels at the start of a row so it's not
-            // grabbing GOK values from memory at negative indices of the
-            // image's data or grabbing from the previous row
-            if ( kernel_x < 0 )
-                pixel_idx = y * M_IMGDATA->m_width;
-            else
-                pixel_idx = kernel_x + y * M_IMGDATA->m_width;
-
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
-        }
-
-        dst = dst_data + y * M_IMGDATA->m_width*3;
-        dst[0] = (unsigned char)(sum_r / blurArea);
-        dst[1] = (unsigned char)(sum_g / blurArea);
-        dst[2] = (unsigned char)(sum_b / blurArea);
-        if ( src_alpha )
-            dst_alpha[y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
-
-        // Now average the values of the rest of the pixels by just moving the
-        // blur radius box along the row
-        for ( int x = 1; x < M_IMGDATA->m_width; x++ )
-        {
-            // Take care of edge pixels on the left edge by essentially
-            // duplicating the edge pixel
-            if ( x - blurRadius - 1 < 0 )
-                pixel_idx = y * M_IMGDATA->m_width;
-            else
-                pixel_idx = (x - blurRadius - 1) + y * M_IMGDATA->m_width;
-
-            // Subtract the value of the pixel at the left side of the blur
-            // radius box
-            src = src_data + pixel_idx*3;
-            sum_r -= src[0];
-            sum_g -= src[1];
-            sum_b -= src[2];
-            if ( src_alpha )
-                sum_a -= src_alpha[pixel_idx];
-
-            // Take care of edge pixels on the right edge
-            if ( x + blurRadius > M_IMGDATA->m_width - 1 )
-                pixel_idx = M_IMGDATA->m_width - 1 + y * M_IMGDATA->m_width;
-            else
-                pixel_idx = x + blurRadius + y * M_IMGDATA->m_width;
+    axis.taps = 2;
+    axis.offsets.resize(newDim*2);
+    axis.weights.resize(newDim*2);
 
-            // Add the value of the pixel being added to the end of our box
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
+    for ( int n = 0; n < newDim; n++ )
+    {
+        const BilinearPrecalc& precalc = precalcs[n];
 
-            // Save off the averaged data
-            dst = dst_data + x*3 + y*M_IMGDATA->m_width*3;
-            dst[0] = (unsigned char)(sum_r / blurArea);
-            dst[1] = (unsigned char)(sum_g / blurArea);
-            dst[2] = (unsigned char)(sum_b / blurArea);
-            if ( src_alpha )
-                dst_alpha[x + y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
-        }
+        axis.offsets[n*2    ] = precalc.offset1;
+        axis.offsets[n*2 + 1] = precalc.offset2;
+        axis.weights[n*2    ] = static_cast<float>(precalc.dd1);
+        axis.weights[n*2 + 1] = static_cast<float>(precalc.dd);
     }
-
-    return ret_image;
 }
 
-// Blur in the vertical direction
-wxImage wxImage::BlurVertical(int blurRadius) const
+void InitBicubicAxis(ResampleAxis& axis, int oldDim, int newDim)
 {
-    wxImage ret_image(MakeEmptyClone());
-
-    wxCHECK( ret_image.IsOk(), ret_image );
-
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    unsigned char* dst_data = ret_image.GetData();
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_alpha = ret_image.GetAlpha();
-
-    // number of pixels we average over
-    const int blurArea = blurRadius*2 + 1;
-
-    // Vertical blurring algorithm - same as horizontal but switched the
-    // opposite direction
-    for ( int x = 0; x < M_IMGDATA->m_width; x++ )
-    {
-        // Variables used in the blurring algorithm
-        long sum_r = 0,
-             sum_g = 0,
-             sum_b = 0,
-             sum_a = 0;
-
-        long pixel_idx;
-        const unsigned char *src;
-        unsigned char *dst;
-
-        // Calculate the average of all pixels in our blur radius box for the
-        // first pixel of the column
-        for ( int kernel_y = -blurRadius; kernel_y <= blurRadius; kernel_y++ )
-        {
-            // To deal with the pixels at the start of a column so it's not
-            // grabbing GOK values from memory at negative indices of the
-            // image's data or grabbing from the previous column
-            if ( kernel_y < 0 )
-                pixel_idx = x;
-            else
-                pixel_idx = x + kernel_y * M_IMGDATA->m_width;
-
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
-        }
-
-        dst = dst_data + x*3;
-        dst[0] = (unsigned char)(sum_r / blurArea);
-        dst[1] = (unsigned char)(sum_g / blurArea);
-        dst[2] = (unsigned char)(sum_b / blurArea);
-        if ( src_alpha )
-            dst_alpha[x] = (unsigned char)(sum_a / blurArea);
-
-        // Now average the values of the rest of the pixels by just moving the
-        // box along the column from top to bottom
-        for ( int y = 1; y < M_IMGDATA->m_height; y++ )
-        {
-            // Take care of pixels that would be beyond the top edge by
-            // duplicating the top edge pixel for the column
-            if ( y - blurRadius - 1 < 0 )
-                pixel_idx = x;
-            else
-                pixel_idx = x + (y - blurRadius - 1) * M_IMGDATA->m_width;
-
-            // Subtract the value of the pixel at the top of our blur radius box
-            src = src_data + pixel_idx*3;
-            sum_r -= src[0];
-            sum_g -= src[1];
-            sum_b -= src[2];
-            if ( src_alpha )
-                sum_a -= src_alpha[pixel_idx];
-
-            // Take care of the pixels that would be beyond the bottom edge of
-            // the image similar to the top edge
-            if ( y + blurRadius > M_IMGDATA->m_height - 1 )
-                pixel_idx = x + (M_IMGDATA->m_height - 1) * M_IMGDATA->m_width;
-            else
-                pixel_idx = x + (blurRadius + y) * M_IMGDATA->m_width;
+    wxVector<BicubicPrecalc> precalcs(newDim);
+    ResampleBicubicPrecalc(precalcs, oldDim);
 
-            // Add the value of the pixel being added to the end of our box
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
+    axis.taps = 4;
+    axis.offsets.resize(newDim*4);
+    axis.weights.resize(newDim*4);
 
-            // Save off the averaged data
-            dst = dst_data + (x + y * M_IMGDATA->m_width) * 3;
-            dst[0] = (unsigned char)(sum_r / blurArea);
-            dst[1] = (unsigned char)(sum_g / blurArea);
-            dst[2] = (unsigned char)(sum_b / blurArea);
-            if ( src_alpha )
-                dst_alpha[x + y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
+    for ( int n = 0; n < newDim; n++ )
+    {
+        for ( int k = 0; k < 4; k++ )
+        {
+            axis.offsets[n*4 + k] = precalcs[n].offset[k];
+            axis.weights[n*4 + k] = static_cast<float>(precalcs[n].weight[k]);
         }
     }
-
-    return ret_image;
 }
 
-// The new blur function
-wxImage wxImage::Blur(int blurRadius) const
-{
-    wxImage ret_image;
-    ret_image.Create(M_IMGDATA->m_width, M_IMGDATA->m_height, false);
+// Minimal set of operations on the intermediate pixels.
+#ifdef wxHAS_SSE2_RESAMPLE
 
-    // Blur the image in each direction
-    ret_image = BlurHorizontal(blurRadius);
-    ret_image = ret_image.BlurVertical(blurRadius);
+typedef __m128 ResamplePixel;
 
-    return ret_image;
+inline ResamplePixel PixelZero()
+{
+    return _mm_setzero_ps();
 }
 
-wxImage wxImage::Rotate90( bool clockwise ) const
+inline ResamplePixel PixelFromInts(int r, int g, int b, int a)
 {
-    wxImage image(MakeEmptyClone(Clone_SwapOrientation));
+    return _mm_cvtepi32_ps(_mm_setr_epi32(r, g, b, a));
+}
 
-    wxCHECK( image.IsOk(), image );
+inline ResamplePixel PixelLoad(const float* p)
+{
+    return _mm_loadu_ps(p);
+}
 
-    long height = M_IMGDATA->m_height;
+inline void PixelStore(float* p, ResamplePixel pixel)
+{
+    _mm_storeu_ps(p, pixel);
+}
+
+inline ResamplePixel PixelMulAdd(ResamplePixel acc, ResamplePixel pixel, float w)
+{
+    return _mm_add_ps(acc, _mm_mul_ps(pixel, _mm_set1_ps(w)));
+}
+
+#else // !wxHAS_SSE2_RESAMPLE
+
+struct ResamplePixel
+{
+    float c[4];
+};
+
+inline ResamplePixel PixelZero()
+{
+    const ResamplePixel pixel = { { 0, 0, 0, 0 } };
+    return pixel;
+}
+
+inline ResamplePixel PixelFromInts(int r, int g, int b, int a)
+{
+    const ResamplePixel pixel = { { float(r), float(g), float(b), float(a) } };
+    return pixel;
+}
+
+inline ResamplePixel PixelLoad(const float* p)
+{
+    const ResamplePixel pixel = { { p[0], p[1], p[2], p[3] } };
+    return pixel;
+}
+
+inline void PixelStore(float* p, ResamplePixel pixel)
+{
+    for ( int i = 0; i < 4; i++ )
+        p[i] = pixel.c[i];
+}
+
+inline ResamplePixel PixelMulAdd(ResamplePixel acc, ResamplePixel pixel, float w)
+{
+    for ( int i = 0; i < 4; i++ )
+        acc.c[i] += pixel.c[i] * w;
+    return acc;
+}
+
+#endif // wxHAS_SSE2_RESAMPLE/!wxHAS_SSE2_RESAMPLE
+
+inline ResamplePixel
+GetSourcePixel(const unsigned char* rgb, const unsigned char* alpha,
+               bool premultiply)
+{
+    if ( !alpha )
+        return PixelFromInts(rgb[0], rgb[1], rgb[2], 0);
+
+    const int a = *alpha;
+    if ( premultiply )
+        return PixelFromInts(rgb[0]*a, rgb[1]*a, rgb[2]*a, a);
+
+    return PixelFromInts(rgb[0], rgb[1], rgb[2], a);
+}
+
+enum ResampleFilter
+{
+    ResampleFilter_Box,
+    ResampleFilter_Bilinear,
+    ResampleFilter_Bicubic
+};
+
+// Compute the destination rows in [rowStart, rowEnd) range.
+void ResampleRows(const unsigned char* srcData,
+                  const unsigned char* srcAlpha,
+                  int srcWidth,
+                  unsigned char* dstData,
+                  unsigned char* dstAlpha,
+                  const ResampleAxis& hAxis,
+                  const ResampleAxis& vAxis,
+                  ResampleFilter filter,
+                  int rowStart,
+                  int rowEnd)
+{
+    const int dstWidth = hAxis.GetSize();
+
+    // Box and bicubic filters weight the colour of each pixel by its alpha,
+    // but bilinear interpolation has always treated all channels in the same
+    // way, so keep doing it.
+    const bool premultiply = srcAlpha && filter != ResampleFilter_Bilinear;
+
+    wxVector<float> row(4*srcWidth);
+    wxVector<const unsigned char*> rgbRows(vAxis.taps);
+    wxVector<const unsigned char*> alphaRows(vAxis.taps);
+
+    dstData += 3*static_cast<size_t>(rowStart)*dstWidth;
+    if ( dstAlpha )
+        dstAlpha += static_cast<size_t>(rowStart)*dstWidth;
+
+    float sum[4];
+
+    for ( int y = rowStart; y < rowEnd; y++ )
+    {
+        const int* const vOffsets = &vAxis.offsets[y*vAxis.taps];
+        const float* const vWeights = &vAxis.weights[y*vAxis.taps];
+
+        for ( int k = 0; k < vAxis.taps; k++ )
+        {
+            const size_t rowOffset = static_cast<size_t>(vOffsets[k])*srcWidth;
+
+            rgbRows[k] = srcData + 3*rowOffset;
+            alphaRows[k] = srcAlpha ? srcAlpha + rowOffset : NULL;
+        }
+
+        // Vertical pass: combine all the contributing source rows.
+        for ( int x = 0; x < srcWidth; x++ )
+        {
+            ResamplePixel acc = PixelZero();
+            for ( int k = 0; k < vAxis.taps; k++ )
+            {
+                const ResamplePixel
+                    pixel = GetSourcePixel(rgbRows[k] + 3*x,
+                                           srcAlpha ? alphaRows[k] + x : NULL,
+                                           premultiply);
+                acc = PixelMulAdd(acc, pixel, vWeights[k]);
+            }
+
+            PixelStore(&row[4*x], acc);
+        }
+
+        // Horizontal pass: compute the destination pixels from this row.
+        for ( int x = 0; x < dstWidth; x++ )
+        {
+            const int* const hOffsets = &hAxis.offsets[x*hAxis.taps];
+            const float* const hWeights = &hAxis.weights[x*hAxis.taps];
+
+            ResamplePixel acc = PixelZero();
+            for ( int k = 0; k < hAxis.taps; k++ )
+                acc = PixelMulAdd(acc, PixelLoad(&row[4*hOffsets[k]]), hWeights[k]);
+
+            PixelStore(sum, acc);
+
+            switch ( filter )
+            {
+                case ResampleFilter_Box:
+                    {
+                        // Note that the sums are integer and so computed
+                        // exactly for all but really huge boxes.
+                        const float count = static_cast<float>
+                                            (
+                                                hAxis.counts[x]*vAxis.counts[y]
+                                            );
+
+                        if ( srcAlpha )
+                        {
+                            for ( int i = 0; i < 3; i++ )
+                            {
+                                dstData[i] = sum[3]
+                                    ? static_cast<unsigned char>(sum[i] / sum[3])
+                                    : 0;
+                            }
+                            *dstAlpha++ = static_cast<unsigned char>(sum[3] / count);
+                        }
+                        else
+                        {
+                            for ( int i = 0; i < 3; i++ )
+                                dstData[i] = static_cast<unsigned char>(sum[i] / count);
+                        }
+                    }
+                    break;
+
+                case ResampleFilter_Bilinear:
+                    for ( int i = 0; i < 3; i++ )
+                        dstData[i] = static_cast<unsigned char>(sum[i] + .5f);
+
+                    if ( srcAlpha )
+                        *dstAlpha++ = static_cast<unsigned char>(sum[3] + .5f);
+                    break;
+
+                case ResampleFilter_Bicubic:
+                    if ( srcAlpha )
+                    {
+                        for ( int i = 0; i < 3; i++ )
+                        {
+                            dstData[i] = sum[3]
+                                ? static_cast<unsigned char>(sum[i] / sum[3] + .5f)
+                                : 0;
+                        }
+
+                        // Round the alpha too, as it would be otherwise
+                        // possible to get 254 for fully opaque pixels due to
+                        // the rounding errors.
+                        *dstAlpha++ = static_cast<unsigned char>(sum[3] + .5f);
+                    }
+                    else
+                    {
+                        for ( int i = 0; i < 3; i++ )
+                            dstData[i] = static_cast<unsigned char>(sum[i] + .5f);
+                    }
+                    break;
+            }
+
+            dstData += 3;
+        }
+    }
+}
+
+class ResampleProcessor : public wxImageBandProcessor
+{
+public:
+    ResampleProcessor(const wxImage& src,
+                      wxImage& dst,
+                      const ResampleAxis& hAxis,
+                      const ResampleAxis& vAxis,
+                      ResampleFilter filter)
+        : m_srcData(src.GetData()),
+          m_srcAlpha(src.GetAlpha()),
+          m_srcWidth(src.GetWidth()),
+          m_dstData(dst.GetData()),
+          m_dstAlpha(dst.GetAlpha()),
+          m_hAxis(hAxis),
+          m_vAxis(vAxis),
+          m_filter(filter)
+    {
+    }
+
+    virtual void ProcessBand(int start, int end) wxOVERRIDE
+    {
+        ResampleRows(m_srcData, m_srcAlpha, m_srcWidth,
+                     m_dstData, m_dstAlpha,
+                     m_hAxis, m_vAxis, m_filter,
+                     start, end);
+    }
+
+private:
+    const unsigned char* const m_srcData;
+    const unsigned char* const m_srcAlpha;
+    const int m_srcWidth;
+    unsigned char* const m_dstData;
+    unsigned char* const m_dstAlpha;
+    const ResampleAxis& m_hAxis;
+    const ResampleAxis& m_vAxis;
+    const ResampleFilter m_filter;
+
+    wxDECLARE_NO_COPY_CLASS(ResampleProcessor);
+};
+
+void ResampleImage(const wxImage& src,
+                   wxImage& dst,
+                   const ResampleAxis& hAxis,
+                   const ResampleAxis& vAxis,
+                   ResampleFilter filter)
+{
+    if ( src.HasAlpha() )
+        dst.SetAlpha();
+
+    ResampleProcessor processor(src, dst, hAxis, vAxis, filter);
+    ProcessImageBands(processor, dst.GetHeight(),
+                      src.GetWidth()*vAxis.taps + dst.GetWidth()*hAxis.taps);
+}
+
+} // anonymous namespace
+
+wxImage wxImage::ResampleBox(int width, int height) const
+{
+    // This function implements a simple pre-blur/box averaging method for
+    // downsampling that gives reasonably smooth results To scale the image
+    // down we will need to gather a grid of pixels of the size of the scale
+    // factor in each direction and then do an averaging of the pixels.
+
+    wxImage ret_image(width, height, false);
+
+    ResampleAxis hAxis, vAxis;
+    InitBoxAxis(hAxis, M_IMGDATA->m_width, width);
+    InitBoxAxis(vAxis, M_IMGDATA->m_height, height);
+
+    ResampleImage(*this, ret_image, hAxis, vAxis, ResampleFilter_Box);
+
+    return ret_image;
+}
+
+wxImage wxImage::ResampleBilinear(int width, int height) const
+{
+    // This function implements a Bilinear algorithm for resampling.
+    wxImage ret_image(width, height, false);
+
+    ResampleAxis hAxis, vAxis;
+    InitBilinearAxis(hAxis, M_IMGDATA->m_width, width);
+    InitBilinearAxis(vAxis, M_IMGDATA->m_height, height);
+
+    ResampleImage(*this, ret_image, hAxis, vAxis, ResampleFilter_Bilinear);
+
+    return ret_image;
+}
+
+// This is the bicubic resampling algorithm
+wxImage wxImage::ResampleBicubic(int width, int height) const
+{
+    // This function implements a Bicubic B-Spline algorithm for resampling.
+    // This method is certainly a little slower than wxImage's default pixel
+    // replication method, however for most reasonably sized images not being
+    // upsampled too much on a fairly average CPU this difference is hardly
+    // noticeable and the results are far more pleasing to look at.
+    //
+    // This particular bicubic algorithm does pixel weighting according to a
+    // B-Spline that basically implements a Gaussian bell-like weighting
+    // kernel. Because of this method the results may appear a bit blurry when
+    // upsampling by large factors.  This is basically because a slight
+    // gaussian blur is being performed to get the smooth look of the upsampled
+    // image.
+
+    // Edge pixels: 3-4 possible solutions
+    // - (Wrap/tile) Wrap the image, take the color value from the opposite
+    // side of the image.
+    // - (Mirror)    Duplicate edge pixels, so that pixel at coordinate (2, n),
+    // where n is nonpositive, will have the value of (2, 1).
+    // - (Ignore)    Simply ignore the edge pixels and apply the kernel only to
+    // pixels which do have all neighbours.
+    // - (Clamp)     Choose the nearest pixel along the border. This takes the
+    // border pixels and extends them out to infinity.
+    //
+    // NOTE: the offsets computed by ResampleBicubicPrecalc() are set for edge
+    // pixels using the "Mirror" method mentioned above
+
+    wxImage ret_image(width, height, false);
+
+    ResampleAxis hAxis, vAxis;
+    InitBicubicAxis(hAxis, M_IMGDATA->m_width, width);
+    InitBicubicAxis(vAxis, M_IMGDATA->m_height, height);
+
+    ResampleImage(*this, ret_image, hAxis, vAxis, ResampleFilter_Bicubic);
+
+    return ret_image;
+}
+
+namespace
+{
+
+// Divide the sums of the pixels values in the blur window by the window size.
+//
+// As the divisor is always the same, the (slow) division is replaced by the
+// multiplication by its precomputed reciprocal, using enough bits for the
+// result to be exactly the same as the result of the integer division.
+class BlurDivider
+{
+public:
+    // The sums are rounded instead of being truncated if round is true.
+    BlurDivider(int area, bool round)
+        : m_area(area),
+          m_add(round ? area / 2 : 0),
+          m_mul(area < MAX_AREA ? (wxUint64(1) << SHIFT) / area + 1 : 0)
+    {
+    }
+
+    unsigned char operator()(wxUint32 sum) const
+    {
+        sum += m_add;
+
+        // The result is exact as long as sum < 2^SHIFT/area, which is always
+        // the case for the areas smaller than MAX_AREA, but fall back to the
+        // normal division for (unrealistically) bigger ones.
+        return static_cast<unsigned char>
+               (
+                m_mul ? (sum * m_mul) >> SHIFT : sum / m_area
+               );
+    }
+
+private:
+    enum
+    {
+        SHIFT = 48,
+        MAX_AREA = 1 << 20
+    };
+
+    const wxUint32 m_area;
+    const wxUint32 m_add;
+    const wxUint64 m_mul;
+};
+
+// Blur a single line of the given number of pixels with N channels each.
+//
+// The edge pixels are duplicated as needed and the cost per pixel is
+// independent of the radius, as the sum of the values in the blur window is
+// updated when it moves instead of being recomputed.
+template <int N>
+void BlurLine(const unsigned char* src,
+              unsigned char* dst,
+              int count,
+              int radius,
+              const BlurDivider& divide)
+{
+    const int last = count - 1;
+
+    // Compute the sum for the first pixel: it consists of radius + 1 copies
+    // of the first pixel, all the pixels inside the line up to the radius and
+    // the copies of the last pixel if the line is shorter than the radius.
+    const int inside = wxMin(radius, last);
+
+    wxUint32 sum[N];
+    for ( int c = 0; c < N; c++ )
+    {
+        sum[c] = (radius + 1)*src[c] + (radius - inside)*src[last*N + c];
+        for ( int k = 1; k <= inside; k++ )
+            sum[c] += src[k*N + c];
+
+        dst[c] = divide(sum[c]);
+    }
+
+    for ( int x = 1; x < count; x++ )
+    {
+        const int left = x - radius - 1;
+        const int right = x + radius;
+
+        const unsigned char* const pl = src + (left < 0 ? 0 : left)*N;
+        const unsigned char* const pr = src + (right > last ? last : right)*N;
+
+        for ( int c = 0; c < N; c++ )
+        {
+            sum[c] += pr[c] - pl[c];
+            dst[x*N + c] = divide(sum[c]);
+        }
+    }
+}
+
+// Blur the rows [start, end) of the planar data in which each row has the
+// given number of bytes, i.e. compute the average of each byte with the bytes
+// at the same position in the neighbouring rows.
+//
+// Only the sums for the first row are computed entirely, then they're
+// updated using the rows entering and leaving the blur window, which is
+// cache-friendly and doesn't depend on the radius.
+void BlurRows(const unsigned char* src,
+              unsigned char* dst,
+              int rowLen,
+              int height,
+              int radius,
+              int start,
+              int end,
+              const BlurDivider& divide)
+{
+    const int last = height - 1;
+
+    wxVector<wxUint32> sums(rowLen);
+
+    // Compute the sums for the first row, taking into account the rows
+    // outside of the image which are copies of the first and last ones.
+    const int top = start - radius;
+    const int bottom = start + radius;
+    const int firstInside = wxMax(top, 0);
+    const int lastInside = wxMin(bottom, last);
+
+    const unsigned char* const firstRow = src;
+    const unsigned char* const lastRow = src + static_cast<size_t>(last)*rowLen;
+    const wxUint32 firstCopies = firstInside - top;
+    const wxUint32 lastCopies = bottom - lastInside;
+
+    for ( int i = 0; i < rowLen; i++ )
+        sums[i] = firstCopies*firstRow[i] + lastCopies*lastRow[i];
+
+    for ( int y = firstInside; y <= lastInside; y++ )
+    {
+        const unsigned char* const row = src + static_cast<size_t>(y)*rowLen;
+        for ( int i = 0; i < rowLen; i++ )
+            sums[i] += row[i];
+    }
+
+    for ( int y = start; y < end; y++ )
+    {
+        if ( y > start )
+        {
+            const int leaving = y - radius - 1;
+            const int entering = y + radius;
+
+            const unsigned char* const pl =
+                src + static_cast<size_t>(leaving < 0 ? 0 : leaving)*rowLen;
+            const unsigned char* const pe =
+                src + static_cast<size_t>(entering > last ? last : entering)*rowLen;
+
+            for ( int i = 0; i < rowLen; i++ )
+                sums[i] += pe[i] - pl[i];
+        }
+
+        unsigned char* const out = dst + static_cast<size_t>(y)*rowLen;
+        for ( int i = 0; i < rowLen; i++ )
+            out[i] = divide(sums[i]);
+    }
+}
+
+class BlurProcessor : public wxImageBandProcessor
+{
+public:
+    BlurProcessor(const wxImage& src,
+                  wxImage& dst,
+                  int blurRadius,
+                  bool horizontal,
+                  bool round)
+        : m_src_data(src.GetData()),
+          m_src_alpha(src.GetAlpha()),
+          m_dst_data(dst.GetData()),
+          m_dst_alpha(dst.GetAlpha()),
+          m_width(src.GetWidth()),
+          m_height(src.GetHeight()),
+          m_blurRadius(blurRadius),
+          m_horizontal(horizontal),
+          m_divide(blurRadius*2 + 1, round)
+    {
+    }
+
+    // Process the given range of rows: notice that we always split the image
+    // in bands of rows, even for the vertical blur.
+    virtual void ProcessBand(int start, int end) wxOVERRIDE
+    {
+        if ( m_horizontal )
+        {
+            for ( int y = start; y < end; y++ )
+            {
+                const size_t offset = static_cast<size_t>(y)*m_width;
+
+                BlurLine<3>(m_src_data + 3*offset, m_dst_data + 3*offset,
+                            m_width, m_blurRadius, m_divide);
+                if ( m_src_alpha )
+                {
+                    BlurLine<1>(m_src_alpha + offset, m_dst_alpha + offset,
+                                m_width, m_blurRadius, m_divide);
+                }
+            }
+        }
+        else
+        {
+            BlurRows(m_src_data, m_dst_data, 3*m_width, m_height,
+                     m_blurRadius, start, end, m_divide);
+            if ( m_src_alpha )
+            {
+                BlurRows(m_src_alpha, m_dst_alpha, m_width, m_height,
+                         m_blurRadius, start, end, m_divide);
+            }
+        }
+    }
+
+private:
+    const unsigned char* const m_src_data;
+    const unsigned char* const m_src_alpha;
+    unsigned char* const m_dst_data;
+    unsigned char* const m_dst_alpha;
+    const int m_width;
+    const int m_height;
+    const int m_blurRadius;
+    const bool m_horizontal;
+    const BlurDivider m_divide;
+
+    wxDECLARE_NO_COPY_CLASS(BlurProcessor);
+};
+
+// Blur the source image into the destination one which must have the same
+// size and alpha presence.
+void BlurImage(const wxImage& src,
+               wxImage& dst,
+               int blurRadius,
+               bool horizontal,
+               bool round = false)
+{
+    BlurProcessor processor(src, dst, blurRadius, horizontal, round);
+    ProcessImageBands(processor, src.GetHeight(), src.GetWidth());
+}
+
+} // anonymous namespace
+
+// Blur in the horizontal direction
+wxImage wxImage::BlurHorizontal(int blurRadius) const
+{
+    wxImage ret_image(MakeEmptyClone());
+
+    wxCHECK( ret_image.IsOk(), ret_image );
+
+    BlurImage(*this, ret_image, blurRadius, true /* horizontal */);
+
+    return ret_image;
+}
+
+// Blur in the vertical direction
+wxImage wxImage::BlurVertical(int blurRadius) const
+{
+    wxImage ret_image(MakeEmptyClone());
+
+    wxCHECK( ret_image.IsOk(), ret_image );
+
+    BlurImage(*this, ret_image, blurRadius, false /* vertical */);
+
+    return ret_image;
+}
+
+// The new blur function
+wxImage wxImage::Blur(int blurRadius) const
+{
+    // Blur the image in each direction
+    return BlurHorizontal(blurRadius).BlurVertical(blurRadius);
+}
+
+wxImage wxImage::GaussianBlur(double sigma) const
+{
+    wxImage ret_image(MakeEmptyClone());
+
+    wxCHECK( ret_image.IsOk(), ret_image );
+    wxCHECK_MSG( sigma >= 0, ret_image, wxS("invalid standard deviation") );
+
+    // Approximate the Gaussian blur by applying a box blur several times in
+    // each direction, choosing the widths of the boxes (which must be odd)
+    // so that the variance of the result is as close to sigma^2 as possible.
+    static const int NUM_BOXES = 3;
+
+    const double variance = sigma*sigma;
+    int lower = static_cast<int>(floor(sqrt(12*variance/NUM_BOXES + 1)));
+    if ( lower % 2 == 0 )
+        lower--;
+    const int upper = lower + 2;
+
+    // The number of the passes using the smaller box.
+    const int numLower = wxRound((12*variance - NUM_BOXES*lower*lower
+                                  - 4*NUM_BOXES*lower - 3*NUM_BOXES)
+                                 / (-4*lower - 4));
+
+    // Alternate between the two images to avoid allocating a new one for
+    // each pass. Also notice that the intermediate results are rounded to
+    // avoid darkening the image due to the accumulated truncation errors.
+    wxImage tmp_image(MakeEmptyClone());
+    wxImage* const images[2] = { &ret_image, &tmp_image };
+
+    const wxImage* src = this;
+    for ( int pass = 0; pass < 2*NUM_BOXES; pass++ )
+    {
+        const int box = pass % NUM_BOXES;
+        const int width = box < numLower ? lower : upper;
+
+        wxImage& dst = *images[pass % 2];
+        BlurImage(*src, dst, (width - 1) / 2, pass < NUM_BOXES, true);
+        src = &dst;
+    }
+
+    return *src;
+}
+
+wxImage wxImage::Rotate90( bool clockwise ) const
+{
+    wxImage image(MakeEmptyClone(Clone_SwapOrientation));
+
+    wxCHECK( image.IsOk(), image );
+
+    long height = M_IMGDATA->m_height;
     long width  = M_IMGDATA->m_width;
 
     if ( HasOption(wxIMAGE_OPTION_CUR_HOTSPOT_X) )
@@ -1826,6 +2246,68 @@ wxImage wxImage::ConvertToGreyscale(void) const
     return ConvertToGreyscale(0.299, 0.587, 0.114);
 }
 
+namespace
+{
+
+class GreyscaleProcessor : public wxImageBandProcessor
+{
+public:
+    GreyscaleProcessor(const unsigned char* src,
+                       unsigned char* dst,
+                       int width,
+                       double weight_r, double weight_g, double weight_b,
+                       bool hasMask,
+                       unsigned char mask_r,
+                       unsigned char mask_g,
+                       unsigned char mask_b)
+        : m_src(src),
+          m_dst(dst),
+          m_width(width),
+          m_weight_r(weight_r),
+          m_weight_g(weight_g),
+          m_weight_b(weight_b),
+          m_hasMask(hasMask),
+          m_mask_r(mask_r),
+          m_mask_g(mask_g),
+          m_mask_b(mask_b)
+    {
+    }
+
+    virtual void ProcessBand(int start, int end) wxOVERRIDE
+    {
+        const unsigned char* src = m_src + 3*static_cast<size_t>(start)*m_width;
+        unsigned char* dst = m_dst + 3*static_cast<size_t>(start)*m_width;
+        size_t size = static_cast<size_t>(end - start)*m_width;
+        while (size--)
+        {
+            unsigned char r = *src++;
+            unsigned char g = *src++;
+            unsigned char b = *src++;
+            if (!m_hasMask || r != m_mask_r || g != m_mask_g || b != m_mask_b)
+                wxColour::MakeGrey(&r, &g, &b, m_weight_r, m_weight_g, m_weight_b);
+            *dst++ = r;
+            *dst++ = g;
+            *dst++ = b;
+        }
+    }
+
+private:
+    const unsigned char* const m_src;
+    unsigned char* const m_dst;
+    const int m_width;
+    const double m_weight_r,
+                 m_weight_g,
+                 m_weight_b;
+    const bool m_hasMask;
+    const unsigned char m_mask_r,
+                        m_mask_g,
+                        m_mask_b;
+
+    wxDECLARE_NO_COPY_CLASS(GreyscaleProcessor);
+};
+
+} // anonymous namespace
+
 wxImage wxImage::ConvertToGreyscale(double weight_r, double weight_g, double weight_b) const
 {
     wxImage image;
@@ -1848,19 +2330,11 @@ wxImage wxImage::ConvertToGreyscale(double weight_r, double weight_g, double wei
     if (hasMask)
         image.SetMaskColour(mask_r, mask_g, mask_b);
 
-    const unsigned char* src = M_IMGDATA->m_data;
-    unsigned char* dst = image.GetData();
-    while (size--)
-    {
-        unsigned char r = *src++;
-        unsigned char g = *src++;
-        unsigned char b = *src++;
-        if (!hasMask || r != mask_r || g != mask_g || b != mask_b)
-            wxColour::MakeGrey(&r, &g, &b, weight_r, weight_g, weight_b);
-        *dst++ = r;
-        *dst++ = g;
-        *dst++ = b;
-    }
+    GreyscaleProcessor processor(M_IMGDATA->m_data, image.GetData(), w,
+                                 weight_r, weight_g, weight_b,
+                                 hasMask, mask_r, mask_g, mask_b);
+    ProcessImageBands(processor, h, w);
+
     return image;
 }
 
@@ -2251,6 +2725,95 @@ void wxImage::ClearAlpha()
     M_IMGDATA->m_alpha = NULL;
 }
 
+namespace
+{
+
+class InterleaveProcessor : public wxImageBandProcessor
+{
+public:
+    InterleaveProcessor(const unsigned char* data,
+                        const unsigned char* alpha,
+                        int width,
+                        wxImagePixelFormat format,
+                        unsigned char* dst,
+                        size_t stride)
+        : m_data(data), m_alpha(alpha), m_width(width),
+          m_format(format), m_dst(dst), m_stride(stride)
+    {
+    }
+
+    virtual void ProcessBand(int start, int end) wxOVERRIDE
+    {
+        for ( int y = start; y < end; y++ )
+            ProcessRow(y);
+    }
+
+private:
+    void ProcessRow(int y)
+    {
+        const size_t offset = static_cast<size_t>(y) * m_width;
+        const unsigned char* src = m_data + 3*offset;
+        const unsigned char* alpha = m_alpha ? m_alpha + offset : NULL;
+        unsigned char* const row = m_dst + y * m_stride;
+
+        if ( m_format == wxIMAGE_PIXEL_FORMAT_RGBA )
+        {
+            unsigned char* dst = row;
+            for ( int n = 0; n < m_width; n++ )
+            {
+                *dst++ = *src++;
+                *dst++ = *src++;
+                *dst++ = *src++;
+                *dst++ = alpha ? *alpha++ : wxIMAGE_ALPHA_OPAQUE;
+            }
+        }
+        else // wxIMAGE_PIXEL_FORMAT_BGRA_PREMULTIPLIED
+        {
+            // use the same rounding as wxGraphicsContext implementations
+            wxUint32* dst = reinterpret_cast<wxUint32*>(row);
+            for ( int n = 0; n < m_width; n++, src += 3 )
+            {
+                const unsigned a = alpha ? *alpha++ : wxIMAGE_ALPHA_OPAQUE;
+                *dst++ = a                 << 24 |
+                         (a * src[0] / 255) << 16 |
+                         (a * src[1] / 255) <<  8 |
+                         (a * src[2] / 255);
+            }
+        }
+    }
+
+    const unsigned char* const m_data;
+    const unsigned char* const m_alpha;
+    const int m_width;
+    const wxImagePixelFormat m_format;
+    unsigned char* const m_dst;
+    const size_t m_stride;
+
+    wxDECLARE_NO_COPY_CLASS(InterleaveProcessor);
+};
+
+} // anonymous namespace
+
+bool wxImage::GetInterleavedData(wxImagePixelFormat format,
+                                 unsigned char *buffer,
+                                 int stride) const
+{
+    wxCHECK_MSG( IsOk(), false, wxT("invalid image") );
+    wxCHECK_MSG( buffer, false, wxT("NULL buffer") );
+
+    const wxImageRefData* const data = M_IMGDATA;
+    if ( !stride )
+        stride = 4 * data->m_width;
+
+    wxCHECK_MSG( stride >= 4 * data->m_width, false, wxT("stride too small") );
+
+    InterleaveProcessor processor(data->m_data, data->m_alpha, data->m_width,
+                                  format, buffer, stride);
+    ProcessImageBands(processor, data->m_height, data->m_width);
+
+    return true;
+}
+
 
 // ----------------------------------------------------------------------------
 // mask support
@@ -2556,6 +3119,20 @@ int wxImage::GetDefaultLoadFlags()
     return wxImageRefData::sm_defaultLoadFlags;
 }
 
+/* static */
+void wxImage::SetMaxThreads(int count)
+{
+    wxCHECK_RET( count >= 0, wxS("invalid number of threads") );
+
+    gs_maxThreads = count;
+}
+
+/* static */
+int wxImage::GetMaxThreads()
+{
+    return gs_maxThreads;
+}
+
 void wxImage::SetLoadFlags(int flags)
 {
     AllocExclusive();
@@ -2960,44 +3537,134 @@ bool wxImage::LoadFile( wxInputStream& stream, wxBitmapType type, int index )
     {
         if ( verbose )
         {
-            wxLogError(_("This is not a %s."), handler->GetName());
+            wxLogError(_("This is not a %s."), handler->GetName());
+        }
+        return false;
+    }
+
+    return DoLoad(*handler, stream, index);
+}
+
+bool wxImage::LoadFile( wxInputStream& stream, const wxString& mimetype, int index )
+{
+    UnRef();
+
+    m_refData = new wxImageRefData;
+
+    wxImageHandler *handler = FindHandlerMime(mimetype);
+
+    // do we issue warning/error messages?
+    const bool verbose = M_IMGDATA->m_loadFlags & Load_Verbose;
+
+    if ( !handler )
+    {
+        if ( verbose )
+        {
+            wxLogWarning( _("No image handler for type %s defined."), mimetype.GetData() );
+        }
+        return false;
+    }
+
+    if ( stream.IsSeekable() && !handler->CanRead(stream) )
+    {
+        if ( verbose )
+        {
+            wxLogError(_("Image is not of type %s."), mimetype);
+        }
+        return false;
+    }
+
+    return DoLoad(*handler, stream, index);
+}
+
+/* static */
+bool wxImage::LoadRows( wxImageRowConsumer& consumer, wxInputStream& stream,
+                        wxBitmapType type, int index )
+{
+    const bool verbose = (GetDefaultLoadFlags() & Load_Verbose) != 0;
+
+    wxImageHandler *handler = NULL;
+    if ( type == wxBITMAP_TYPE_ANY )
+    {
+        if ( !stream.IsSeekable() )
+        {
+            if ( verbose )
+            {
+                wxLogError(_("Can't automatically determine the image format "
+                             "for non-seekable input."));
+            }
+            return false;
+        }
+
+        // unlike LoadFile(), don't try the other handlers if the first one
+        // recognizing the data fails, as some rows could have been already
+        // passed to the consumer by it
+        const wxList& list = GetHandlers();
+        for ( wxList::compatibility_iterator node = list.GetFirst();
+              node;
+              node = node->GetNext() )
+        {
+            wxImageHandler * const h = (wxImageHandler*)node->GetData();
+            if ( h->CanRead(stream) )
+            {
+                handler = h;
+                break;
+            }
+        }
+
+        if ( !handler )
+        {
+            if ( verbose )
+            {
+                wxLogWarning( _("Unknown image data format.") );
+            }
+            return false;
+        }
+    }
+    else
+    {
+        handler = FindHandler(type);
+        if ( !handler )
+        {
+            if ( verbose )
+            {
+                wxLogWarning( _("No image handler for type %d defined."), type );
+            }
+            return false;
+        }
+
+        if ( stream.IsSeekable() && !handler->CanRead(stream) )
+        {
+            if ( verbose )
+            {
+                wxLogError(_("This is not a %s."), handler->GetName());
+            }
+            return false;
         }
-        return false;
     }
 
-    return DoLoad(*handler, stream, index);
+    return handler->LoadRows(consumer, stream, verbose, index);
 }
 
-bool wxImage::LoadFile( wxInputStream& stream, const wxString& mimetype, int index )
+/* static */
+bool wxImage::LoadRows( wxImageRowConsumer& WXUNUSED_UNLESS_STREAMS(consumer),
+                        const wxString& WXUNUSED_UNLESS_STREAMS(filename),
+                        wxBitmapType WXUNUSED_UNLESS_STREAMS(type),
+                        int WXUNUSED_UNLESS_STREAMS(index) )
 {
-    UnRef();
-
-    m_refData = new wxImageRefData;
-
-    wxImageHandler *handler = FindHandlerMime(mimetype);
-
-    // do we issue warning/error messages?
-    const bool verbose = M_IMGDATA->m_loadFlags & Load_Verbose;
-
-    if ( !handler )
+#if HAS_FILE_STREAMS
+    wxImageFileInputStream stream(filename);
+    if ( stream.IsOk() )
     {
-        if ( verbose )
-        {
-            wxLogWarning( _("No image handler for type %s defined."), mimetype.GetData() );
-        }
-        return false;
+        wxBufferedInputStream bstream( stream );
+        if ( LoadRows(consumer, bstream, type, index) )
+            return true;
     }
 
-    if ( stream.IsSeekable() && !handler->CanRead(stream) )
-    {
-        if ( verbose )
-        {
-            wxLogError(_("Image is not of type %s."), mimetype);
-        }
-        return false;
-    }
+    wxLogError(_("Failed to load image from file \"%s\"."), filename);
+#endif // HAS_FILE_STREAMS
 
-    return DoLoad(*handler, stream, index);
+    return false;
 }
 
 bool wxImage::DoSave(wxImageHandler& handler, wxOutputStream& stream) const
@@ -3321,40 +3988,69 @@ wxImage::RGBValue wxImage::HSVtoRGB(const HSVValue& hsv)
  * Rotates the hue of each pixel of the image. angle is a double in the range
  * -1.0..1.0 where -1.0 is -360 degrees and 1.0 is 360 degrees
  */
-void wxImage::RotateHue(double angle)
+namespace
 {
-    AllocExclusive();
 
-    unsigned long count;
-    wxImage::HSVValue hsv;
-    wxImage::RGBValue rgb;
+class RotateHueProcessor : public wxImageBandProcessor
+{
+public:
+    RotateHueProcessor(unsigned char* data, int width, double angle)
+        : m_data(data),
+          m_width(width),
+          m_angle(angle)
+    {
+    }
 
-    wxASSERT (angle >= -1.0 && angle <= 1.0);
-    count = M_IMGDATA->m_width * M_IMGDATA->m_height;
-    if ( count > 0 && !wxIsNullDouble(angle) )
+    virtual void ProcessBand(int start, int end) wxOVERRIDE
     {
-        unsigned char* srcBytePtr;
-        unsigned char* dstBytePtr;
-        srcBytePtr = M_IMGDATA->m_data;
-        dstBytePtr = srcBytePtr;
-        do
+        wxImage::HSVValue hsv;
+        wxImage::RGBValue rgb;
+
+        unsigned char* srcBytePtr = m_data + 3*static_cast<size_t>(start)*m_width;
+        unsigned char* dstBytePtr = srcBytePtr;
+        for ( size_t count = static_cast<size_t>(end - start)*m_width;
+              count != 0;
+              --count )
         {
             rgb.red = *srcBytePtr++;
             rgb.green = *srcBytePtr++;
             rgb.blue = *srcBytePtr++;
-            hsv = RGBtoHSV(rgb);
+            hsv = wxImage::RGBtoHSV(rgb);
 
-            hsv.hue = hsv.hue + angle;
+            hsv.hue = hsv.hue + m_angle;
             if (hsv.hue > 1.0)
                 hsv.hue = hsv.hue - 1.0;
             else if (hsv.hue < 0.0)
                 hsv.hue = hsv.hue + 1.0;
 
-            rgb = HSVtoRGB(hsv);
+            rgb = wxImage::HSVtoRGB(hsv);
             *dstBytePtr++ = rgb.red;
             *dstBytePtr++ = rgb.green;
             *dstBytePtr++ = rgb.blue;
-        } while (--count != 0);
+        }
+    }
+
+private:
+    unsigned char* const m_data;
+    const int m_width;
+    const double m_angle;
+
+    wxDECLARE_NO_COPY_CLASS(RotateHueProcessor);
+};
+
+} // anonymous namespace
+
+void wxImage::RotateHue(double angle)
+{
+    AllocExclusive();
+
+    wxASSERT (angle >= -1.0 && angle <= 1.0);
+    if ( M_IMGDATA->m_width > 0 && M_IMGDATA->m_height > 0 &&
+            !wxIsNullDouble(angle) )
+    {
+        RotateHueProcessor processor(M_IMGDATA->m_data, M_IMGDATA->m_width,
+                                     angle);
+        ProcessImageBands(processor, M_IMGDATA->m_height, M_IMGDATA->m_width);
     }
 }
 
@@ -3388,6 +4084,66 @@ int wxImageHandler::GetImageCount( wxInputStream& stream )
     return n;
 }
 
+bool wxImageHandler::LoadRows( wxImageRowConsumer& consumer,
+                               wxInputStream& stream,
+                               bool verbose,
+                               int index )
+{
+    wxImage image;
+    if ( !LoadFile(&image, stream, verbose, index) )
+        return false;
+
+    return SendImageRows(image, consumer);
+}
+
+/* static */
+bool wxImageHandler::SendImageRows(const wxImage& image,
+                                   wxImageRowConsumer& consumer)
+{
+    const int width = image.GetWidth(),
+              height = image.GetHeight();
+    const bool hasMask = image.HasMask() && !image.HasAlpha();
+
+    if ( !consumer.OnStart(width, height, image.HasAlpha() || hasMask) )
+        return false;
+
+    const unsigned char* rgb = image.GetData();
+    const unsigned char* alpha = image.GetAlpha();
+
+    const unsigned char mr = image.GetMaskRed(),
+                        mg = image.GetMaskGreen(),
+                        mb = image.GetMaskBlue();
+
+    wxVector<unsigned char> maskAlpha;
+    if ( hasMask )
+        maskAlpha.resize(width);
+
+    for ( int y = 0; y < height; y++ )
+    {
+        if ( hasMask )
+        {
+            for ( int x = 0; x < width; x++ )
+            {
+                const unsigned char* const p = rgb + 3*x;
+                maskAlpha[x] = p[0] == mr && p[1] == mg && p[2] == mb
+                                ? wxIMAGE_ALPHA_TRANSPARENT
+                                : wxIMAGE_ALPHA_OPAQUE;
+            }
+
+            alpha = &maskAlpha[0];
+        }
+
+        if ( !consumer.OnRow(y, rgb, alpha) )
+            return false;
+
+        rgb += 3*width;
+        if ( alpha && !hasMask )
+            alpha += width;
+    }
+
+    return true;
+}
+
 bool wxImageHandler::CanRead( const wxString& name )
 {
     wxImageFileInputStream stream(name);
@@ -3573,6 +4329,261 @@ wxRotatePoint(double x, double y, double cos_angle, double sin_angle,
     return wxRotatePoint (wxRealPoint(x,y), cos_angle, sin_angle, p0);
 }
 
+namespace
+{
+
+class RotateProcessor : public wxImageBandProcessor
+{
+public:
+    RotateProcessor(unsigned char** data,
+                    unsigned char** alpha,
+                    int w, int h,
+                    double cos_angle, double sin_angle,
+                    const wxRealPoint& p0,
+                    int x1a, int y1a,
+                    wxImage& rotated,
+                    unsigned char blank_r,
+                    unsigned char blank_g,
+                    unsigned char blank_b,
+                    bool interpolating)
+        : m_data(data),
+          m_alpha(alpha),
+          m_w(w),
+          m_h(h),
+          m_cos_angle(cos_angle),
+          m_sin_angle(sin_angle),
+          m_p0(p0),
+          m_x1a(x1a),
+          m_y1a(y1a),
+          m_rW(rotated.GetWidth()),
+          m_has_alpha(alpha != NULL),
+          m_dst(rotated.GetData()),
+          m_alpha_dst(rotated.GetAlpha()),
+          m_blank_r(blank_r),
+          m_blank_g(blank_g),
+          m_blank_b(blank_b),
+          m_interpolating(interpolating)
+    {
+    }
+
+    virtual void ProcessBand(int start, int end) wxOVERRIDE
+    {
+        // the rotated (destination) image is always accessed sequentially via
+        // this pointer, there is no need for pointer-based arrays here
+        unsigned char *dst = m_dst + 3*static_cast<size_t>(start)*m_rW;
+
+        unsigned char *alpha_dst = m_has_alpha
+                                    ? m_alpha_dst + static_cast<size_t>(start)*m_rW
+                                    : NULL;
+
+        // do the (interpolating) test outside of the loops, so that it is done
+        // only once, instead of repeating it for each pixel.
+        if (m_interpolating)
+        {
+            for (int y = start; y < end; y++)
+            {
+                for (int x = 0; x < m_rW; x++)
+                {
+                    wxRealPoint src = wxRotatePoint (x + m_x1a, y + m_y1a, m_cos_angle, -m_sin_angle, m_p0);
+
+                    if (-0.25 < src.x && src.x < m_w - 0.75 &&
+                        -0.25 < src.y && src.y < m_h - 0.75)
+                    {
+                        // interpolate using the 4 enclosing grid-points.  Those
+                        // points can be obtained using floor and ceiling of the
+                        // exact coordinates of the point
+                        int x1, y1, x2, y2;
+
+                        if (0 < src.x && src.x < m_w - 1)
+                        {
+                            x1 = wxRound(floor(src.x));
+                            x2 = wxRound(ceil(src.x));
+                        }
+                        else    // else means that x is near one of the borders (0 or width-1)
+                        {
+                            x1 = x2 = wxRound (src.x);
+                        }
+
+                        if (0 < src.y && src.y < m_h - 1)
+                        {
+                            y1 = wxRound(floor(src.y));
+                            y2 = wxRound(ceil(src.y));
+                        }
+                        else
+                        {
+                            y1 = y2 = wxRound (src.y);
+                        }
+
+                        // get four points and the distances (square of the distance,
+                        // for efficiency reasons) for the interpolation formula
+
+                        // GRG: Do not calculate the points until they are
+                        //      really needed -- this way we can calculate
+                        //      just one, instead of four, if d1, d2, d3
+                        //      or d4 are < wxROTATE_EPSILON
+
+                        const double d1 = (src.x - x1) * (src.x - x1) + (src.y - y1) * (src.y - y1);
+                        const double d2 = (src.x - x2) * (src.x - x2) + (src.y - y1) * (src.y - y1);
+                        const double d3 = (src.x - x2) * (src.x - x2) + (src.y - y2) * (src.y - y2);
+                        const double d4 = (src.x - x1) * (src.x - x1) + (src.y - y2) * (src.y - y2);
+
+                        // Now interpolate as a weighted average of the four surrounding
+                        // points, where the weights are the distances to each of those points
+
+                        // If the point is exactly at one point of the grid of the source
+                        // image, then don't interpolate -- just assign the pixel
+
+                        // d1,d2,d3,d4 are positive -- no need for abs()
+                        if (d1 < wxROTATE_EPSILON)
+                        {
+                            unsigned char *p = m_data[y1] + (3 * x1);
+                            *(dst++) = *(p++);
+                            *(dst++) = *(p++);
+                            *(dst++) = *p;
+
+                            if (m_has_alpha)
+                                *(alpha_dst++) = *(m_alpha[y1] + x1);
+                        }
+                        else if (d2 < wxROTATE_EPSILON)
+                        {
+                            unsigned char *p = m_data[y1] + (3 * x2);
+                            *(dst++) = *(p++);
+                            *(dst++) = *(p++);
+                            *(dst++) = *p;
+
+                            if (m_has_alpha)
+                                *(alpha_dst++) = *(m_alpha[y1] + x2);
+                        }
+                        else if (d3 < wxROTATE_EPSILON)
+                        {
+                            unsigned char *p = m_data[y2] + (3 * x2);
+                            *(dst++) = *(p++);
+                            *(dst++) = *(p++);
+                            *(dst++) = *p;
+
+                            if (m_has_alpha)
+                                *(alpha_dst++) = *(m_alpha[y2] + x2);
+                        }
+                        else if (d4 < wxROTATE_EPSILON)
+                        {
+                            unsigned char *p = m_data[y2] + (3 * x1);
+                            *(dst++) = *(p++);
+                            *(dst++) = *(p++);
+                            *(dst++) = *p;
+
+                            if (m_has_alpha)
+                                *(alpha_dst++) = *(m_alpha[y2] + x1);
+                        }
+                        else
+                        {
+                            // weights for the weighted average are proportional to the inverse of the distance
+                            unsigned char *v1 = m_data[y1] + (3 * x1);
+                            unsigned char *v2 = m_data[y1] + (3 * x2);
+                            unsigned char *v3 = m_data[y2] + (3 * x2);
+                            unsigned char *v4 = m_data[y2] + (3 * x1);
+
+                            const double w1 = 1/d1, w2 = 1/d2, w3 = 1/d3, w4 = 1/d4;
+
+                            // GRG: Unrolled.
+
+                            *(dst++) = (unsigned char)
+                                ( (w1 * *(v1++) + w2 * *(v2++) +
+                                   w3 * *(v3++) + w4 * *(v4++)) /
+                                  (w1 + w2 + w3 + w4) );
+                            *(dst++) = (unsigned char)
+                                ( (w1 * *(v1++) + w2 * *(v2++) +
+                                   w3 * *(v3++) + w4 * *(v4++)) /
+                                  (w1 + w2 + w3 + w4) );
+                            *(dst++) = (unsigned char)
+                                ( (w1 * *v1 + w2 * *v2 +
+                                   w3 * *v3 + w4 * *v4) /
+                                  (w1 + w2 + w3 + w4) );
+
+                            if (m_has_alpha)
+                            {
+                                v1 = m_alpha[y1] + (x1);
+                                v2 = m_alpha[y1] + (x2);
+                                v3 = m_alpha[y2] + (x2);
+                                v4 = m_alpha[y2] + (x1);
+
+                                *(alpha_dst++) = (unsigned char)
+                                    ( (w1 * *v1 + w2 * *v2 +
+                                       w3 * *v3 + w4 * *v4) /
+                                      (w1 + w2 + w3 + w4) );
+                            }
+                        }
+                    }
+                    else
+                    {
+                        *(dst++) = m_blank_r;
+                        *(dst++) = m_blank_g;
+                        *(dst++) = m_blank_b;
+
+                        if (m_has_alpha)
+                            *(alpha_dst++) = 0;
+                    }
+                }
+            }
+        }
+        else // not m_interpolating
+        {
+            for (int y = start; y < end; y++)
+            {
+                for (int x = 0; x < m_rW; x++)
+                {
+                    wxRealPoint src = wxRotatePoint (x + m_x1a, y + m_y1a, m_cos_angle, -m_sin_angle, m_p0);
+
+                    const int xs = wxRound (src.x);      // wxRound rounds to the
+                    const int ys = wxRound (src.y);      // closest integer
+
+                    if (0 <= xs && xs < m_w && 0 <= ys && ys < m_h)
+                    {
+                        unsigned char *p = m_data[ys] + (3 * xs);
+                        *(dst++) = *(p++);
+                        *(dst++) = *(p++);
+                        *(dst++) = *p;
+
+                        if (m_has_alpha)
+                            *(alpha_dst++) = *(m_alpha[ys] + (xs));
+                    }
+                    else
+                    {
+                        *(dst++) = m_blank_r;
+                        *(dst++) = m_blank_g;
+                        *(dst++) = m_blank_b;
+
+                        if (m_has_alpha)
+                            *(alpha_dst++) = 255;
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    unsigned char** const m_data;
+    unsigned char** const m_alpha;
+    const int m_w,
+              m_h;
+    const double m_cos_angle,
+                 m_sin_angle;
+    const wxRealPoint m_p0;
+    const int m_x1a,
+              m_y1a;
+    const int m_rW;
+    const bool m_has_alpha;
+    unsigned char* const m_dst;
+    unsigned char* const m_alpha_dst;
+    const unsigned char m_blank_r,
+                        m_blank_g,
+                        m_blank_b;
+    const bool m_interpolating;
+
+    wxDECLARE_NO_COPY_CLASS(RotateProcessor);
+};
+
+} // anonymous namespace
+
 wxImage wxImage::Rotate(double angle,
                         const wxPoint& centre_of_rotation,
                         bool interpolating,
@@ -3635,12 +4646,6 @@ wxImage wxImage::Rotate(double angle,
         *offset_after_rotation = wxPoint (x1a, y1a);
     }
 
-    // the rotated (destination) image is always accessed sequentially via this
-    // pointer, there is no need for pointer-based arrays here
-    unsigned char *dst = rotated.GetData();
-
-    unsigned char *alpha_dst = has_alpha ? rotated.GetAlpha() : NULL;
-
     // if the original image has a mask, use its RGB values as the blank pixel,
     // else, fall back to default (black).
     unsigned char blank_r = 0;
@@ -3658,192 +4663,10 @@ wxImage wxImage::Rotate(double angle,
     // Now, for each point of the rotated image, find where it came from, by
     // performing an inverse rotation (a rotation of -angle) and getting the
     // pixel at those coordinates
-
-    const int rH = rotated.GetHeight();
-    const int rW = rotated.GetWidth();
-
-    // do the (interpolating) test outside of the loops, so that it is done
-    // only once, instead of repeating it for each pixel.
-    if (interpolating)
-    {
-        for (int y = 0; y < rH; y++)
-        {
-            for (int x = 0; x < rW; x++)
-            {
-                wxRealPoint src = wxRotatePoint (x + x1a, y + y1a, cos_angle, -sin_angle, p0);
-
-                if (-0.25 < src.x && src.x < w - 0.75 &&
-                    -0.25 < src.y && src.y < h - 0.75)
-                {
-                    // interpolate using the 4 enclosing grid-points.  Those
-                    // points can be obtained using floor and ceiling of the
-                    // exact coordinates of the point
-                    int x1, y1, x2, y2;
-
-                    if (0 < src.x && src.x < w - 1)
-                    {
-                        x1 = wxRound(floor(src.x));
-                        x2 = wxRound(ceil(src.x));
-                    }
-                    else    // else means that x is near one of the borders (0 or width-1)
-                    {
-                        x1 = x2 = wxRound (src.x);
-                    }
-
-                    if (0 < src.y && src.y < h - 1)
-                    {
-                        y1 = wxRound(floor(src.y));
-                        y2 = wxRound(ceil(src.y));
-                    }
-                    else
-                    {
-                        y1 = y2 = wxRound (src.y);
-                    }
-
-                    // get four points and the distances (square of the distance,
-                    // for efficiency reasons) for the interpolation formula
-
-                    // GRG: Do not calculate the points until they are
-                    //      really needed -- this way we can calculate
-                    //      just one, instead of four, if d1, d2, d3
-                    //      or d4 are < wxROTATE_EPSILON
-
-                    const double d1 = (src.x - x1) * (src.x - x1) + (src.y - y1) * (src.y - y1);
-                    const double d2 = (src.x - x2) * (src.x - x2) + (src.y - y1) * (src.y - y1);
-                    const double d3 = (src.x - x2) * (src.x - x2) + (src.y - y2) * (src.y - y2);
-                    const double d4 = (src.x - x1) * (src.x - x1) + (src.y - y2) * (src.y - y2);
-
-                    // Now interpolate as a weighted average of the four surrounding
-                    // points, where the weights are the distances to each of those points
-
-                    // If the point is exactly at one point of the grid of the source
-                    // image, then don't interpolate -- just assign the pixel
-
-                    // d1,d2,d3,d4 are positive -- no need for abs()
-                    if (d1 < wxROTATE_EPSILON)
-                    {
-                        unsigned char *p = data[y1] + (3 * x1);
-                        *(dst++) = *(p++);
-                        *(dst++) = *(p++);
-                        *(dst++) = *p;
-
-                        if (has_alpha)
-                            *(alpha_dst++) = *(alpha[y1] + x1);
-                    }
-                    else if (d2 < wxROTATE_EPSILON)
-                    {
-                        unsigned char *p = data[y1] + (3 * x2);
-                        *(dst++) = *(p++);
-                        *(dst++) = *(p++);
-                        *(dst++) = *p;
-
-                        if (has_alpha)
-                            *(alpha_dst++) = *(alpha[y1] + x2);
-                    }
-                    else if (d3 < wxROTATE_EPSILON)
-                    {
-                        unsigned char *p = data[y2] + (3 * x2);
-                        *(dst++) = *(p++);
-                        *(dst++) = *(p++);
-                        *(dst++) = *p;
-
-                        if (has_alpha)
-                            *(alpha_dst++) = *(alpha[y2] + x2);
-                    }
-                    else if (d4 < wxROTATE_EPSILON)
-                    {
-                        unsigned char *p = data[y2] + (3 * x1);
-                        *(dst++) = *(p++);
-                        *(dst++) = *(p++);
-                        *(dst++) = *p;
-
-                        if (has_alpha)
-                            *(alpha_dst++) = *(alpha[y2] + x1);
-                    }
-                    else
-                    {
-                        // weights for the weighted average are proportional to the inverse of the distance
-                        unsigned char *v1 = data[y1] + (3 * x1);
-                        unsigned char *v2 = data[y1] + (3 * x2);
-                        unsigned char *v3 = data[y2] + (3 * x2);
-                        unsigned char *v4 = data[y2] + (3 * x1);
-
-                        const double w1 = 1/d1, w2 = 1/d2, w3 = 1/d3, w4 = 1/d4;
-
-                        // GRG: Unrolled.
-
-                        *(dst++) = (unsigned char)
-                            ( (w1 * *(v1++) + w2 * *(v2++) +
-                               w3 * *(v3++) + w4 * *(v4++)) /
-                              (w1 + w2 + w3 + w4) );
-                        *(dst++) = (unsigned char)
-                            ( (w1 * *(v1++) + w2 * *(v2++) +
-                               w3 * *(v3++) + w4 * *(v4++)) /
-                              (w1 + w2 + w3 + w4) );
-                        *(dst++) = (unsigned char)
-                            ( (w1 * *v1 + w2 * *v2 +
-                               w3 * *v3 + w4 * *v4) /
-                              (w1 + w2 + w3 + w4) );
-
-                        if (has_alpha)
-                        {
-                            v1 = alpha[y1] + (x1);
-                            v2 = alpha[y1] + (x2);
-                            v3 = alpha[y2] + (x2);
-                            v4 = alpha[y2] + (x1);
-
-                            *(alpha_dst++) = (unsigned char)
-                                ( (w1 * *v1 + w2 * *v2 +
-                                   w3 * *v3 + w4 * *v4) /
-                                  (w1 + w2 + w3 + w4) );
-                        }
-                    }
-                }
-                else
-                {
-                    *(dst++) = blank_r;
-                    *(dst++) = blank_g;
-                    *(dst++) = blank_b;
-
-                    if (has_alpha)
-                        *(alpha_dst++) = 0;
-                }
-            }
-        }
-    }
-    else // not interpolating
-    {
-        for (int y = 0; y < rH; y++)
-        {
-            for (int x = 0; x < rW; x++)
-            {
-                wxRealPoint src = wxRotatePoint (x + x1a, y + y1a, cos_angle, -sin_angle, p0);
-
-                const int xs = wxRound (src.x);      // wxRound rounds to the
-                const int ys = wxRound (src.y);      // closest integer
-
-                if (0 <= xs && xs < w && 0 <= ys && ys < h)
-                {
-                    unsigned char *p = data[ys] + (3 * xs);
-                    *(dst++) = *(p++);
-                    *(dst++) = *(p++);
-                    *(dst++) = *p;
-
-                    if (has_alpha)
-                        *(alpha_dst++) = *(alpha[ys] + (xs));
-                }
-                else
-                {
-                    *(dst++) = blank_r;
-                    *(dst++) = blank_g;
-                    *(dst++) = blank_b;
-
-                    if (has_alpha)
-                        *(alpha_dst++) = 255;
-                }
-            }
-        }
-    }
+    RotateProcessor processor(data, alpha, w, h, cos_angle, sin_angle, p0,
+                              x1a, y1a, rotated,
+                              blank_r, blank_g, blank_b, interpolating);
+    ProcessImageBands(processor, rotated.GetHeight(), rotated.GetWidth());
 
     delete [] data;
     delete [] alpha;
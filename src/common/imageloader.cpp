@@ -0,0 +1,267 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        src/common/imageloader.cpp
+// Purpose:     wxImageLoader implementation
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+// ============================================================================
+// declarations
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+// for compilers that support precompilation, includes "wx.h".
+#include "wx/wxprec.h"
+
+
+#if wxUSE_IMAGE && wxUSE_THREADS && wxUSE_STREAMS
+
+#include "wx/imageloader.h"
+#include "wx/threadpool.h"
+
+#ifndef WX_PRECOMP
+    #include "wx/log.h"
+#endif // WX_PRECOMP
+
+wxIMPLEMENT_DYNAMIC_CLASS(wxImageLoadedEvent, wxEvent);
+
+wxDEFINE_EVENT(wxEVT_IMAGE_LOADED, wxImageLoadedEvent);
+
+// ----------------------------------------------------------------------------
+// wxImageLoaderTask: task loading the next pending request
+// ----------------------------------------------------------------------------
+
+class wxImageLoaderTask : public wxThreadPoolTask
+{
+public:
+    explicit wxImageLoaderTask(wxImageLoader& loader)
+        : m_loader(loader)
+    {
+    }
+
+    virtual void Run() wxOVERRIDE
+    {
+        // There is one task per request, but it doesn't necessarily load the
+        // request it was created for: it loads the one with the highest
+        // priority instead, or nothing if the requests were cancelled.
+        wxImageLoader::Request req;
+        if ( !m_loader.GetNextRequest(req) )
+            return;
+
+        wxImage image;
+
+        {
+            // errors are reported by sending an event with invalid image
+            wxLogNull noLog;
+
+            image.SetLoadFlags(image.GetLoadFlags() & ~wxImage::Load_Verbose);
+            if ( !image.LoadFile(req.filename, req.type, req.index) )
+                image = wxImage();
+        }
+
+        m_loader.OnRequestDone(req.id, image, req.filename);
+    }
+
+private:
+    wxImageLoader& m_loader;
+
+    wxDECLARE_NO_COPY_CLASS(wxImageLoaderTask);
+};
+
+// ============================================================================
+// wxImageLoader implementation
+// ============================================================================
+
+wxImageLoader::wxImageLoader(wxEvtHandler* handler, int numThreads)
+    : m_handler(handler),
+      m_id(wxID_ANY),
+      m_pool(new wxThreadPool(numThreads)),
+      m_lastRequestId(0)
+{
+    wxASSERT_MSG( handler, wxS("must have a handler for the events") );
+
+    if ( !m_pool->GetThreadCount() )
+        wxLogDebug(wxS("Failed to start image loader threads."));
+}
+
+wxImageLoader::~wxImageLoader()
+{
+    CancelAll();
+
+    // This cancels the tasks which haven't run yet and waits for the running
+    // ones, which won't send any events as their requests were cancelled.
+    delete m_pool;
+}
+
+void wxImageLoader::DoQueue(const Request& req)
+{
+    // The requests are ordered by priority and then by id, so that the older
+    // requests with the same priority run first. As the last request in the
+    // vector is the next one to run, find the first one which must run before
+    // the new one using binary search and insert the new request before it.
+    size_t lo = 0,
+           hi = m_pending.size();
+    while ( lo < hi )
+    {
+        const size_t mid = (lo + hi) / 2;
+        const Request& other = m_pending[mid];
+        if ( other.priority < req.priority ||
+                (other.priority == req.priority && other.id > req.id) )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    m_pending.insert(m_pending.begin() + lo, req);
+}
+
+int wxImageLoader::Load(const wxString& filename,
+                        int priority,
+                        wxBitmapType type,
+                        int index)
+{
+    wxCHECK_MSG( m_pool->GetThreadCount(), 0, wxS("no threads to load images") );
+
+    Request req;
+    // make a deep copy as the string is going to be used by another thread
+    req.filename = filename.Clone();
+    req.priority = priority;
+    req.type = type;
+    req.index = index;
+
+    {
+        wxMutexLocker lock(m_mutex);
+
+        req.id = ++m_lastRequestId;
+        DoQueue(req);
+    }
+
+    m_pool->Submit(new wxImageLoaderTask(*this));
+
+    return req.id;
+}
+
+bool wxImageLoader::SetPriority(int requestId, int priority)
+{
+    wxMutexLocker lock(m_mutex);
+
+    for ( size_t n = 0; n < m_pending.size(); n++ )
+    {
+        if ( m_pending[n].id == requestId )
+        {
+            Request req = m_pending[n];
+            m_pending.erase(m_pending.begin() + n);
+
+            req.priority = priority;
+            DoQueue(req);
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool wxImageLoader::Cancel(int requestId)
+{
+    wxMutexLocker lock(m_mutex);
+
+    for ( size_t n = 0; n < m_pending.size(); n++ )
+    {
+        if ( m_pending[n].id == requestId )
+        {
+            m_pending.erase(m_pending.begin() + n);
+            return true;
+        }
+    }
+
+    for ( size_t n = 0; n < m_running.size(); n++ )
+    {
+        if ( m_running[n] == requestId )
+        {
+            m_runningCancelled[n] = true;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void wxImageLoader::CancelAll()
+{
+    wxMutexLocker lock(m_mutex);
+
+    m_pending.clear();
+    for ( size_t n = 0; n < m_runningCancelled.size(); n++ )
+        m_runningCancelled[n] = true;
+}
+
+size_t wxImageLoader::GetPendingCount() const
+{
+    wxMutexLocker lock(m_mutex);
+
+    return m_pending.size();
+}
+
+bool wxImageLoader::GetNextRequest(Request& req)
+{
+    wxMutexLocker lock(m_mutex);
+
+    if ( m_pending.empty() )
+        return false;
+
+    req = m_pending.back();
+    m_pending.pop_back();
+
+    m_running.push_back(req.id);
+    m_runningCancelled.push_back(false);
+
+    return true;
+}
+
+void wxImageLoader::OnRequestDone(int requestId,
+                                  wxImage& image,
+                                  const wxString& filename)
+{
+    // create the event before taking the lock, as it can take some time to
+    // copy the file name
+    wxImageLoadedEvent*
+        event = new wxImageLoadedEvent(wxEVT_IMAGE_LOADED, m_id,
+                                       requestId, filename.Clone());
+    event->SetImage(image);
+
+    // wxImage reference counting is not thread-safe, so ensure that the image
+    // is only referenced by the event before it is processed in the main
+    // thread
+    image.Destroy();
+
+    bool cancelled = false;
+    {
+        wxMutexLocker lock(m_mutex);
+
+        for ( size_t n = 0; n < m_running.size(); n++ )
+        {
+            if ( m_running[n] == requestId )
+            {
+                cancelled = m_runningCancelled[n];
+                m_running.erase(m_running.begin() + n);
+                m_runningCancelled.erase(m_runningCancelled.begin() + n);
+                break;
+            }
+        }
+    }
+
+    if ( cancelled )
+    {
+        delete event;
+        return;
+    }
+
+    wxQueueEvent(m_handler, event);
+}
+
+#endif // wxUSE_IMAGE && wxUSE_THREADS && wxUSE_STREAMS
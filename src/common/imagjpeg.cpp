@@ -278,12 +278,19 @@ bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
         bytesPerPixel = 3;
     }
 
-    // scale the picture to fit in the specified max size if necessary
+    // scale the picture to fit in the specified max size if necessary: this
+    // is done by libjpeg using DCT scaling, which is much faster than decoding
+    // the image at full size and also uses less memory, but it only supports
+    // scaling by at most 1/8, so if the image still doesn't fit, it will be
+    // scaled down further by wxImage::DoLoad() after decoding it
     if ( maxWidth > 0 || maxHeight > 0 )
     {
+        static const unsigned MAX_SCALE = 8;
+
         unsigned& scale = cinfo.scale_denom;
-        while ( (maxWidth && (cinfo.image_width / scale > maxWidth)) ||
-                    (maxHeight && (cinfo.image_height / scale > maxHeight)) )
+        while ( scale < MAX_SCALE &&
+                ((maxWidth && (cinfo.image_width / scale > maxWidth)) ||
+                    (maxHeight && (cinfo.image_height / scale > maxHeight))) )
         {
             scale *= 2;
         }
@@ -300,26 +307,46 @@ bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
     image->SetMask( false );
     ptr = image->GetData();
 
-    unsigned stride = cinfo.output_width * bytesPerPixel;
-    JSAMPARRAY tempbuf = (*cinfo.mem->alloc_sarray)
-                            ((j_common_ptr) &cinfo, JPOOL_IMAGE, stride, 1 );
-
-    while ( cinfo.output_scanline < cinfo.output_height )
+    if (cinfo.out_color_space == JCS_RGB)
     {
-        jpeg_read_scanlines( &cinfo, tempbuf, 1 );
-        if (cinfo.out_color_space == JCS_RGB)
+        // decode directly into the image buffer, as many lines at once as
+        // libjpeg can give us, to avoid copying the data (notice that the
+        // rows array is allocated using libjpeg memory manager as it would be
+        // leaked otherwise if an error occurs)
+        const unsigned stride = cinfo.output_width * 3;
+        JSAMPARRAY rows = (JSAMPARRAY)(*cinfo.mem->alloc_small)
+                            ((j_common_ptr) &cinfo, JPOOL_IMAGE,
+                             cinfo.output_height * sizeof(JSAMPROW));
+        for (JDIMENSION y = 0; y < cinfo.output_height; y++)
+            rows[y] = ptr + y * stride;
+
+        while ( cinfo.output_scanline < cinfo.output_height )
         {
-            memcpy( ptr, tempbuf[0], stride );
-            ptr += stride;
+            jpeg_read_scanlines( &cinfo, rows + cinfo.output_scanline,
+                                 cinfo.output_height - cinfo.output_scanline );
         }
-        else // CMYK
+    }
+    else // CMYK
+    {
+        const unsigned stride = cinfo.output_width * bytesPerPixel;
+        const JDIMENSION numLines = cinfo.rec_outbuf_height;
+        JSAMPARRAY tempbuf = (*cinfo.mem->alloc_sarray)
+                                ((j_common_ptr) &cinfo, JPOOL_IMAGE, stride, numLines );
+
+        while ( cinfo.output_scanline < cinfo.output_height )
         {
-            const unsigned char* inptr = (const unsigned char*) tempbuf[0];
-            for (size_t i = 0; i < cinfo.output_width; i++)
+            const JDIMENSION
+                linesRead = jpeg_read_scanlines( &cinfo, tempbuf, numLines );
+
+            for (JDIMENSION n = 0; n < linesRead; n++)
             {
-                wx_cmyk_to_rgb(ptr, inptr);
-                ptr += 3;
-                inptr += 4;
+                const unsigned char* inptr = (const unsigned char*) tempbuf[n];
+                for (size_t i = 0; i < cinfo.output_width; i++)
+                {
+                    wx_cmyk_to_rgb(ptr, inptr);
+                    ptr += 3;
+                    inptr += 4;
+                }
             }
         }
     }
@@ -347,6 +374,84 @@ bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
     return true;
 }
 
+bool wxJPEGHandler::LoadRows( wxImageRowConsumer& consumer, wxInputStream& stream, bool verbose, int WXUNUSED(index) )
+{
+    struct jpeg_decompress_struct cinfo;
+    wx_error_mgr jerr;
+
+    cinfo.err = jpeg_std_error( &jerr );
+    jerr.error_exit = wx_error_exit;
+
+    if (!verbose)
+        cinfo.err->output_message = wx_ignore_message;
+
+    /* Establish the setjmp return context for wx_error_exit to use. */
+    if (setjmp(jerr.setjmp_buffer)) {
+      if (verbose)
+      {
+        wxLogError(_("JPEG: Couldn't load - file is probably corrupted."));
+      }
+      (cinfo.src->term_source)(&cinfo);
+      jpeg_destroy_decompress(&cinfo);
+      return false;
+    }
+
+    jpeg_create_decompress( &cinfo );
+    wx_jpeg_io_src( &cinfo, stream );
+    jpeg_read_header( &cinfo, TRUE );
+
+    const bool isCMYK = cinfo.out_color_space == JCS_CMYK ||
+                            cinfo.out_color_space == JCS_YCCK;
+    cinfo.out_color_space = isCMYK ? JCS_CMYK : JCS_RGB;
+
+    jpeg_start_decompress( &cinfo );
+
+    bool ok = consumer.OnStart( cinfo.output_width, cinfo.output_height, false );
+    if ( ok )
+    {
+        // only keep as many lines as libjpeg decodes at once in memory, all
+        // the buffers are freed by jpeg_destroy_decompress(), even in case of
+        // an error
+        const JDIMENSION numLines = cinfo.rec_outbuf_height;
+        JSAMPARRAY buf = (*cinfo.mem->alloc_sarray)
+                            ((j_common_ptr) &cinfo, JPOOL_IMAGE,
+                             cinfo.output_width * (isCMYK ? 4 : 3), numLines );
+        JSAMPROW rgb = isCMYK ? (JSAMPROW)(*cinfo.mem->alloc_small)
+                                    ((j_common_ptr) &cinfo, JPOOL_IMAGE,
+                                     cinfo.output_width * 3)
+                              : NULL;
+
+        while ( ok && cinfo.output_scanline < cinfo.output_height )
+        {
+            const JDIMENSION y = cinfo.output_scanline;
+            const JDIMENSION
+                linesRead = jpeg_read_scanlines( &cinfo, buf, numLines );
+
+            for (JDIMENSION n = 0; ok && n < linesRead; n++)
+            {
+                const unsigned char* row = (const unsigned char*) buf[n];
+                if ( isCMYK )
+                {
+                    for (size_t i = 0; i < cinfo.output_width; i++)
+                        wx_cmyk_to_rgb(rgb + 3*i, row + 4*i);
+
+                    row = rgb;
+                }
+
+                ok = consumer.OnRow( y + n, row, NULL );
+            }
+        }
+    }
+
+    if ( ok )
+        jpeg_finish_decompress( &cinfo );
+    else // loading was cancelled by the consumer
+        (cinfo.src->term_source)(&cinfo);
+
+    jpeg_destroy_decompress( &cinfo );
+    return ok;
+}
+
 typedef struct {
     struct jpeg_destination_mgr pub;
 
@@ -105,9 +105,11 @@ struct wxPNGImageData
     {
         lines = NULL;
         m_buf = NULL;
+        m_row = NULL;
         info_ptr = (png_infop) NULL;
         png_ptr = (png_structp) NULL;
         ok = false;
+        cancelled = false;
     }
 
     bool Alloc(png_uint_32 width, png_uint_32 height, unsigned char* buf)
@@ -139,6 +141,7 @@ struct wxPNGImageData
 
     ~wxPNGImageData()
     {
+        free(m_row);
         free(m_buf);
         free( lines );
 
@@ -152,12 +155,15 @@ struct wxPNGImageData
     }
 
     void DoLoadPNGFile(wxImage* image, wxPNGInfoStruct& wxinfo);
+    void DoLoadPNGRows(wxImageRowConsumer& consumer, wxPNGInfoStruct& wxinfo);
 
     unsigned char** lines;
     unsigned char* m_buf;
+    unsigned char* m_row;
     png_infop info_ptr;
     png_structp png_ptr;
     bool ok;
+    bool cancelled;
 };
 
 } // anonymous namespace
@@ -417,6 +423,125 @@ wxPNGImageData::DoLoadPNGFile(wxImage* image, wxPNGInfoStruct& wxinfo)
     ok = true;
 }
 
+// Same as DoLoadPNGFile() but passes the rows to the consumer as they are
+// decoded instead of storing them in wxImage. Only interlaced images, which
+// can't be shown before their last pass is decoded, need to be stored whole.
+void
+wxPNGImageData::DoLoadPNGRows(wxImageRowConsumer& consumer, wxPNGInfoStruct& wxinfo)
+{
+    png_uint_32 width, height = 0;
+    int bit_depth, color_type;
+
+    png_ptr = png_create_read_struct
+                          (
+                            PNG_LIBPNG_VER_STRING,
+                            NULL,
+                            wx_PNG_error,
+                            wx_PNG_warning
+                          );
+    if (!png_ptr)
+        return;
+
+    png_set_read_fn( png_ptr, &wxinfo, wx_PNG_stream_reader);
+
+    info_ptr = png_create_info_struct( png_ptr );
+    if (!info_ptr)
+        return;
+
+    if (setjmp(wxinfo.jmpbuf))
+        return;
+
+    png_read_info( png_ptr, info_ptr );
+    png_get_IHDR( png_ptr, info_ptr, &width, &height, &bit_depth, &color_type, NULL, NULL, NULL );
+
+    png_set_expand(png_ptr);
+    png_set_gray_to_rgb(png_ptr);
+    png_set_strip_16( png_ptr );
+    png_set_packing( png_ptr );
+    const int numPasses = png_set_interlace_handling( png_ptr );
+
+    const bool hasAlpha =
+        (color_type & PNG_COLOR_MASK_ALPHA) ||
+        png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS);
+
+    if ( !consumer.OnStart((int)width, (int)height, hasAlpha) )
+    {
+        cancelled = true;
+        return;
+    }
+
+    // with alpha, the RGBA data is decoded into the first half of the row
+    // buffer and then split into RGB and alpha parts stored after it
+    m_row = static_cast<unsigned char*>(malloc(width * (hasAlpha ? 8 : 3)));
+    if ( !m_row )
+        return;
+
+    unsigned char* const rgb = hasAlpha ? m_row + 4*width : m_row;
+    unsigned char* const alpha = hasAlpha ? rgb + 3*width : NULL;
+
+    if ( numPasses > 1 )
+    {
+        if ( !Alloc(width, height, NULL) )
+            return;
+
+        png_read_image( png_ptr, lines );
+    }
+
+    for ( png_uint_32 y = 0; y < height; y++ )
+    {
+        unsigned char* src = hasAlpha ? m_row : rgb;
+        if ( lines )
+            src = lines[y];
+        else
+            png_read_row( png_ptr, src, NULL );
+
+        if ( hasAlpha )
+        {
+            unsigned char* ptrRGB = rgb;
+            for ( png_uint_32 x = 0; x < width; x++ )
+            {
+                *ptrRGB++ = *src++;
+                *ptrRGB++ = *src++;
+                *ptrRGB++ = *src++;
+                alpha[x] = *src++;
+            }
+
+            src = rgb;
+        }
+
+        if ( !consumer.OnRow((int)y, src, alpha) )
+        {
+            cancelled = true;
+            return;
+        }
+    }
+
+    png_read_end( png_ptr, info_ptr );
+
+    ok = true;
+}
+
+bool
+wxPNGHandler::LoadRows(wxImageRowConsumer& consumer,
+                       wxInputStream& stream,
+                       bool verbose,
+                       int WXUNUSED(index))
+{
+    wxPNGInfoStruct wxinfo;
+    wxinfo.verbose = verbose;
+    wxinfo.stream.in = &stream;
+
+    wxPNGImageData data;
+    data.DoLoadPNGRows(consumer, wxinfo);
+
+    if ( !data.ok && !data.cancelled && verbose )
+    {
+        wxLogError(_("Couldn't load a PNG image - file is corrupted or not enough memory."));
+    }
+
+    return data.ok;
+}
+
 bool
 wxPNGHandler::LoadFile(wxImage *image,
                        wxInputStream& stream,
@@ -574,6 +574,147 @@ bool wxTIFFHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
     return true;
 }
 
+bool wxTIFFHandler::LoadRows( wxImageRowConsumer& consumer, wxInputStream& stream, bool verbose, int index )
+{
+    if (index == -1)
+        index = 0;
+
+    const wxFileOffset posStart = stream.TellI();
+
+    TIFF *tif = TIFFwxOpen( stream, "image", "r" );
+
+    if (!tif)
+    {
+        if (verbose)
+        {
+            wxLogError( _("TIFF: Error loading image.") );
+        }
+
+        return false;
+    }
+
+    if (!TIFFSetDirectory( tif, (tdir_t)index ))
+    {
+        if (verbose)
+        {
+            wxLogError( _("Invalid TIFF image index.") );
+        }
+
+        TIFFClose( tif );
+
+        return false;
+    }
+
+    uint32 w, h;
+    TIFFGetField( tif, TIFFTAG_IMAGEWIDTH, &w );
+    TIFFGetField( tif, TIFFTAG_IMAGELENGTH, &h );
+
+    uint16 samplesPerPixel = 0;
+    (void) TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLESPERPIXEL, &samplesPerPixel);
+
+    uint16 extraSamples;
+    uint16* samplesInfo;
+    TIFFGetFieldDefaulted(tif, TIFFTAG_EXTRASAMPLES,
+                          &extraSamples, &samplesInfo);
+
+    uint16 photometric;
+    if (!TIFFGetField(tif, TIFFTAG_PHOTOMETRIC, &photometric))
+    {
+        photometric = PHOTOMETRIC_MINISWHITE;
+    }
+    const bool hasAlpha = (extraSamples >= 1
+        && ((samplesInfo[0] == EXTRASAMPLE_UNSPECIFIED)
+            || samplesInfo[0] == EXTRASAMPLE_ASSOCALPHA
+            || samplesInfo[0] == EXTRASAMPLE_UNASSALPHA))
+        || (extraSamples == 0 && samplesPerPixel == 4
+            && photometric == PHOTOMETRIC_RGB);
+
+    uint16 orientation = ORIENTATION_TOPLEFT;
+    (void) TIFFGetFieldDefaulted(tif, TIFFTAG_ORIENTATION, &orientation);
+
+    uint32 rowsPerStrip = 0;
+    (void) TIFFGetFieldDefaulted(tif, TIFFTAG_ROWSPERSTRIP, &rowsPerStrip);
+    if ( rowsPerStrip > h )
+        rowsPerStrip = h;
+
+    // Only the images stored in strips in the usual top to bottom order can
+    // be decoded one strip at a time, and the grey images with alpha are
+    // handled specially by LoadFile(), so just use it for all the others.
+    char msg[1024] = "";
+    if ( TIFFIsTiled(tif) || orientation != ORIENTATION_TOPLEFT ||
+            samplesPerPixel == 2 || !rowsPerStrip ||
+            !TIFFRGBAImageOK(tif, msg) ||
+            (double)w * rowsPerStrip * sizeof(uint32) >= wxUINT32_MAX )
+    {
+        TIFFClose( tif );
+
+        if ( stream.SeekI(posStart) == wxInvalidOffset )
+            return false;
+
+        return wxImageHandler::LoadRows(consumer, stream, verbose, index);
+    }
+
+    uint32 *raster = (uint32*) _TIFFmalloc( w * rowsPerStrip * sizeof(uint32) );
+    unsigned char *rgb = (unsigned char*) _TIFFmalloc( w * 3 );
+    unsigned char *alpha = hasAlpha ? (unsigned char*) _TIFFmalloc( w ) : NULL;
+
+    bool ok = raster && rgb && (alpha || !hasAlpha);
+    if ( !ok )
+    {
+        if (verbose)
+        {
+            wxLogError( _("TIFF: Couldn't allocate memory.") );
+        }
+    }
+    else
+    {
+        ok = consumer.OnStart( (int)w, (int)h, hasAlpha );
+    }
+
+    for ( uint32 row = 0; ok && row < h; row += rowsPerStrip )
+    {
+        if ( !TIFFReadRGBAStrip( tif, row, raster ) )
+        {
+            if (verbose)
+            {
+                wxLogError( _("TIFF: Error reading image.") );
+            }
+
+            ok = false;
+            break;
+        }
+
+        // the rows of the strip are returned bottom to top
+        const uint32 rows = wxMin(rowsPerStrip, h - row);
+        for ( uint32 i = 0; ok && i < rows; i++ )
+        {
+            const uint32 *src = raster + (rows - 1 - i) * w;
+            unsigned char *ptr = rgb;
+            for ( uint32 j = 0; j < w; j++ )
+            {
+                *(ptr++) = (unsigned char)TIFFGetR(src[j]);
+                *(ptr++) = (unsigned char)TIFFGetG(src[j]);
+                *(ptr++) = (unsigned char)TIFFGetB(src[j]);
+                if ( hasAlpha )
+                    alpha[j] = (unsigned char)TIFFGetA(src[j]);
+            }
+
+            ok = consumer.OnRow( (int)(row + i), rgb, alpha );
+        }
+    }
+
+    if ( alpha )
+        _TIFFfree( alpha );
+    if ( rgb )
+        _TIFFfree( rgb );
+    if ( raster )
+        _TIFFfree( raster );
+
+    TIFFClose( tif );
+
+    return ok;
+}
+
 int wxTIFFHandler::DoGetImageCount( wxInputStream& stream )
 {
     TIFF *tif = TIFFwxOpen( stream, "image", "r" );
@@ -20,15 +20,259 @@
 
 #ifndef WX_PRECOMP
     #include "wx/dc.h"
+    #include "wx/hashmap.h"
+    #include "wx/module.h"
     #include "wx/window.h"
 #endif //WX_PRECOMP
 
 #include "wx/private/textmeasure.h"
+#include "wx/thread.h"
+#include "wx/vector.h"
+
+// ----------------------------------------------------------------------------
+// wxTextExtentCache: LRU cache of the already measured strings
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// The font is identified by its ref data, which can't be reused by another
+// font as long as the cache keeps a reference to the font using it.
+struct wxTextExtentKey
+{
+    wxTextExtentKey() : font(NULL), forDC(false) { }
+
+    wxTextExtentKey(const wxObjectRefData* font_,
+                    bool forDC_,
+                    const wxString& text_)
+        : font(font_), forDC(forDC_), text(text_)
+    {
+    }
+
+    const wxObjectRefData* font;
+    bool forDC;
+    wxString text;
+};
+
+struct wxTextExtentKeyHash
+{
+    wxTextExtentKeyHash() { }
+
+    unsigned long operator()(const wxTextExtentKey& key) const
+    {
+        return wxStringHash()(key.text) ^
+                (unsigned long)wxPointerHash()(key.font) ^
+                    (key.forDC ? 1 : 0);
+    }
+};
+
+struct wxTextExtentKeyEqual
+{
+    wxTextExtentKeyEqual() { }
+
+    bool operator()(const wxTextExtentKey& a, const wxTextExtentKey& b) const
+    {
+        return a.font == b.font && a.forDC == b.forDC && a.text == b.text;
+    }
+};
+
+WX_DECLARE_HASH_MAP(wxTextExtentKey, size_t,
+                    wxTextExtentKeyHash, wxTextExtentKeyEqual,
+                    wxTextExtentIndexMap);
+
+class wxTextExtentCache
+{
+public:
+    struct Extent
+    {
+        Extent()
+            : width(0), height(0), descent(0), externalLeading(0),
+              hasDescent(false)
+        {
+        }
+
+        wxCoord width,
+                height,
+                descent,
+                externalLeading;
+
+        // true if descent and externalLeading fields are valid
+        bool hasDescent;
+    };
+
+    wxTextExtentCache()
+        : m_head(NONE), m_tail(NONE), m_hits(0), m_misses(0)
+    {
+    }
+
+    // Fill in the extent and return true if it is in the cache.
+    bool Lookup(const wxTextExtentKey& key, bool needDescent, Extent& extent)
+    {
+        wxTextExtentIndexMap::const_iterator it = m_map.find(key);
+        if ( it == m_map.end() ||
+                (needDescent && !m_nodes[it->second].extent.hasDescent) )
+        {
+            m_misses++;
+            return false;
+        }
+
+        m_hits++;
+
+        const size_t n = it->second;
+        if ( n != m_head )
+        {
+            Unlink(n);
+            LinkFront(n);
+        }
+
+        extent = m_nodes[n].extent;
+        return true;
+    }
+
+    void Store(const wxTextExtentKey& key,
+               const wxFont& font,
+               const Extent& extent)
+    {
+        size_t n;
+
+        wxTextExtentIndexMap::iterator it = m_map.find(key);
+        if ( it != m_map.end() )
+        {
+            // this happens if we measure the string again to get its descent
+            n = it->second;
+            Unlink(n);
+        }
+        else if ( m_nodes.size() < MAX_SIZE )
+        {
+            n = m_nodes.size();
+            m_nodes.push_back(Node());
+            m_map[key] = n;
+        }
+        else // reuse the least recently used node
+        {
+            n = m_tail;
+            Unlink(n);
+            m_map.erase(m_nodes[n].key);
+            m_map[key] = n;
+        }
+
+        Node& node = m_nodes[n];
+        node.key = key;
+        node.font = font;
+        node.extent = extent;
+
+        LinkFront(n);
+    }
+
+    void Clear()
+    {
+        m_map.clear();
+        m_nodes.clear();
+        m_head =
+        m_tail = NONE;
+    }
+
+    size_t GetHits() const { return m_hits; }
+    size_t GetMisses() const { return m_misses; }
+
+private:
+    // The maximal number of strings in the cache: this should be enough for
+    // all the strings shown on screen in a typical application.
+    static const size_t MAX_SIZE = 4096;
+
+    // Invalid index used for the list links.
+    static const size_t NONE = static_cast<size_t>(-1);
+
+    // The nodes form a doubly linked list in the order of their use.
+    struct Node
+    {
+        Node() : prev(NONE), next(NONE) { }
+
+        wxTextExtentKey key;
+        wxFont font;
+        Extent extent;
+        size_t prev,
+               next;
+    };
+
+    void Unlink(size_t n)
+    {
+        Node& node = m_nodes[n];
+        if ( node.prev != NONE )
+            m_nodes[node.prev].next = node.next;
+        else
+            m_head = node.next;
+
+        if ( node.next != NONE )
+            m_nodes[node.next].prev = node.prev;
+        else
+            m_tail = node.prev;
+    }
+
+    void LinkFront(size_t n)
+    {
+        Node& node = m_nodes[n];
+        node.prev = NONE;
+        node.next = m_head;
+
+        if ( m_head != NONE )
+            m_nodes[m_head].prev = n;
+        else
+            m_tail = n;
+
+        m_head = n;
+    }
+
+    wxVector<Node> m_nodes;
+    wxTextExtentIndexMap m_map;
+
+    // The most and least recently used nodes.
+    size_t m_head,
+           m_tail;
+
+    size_t m_hits,
+           m_misses;
+};
+
+wxTextExtentCache gs_textExtentCache;
+
+} // anonymous namespace
+
+// Clear the cache on shutdown to avoid destroying the fonts in it after the
+// GUI is cleaned up.
+class wxTextMeasureModule : public wxModule
+{
+public:
+    wxTextMeasureModule() { }
+
+    virtual bool OnInit() wxOVERRIDE { return true; }
+    virtual void OnExit() wxOVERRIDE { gs_textExtentCache.Clear(); }
+
+private:
+    wxDECLARE_DYNAMIC_CLASS(wxTextMeasureModule);
+};
+
+wxIMPLEMENT_DYNAMIC_CLASS(wxTextMeasureModule, wxModule);
 
 // ============================================================================
 // wxTextMeasureBase implementation
 // ============================================================================
 
+/* static */
+void wxTextMeasureBase::ClearCache()
+{
+    gs_textExtentCache.Clear();
+}
+
+/* static */
+void wxTextMeasureBase::GetCacheStats(size_t *hits, size_t *misses)
+{
+    if ( hits )
+        *hits = gs_textExtentCache.GetHits();
+    if ( misses )
+        *misses = gs_textExtentCache.GetMisses();
+}
+
 wxTextMeasureBase::wxTextMeasureBase(const wxDC *dc, const wxFont *theFont)
     : m_dc(dc),
       m_win(NULL),
@@ -39,6 +283,9 @@ wxTextMeasureBase::wxTextMeasureBase(const wxDC *dc, const wxFont *theFont)
     // By default, use wxDC version, we'll explicitly reset this to false in
     // the derived classes if the DC is of native variety.
     m_useDCImpl = true;
+
+    // And don't cache the extents as they can depend on the DC.
+    m_useCache = false;
 }
 
 wxTextMeasureBase::wxTextMeasureBase(const wxWindow *win, const wxFont *theFont)
@@ -50,6 +297,8 @@ wxTextMeasureBase::wxTextMeasureBase(const wxWindow *win, const wxFont *theFont)
 
     // We don't have any wxDC so we can't forward to it.
     m_useDCImpl = false;
+
+    m_useCache = true;
 }
 
 wxFont wxTextMeasureBase::GetFont() const
@@ -67,8 +316,84 @@ void wxTextMeasureBase::CallGetTextExtent(const wxString& string,
 {
     if ( m_useDCImpl )
         m_dc->GetTextExtent(string, width, height, descent, externalLeading);
-    else
+    else if ( !GetCachedTextExtent(string, width, height, descent, externalLeading) )
+        DoGetAndCacheTextExtent(string, width, height, descent, externalLeading);
+}
+
+bool wxTextMeasureBase::GetCachedTextExtent(const wxString& string,
+                                            wxCoord *width,
+                                            wxCoord *height,
+                                            wxCoord *descent,
+                                            wxCoord *externalLeading)
+{
+    // The cache is not thread-safe, but it's only supposed to be used by the
+    // GUI code anyhow.
+    if ( !m_useCache || !wxIsMainThread() )
+        return false;
+
+    const wxFont font = GetFont();
+    if ( !font.IsOk() )
+        return false;
+
+    wxTextExtentCache::Extent extent;
+    if ( !gs_textExtentCache.Lookup(wxTextExtentKey(font.GetRefData(),
+                                                    m_dc != NULL,
+                                                    string),
+                                    descent || externalLeading,
+                                    extent) )
+        return false;
+
+    *width = extent.width;
+    *height = extent.height;
+    if ( descent )
+        *descent = extent.descent;
+    if ( externalLeading )
+        *externalLeading = extent.externalLeading;
+
+    return true;
+}
+
+void wxTextMeasureBase::DoGetAndCacheTextExtent(const wxString& string,
+                                                wxCoord *width,
+                                                wxCoord *height,
+                                                wxCoord *descent,
+                                                wxCoord *externalLeading)
+{
+    if ( !m_useCache || !wxIsMainThread() )
+    {
         DoGetTextExtent(string, width, height, descent, externalLeading);
+        return;
+    }
+
+    // Always get both descent and external leading if either of them is
+    // needed, to be able to reuse the cached value for any future request.
+    wxTextExtentCache::Extent extent;
+    extent.hasDescent = descent || externalLeading;
+    DoGetTextExtent(string, &extent.width, &extent.height,
+                    extent.hasDescent ? &extent.descent : NULL,
+                    extent.hasDescent ? &extent.externalLeading : NULL);
+
+    *width = extent.width;
+    *height = extent.height;
+    if ( descent )
+        *descent = extent.descent;
+    if ( externalLeading )
+        *externalLeading = extent.externalLeading;
+
+    // Don't cache the failures to measure the text, e.g. because the window
+    // is not fully created yet.
+    if ( extent.height > 0 )
+    {
+        const wxFont font = GetFont();
+        if ( font.IsOk() )
+        {
+            gs_textExtentCache.Store(wxTextExtentKey(font.GetRefData(),
+                                                     m_dc != NULL,
+                                                     string),
+                                     font,
+                                     extent);
+        }
+    }
 }
 
 void wxTextMeasureBase::GetTextExtent(const wxString& string,
@@ -95,9 +420,17 @@ void wxTextMeasureBase::GetTextExtent(const wxString& string,
         return;
     }
 
+    // Also avoid doing it if the extent of this string is already known.
+    if ( !m_useDCImpl &&
+            GetCachedTextExtent(string, width, height, descent, externalLeading) )
+        return;
+
     MeasuringGuard guard(*this);
 
-    CallGetTextExtent(string, width, height, descent, externalLeading);
+    if ( m_useDCImpl )
+        m_dc->GetTextExtent(string, width, height, descent, externalLeading);
+    else
+        DoGetAndCacheTextExtent(string, width, height, descent, externalLeading);
 }
 
 int wxTextMeasureBase::GetEmptyLineHeight()
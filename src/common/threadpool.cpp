@@ -0,0 +1,899 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        src/common/threadpool.cpp
+// Purpose:     wxThreadPool implementation
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+// ============================================================================
+// declarations
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+// for compilers that support precompilation, includes "wx.h".
+#include "wx/wxprec.h"
+
+
+#if wxUSE_THREADS
+
+#include "wx/threadpool.h"
+
+#ifndef WX_PRECOMP
+    #include "wx/app.h"
+    #include "wx/log.h"
+#endif // WX_PRECOMP
+
+#include "wx/atomic.h"
+#include "wx/thread.h"
+#include "wx/tls.h"
+#include "wx/vector.h"
+
+class wxThreadPoolWorker;
+
+namespace
+{
+
+// Pointer to the worker object of the current thread if it's a pool thread.
+inline wxTLS_TYPE_REF(wxThreadPoolWorker*) GetThisThreadWorker()
+{
+    static wxTLS_TYPE(wxThreadPoolWorker*) s_thisThreadWorker;
+
+    return s_thisThreadWorker;
+}
+
+#define wxTHIS_THREAD_WORKER wxTLS_VALUE(GetThisThreadWorker())
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// wxThreadPoolTaskState: the state of a task shared with its futures
+// ----------------------------------------------------------------------------
+
+class wxThreadPoolTaskState
+{
+public:
+    enum Status
+    {
+        Status_Pending,
+        Status_Running,
+        Status_Done,
+        Status_Cancelled
+    };
+
+    // The state is created with the reference count of 1.
+    wxThreadPoolTaskState(wxThreadPoolImpl& pool,
+                          wxThreadPoolTask* task,
+                          wxEvtHandler* handler)
+        : m_pool(pool),
+          m_task(task),
+          m_handler(handler),
+          m_condition(m_mutex),
+          m_status(Status_Pending),
+          m_refCount(1)
+    {
+    }
+
+    ~wxThreadPoolTaskState()
+    {
+        delete m_task;
+    }
+
+    void IncRef() { wxAtomicInc(m_refCount); }
+    void DecRef()
+    {
+        if ( !wxAtomicDec(m_refCount) )
+            delete this;
+    }
+
+    wxThreadPoolImpl& GetPool() const { return m_pool; }
+    wxThreadPoolTask* GetTask() const { return m_task; }
+    wxEvtHandler* GetHandler() const { return m_handler; }
+
+    Status GetStatus() const
+    {
+        wxMutexLocker lock(m_mutex);
+
+        return m_status;
+    }
+
+    bool IsFinished() const
+    {
+        const Status status = GetStatus();
+
+        return status == Status_Done || status == Status_Cancelled;
+    }
+
+    // Change the status from pending to running, return false if the task
+    // was cancelled.
+    bool StartRunning()
+    {
+        wxMutexLocker lock(m_mutex);
+
+        if ( m_status != Status_Pending )
+            return false;
+
+        m_status = Status_Running;
+        return true;
+    }
+
+    // Mark the task as done, after it has run, or cancelled, if it hasn't
+    // started yet: in the latter case, false is returned if it's too late.
+    bool Finish(Status status);
+
+    // Add the task to submit once this one is done, return false if it
+    // already finished. Takes ownership of a reference to the state if true
+    // is returned.
+    bool AddNext(wxThreadPoolTaskState* next)
+    {
+        wxMutexLocker lock(m_mutex);
+
+        if ( m_status == Status_Done || m_status == Status_Cancelled )
+            return false;
+
+        m_next.push_back(next);
+        return true;
+    }
+
+    bool Wait();
+
+private:
+    wxThreadPoolImpl& m_pool;
+    wxThreadPoolTask* const m_task;
+    wxEvtHandler* const m_handler;
+
+    // protects m_status and m_next
+    mutable wxMutex m_mutex;
+
+    // signalled when the task finishes
+    wxCondition m_condition;
+
+    Status m_status;
+
+    // the tasks submitted with SubmitAfter() this one
+    wxVector<wxThreadPoolTaskState*> m_next;
+
+    wxAtomicInt m_refCount;
+
+    wxDECLARE_NO_COPY_CLASS(wxThreadPoolTaskState);
+};
+
+// ----------------------------------------------------------------------------
+// wxThreadPoolQueue: the queue of tasks used by the pool
+// ----------------------------------------------------------------------------
+
+// This is a simple double-ended queue of tasks, it is not thread-safe and must
+// be protected by the caller.
+class wxThreadPoolQueue
+{
+public:
+    wxThreadPoolQueue() : m_head(0) { }
+
+    bool IsEmpty() const { return m_head == m_states.size(); }
+
+    void PushBack(wxThreadPoolTaskState* state) { m_states.push_back(state); }
+
+    wxThreadPoolTaskState* PopBack()
+    {
+        if ( IsEmpty() )
+            return NULL;
+
+        wxThreadPoolTaskState* const state = m_states.back();
+        m_states.pop_back();
+        if ( IsEmpty() )
+            Clear();
+
+        return state;
+    }
+
+    wxThreadPoolTaskState* PopFront()
+    {
+        if ( IsEmpty() )
+            return NULL;
+
+        wxThreadPoolTaskState* const state = m_states[m_head++];
+        if ( IsEmpty() )
+        {
+            Clear();
+        }
+        else if ( m_head > 64 && m_head > m_states.size() / 2 )
+        {
+            // Don't let the unused part of the vector grow indefinitely.
+            m_states.erase(m_states.begin(), m_states.begin() + m_head);
+            m_head = 0;
+        }
+
+        return state;
+    }
+
+    // Append all the tasks to the given vector and clear the queue.
+    void TakeAll(wxVector<wxThreadPoolTaskState*>& states)
+    {
+        for ( size_t n = m_head; n < m_states.size(); n++ )
+            states.push_back(m_states[n]);
+
+        Clear();
+    }
+
+private:
+    void Clear()
+    {
+        m_states.clear();
+        m_head = 0;
+    }
+
+    wxVector<wxThreadPoolTaskState*> m_states;
+
+    // the index of the first element of the queue in m_states
+    size_t m_head;
+
+    wxDECLARE_NO_COPY_CLASS(wxThreadPoolQueue);
+};
+
+// ----------------------------------------------------------------------------
+// wxThreadPoolImpl: the real implementation of wxThreadPool
+// ----------------------------------------------------------------------------
+
+// The pool uses a global queue for the tasks submitted from outside of the
+// pool threads and each of the pool threads has its own queue for the tasks
+// submitted by the tasks it runs. The threads take the tasks from their own
+// queue first, then from the global one and, finally, steal the oldest tasks
+// from the queues of the other threads. This avoids contention on a single
+// lock when the tasks submit many small subtasks.
+class wxThreadPoolImpl
+{
+public:
+    explicit wxThreadPoolImpl(int numThreads);
+    ~wxThreadPoolImpl();
+
+    int GetThreadCount() const { return m_threadCount; }
+
+    // Add the task to the appropriate queue, taking ownership of a reference
+    // to its state.
+    void Schedule(wxThreadPoolTaskState* state);
+
+    // Run a task from the queues, if there are any, return false otherwise.
+    bool RunOneTask(wxThreadPoolWorker* worker);
+
+    // Return the current thread worker if it belongs to this pool.
+    wxThreadPoolWorker* GetCurrentWorker() const;
+
+    void CancelAll();
+    void WaitAll();
+
+    size_t GetPendingCount() const
+    {
+        const wxInt32 count = m_pendingCount;
+        return count > 0 ? count : 0;
+    }
+
+    // The function executed by all pool threads.
+    void WorkerLoop(wxThreadPoolWorker* worker);
+
+private:
+    wxThreadPoolTaskState* FindTask(wxThreadPoolWorker* worker);
+
+    // Must be called once for every task passed to Schedule() after it ran or
+    // was cancelled.
+    void OnTaskFinished();
+
+    wxVector<wxThreadPoolWorker*> m_workers;
+
+    // the number of threads which were successfully started
+    int m_threadCount;
+
+    // protects m_queue and is used with the conditions below
+    mutable wxMutex m_mutex;
+
+    // signalled when a task is scheduled while some threads are sleeping
+    wxCondition m_workAvailable;
+
+    // signalled when m_activeCount becomes 0
+    wxCondition m_allDone;
+
+    // the global queue of tasks
+    wxThreadPoolQueue m_queue;
+
+    // the number of tasks in all the queues, this can be transiently negative
+    // as it's updated after adding the task to the queue
+    wxAtomicInt m_pendingCount;
+
+    // the number of tasks which were scheduled but not finished yet
+    wxAtomicInt m_activeCount;
+
+    // the number of threads waiting for m_workAvailable
+    wxAtomicInt m_sleepingCount;
+
+    // non-zero when the pool is being destroyed
+    wxAtomicInt m_shutdown;
+
+    wxDECLARE_NO_COPY_CLASS(wxThreadPoolImpl);
+};
+
+// ----------------------------------------------------------------------------
+// wxThreadPoolWorker: one of the pool threads
+// ----------------------------------------------------------------------------
+
+class wxThreadPoolWorker : public wxThread
+{
+public:
+    wxThreadPoolWorker(wxThreadPoolImpl& pool, size_t index)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_pool(pool),
+          m_index(index),
+          m_started(false)
+    {
+    }
+
+    wxThreadPoolImpl& GetPool() const { return m_pool; }
+    size_t GetIndex() const { return m_index; }
+
+    bool IsStarted() const { return m_started; }
+    void SetStarted() { m_started = true; }
+
+    void PushBack(wxThreadPoolTaskState* state)
+    {
+        wxCriticalSectionLocker lock(m_queueLock);
+
+        m_queue.PushBack(state);
+    }
+
+    wxThreadPoolTaskState* PopBack()
+    {
+        wxCriticalSectionLocker lock(m_queueLock);
+
+        return m_queue.PopBack();
+    }
+
+    wxThreadPoolTaskState* PopFront()
+    {
+        wxCriticalSectionLocker lock(m_queueLock);
+
+        return m_queue.PopFront();
+    }
+
+    void TakeAll(wxVector<wxThreadPoolTaskState*>& states)
+    {
+        wxCriticalSectionLocker lock(m_queueLock);
+
+        m_queue.TakeAll(states);
+    }
+
+protected:
+    virtual void *Entry() wxOVERRIDE
+    {
+        wxTHIS_THREAD_WORKER = this;
+
+        m_pool.WorkerLoop(this);
+
+        return NULL;
+    }
+
+private:
+    wxThreadPoolImpl& m_pool;
+    const size_t m_index;
+    bool m_started;
+
+    // the queue of the tasks submitted from this thread, other threads can
+    // steal tasks from it too
+    wxCriticalSection m_queueLock;
+    wxThreadPoolQueue m_queue;
+
+    wxDECLARE_NO_COPY_CLASS(wxThreadPoolWorker);
+};
+
+// ----------------------------------------------------------------------------
+// wxThreadPoolDoneFunctor: calls wxThreadPoolTask::OnDone() via CallAfter()
+// ----------------------------------------------------------------------------
+
+#ifdef wxHAS_CALL_AFTER
+
+class wxThreadPoolDoneFunctor
+{
+public:
+    explicit wxThreadPoolDoneFunctor(wxThreadPoolTaskState* state)
+        : m_state(state)
+    {
+        m_state->IncRef();
+    }
+
+    wxThreadPoolDoneFunctor(const wxThreadPoolDoneFunctor& other)
+        : m_state(other.m_state)
+    {
+        m_state->IncRef();
+    }
+
+    ~wxThreadPoolDoneFunctor()
+    {
+        m_state->DecRef();
+    }
+
+    void operator()()
+    {
+        m_state->GetTask()->OnDone();
+    }
+
+private:
+    wxThreadPoolTaskState* const m_state;
+
+    wxThreadPoolDoneFunctor& operator=(const wxThreadPoolDoneFunctor&);
+};
+
+#endif // wxHAS_CALL_AFTER
+
+// ============================================================================
+// implementation
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// wxThreadPoolTaskState
+// ----------------------------------------------------------------------------
+
+bool wxThreadPoolTaskState::Finish(Status status)
+{
+    wxVector<wxThreadPoolTaskState*> next;
+    {
+        wxMutexLocker lock(m_mutex);
+
+        if ( status == Status_Cancelled && m_status != Status_Pending )
+            return false;
+
+        m_status = status;
+
+        next = m_next;
+        m_next.clear();
+
+        m_condition.Broadcast();
+    }
+
+    for ( size_t n = 0; n < next.size(); n++ )
+    {
+        if ( status == Status_Done )
+        {
+            next[n]->GetPool().Schedule(next[n]);
+        }
+        else
+        {
+            next[n]->Finish(Status_Cancelled);
+            next[n]->DecRef();
+        }
+    }
+
+    return true;
+}
+
+bool wxThreadPoolTaskState::Wait()
+{
+    // If we're called from one of the pool threads, the task we're waiting
+    // for may not be able to run until we return, so run other tasks while
+    // waiting instead of blocking.
+    wxThreadPoolWorker* const worker = IsFinished()
+                                        ? NULL
+                                        : m_pool.GetCurrentWorker();
+
+    wxMutexLocker lock(m_mutex);
+
+    while ( m_status != Status_Done && m_status != Status_Cancelled )
+    {
+        if ( !worker )
+        {
+            m_condition.Wait();
+            continue;
+        }
+
+        m_mutex.Unlock();
+        const bool ranTask = m_pool.RunOneTask(worker);
+        m_mutex.Lock();
+
+        // If there are no tasks to run, the task we're waiting for must be
+        // running in another thread, but wake up periodically to help with
+        // the tasks it may submit.
+        if ( !ranTask &&
+                m_status != Status_Done && m_status != Status_Cancelled )
+            m_condition.WaitTimeout(10);
+    }
+
+    return m_status == Status_Done;
+}
+
+// ----------------------------------------------------------------------------
+// wxThreadPoolImpl
+// ----------------------------------------------------------------------------
+
+wxThreadPoolImpl::wxThreadPoolImpl(int numThreads)
+    : m_threadCount(0),
+      m_workAvailable(m_mutex),
+      m_allDone(m_mutex),
+      m_pendingCount(0),
+      m_activeCount(0),
+      m_sleepingCount(0),
+      m_shutdown(0)
+{
+    if ( numThreads <= 0 )
+        numThreads = wxThread::GetCPUCount();
+    if ( numThreads <= 0 )
+        numThreads = 1;
+
+    // Create all the workers before starting any of them as m_workers can't
+    // be modified once the threads, which use it, are running.
+    for ( int n = 0; n < numThreads; n++ )
+        m_workers.push_back(new wxThreadPoolWorker(*this, n));
+
+    for ( int n = 0; n < numThreads; n++ )
+    {
+        if ( m_workers[n]->Run() != wxTHREAD_NO_ERROR )
+        {
+            // The queue of this worker will just remain empty.
+            wxLogDebug(wxS("Failed to start thread pool thread."));
+            continue;
+        }
+
+        m_workers[n]->SetStarted();
+        m_threadCount++;
+    }
+}
+
+wxThreadPoolImpl::~wxThreadPoolImpl()
+{
+    {
+        wxMutexLocker lock(m_mutex);
+
+        wxAtomicInc(m_shutdown);
+        m_workAvailable.Broadcast();
+    }
+
+    for ( size_t n = 0; n < m_workers.size(); n++ )
+    {
+        if ( m_workers[n]->IsStarted() )
+            m_workers[n]->Wait();
+    }
+
+    // Cancel the tasks which were not started before the threads stopped
+    // before deleting the workers, as their queues could contain some.
+    CancelAll();
+
+    for ( size_t n = 0; n < m_workers.size(); n++ )
+        delete m_workers[n];
+}
+
+wxThreadPoolWorker* wxThreadPoolImpl::GetCurrentWorker() const
+{
+    wxThreadPoolWorker* const worker = wxTHIS_THREAD_WORKER;
+
+    return worker && &worker->GetPool() == this ? worker : NULL;
+}
+
+void wxThreadPoolImpl::Schedule(wxThreadPoolTaskState* state)
+{
+    wxAtomicInc(m_activeCount);
+
+    wxThreadPoolWorker* const worker = GetCurrentWorker();
+    if ( worker )
+    {
+        worker->PushBack(state);
+    }
+    else
+    {
+        wxMutexLocker lock(m_mutex);
+
+        m_queue.PushBack(state);
+    }
+
+    // Notice that this must be done after adding the task to the queue, see
+    // WorkerLoop(), and that both this and the check below act as memory
+    // barriers.
+    wxAtomicInc(m_pendingCount);
+
+    if ( m_sleepingCount > 0 )
+    {
+        wxMutexLocker lock(m_mutex);
+
+        m_workAvailable.Signal();
+    }
+}
+
+wxThreadPoolTaskState* wxThreadPoolImpl::FindTask(wxThreadPoolWorker* worker)
+{
+    wxThreadPoolTaskState* state = NULL;
+
+    // The most recently submitted task from our own queue is the most likely
+    // to use the data still in the CPU cache.
+    if ( worker )
+    {
+        state = worker->PopBack();
+        if ( state )
+            return state;
+    }
+
+    {
+        wxMutexLocker lock(m_mutex);
+
+        state = m_queue.PopFront();
+        if ( state )
+            return state;
+    }
+
+    // Try stealing the oldest task from the other threads, starting with the
+    // next one to avoid all threads stealing from the same one.
+    const size_t count = m_workers.size();
+    const size_t start = worker ? worker->GetIndex() + 1 : 0;
+    for ( size_t n = 0; n < count; n++ )
+    {
+        wxThreadPoolWorker* const other = m_workers[(start + n) % count];
+        if ( other == worker )
+            continue;
+
+        state = other->PopFront();
+        if ( state )
+            return state;
+    }
+
+    return NULL;
+}
+
+bool wxThreadPoolImpl::RunOneTask(wxThreadPoolWorker* worker)
+{
+    wxThreadPoolTaskState* const state = FindTask(worker);
+    if ( !state )
+        return false;
+
+    wxAtomicDec(m_pendingCount);
+
+    // The task could have been cancelled while it was in the queue.
+    if ( state->StartRunning() )
+    {
+        wxTRY
+        {
+            state->GetTask()->Run();
+        }
+        wxCATCH_ALL( if ( wxTheApp ) wxTheApp->OnUnhandledException(); )
+
+#ifdef wxHAS_CALL_AFTER
+        // Queue the call to OnDone() before marking the task as done, so that
+        // it is guaranteed to be pending once Wait() returns.
+        wxEvtHandler* const handler = state->GetHandler();
+        if ( handler )
+            handler->CallAfter(wxThreadPoolDoneFunctor(state));
+#endif // wxHAS_CALL_AFTER
+
+        state->Finish(wxThreadPoolTaskState::Status_Done);
+    }
+
+    state->DecRef();
+
+    OnTaskFinished();
+
+    return true;
+}
+
+void wxThreadPoolImpl::OnTaskFinished()
+{
+    if ( !wxAtomicDec(m_activeCount) )
+    {
+        wxMutexLocker lock(m_mutex);
+
+        m_allDone.Broadcast();
+    }
+}
+
+void wxThreadPoolImpl::WorkerLoop(wxThreadPoolWorker* worker)
+{
+    while ( !m_shutdown )
+    {
+        if ( RunOneTask(worker) )
+            continue;
+
+        wxMutexLocker lock(m_mutex);
+
+        // Incrementing the counter acts as a memory barrier, so either we see
+        // the task scheduled after we couldn't find it above or the thread
+        // scheduling it sees that we're sleeping and wakes us up, which can't
+        // happen before we start waiting as it needs to lock the mutex first.
+        wxAtomicInc(m_sleepingCount);
+
+        while ( m_pendingCount <= 0 && !m_shutdown )
+            m_workAvailable.Wait();
+
+        wxAtomicDec(m_sleepingCount);
+    }
+}
+
+void wxThreadPoolImpl::CancelAll()
+{
+    wxVector<wxThreadPoolTaskState*> states;
+
+    {
+        wxMutexLocker lock(m_mutex);
+
+        m_queue.TakeAll(states);
+    }
+
+    for ( size_t n = 0; n < m_workers.size(); n++ )
+        m_workers[n]->TakeAll(states);
+
+    for ( size_t n = 0; n < states.size(); n++ )
+    {
+        wxAtomicDec(m_pendingCount);
+
+        states[n]->Finish(wxThreadPoolTaskState::Status_Cancelled);
+        states[n]->DecRef();
+
+        OnTaskFinished();
+    }
+}
+
+void wxThreadPoolImpl::WaitAll()
+{
+    wxCHECK_RET( !GetCurrentWorker(),
+                 wxS("can't wait for all tasks from a pool thread") );
+
+    wxMutexLocker lock(m_mutex);
+
+    while ( m_activeCount > 0 )
+        m_allDone.Wait();
+}
+
+// ============================================================================
+// wxThreadPoolFuture implementation
+// ============================================================================
+
+wxThreadPoolFuture::wxThreadPoolFuture(const wxThreadPoolFuture& other)
+    : m_state(other.m_state)
+{
+    if ( m_state )
+        m_state->IncRef();
+}
+
+wxThreadPoolFuture&
+wxThreadPoolFuture::operator=(const wxThreadPoolFuture& other)
+{
+    if ( other.m_state )
+        other.m_state->IncRef();
+    if ( m_state )
+        m_state->DecRef();
+
+    m_state = other.m_state;
+
+    return *this;
+}
+
+wxThreadPoolFuture::~wxThreadPoolFuture()
+{
+    if ( m_state )
+        m_state->DecRef();
+}
+
+bool wxThreadPoolFuture::IsDone() const
+{
+    wxCHECK_MSG( m_state, false, wxS("invalid future") );
+
+    return m_state->IsFinished();
+}
+
+bool wxThreadPoolFuture::IsCancelled() const
+{
+    wxCHECK_MSG( m_state, false, wxS("invalid future") );
+
+    return m_state->GetStatus() == wxThreadPoolTaskState::Status_Cancelled;
+}
+
+bool wxThreadPoolFuture::Wait()
+{
+    wxCHECK_MSG( m_state, false, wxS("invalid future") );
+
+    return m_state->Wait();
+}
+
+bool wxThreadPoolFuture::Cancel()
+{
+    wxCHECK_MSG( m_state, false, wxS("invalid future") );
+
+    return m_state->Finish(wxThreadPoolTaskState::Status_Cancelled);
+}
+
+wxThreadPoolTask* wxThreadPoolFuture::GetTask() const
+{
+    wxCHECK_MSG( m_state, NULL, wxS("invalid future") );
+
+    return m_state->GetTask();
+}
+
+// ============================================================================
+// wxThreadPool implementation
+// ============================================================================
+
+wxThreadPool::wxThreadPool(int numThreads)
+    : m_impl(new wxThreadPoolImpl(numThreads))
+{
+}
+
+wxThreadPool::~wxThreadPool()
+{
+    delete m_impl;
+}
+
+int wxThreadPool::GetThreadCount() const
+{
+    return m_impl->GetThreadCount();
+}
+
+wxThreadPoolFuture
+wxThreadPool::Submit(wxThreadPoolTask* task, wxEvtHandler* handler)
+{
+    wxCHECK_MSG( task, wxThreadPoolFuture(), wxS("NULL task") );
+
+    if ( !m_impl->GetThreadCount() )
+    {
+        wxFAIL_MSG( wxS("no threads to run the task") );
+
+        delete task;
+        return wxThreadPoolFuture();
+    }
+
+    wxThreadPoolTaskState* const
+        state = new wxThreadPoolTaskState(*m_impl, task, handler);
+
+    // One reference is owned by the future and another one by the queue.
+    state->IncRef();
+    m_impl->Schedule(state);
+
+    return wxThreadPoolFuture(state);
+}
+
+wxThreadPoolFuture
+wxThreadPool::SubmitAfter(const wxThreadPoolFuture& previous,
+                          wxThreadPoolTask* task,
+                          wxEvtHandler* handler)
+{
+    if ( !previous.IsOk() )
+    {
+        wxFAIL_MSG( wxS("invalid future") );
+
+        delete task;
+        return wxThreadPoolFuture();
+    }
+
+    wxCHECK_MSG( task, wxThreadPoolFuture(), wxS("NULL task") );
+
+    wxThreadPoolTaskState* const
+        state = new wxThreadPoolTaskState(*m_impl, task, handler);
+
+    state->IncRef();
+    if ( !previous.m_state->AddNext(state) )
+    {
+        // The previous task has already finished, so either submit this one
+        // immediately or cancel it too.
+        if ( previous.m_state->GetStatus() ==
+                wxThreadPoolTaskState::Status_Done && m_impl->GetThreadCount() )
+        {
+            m_impl->Schedule(state);
+        }
+        else
+        {
+            state->Finish(wxThreadPoolTaskState::Status_Cancelled);
+            state->DecRef();
+        }
+    }
+
+    return wxThreadPoolFuture(state);
+}
+
+void wxThreadPool::CancelAll()
+{
+    m_impl->CancelAll();
+}
+
+void wxThreadPool::WaitAll()
+{
+    m_impl->WaitAll();
+}
+
+size_t wxThreadPool::GetPendingCount() const
+{
+    return m_impl->GetPendingCount();
+}
+
+#endif // wxUSE_THREADS
@@ -46,9 +46,13 @@
 #include "wx/imaglist.h"
 #include "wx/headerctrl.h"
 #include "wx/dnd.h"
+#include "wx/hashmap.h"
 #include "wx/selstore.h"
 #include "wx/stopwatch.h"
 #include "wx/weakref.h"
+#if wxUSE_THREADS
+    #include "wx/thread.h"
+#endif // wxUSE_THREADS
 #include "wx/generic/private/markuptext.h"
 #include "wx/generic/private/rowheightcache.h"
 #include "wx/generic/private/widthcalc.h"
@@ -74,7 +78,7 @@ static const int PADDING_RIGHTLEFT = 3;
 namespace
 {
 
-// Flags for Walker() function defined below.
+// Flags for GetRowByItem() function defined below.
 enum WalkFlags
 {
     Walk_All,               // Visit all items.
@@ -478,6 +482,9 @@ class wxDataViewTreeNode;
 
 typedef wxVector<wxDataViewTreeNode*> wxDataViewTreeNodes;
 
+WX_DECLARE_HASH_MAP(void*, wxDataViewTreeNode*, wxPointerHash, wxPointerEqual,
+                    wxDataViewTreeNodeItemMap);
+
 // Note: this class is not used at all for virtual list models, so all code
 // using it, i.e. any functions taking or returning objects of this type,
 // including wxDataViewMainWindow::m_root, can only be called after checking
@@ -489,7 +496,8 @@ public:
     wxDataViewTreeNode(wxDataViewTreeNode *parent, const wxDataViewItem& item)
         : m_parent(parent),
           m_item(item),
-          m_branchData(NULL)
+          m_branchData(NULL),
+          m_indexInParent(0)
     {
     }
 
@@ -539,14 +547,37 @@ public:
         if ( !m_branchData )
             return wxNOT_FOUND;
 
-        const wxDataViewTreeNodes& nodes = m_branchData->children;
-        const int len = nodes.size();
-        for ( int i = 0; i < len; i++ )
-        {
-            if ( nodes[i]->m_item == item )
-                return i;
-        }
-        return wxNOT_FOUND;
+        return m_branchData->FindChildByItem(item);
+    }
+
+    // returns position of the given child node in children list
+    int GetChildIndex(const wxDataViewTreeNode* child) const
+    {
+        wxASSERT( m_branchData && child->m_parent == this );
+
+        m_branchData->UpdateIndex();
+        return child->m_indexInParent;
+    }
+
+    // returns the number of rows occupied by the children preceding the child
+    // with the given index and their subtrees
+    int GetRowsBeforeChild(int index) const
+    {
+        wxASSERT( m_branchData );
+
+        return m_branchData->GetRowsBefore(index);
+    }
+
+    // returns the child whose subtree contains the given row, counted from
+    // the row just after this node, and adjusts the row to be relative to this
+    // child (i.e. it is 0 if the row is the child itself) or NULL if the row
+    // is beyond this node subtree
+    wxDataViewTreeNode* GetChildByRow(int& row) const
+    {
+        if ( !m_branchData )
+            return NULL;
+
+        return m_branchData->FindChildByRow(row);
     }
 
     const wxDataViewItem & GetItem() const { return m_item; }
@@ -639,11 +670,48 @@ public:
         wxASSERT( m_branchData->subTreeCount >= 0 );
 
         if( m_parent )
+        {
+            if ( m_parent->m_branchData )
+                m_parent->m_branchData->ChangeChildRows(m_indexInParent, num);
+
             m_parent->ChangeSubTreeCount(num);
+        }
     }
 
     void Resort(wxDataViewMainWindow* window);
 
+    // Functions used for sorting the children in a background thread: once
+    // the job is started, the children are considered to be unsorted until
+    // it's finished.
+    void StartSortJob(int jobId)
+    {
+        wxASSERT( m_branchData );
+
+        m_branchData->sortOrder = SortOrder();
+        m_branchData->sortJobId = jobId;
+        m_branchData->sortJobStale = false;
+    }
+
+    bool IsSortJobPending(int jobId) const
+    {
+        return m_branchData && m_branchData->sortJobId == jobId;
+    }
+
+    bool IsSortJobStale() const
+    {
+        return m_branchData && m_branchData->sortJobStale;
+    }
+
+    void CancelSortJob()
+    {
+        if ( m_branchData )
+            m_branchData->sortJobId = 0;
+    }
+
+    // Reorder the children using the result of the sort job, the n-th child
+    // after reordering is the one which was at order[n] position before.
+    void FinishSortJob(const wxVector<unsigned>& order, const SortOrder& sortOrder);
+
     // Should be called after changing the item value to update its position in
     // the control if necessary.
     void PutInSortOrder(wxDataViewMainWindow* window)
@@ -652,6 +720,26 @@ public:
             m_parent->PutChildInSortOrder(window, this);
     }
 
+    // Used instead of PutInSortOrder() when changes are batched: mark the
+    // siblings of this node as unsorted, so that they're sorted again by the
+    // next call to Resort(). Returns false if there is nothing to do.
+    bool DeferPutInSortOrder()
+    {
+        if ( !m_parent || !m_parent->IsOpen() )
+            return false;
+
+        BranchNodeData* const parentData = m_parent->m_branchData;
+        parentData->InvalidateSortJob();
+
+        if ( parentData->sortOrder.IsNone() )
+            return parentData->sortDeferred;
+
+        parentData->sortOrder = SortOrder();
+        parentData->sortDeferred = true;
+
+        return true;
+    }
+
 private:
     // Called by the child after it has been updated to put it in the right
     // place among its siblings, depending on the sort order.
@@ -672,18 +760,163 @@ private:
     {
         BranchNodeData()
             : open(false),
-              subTreeCount(0)
+              subTreeCount(0),
+              indexValid(true),
+              itemIndex(NULL),
+              sortJobId(0),
+              sortJobStale(false),
+              sortDeferred(false)
         {
         }
 
+        ~BranchNodeData()
+        {
+            delete itemIndex;
+        }
+
         void InsertChild(wxDataViewTreeNode* node, unsigned index)
         {
             children.insert(children.begin() + index, node);
+
+            if ( itemIndex )
+                (*itemIndex)[node->m_item.GetID()] = node;
+
+            InvalidateIndex();
+            InvalidateSortJob();
         }
 
         void RemoveChild(unsigned index)
         {
+            if ( itemIndex )
+                itemIndex->erase(children[index]->m_item.GetID());
+
             children.erase(children.begin() + index);
+
+            InvalidateIndex();
+            InvalidateSortJob();
+        }
+
+        // Must be called after changing the order of children.
+        void InvalidateIndex()
+        {
+            indexValid = false;
+        }
+
+        // Must be called after changing the children or their values as the
+        // result of the pending background sorting can't be used any more.
+        void InvalidateSortJob()
+        {
+            if ( sortJobId )
+                sortJobStale = true;
+        }
+
+        // Recompute the positions of the children and the tree of their row
+        // counts if they're not up to date.
+        void UpdateIndex() const
+        {
+            if ( indexValid )
+                return;
+
+            const size_t count = children.size();
+            rowsTree.resize(count);
+            for ( size_t n = 0; n < count; n++ )
+            {
+                children[n]->m_indexInParent = n;
+                rowsTree[n] = 1 + children[n]->GetSubTreeCount();
+            }
+
+            // Build the Fenwick tree in place: each element stores the sum of
+            // the row counts of the children in the range ending at it and of
+            // length equal to the lowest bit of its (1-based) index.
+            for ( size_t i = 1; i <= count; i++ )
+            {
+                const size_t next = i + (i & (~i + 1));
+                if ( next <= count )
+                    rowsTree[next - 1] += rowsTree[i - 1];
+            }
+
+            indexValid = true;
+        }
+
+        // Update the index after the number of rows in the subtree of the
+        // given child changed.
+        void ChangeChildRows(size_t index, int num)
+        {
+            // Nothing to do if the index will be recomputed anyhow.
+            if ( !indexValid )
+                return;
+
+            const size_t count = rowsTree.size();
+            for ( size_t i = index + 1; i <= count; i += i & (~i + 1) )
+                rowsTree[i - 1] += num;
+        }
+
+        int GetRowsBefore(size_t index) const
+        {
+            UpdateIndex();
+
+            int rows = 0;
+            for ( size_t i = index; i > 0; i -= i & (~i + 1) )
+                rows += rowsTree[i - 1];
+
+            return rows;
+        }
+
+        wxDataViewTreeNode* FindChildByRow(int& row) const
+        {
+            UpdateIndex();
+
+            const size_t count = rowsTree.size();
+
+            size_t mask = 1;
+            while ( mask <= count / 2 )
+                mask <<= 1;
+
+            // Find the number of the children before the one containing the
+            // row by descending the tree.
+            size_t pos = 0;
+            for ( ; count && mask; mask >>= 1 )
+            {
+                const size_t next = pos + mask;
+                if ( next <= count && rowsTree[next - 1] <= row )
+                {
+                    pos = next;
+                    row -= rowsTree[next - 1];
+                }
+            }
+
+            return pos < count ? children[pos] : NULL;
+        }
+
+        int FindChildByItem(const wxDataViewItem& item) const
+        {
+            // Linear search is fast enough for a few children and avoids
+            // allocating the index for them.
+            const int len = children.size();
+            if ( len < 16 && !itemIndex )
+            {
+                for ( int i = 0; i < len; i++ )
+                {
+                    if ( children[i]->m_item == item )
+                        return i;
+                }
+                return wxNOT_FOUND;
+            }
+
+            if ( !itemIndex )
+            {
+                itemIndex = new wxDataViewTreeNodeItemMap(len);
+                for ( int i = 0; i < len; i++ )
+                    (*itemIndex)[children[i]->m_item.GetID()] = children[i];
+            }
+
+            wxDataViewTreeNodeItemMap::const_iterator it =
+                itemIndex->find(item.GetID());
+            if ( it == itemIndex->end() )
+                return wxNOT_FOUND;
+
+            UpdateIndex();
+            return it->second->m_indexInParent;
         }
 
         // Child nodes. Note that this may be empty even if m_hasChildren in
@@ -701,13 +934,257 @@ private:
         // 0 for leaves and is the number of rows the subtree occupies for
         // branch nodes.
         int                  subTreeCount;
+
+        // Whether m_indexInParent of the children and rowsTree are valid.
+        mutable bool         indexValid;
+
+        // Fenwick tree of the number of rows occupied by each child, including
+        // its subtree, allowing to find the child by row and vice versa in
+        // logarithmic time.
+        mutable wxVector<int> rowsTree;
+
+        // Map of the items to the child nodes, only created for the branches
+        // with many children, when it's needed.
+        mutable wxDataViewTreeNodeItemMap* itemIndex;
+
+        // Identifier of the job sorting the children in a background thread
+        // or 0 if none. While it's pending, the children are not sorted.
+        int                  sortJobId;
+
+        // Whether the children changed since the sort job was started.
+        bool                 sortJobStale;
+
+        // Whether the children of this open node are not sorted because
+        // their changes are being batched and they will be resorted later.
+        bool                 sortDeferred;
     };
 
     BranchNodeData *m_branchData;
+
+    // Position of this node in the children list of its parent, only valid if
+    // the parent indexValid is true.
+    mutable size_t       m_indexInParent;
 };
 
 
 
+#if wxUSE_THREADS
+
+//-----------------------------------------------------------------------------
+// wxDataViewSortThread
+//-----------------------------------------------------------------------------
+
+// This thread sorts the children of a node using the values of the sort column
+// retrieved from the model beforehand, as the model can't be used from it, and
+// sends wxEVT_THREAD event with the job id to the main window when it's done.
+class wxDataViewSortThread : public wxThread
+{
+public:
+    wxDataViewSortThread(wxEvtHandler* handler,
+                         int jobId,
+                         wxDataViewTreeNode* node,
+                         const SortOrder& sortOrder)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_handler(handler),
+          m_jobId(jobId),
+          m_node(node),
+          m_sortOrder(sortOrder),
+          m_valueType(Value_Integer)
+    {
+    }
+
+    // Must be called before running the thread to retrieve the values to sort
+    // by. Returns false if they can't be compared in the same way as
+    // wxDataViewModel::Compare() does it, without using the model.
+    bool GetValues(const wxDataViewModel* model)
+    {
+        const wxDataViewTreeNodes& nodes = m_node->GetChildNodes();
+        const unsigned column = m_sortOrder.GetColumn();
+        const size_t count = nodes.size();
+
+        m_ids.reserve(count);
+        m_order.reserve(count);
+
+        wxString type;
+        for ( size_t n = 0; n < count; n++ )
+        {
+            const wxDataViewItem& item = nodes[n]->GetItem();
+            if ( !model->HasValue(item, column) )
+                return false;
+
+            wxVariant value;
+            model->GetValue(value, item, column);
+
+            if ( !n )
+            {
+                type = value.GetType();
+                if ( type == wxS("string") || type == wxS("wxDataViewIconText") )
+                {
+                    m_valueType = Value_String;
+                    m_strings.reserve(count);
+                }
+                else if ( type == wxS("double") )
+                {
+                    m_valueType = Value_Double;
+                    m_doubles.reserve(count);
+                }
+                else if ( type == wxS("long") ||
+#if wxUSE_DATETIME
+                          type == wxS("datetime") ||
+#endif // wxUSE_DATETIME
+                          type == wxS("bool") )
+                {
+                    m_valueType = Value_Integer;
+                    m_integers.reserve(count);
+                }
+                else
+                {
+                    // Comparing the values of other types requires calling
+                    // the model DoCompareValues().
+                    return false;
+                }
+            }
+            else if ( value.GetType() != type )
+            {
+                return false;
+            }
+
+            switch ( m_valueType )
+            {
+                case Value_String:
+                    if ( type == wxS("string") )
+                    {
+                        // Make a deep copy as the string is going to be used
+                        // by another thread.
+                        m_strings.push_back(value.GetString().Clone());
+                    }
+                    else
+                    {
+                        wxDataViewIconText iconText;
+                        iconText << value;
+                        m_strings.push_back(iconText.GetText().Clone());
+                    }
+                    break;
+
+                case Value_Integer:
+                    if ( type == wxS("long") )
+                        m_integers.push_back(value.GetLong());
+                    else if ( type == wxS("bool") )
+                        m_integers.push_back(value.GetBool());
+#if wxUSE_DATETIME
+                    else
+                        m_integers.push_back(value.GetDateTime().GetValue().GetValue());
+#endif // wxUSE_DATETIME
+                    break;
+
+                case Value_Double:
+                    m_doubles.push_back(value.GetDouble());
+                    break;
+            }
+
+            m_ids.push_back(wxPtrToUInt(item.GetID()));
+            m_order.push_back(n);
+        }
+
+        return true;
+    }
+
+    int GetJobId() const { return m_jobId; }
+    const SortOrder& GetSortOrder() const { return m_sortOrder; }
+
+    // Returns NULL if the job was cancelled.
+    wxDataViewTreeNode* GetNode() const { return m_node; }
+    void Cancel() { m_node = NULL; }
+
+    // Can only be used after the thread terminates.
+    const wxVector<unsigned>& GetOrder() const { return m_order; }
+
+protected:
+    virtual void *Entry() wxOVERRIDE
+    {
+        std::sort(m_order.begin(), m_order.end(), Less(*this));
+
+        wxThreadEvent* const event = new wxThreadEvent();
+        event->SetInt(m_jobId);
+        wxQueueEvent(m_handler, event);
+
+        return NULL;
+    }
+
+private:
+    // Compares the children in the same way as wxDataViewModel::Compare().
+    class Less
+    {
+    public:
+        explicit Less(const wxDataViewSortThread& thread) : m_thread(thread) { }
+
+        bool operator()(unsigned first, unsigned second) const
+        {
+            const int res = m_thread.Compare(first, second);
+            return m_thread.m_sortOrder.IsAscending() ? res < 0 : res > 0;
+        }
+
+    private:
+        const wxDataViewSortThread& m_thread;
+    };
+
+    int Compare(unsigned first, unsigned second) const
+    {
+        switch ( m_valueType )
+        {
+            case Value_String:
+                {
+                    const int res = m_strings[first].Cmp(m_strings[second]);
+                    if ( res )
+                        return res;
+                }
+                break;
+
+            case Value_Integer:
+                if ( m_integers[first] != m_integers[second] )
+                    return m_integers[first] < m_integers[second] ? -1 : 1;
+                break;
+
+            case Value_Double:
+                if ( m_doubles[first] < m_doubles[second] )
+                    return -1;
+                if ( m_doubles[first] > m_doubles[second] )
+                    return 1;
+                break;
+        }
+
+        // Items must be different.
+        return m_ids[first] < m_ids[second] ? -1 : 1;
+    }
+
+    wxEvtHandler* const m_handler;
+    const int m_jobId;
+    wxDataViewTreeNode* m_node;
+    const SortOrder m_sortOrder;
+
+    // Only one of the vectors of values, depending on m_valueType, is used.
+    enum
+    {
+        Value_String,
+        Value_Integer,
+        Value_Double
+    } m_valueType;
+
+    wxVector<wxString> m_strings;
+    wxVector<wxLongLong_t> m_integers;
+    wxVector<double> m_doubles;
+
+    // Identifiers of the items, used for the items with equal values.
+    wxVector<wxUIntPtr> m_ids;
+
+    // Indices of the children, in the sort order after the thread terminates.
+    wxVector<unsigned> m_order;
+
+    wxDECLARE_NO_COPY_CLASS(wxDataViewSortThread);
+};
+
+#endif // wxUSE_THREADS
+
 //-----------------------------------------------------------------------------
 // wxDataViewMainWindow
 //-----------------------------------------------------------------------------
@@ -736,6 +1213,8 @@ public:
     bool Cleared();
     void Resort()
     {
+        AddBatchedItems();
+
         ClearRowHeightCache();
 
         if (!IsVirtualList())
@@ -750,6 +1229,55 @@ public:
             m_rowHeightCache->Clear();
     }
 
+    // Invalidate the cached heights of the given row and all rows after it,
+    // does nothing if the row is invalid.
+    //
+    // During a batch, only the first row is remembered and the heights are
+    // invalidated once at its end.
+    void InvalidateRowHeights(int row)
+    {
+        if ( !m_rowHeightCache || row < 0 )
+            return;
+
+        if ( m_batchCount )
+        {
+            if ( m_batchFirstChangedRow == -1 || row < m_batchFirstChangedRow )
+                m_batchFirstChangedRow = row;
+        }
+        else
+        {
+            m_rowHeightCache->Remove(row);
+        }
+    }
+
+    // Batch the changes notified by the model: the added items are not
+    // inserted, the items are not moved to their sorted position and the
+    // window is not refreshed until the outermost EndBatch() call.
+    void BeginBatch() { m_batchCount++; }
+    void EndBatch();
+
+    // Forget about any batch in progress, used when the model changes.
+    void ResetBatch()
+    {
+        m_batchCount = 0;
+        m_batchNeedsResort =
+        m_batchNeedsRefresh =
+        m_batchNeedsColWidths = false;
+        m_batchFirstChangedRow = -1;
+        m_batchAddedItems.clear();
+    }
+
+    // Set the minimal number of children of a node for sorting them in a
+    // background thread, 0 to never do it.
+    void SetBackgroundSortingThreshold(unsigned minChildren)
+    {
+        m_backgroundSortingThreshold = minChildren;
+    }
+
+    // Start sorting the children of the given node in a background thread if
+    // possible, return false if they must be sorted synchronously instead.
+    bool SortInBackground(wxDataViewTreeNode* node, const SortOrder& sortOrder);
+
     SortOrder GetSortOrder() const
     {
         wxDataViewColumn* const col = GetOwner()->GetSortingColumn();
@@ -972,6 +1500,16 @@ private:
     // assumes that all columns were modified, otherwise just this one.
     bool DoItemChanged(const wxDataViewItem& item, int view_column);
 
+    // Insert the nodes of the items added during the batch, returns false if
+    // any of them couldn't be added.
+    bool AddBatchedItems();
+
+    // Insert the nodes of the given children of the parent item and append
+    // the items for which they were created to newItems.
+    bool AddChildNodes(const wxDataViewItem& parent,
+                       const wxDataViewItemArray& items,
+                       wxDataViewItemArray& newItems);
+
     // Return whether the item has at most one column with a value.
     bool IsItemSingleValued(const wxDataViewItem& item) const
     {
@@ -1008,6 +1546,14 @@ private:
     // Helper of public Expand(), must be called with a valid node.
     void DoExpand(wxDataViewTreeNode* node, unsigned int row, bool expandChildren);
 
+#if wxUSE_THREADS
+    void OnSortThreadDone(wxThreadEvent& event);
+
+    // Discard the results of the background sort jobs for the given node and
+    // all its descendants or for all nodes if it's NULL.
+    void CancelBackgroundSorting(const wxDataViewTreeNode* node = NULL);
+#endif // wxUSE_THREADS
+
 private:
     wxDataViewCtrl             *m_owner;
     int                         m_lineHeight;
@@ -1058,6 +1604,43 @@ private:
     // Id m_editorCtrl is non-NULL, pointer to the associated renderer.
     wxDataViewRenderer* m_editorRenderer;
 
+    // The minimal number of children for sorting them in background or 0.
+    unsigned m_backgroundSortingThreshold;
+
+    // The nesting level of BeginBatch() calls and the updates postponed until
+    // the end of the batch.
+    int m_batchCount;
+    bool m_batchNeedsResort;
+    bool m_batchNeedsRefresh;
+    bool m_batchNeedsColWidths;
+    int m_batchFirstChangedRow;
+
+    // An item added to the model during the batch.
+    struct AddedItem
+    {
+        AddedItem(const wxDataViewItem& parent_, const wxDataViewItem& item_)
+            : parent(parent_), item(item_)
+        {
+        }
+
+        wxDataViewItem parent,
+                       item;
+    };
+
+    // The items added during the batch, in the order of their addition. They
+    // are only inserted in the tree when the batch ends or before handling
+    // any other change, which allows to do it for all of them at once.
+    wxVector<AddedItem> m_batchAddedItems;
+
+#if wxUSE_THREADS
+    // The threads sorting the nodes children in background, including the
+    // cancelled ones which are still running.
+    wxVector<wxDataViewSortThread*> m_sortThreads;
+
+    // The id of the last started sort job, used to generate unique ids.
+    int m_lastSortJobId;
+#endif // wxUSE_THREADS
+
 private:
     wxDECLARE_DYNAMIC_CLASS(wxDataViewMainWindow);
     wxDECLARE_EVENT_TABLE();
@@ -1085,6 +1668,10 @@ public:
         { return m_mainWindow->Cleared(); }
     virtual void Resort() wxOVERRIDE
         { m_mainWindow->Resort(); }
+    virtual void BeginBatch() wxOVERRIDE
+        { m_mainWindow->BeginBatch(); }
+    virtual void EndBatch() wxOVERRIDE
+        { m_mainWindow->EndBatch(); }
 
     wxDataViewMainWindow    *m_mainWindow;
 };
@@ -1839,9 +2426,11 @@ void wxDataViewTreeNode::InsertChild(wxDataViewMainWindow* window,
             m_branchData->sortOrder = SortOrder();
         }
     }
-    else if ( m_branchData->open )
+    else if ( m_branchData->open &&
+                !m_branchData->sortJobId && !m_branchData->sortDeferred )
     {
-        // For open branches, children should be already sorted.
+        // For open branches, children should be already sorted, unless they
+        // are being sorted in background or their sorting was deferred.
         wxASSERT_MSG( m_branchData->sortOrder == sortOrder,
                       wxS("Logic error in wxDVC sorting code") );
 
@@ -1908,11 +2497,18 @@ void wxDataViewTreeNode::Resort(wxDataViewMainWindow* window)
         // using model-specific sort order, which can change at any time.
         if ( m_branchData->sortOrder != sortOrder || !sortOrder.UsesColumn() )
         {
-            std::sort(m_branchData->children.begin(),
-                      m_branchData->children.end(),
-                      wxGenericTreeModelNodeCmp(window, sortOrder));
+            m_branchData->sortDeferred = false;
 
-            m_branchData->sortOrder = sortOrder;
+            if ( !window->SortInBackground(this, sortOrder) )
+            {
+                std::sort(m_branchData->children.begin(),
+                          m_branchData->children.end(),
+                          wxGenericTreeModelNodeCmp(window, sortOrder));
+                m_branchData->InvalidateIndex();
+
+                m_branchData->sortOrder = sortOrder;
+                m_branchData->sortJobId = 0;
+            }
         }
 
         // There may be open child nodes that also need a resort.
@@ -1935,6 +2531,11 @@ wxDataViewTreeNode::PutChildInSortOrder(wxDataViewMainWindow* window,
 
     if ( !m_branchData )
         return;
+
+    // The child will be put in the right place when the children are sorted
+    // again after the background sort job finishes.
+    m_branchData->InvalidateSortJob();
+
     if ( !m_branchData->open )
         return;
     if ( m_branchData->sortOrder.IsNone() )
@@ -1951,17 +2552,8 @@ wxDataViewTreeNode::PutChildInSortOrder(wxDataViewMainWindow* window,
     wxASSERT(m_branchData->sortOrder == window->GetSortOrder());
 
     // First find the node in the current child list
-    int hi = nodes.size();
-    int oldLocation = wxNOT_FOUND;
-    for ( int index = 0; index < hi; ++index )
-    {
-        if ( nodes[index] == childNode )
-        {
-            oldLocation = index;
-            break;
-        }
-    }
-    wxCHECK_RET( oldLocation >= 0, "not our child?" );
+    const int oldLocation = GetChildIndex(childNode);
+    wxCHECK_RET( nodes[oldLocation] == childNode, "not our child?" );
 
     wxGenericTreeModelNodeCmp cmp(window, m_branchData->sortOrder);
 
@@ -1987,7 +2579,7 @@ wxDataViewTreeNode::PutChildInSortOrder(wxDataViewMainWindow* window,
 
     // Remove and reinsert the node in the child list
     m_branchData->RemoveChild(oldLocation);
-    hi = nodes.size();
+    int hi = nodes.size();
     int lo = 0;
     while ( lo < hi )
     {
@@ -2006,6 +2598,25 @@ wxDataViewTreeNode::PutChildInSortOrder(wxDataViewMainWindow* window,
     window->UpdateDisplay();
 }
 
+void
+wxDataViewTreeNode::FinishSortJob(const wxVector<unsigned>& order,
+                                  const SortOrder& sortOrder)
+{
+    wxDataViewTreeNodes& nodes = m_branchData->children;
+    wxCHECK_RET( order.size() == nodes.size(), "children changed" );
+
+    wxDataViewTreeNodes sorted;
+    sorted.reserve(nodes.size());
+    for ( size_t n = 0; n < order.size(); n++ )
+        sorted.push_back(nodes[order[n]]);
+
+    nodes.swap(sorted);
+    m_branchData->InvalidateIndex();
+
+    m_branchData->sortOrder = sortOrder;
+    m_branchData->sortJobId = 0;
+}
+
 
 //-----------------------------------------------------------------------------
 // wxDataViewMainWindow
@@ -2026,6 +2637,9 @@ wxBEGIN_EVENT_TABLE(wxDataViewMainWindow,wxWindow)
     EVT_KILL_FOCUS    (wxDataViewMainWindow::OnKillFocus)
     EVT_CHAR_HOOK     (wxDataViewMainWindow::OnCharHook)
     EVT_CHAR          (wxDataViewMainWindow::OnChar)
+#if wxUSE_THREADS
+    EVT_THREAD        (wxID_ANY, wxDataViewMainWindow::OnSortThreadDone)
+#endif // wxUSE_THREADS
 wxEND_EVENT_TABLE()
 
 wxDataViewMainWindow::wxDataViewMainWindow( wxDataViewCtrl *parent, wxWindowID id,
@@ -2053,6 +2667,12 @@ wxDataViewMainWindow::wxDataViewMainWindow( wxDataViewCtrl *parent, wxWindowID i
 
     m_editorRenderer = NULL;
 
+    m_backgroundSortingThreshold = 0;
+    ResetBatch();
+#if wxUSE_THREADS
+    m_lastSortJobId = 0;
+#endif // wxUSE_THREADS
+
     m_lastOnSame = false;
     m_renameTimer = new wxDataViewRenameTimer( this );
 
@@ -2103,6 +2723,14 @@ wxDataViewMainWindow::wxDataViewMainWindow( wxDataViewCtrl *parent, wxWindowID i
 
 wxDataViewMainWindow::~wxDataViewMainWindow()
 {
+#if wxUSE_THREADS
+    for ( size_t n = 0; n < m_sortThreads.size(); n++ )
+    {
+        m_sortThreads[n]->Wait();
+        delete m_sortThreads[n];
+    }
+#endif // wxUSE_THREADS
+
     DestroyTree();
     delete m_renameTimer;
     delete m_rowHeightCache;
@@ -3017,160 +3645,223 @@ void wxDataViewHeaderWindow::FinishEditing()
     win->FinishEditing();
 }
 
-//-----------------------------------------------------------------------------
-// Helper class for do operation on the tree node
-//-----------------------------------------------------------------------------
-
-namespace
+bool wxDataViewMainWindow::ItemAdded(const wxDataViewItem & parent, const wxDataViewItem & item)
 {
+    if (IsVirtualList())
+    {
+        wxDataViewVirtualListModel *list_model =
+            (wxDataViewVirtualListModel*) GetModel();
+        m_count = list_model->GetCount();
 
-class DoJob
+        const int row = GetRowByItem(item);
+
+        m_selection.OnItemsInserted(row, 1);
+
+        // Only the new item needs to be measured to update the best widths.
+        if ( row != -1 )
+            GetOwner()->UpdateColBestWidths(row, 1);
+
+        if ( m_batchCount )
+            m_batchNeedsRefresh = true;
+        else
+            UpdateDisplay();
+
+        return true;
+    }
+
+    // During a batch, all the items are added at once when it ends, which
+    // allows to get the children of their parent from the model only once.
+    m_batchAddedItems.push_back(AddedItem(parent, item));
+
+    return m_batchCount ? true : AddBatchedItems();
+}
+
+bool wxDataViewMainWindow::AddBatchedItems()
 {
-public:
-    DoJob() { }
-    virtual ~DoJob() { }
+    if ( m_batchAddedItems.empty() )
+        return true;
 
-    // The return value control how the tree-walker tranverse the tree
-    enum
+    wxVector<AddedItem> added;
+    added.swap(m_batchAddedItems);
+
+    bool ok = true;
+
+    wxDataViewItemArray newItems;
+    for ( size_t first = 0; first < added.size(); )
     {
-        DONE,          // Job done, stop traversing and return
-        SKIP_SUBTREE,  // Ignore the current node's subtree and continue
-        CONTINUE       // Job not done, continue
-    };
+        // Add all the consecutive items with the same parent together, but
+        // keep the order of the items with different parents, as they may be
+        // the children of the items added before them.
+        const wxDataViewItem parent = added[first].parent;
 
-    virtual int operator() ( wxDataViewTreeNode * node ) = 0;
-};
+        wxDataViewItemArray items;
+        size_t last = first;
+        for ( ; last < added.size() && added[last].parent == parent; last++ )
+            items.push_back(added[last].item);
 
-bool
-Walker(wxDataViewTreeNode * node, DoJob & func, WalkFlags flags = Walk_All)
-{
-    wxCHECK_MSG( node, false, "can't walk NULL node" );
+        if ( !AddChildNodes(parent, items, newItems) )
+            ok = false;
 
-    switch( func( node ) )
+        first = last;
+    }
+
+    if ( newItems.empty() )
+        return ok;
+
+    InvalidateCount();
+
+    // Find the rows of the new items which are shown in the window.
+    wxVector<int> rows;
+    for ( size_t n = 0; n < newItems.size(); n++ )
     {
-        case DoJob::DONE:
-            return true;
-        case DoJob::SKIP_SUBTREE:
-            return false;
-        case DoJob::CONTINUE:
-            break;
+        const int row = GetRowByItem(newItems[n], Walk_ExpandedOnly);
+        if ( row != -1 )
+            rows.push_back(row);
     }
 
-    if ( node->HasChildren() && (flags != Walk_ExpandedOnly || node->IsOpen()) )
+    if ( !rows.empty() )
     {
-        const wxDataViewTreeNodes& nodes = node->GetChildNodes();
+        wxVectorSort(rows);
 
-        for ( wxDataViewTreeNodes::const_iterator i = nodes.begin();
-              i != nodes.end();
-              ++i )
-        {
-            if ( Walker(*i, func, flags) )
-                return true;
-        }
-    }
+        // Inserting the rows in increasing order ensures that the rows before
+        // each of them already account for the previously inserted ones.
+        for ( size_t n = 0; n < rows.size(); n++ )
+            m_selection.OnItemsInserted(rows[n], 1);
 
-    return false;
-}
+        // The rows after the first new one are shifted, so their heights must
+        // be invalidated too.
+        InvalidateRowHeights(rows[0]);
 
-} // anonymous namespace
+        // Only the new rows need to be measured to update the best widths.
+        for ( size_t first = 0; first < rows.size(); )
+        {
+            size_t last = first + 1;
+            while ( last < rows.size() && rows[last] == rows[last - 1] + 1 )
+                last++;
 
-bool wxDataViewMainWindow::ItemAdded(const wxDataViewItem & parent, const wxDataViewItem & item)
-{
-    if (IsVirtualList())
-    {
-        wxDataViewVirtualListModel *list_model =
-            (wxDataViewVirtualListModel*) GetModel();
-        m_count = list_model->GetCount();
+            GetOwner()->UpdateColBestWidths(rows[first], last - first);
+
+            first = last;
+        }
     }
+
+    if ( m_batchCount )
+        m_batchNeedsRefresh = true;
     else
-    {
-        // specific position (row) is unclear, so clear whole height cache
-        ClearRowHeightCache();
+        UpdateDisplay();
+
+    return ok;
+}
 
-        wxDataViewTreeNode *parentNode = FindNode(parent);
+bool wxDataViewMainWindow::AddChildNodes(const wxDataViewItem& parent,
+                                         const wxDataViewItemArray& items,
+                                         wxDataViewItemArray& newItems)
+{
+    wxDataViewTreeNode *parentNode = FindNode(parent);
 
-        if ( !parentNode )
-            return false;
+    if ( !parentNode )
+        return false;
 
-        parentNode->SetHasChildren(true);
+    parentNode->SetHasChildren(true);
+
+    // Don't create the nodes for the items which already have them, which can
+    // happen if the children of the parent were realized after they were
+    // added to the model but before we were notified about it.
+    wxVector<wxDataViewTreeNode*> nodes;
+    for ( size_t n = 0; n < items.size(); n++ )
+    {
+        const wxDataViewItem& item = items[n];
+        if ( parentNode->FindChildByItem(item) != wxNOT_FOUND )
+            continue;
 
         wxDataViewTreeNode *itemNode = new wxDataViewTreeNode(parentNode, item);
         itemNode->SetHasChildren(GetModel()->IsContainer(item));
+        nodes.push_back(itemNode);
+    }
 
-        if ( GetSortOrder().IsNone() )
-        {
-            // There's no sorting, so we need to select an insertion position
+    if ( nodes.empty() )
+        return true;
 
-            wxDataViewItemArray modelSiblings;
-            GetModel()->GetChildren(parent, modelSiblings);
-            const int modelSiblingsSize = modelSiblings.size();
+    bool ok = true;
 
-            int posInModel = modelSiblings.Index(item, /*fromEnd=*/true);
-            wxCHECK_MSG(posInModel != wxNOT_FOUND, false, "adding non-existent item?");
+    wxVector<int> positions;
+    if ( GetSortOrder().IsNone() )
+    {
+        // There's no sorting, so we need to select the insertion positions:
+        // each new node must be inserted before the node of the next item in
+        // the model which has one, or at the end if there is none.
+        wxDataViewItemArray modelSiblings;
+        GetModel()->GetChildren(parent, modelSiblings);
 
+        wxDataViewTreeNodeItemMap newNodes;
+        for ( size_t n = 0; n < nodes.size(); n++ )
+            newNodes[nodes[n]->GetItem().GetID()] = nodes[n];
 
-            const wxDataViewTreeNodes& nodeSiblings = parentNode->GetChildNodes();
-            const int nodeSiblingsSize = nodeSiblings.size();
+        // Iterate over the siblings from the end, as the items are usually
+        // appended, and find all the positions before inserting anything, so
+        // that the positions of the existing nodes remain valid. As they are
+        // not increasing, inserting the nodes in this order doesn't change
+        // the positions found for the next ones.
+        nodes.clear();
 
-            int nodePos = 0;
+        int nextNodePos = parentNode->GetChildNodes().size();
+        for ( size_t n = modelSiblings.size(); n > 0 && !newNodes.empty(); n-- )
+        {
+            const wxDataViewItem& sibling = modelSiblings[n - 1];
 
-            if ( posInModel == modelSiblingsSize - 1 )
-            {
-                nodePos = nodeSiblingsSize;
-            }
-            else if ( modelSiblingsSize == nodeSiblingsSize + 1 )
+            wxDataViewTreeNodeItemMap::iterator it = newNodes.find(sibling.GetID());
+            if ( it != newNodes.end() )
             {
-                // This is the simple case when our node tree already matches the
-                // model and only this one item is missing.
-                nodePos = posInModel;
+                nodes.push_back(it->second);
+                positions.push_back(nextNodePos);
+                newNodes.erase(it);
             }
             else
             {
-                // It's possible that a larger discrepancy between the model and
-                // our realization exists. This can happen e.g. when adding a bunch
-                // of items to the model and then calling ItemsAdded() just once
-                // afterwards. In this case, we must find the right position by
-                // looking at sibling items.
-
-                // append to the end if we won't find a better position:
-                nodePos = nodeSiblingsSize;
-
-                for ( int nextItemPos = posInModel + 1;
-                     nextItemPos < modelSiblingsSize;
-                     nextItemPos++ )
-                {
-                    int nextNodePos = parentNode->FindChildByItem(modelSiblings[nextItemPos]);
-                    if ( nextNodePos != wxNOT_FOUND )
-                    {
-                        nodePos = nextNodePos;
-                        break;
-                    }
-                }
+                const int pos = parentNode->FindChildByItem(sibling);
+                if ( pos != wxNOT_FOUND && pos < nextNodePos )
+                    nextNodePos = pos;
             }
-            parentNode->ChangeSubTreeCount(+1);
-            parentNode->InsertChild(this, itemNode, nodePos);
         }
-        else
+
+        if ( !newNodes.empty() )
         {
-            // Node list is or will be sorted, so InsertChild do not need insertion position
-            parentNode->ChangeSubTreeCount(+1);
-            parentNode->InsertChild(this, itemNode, 0);
-        }
+            wxFAIL_MSG( "adding non-existent item?" );
 
-        InvalidateCount();
+            for ( wxDataViewTreeNodeItemMap::iterator it = newNodes.begin();
+                  it != newNodes.end();
+                  ++it )
+            {
+                delete it->second;
+            }
+
+            ok = false;
+        }
+    }
+    else
+    {
+        // Node list is or will be sorted, so InsertChild do not need insertion
+        // position.
+        positions.resize(nodes.size(), 0);
     }
 
-    m_selection.OnItemsInserted(GetRowByItem(item), 1);
+    parentNode->ChangeSubTreeCount(+nodes.size());
 
-    GetOwner()->InvalidateColBestWidths();
-    UpdateDisplay();
+    for ( size_t n = 0; n < nodes.size(); n++ )
+    {
+        parentNode->InsertChild(this, nodes[n], positions[n]);
+        newItems.push_back(nodes[n]->GetItem());
+    }
 
-    return true;
+    return ok;
 }
 
 bool wxDataViewMainWindow::ItemDeleted(const wxDataViewItem& parent,
                                        const wxDataViewItem& item)
 {
+    // The deleted item may be one of the items added during the batch.
+    AddBatchedItems();
+
     if (IsVirtualList())
     {
         wxDataViewVirtualListModel *list_model =
@@ -3197,18 +3888,10 @@ bool wxDataViewMainWindow::ItemDeleted(const wxDataViewItem& parent,
         // removed from the model by the time ItemDeleted() is called, so we
         // have to do it manually. We keep track of its position as well for
         // later use.
-        int itemPosInNode = 0;
-        wxDataViewTreeNode *itemNode = NULL;
-        for ( wxDataViewTreeNodes::const_iterator i = parentsChildren.begin();
-              i != parentsChildren.end();
-              ++i, ++itemPosInNode )
-        {
-            if( (*i)->GetItem() == item )
-            {
-                itemNode = *i;
-                break;
-            }
-        }
+        const int itemPosInNode = parentNode->FindChildByItem(item);
+        wxDataViewTreeNode *itemNode = itemPosInNode == wxNOT_FOUND
+                                        ? NULL
+                                        : parentsChildren[itemPosInNode];
 
         // If the parent wasn't expanded, it's possible that we didn't have a
         // node corresponding to 'item' and so there's nothing left to do.
@@ -3222,13 +3905,15 @@ bool wxDataViewMainWindow::ItemDeleted(const wxDataViewItem& parent,
             return true;
         }
 
-        if ( m_rowHeightCache )
-            m_rowHeightCache->Remove(GetRowByItem(parent) + itemPosInNode);
+        InvalidateRowHeights(GetRowByItem(parent) + itemPosInNode);
 
         // Delete the item from wxDataViewTreeNode representation:
         const int itemsDeleted = 1 + itemNode->GetSubTreeCount();
 
         parentNode->RemoveChild(itemPosInNode);
+#if wxUSE_THREADS
+        CancelBackgroundSorting(itemNode);
+#endif // wxUSE_THREADS
         delete itemNode;
         parentNode->ChangeSubTreeCount(-itemsDeleted);
 
@@ -3279,18 +3964,32 @@ bool wxDataViewMainWindow::ItemDeleted(const wxDataViewItem& parent,
     if ( m_currentRow >= GetRowCount() )
         ChangeCurrentRow(m_count - 1);
 
-    GetOwner()->InvalidateColBestWidths();
-    UpdateDisplay();
+    if ( m_batchCount )
+    {
+        if ( !GetOwner()->m_incrementalColWidths )
+            m_batchNeedsColWidths = true;
+
+        m_batchNeedsRefresh = true;
+    }
+    else
+    {
+        if ( !GetOwner()->m_incrementalColWidths )
+            GetOwner()->InvalidateColBestWidths();
+
+        UpdateDisplay();
+    }
 
     return true;
 }
 
 bool wxDataViewMainWindow::DoItemChanged(const wxDataViewItem & item, int view_column)
 {
+    // The changed item may be one of the items added during the batch.
+    AddBatchedItems();
+
     if ( !IsVirtualList() )
     {
-        if ( m_rowHeightCache )
-            m_rowHeightCache->Remove(GetRowByItem(item));
+        InvalidateRowHeights(GetRowByItem(item));
 
         // Move this node to its new correct place after it was updated.
         //
@@ -3302,23 +4001,48 @@ bool wxDataViewMainWindow::DoItemChanged(const wxDataViewItem & item, int view_c
         // change.
         wxDataViewTreeNode* const node = FindNode(item);
         wxCHECK_MSG( node, false, "invalid item" );
-        node->PutInSortOrder(this);
+        if ( m_batchCount && !GetSortOrder().IsNone() )
+        {
+            // Sort all the changed siblings at once at the end of the batch,
+            // which may move any of them.
+            if ( node->DeferPutInSortOrder() )
+            {
+                m_batchNeedsResort = true;
+                InvalidateRowHeights(GetRowByItem(node->GetParent()->GetItem()) + 1);
+            }
+        }
+        else
+        {
+            node->PutInSortOrder(this);
+        }
     }
 
     wxDataViewColumn* column;
     if ( view_column == wxNOT_FOUND )
-    {
         column = NULL;
+    else
+        column = m_owner->GetColumn(view_column);
+
+    if ( GetOwner()->m_incrementalColWidths )
+    {
+        const int row = GetRowByItem(item, Walk_ExpandedOnly);
+        if ( row != -1 )
+            GetOwner()->UpdateColBestWidths(row, 1, view_column);
+    }
+    else if ( view_column == wxNOT_FOUND )
+    {
         GetOwner()->InvalidateColBestWidths();
     }
     else
     {
-        column = m_owner->GetColumn(view_column);
         GetOwner()->InvalidateColBestWidth(view_column);
     }
 
     // Update the displayed value(s).
-    RefreshRow(GetRowByItem(item));
+    if ( m_batchCount )
+        m_batchNeedsRefresh = true;
+    else
+        RefreshRow(GetRowByItem(item));
 
     // Send event
     wxDataViewEvent le(wxEVT_DATAVIEW_ITEM_VALUE_CHANGED, m_owner, column, item);
@@ -3338,6 +4062,9 @@ bool wxDataViewMainWindow::ValueChanged( const wxDataViewItem & item, unsigned i
 
 bool wxDataViewMainWindow::Cleared()
 {
+    // All the items are going to be added anyhow.
+    m_batchAddedItems.clear();
+
     DestroyTree();
     m_selection.Clear();
     m_currentRow = (unsigned)-1;
@@ -3359,6 +4086,55 @@ bool wxDataViewMainWindow::Cleared()
     return true;
 }
 
+void wxDataViewMainWindow::EndBatch()
+{
+    wxCHECK_RET( m_batchCount > 0, "unbalanced EndBatch() call" );
+
+    if ( m_batchCount > 1 )
+    {
+        m_batchCount--;
+        return;
+    }
+
+    // Add the new items before ending the batch, so that the updates they
+    // require are still postponed.
+    AddBatchedItems();
+
+    m_batchCount = 0;
+
+    if ( m_batchNeedsResort )
+    {
+        m_batchNeedsResort = false;
+
+        // Only the branches with deferred changes are actually sorted again
+        // when sorting by column, as the others are still sorted.
+        if ( !IsVirtualList() )
+            m_root->Resort(this);
+
+        m_batchNeedsRefresh = true;
+    }
+
+    // The heights of all the rows after the first changed one are invalidated
+    // only once.
+    if ( m_batchFirstChangedRow != -1 )
+    {
+        InvalidateRowHeights(m_batchFirstChangedRow);
+        m_batchFirstChangedRow = -1;
+    }
+
+    if ( m_batchNeedsColWidths )
+    {
+        m_batchNeedsColWidths = false;
+        GetOwner()->InvalidateColBestWidths();
+    }
+
+    if ( m_batchNeedsRefresh )
+    {
+        m_batchNeedsRefresh = false;
+        UpdateDisplay();
+    }
+}
+
 void wxDataViewMainWindow::UpdateDisplay()
 {
     m_dirty = true;
@@ -3801,58 +4577,6 @@ int wxDataViewMainWindow::QueryAndCacheLineHeight(unsigned int row, wxDataViewIt
 }
 
 
-class RowToTreeNodeJob: public DoJob
-{
-public:
-    // Note that we initialize m_current to -1 because the first node passed to
-    // our operator() will be the root node, which doesn't appear in the window
-    // and so doesn't count as a real row.
-    explicit RowToTreeNodeJob(int row)
-        : m_row(row), m_current(-1), m_ret(NULL)
-    {
-    }
-
-    virtual int operator() ( wxDataViewTreeNode * node ) wxOVERRIDE
-    {
-        if( m_current == m_row)
-        {
-            m_ret = node;
-            return DoJob::DONE;
-        }
-
-        if( node->GetSubTreeCount() + m_current < m_row )
-        {
-            m_current += node->GetSubTreeCount() + 1;
-            return  DoJob::SKIP_SUBTREE;
-        }
-        else
-        {
-            // If the current node has only leaf children, we can find the
-            // desired node directly. This can speed up finding the node
-            // in some cases, and will have a very good effect for list views.
-            if ( node->HasChildren() &&
-                 (int)node->GetChildNodes().size() == node->GetSubTreeCount() )
-            {
-                const int index = m_row - m_current - 1;
-                m_ret = node->GetChildNodes()[index];
-                return DoJob::DONE;
-            }
-
-            m_current++;
-
-            return DoJob::CONTINUE;
-        }
-    }
-
-    wxDataViewTreeNode * GetResult() const
-        { return m_ret; }
-
-private:
-    const int m_row;
-    int m_current;
-    wxDataViewTreeNode* m_ret;
-};
-
 wxDataViewTreeNode * wxDataViewMainWindow::GetTreeNodeByRow(unsigned int row) const
 {
     wxASSERT( !IsVirtualList() );
@@ -3860,9 +4584,20 @@ wxDataViewTreeNode * wxDataViewMainWindow::GetTreeNodeByRow(unsigned int row) co
     if ( row == (unsigned)-1 )
         return NULL;
 
-    RowToTreeNodeJob job(static_cast<int>(row));
-    Walker( m_root , job );
-    return job.GetResult();
+    // Descend into the child containing the row at each level: notice that
+    // the row of the root node itself is -1 as it doesn't appear in the window
+    // and the row passed to GetChildByRow() is counted from its first child.
+    int rowInSubtree = static_cast<int>(row);
+    wxDataViewTreeNode* node = m_root;
+    for ( ;; )
+    {
+        node = node->GetChildByRow(rowInSubtree);
+        if ( !node || !rowInSubtree )
+            return node;
+
+        // Skip the row of the node itself.
+        rowInSubtree--;
+    }
 }
 
 wxDataViewItem wxDataViewMainWindow::GetItemByRow(unsigned int row) const
@@ -3981,8 +4716,8 @@ wxDataViewMainWindow::DoExpand(wxDataViewTreeNode* node,
             m_count += countNewRows;
 
         // Expanding this item means the previously cached column widths could
-        // have become invalid as new items are now visible.
-        GetOwner()->InvalidateColBestWidths();
+        // have become too small as new items are now visible.
+        GetOwner()->UpdateColBestWidths(row + 1, countNewRows);
 
         UpdateDisplay();
         // Send the expanded event
@@ -4062,7 +4797,8 @@ void wxDataViewMainWindow::Collapse(unsigned int row)
         if ( m_count != -1 )
             m_count -= countDeletedRows;
 
-        GetOwner()->InvalidateColBestWidths();
+        if ( !GetOwner()->m_incrementalColWidths )
+            GetOwner()->InvalidateColBestWidths();
 
         UpdateDisplay();
         SendExpanderEvent(wxEVT_DATAVIEW_ITEM_COLLAPSED,node->GetItem());
@@ -4102,24 +4838,15 @@ wxDataViewTreeNode * wxDataViewMainWindow::FindNode( const wxDataViewItem & item
                 ::BuildTreeHelper(this, model, node->GetItem(), node);
             }
 
-            const wxDataViewTreeNodes& nodes = node->GetChildNodes();
-            bool found = false;
+            const int index = node->FindChildByItem(parentChain[iter]);
+            if ( index == wxNOT_FOUND )
+                return NULL;
 
-            for (unsigned i = 0; i < nodes.size(); ++i)
-            {
-                wxDataViewTreeNode* currentNode = nodes[i];
-                if (currentNode->GetItem() == parentChain[iter])
-                {
-                    if (currentNode->GetItem() == item)
-                        return currentNode;
+            wxDataViewTreeNode* const currentNode = node->GetChildNodes()[index];
+            if (currentNode->GetItem() == item)
+                return currentNode;
 
-                    node = currentNode;
-                    found = true;
-                    break;
-                }
-            }
-            if (!found)
-                return NULL;
+            node = currentNode;
         }
         else
             return NULL;
@@ -4245,55 +4972,6 @@ int wxDataViewMainWindow::RecalculateCount() const
     }
 }
 
-class ItemToRowJob : public DoJob
-{
-public:
-    // As with RowToTreeNodeJob above, we initialize m_current to -1 because
-    // the first node passed to our operator() is the root node which is not
-    // visible on screen and so we should return 0 for its first child node and
-    // not for the root itself.
-    ItemToRowJob(const wxDataViewItem& item, wxVector<wxDataViewItem>::reverse_iterator iter)
-        : m_item(item), m_iter(iter), m_current(-1)
-    {
-    }
-
-    // Maybe binary search will help to speed up this process
-    virtual int operator() ( wxDataViewTreeNode * node) wxOVERRIDE
-    {
-        if( node->GetItem() == m_item )
-        {
-            return DoJob::DONE;
-        }
-
-        // Is this node the next (grand)parent of the item we're looking for?
-        if( node->GetItem() == *m_iter )
-        {
-            // Search for the next (grand)parent now and skip this item itself.
-            ++m_iter;
-            ++m_current;
-            return DoJob::CONTINUE;
-        }
-        else
-        {
-            // Skip this node and all its currently visible children.
-            m_current += node->GetSubTreeCount() + 1;
-            return DoJob::SKIP_SUBTREE;
-        }
-
-    }
-
-    int GetResult() const
-        { return m_current; }
-
-private:
-    const wxDataViewItem m_item;
-    wxVector<wxDataViewItem>::reverse_iterator m_iter;
-
-    // The row corresponding to the last node seen in our operator().
-    int m_current;
-
-};
-
 int
 wxDataViewMainWindow::GetRowByItem(const wxDataViewItem & item,
                                    WalkFlags flags) const
@@ -4320,16 +4998,27 @@ wxDataViewMainWindow::GetRowByItem(const wxDataViewItem & item,
             it = model->GetParent(it);
         }
 
-        // add an 'invalid' item to represent our 'invisible' root node
-        parentChain.push_back(wxDataViewItem());
+        // The parent chain was created by adding the deepest parent first, so
+        // iterate over it backwards to descend from the root node, adding the
+        // rows of the preceding siblings and their subtrees at each level.
+        // Notice that the root node itself doesn't appear in the window, so its
+        // row is -1.
+        int row = -1;
+        const wxDataViewTreeNode* node = m_root;
+        for ( size_t n = parentChain.size(); n > 0; n-- )
+        {
+            if ( flags == Walk_ExpandedOnly && !node->IsOpen() )
+                return -1;
+
+            const int index = node->FindChildByItem(parentChain[n - 1]);
+            if ( index == wxNOT_FOUND )
+                return -1;
 
-        // the parent chain was created by adding the deepest parent first.
-        // so if we want to start at the root node, we have to iterate backwards through the vector
-        ItemToRowJob job( item, parentChain.rbegin() );
-        if ( !Walker( m_root, job, flags ) )
-            return -1;
+            row += 1 + node->GetRowsBeforeChild(index);
+            node = node->GetChildNodes()[index];
+        }
 
-        return job.GetResult();
+        return row;
     }
 }
 
@@ -4378,11 +5067,126 @@ void wxDataViewMainWindow::DestroyTree()
 {
     if (!IsVirtualList())
     {
+#if wxUSE_THREADS
+        CancelBackgroundSorting();
+#endif // wxUSE_THREADS
+
         wxDELETE(m_root);
         m_count = 0;
     }
 }
 
+bool
+wxDataViewMainWindow::SortInBackground(wxDataViewTreeNode* node,
+                                       const SortOrder& sortOrder)
+{
+#if wxUSE_THREADS
+    // Only the values of the columns can be retrieved in advance, sorting by
+    // the model-specific order requires calling the model to compare them.
+    if ( !m_backgroundSortingThreshold || !sortOrder.UsesColumn() )
+        return false;
+
+    if ( node->GetChildNodes().size() < m_backgroundSortingThreshold )
+        return false;
+
+    wxDataViewSortThread* const
+        thread = new wxDataViewSortThread(this, ++m_lastSortJobId,
+                                          node, sortOrder);
+    if ( !thread->GetValues(GetModel()) || thread->Run() != wxTHREAD_NO_ERROR )
+    {
+        delete thread;
+        return false;
+    }
+
+    // Notice that if there is already a job for this node, its results will
+    // be just ignored when it finishes as its id doesn't match any more.
+    node->StartSortJob(thread->GetJobId());
+    m_sortThreads.push_back(thread);
+
+    return true;
+#else // !wxUSE_THREADS
+    wxUnusedVar(node);
+    wxUnusedVar(sortOrder);
+
+    return false;
+#endif // wxUSE_THREADS/!wxUSE_THREADS
+}
+
+#if wxUSE_THREADS
+
+void wxDataViewMainWindow::CancelBackgroundSorting(const wxDataViewTreeNode* node)
+{
+    for ( size_t n = 0; n < m_sortThreads.size(); n++ )
+    {
+        wxDataViewSortThread* const thread = m_sortThreads[n];
+
+        // Check if the node is the given one or one of its descendants.
+        for ( const wxDataViewTreeNode* parent = thread->GetNode();
+              parent;
+              parent = parent->GetParent() )
+        {
+            if ( !node || parent == node )
+            {
+                thread->Cancel();
+                break;
+            }
+        }
+    }
+}
+
+void wxDataViewMainWindow::OnSortThreadDone(wxThreadEvent& event)
+{
+    wxDataViewSortThread* thread = NULL;
+    for ( size_t n = 0; n < m_sortThreads.size(); n++ )
+    {
+        if ( m_sortThreads[n]->GetJobId() == event.GetInt() )
+        {
+            thread = m_sortThreads[n];
+            m_sortThreads.erase(m_sortThreads.begin() + n);
+            break;
+        }
+    }
+
+    if ( !thread )
+    {
+        event.Skip();
+        return;
+    }
+
+    // The thread has already finished its work, so this doesn't block.
+    thread->Wait();
+
+    wxDataViewTreeNode* const node = thread->GetNode();
+    if ( node && node->IsSortJobPending(thread->GetJobId()) )
+    {
+        if ( thread->GetSortOrder() != GetSortOrder() )
+        {
+            // The sort order changed in the meanwhile, and the children will
+            // be sorted again if necessary.
+            node->CancelSortJob();
+        }
+        else if ( node->IsSortJobStale() )
+        {
+            // The children changed since the values were retrieved, so sort
+            // them again. Notice that this doesn't do anything for closed
+            // nodes, which will be sorted when they're opened.
+            node->CancelSortJob();
+            node->Resort(this);
+        }
+        else
+        {
+            node->FinishSortJob(thread->GetOrder(), thread->GetSortOrder());
+
+            ClearRowHeightCache();
+            UpdateDisplay();
+        }
+    }
+
+    delete thread;
+}
+
+#endif // wxUSE_THREADS
+
 wxDataViewColumn*
 wxDataViewMainWindow::FindColumnForEditing(const wxDataViewItem& item, wxDataViewCellMode mode) const
 {
@@ -5530,6 +6334,8 @@ void wxDataViewCtrl::Init()
     m_colsDirty = false;
 
     m_allowMultiColumnSort = false;
+
+    m_incrementalColWidths = false;
 }
 
 bool wxDataViewCtrl::Create(wxWindow *parent,
@@ -5594,6 +6400,11 @@ wxHeaderCtrl* wxDataViewCtrl::GenericGetHeader() const
     return m_headerArea;
 }
 
+void wxDataViewCtrl::EnableBackgroundSorting(unsigned minChildren)
+{
+    m_clientArea->SetBackgroundSortingThreshold(minChildren);
+}
+
 #ifdef __WXMSW__
 WXLRESULT wxDataViewCtrl::MSWWindowProc(WXUINT nMsg,
                                         WXWPARAM wParam,
@@ -5750,6 +6561,10 @@ bool wxDataViewCtrl::AssociateModel( wxDataViewModel *model )
     if (!wxDataViewCtrlBase::AssociateModel( model ))
         return false;
 
+    // Any batch of the previous model won't be finished for us, while the new
+    // model notifies the new notifier if it's in the middle of a batch.
+    m_clientArea->ResetBatch();
+
     if (model)
     {
         m_notifier = new wxGenericDataViewModelNotifier( m_clientArea );
@@ -5996,6 +6811,11 @@ unsigned int wxDataViewCtrl::GetBestColumnWidth(int idx) const
                                             GetModel(), column->GetModelColumn(),
                                             m_clientArea->GetRowHeight());
 
+    // Getting the values from a virtual model may be slow, so don't try to
+    // check too many of them.
+    if ( m_clientArea->IsVirtualList() )
+        calculator.LimitRowsToCheck();
+
     calculator.UpdateWithWidth(column->GetMinWidth());
 
     if ( m_headerArea )
@@ -6014,6 +6834,75 @@ unsigned int wxDataViewCtrl::GetBestColumnWidth(int idx) const
     return max_width;
 }
 
+void
+wxDataViewCtrl::UpdateColBestWidths(unsigned int row,
+                                    unsigned int count,
+                                    int idx)
+{
+    // Measuring many rows would be slower than recomputing the best widths
+    // from scratch, as only some of the rows are checked for big controls.
+    static const unsigned int MAX_ROWS_TO_UPDATE = 500;
+    if ( count > MAX_ROWS_TO_UPDATE )
+    {
+        if ( idx == wxNOT_FOUND )
+            InvalidateColBestWidths();
+        else
+            InvalidateColBestWidth(idx);
+        return;
+    }
+
+    unsigned int first = 0,
+                 last = m_colsBestWidths.size();
+    if ( idx != wxNOT_FOUND )
+    {
+        first = idx;
+        last = idx + 1;
+    }
+
+    for ( unsigned int i = first; i < last; i++ )
+    {
+        CachedColWidthInfo& info = m_colsBestWidths[i];
+
+        // Nothing to do if the width is not known yet, it will be computed
+        // from scratch when it's needed anyhow.
+        if ( !info.width )
+            continue;
+
+        wxDataViewColumn * const column = GetColumn(i);
+        wxDataViewMaxWidthCalculator
+            calculator(this, m_clientArea, column->GetRenderer(),
+                       GetModel(), column->GetModelColumn(),
+                       m_clientArea->GetRowHeight());
+
+        for ( unsigned int n = 0; n < count; n++ )
+            calculator.UpdateWithRow(row + n);
+
+        int width = calculator.GetMaxWidth();
+        if ( width <= 0 )
+            continue;
+
+        width += 2 * PADDING_RIGHTLEFT;
+        if ( width > info.width )
+        {
+            info.width = width;
+            info.dirty = true;
+            m_colsDirty = true;
+        }
+    }
+}
+
+bool wxDataViewCtrl::EnableIncrementalColumnWidths(bool enable)
+{
+    m_incrementalColWidths = enable;
+
+    // The widths may be too big if items were deleted while they were only
+    // updated incrementally, so recompute them.
+    if ( !enable )
+        InvalidateColBestWidths();
+
+    return true;
+}
+
 void wxDataViewCtrl::ColumnMoved(wxDataViewColumn *col, unsigned int new_pos)
 {
     // do _not_ reorder m_cols elements here, they should always be in the
@@ -1726,28 +1726,9 @@ wxCairoBitmapData::wxCairoBitmapData(wxGraphicsRenderer* renderer,
 
     if ( bufferFormat == CAIRO_FORMAT_ARGB32 )
     {
-        const unsigned char* alpha = image.GetAlpha();
-
-        for ( int y = 0; y < m_height; y++ )
-        {
-            wxUint32* const rowStartDst = dst;
-
-            for ( int x = 0; x < m_width; x++ )
-            {
-                const unsigned char a = alpha ? *alpha : wxALPHA_OPAQUE;
-
-                *dst++ = a                    << 24 |
-                         ((a * src[0]) / 255) << 16 |
-                         ((a * src[1]) / 255) <<  8 |
-                         ((a * src[2]) / 255);
-                src += 3;
-
-                if ( alpha )
-                    alpha++;
-            }
-
-            dst = rowStartDst + stride / 4;
-        }
+        // this is the same format as used by Cairo, convert directly to it
+        image.GetInterleavedData(wxIMAGE_PIXEL_FORMAT_BGRA_PREMULTIPLIED,
+                                 m_buffer, stride);
     }
     else // RGB
     {
@@ -59,6 +59,7 @@ const char wxGridNameStr[] = "grid";
 
 // Required for wxIs... functions
 #include <ctype.h>
+#include <limits.h>
 
 WX_DECLARE_HASH_SET_WITH_DECL_PTR(int, wxIntegerHash, wxIntegerEqual,
                                   wxGridFixedIndicesSet, class WXDLLIMPEXP_ADV);
@@ -1048,14 +1049,30 @@ wxGridRowOrColAttrData::~wxGridRowOrColAttrData()
     }
 }
 
+size_t wxGridRowOrColAttrData::FindIndex(int rowOrCol) const
+{
+    size_t lo = 0,
+           hi = m_rowsOrCols.GetCount();
+    while ( lo < hi )
+    {
+        const size_t mid = (lo + hi) / 2;
+        if ( m_rowsOrCols[mid] < rowOrCol )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
 wxGridCellAttr *wxGridRowOrColAttrData::GetAttr(int rowOrCol) const
 {
     wxGridCellAttr *attr = NULL;
 
-    int n = m_rowsOrCols.Index(rowOrCol);
-    if ( n != wxNOT_FOUND )
+    const size_t n = FindIndex(rowOrCol);
+    if ( n < m_rowsOrCols.GetCount() && m_rowsOrCols[n] == rowOrCol )
     {
-        attr = m_attrs[(size_t)n];
+        attr = m_attrs[n];
         attr->IncRef();
     }
 
@@ -1064,21 +1081,20 @@ wxGridCellAttr *wxGridRowOrColAttrData::GetAttr(int rowOrCol) const
 
 void wxGridRowOrColAttrData::SetAttr(wxGridCellAttr *attr, int rowOrCol)
 {
-    int i = m_rowsOrCols.Index(rowOrCol);
-    if ( i == wxNOT_FOUND )
+    const size_t n = FindIndex(rowOrCol);
+    if ( n == m_rowsOrCols.GetCount() || m_rowsOrCols[n] != rowOrCol )
     {
         if ( attr )
         {
-            // store the new attribute, taking its ownership
-            m_rowsOrCols.Add(rowOrCol);
-            m_attrs.Add(attr);
+            // store the new attribute, taking its ownership, at the position
+            // preserving the sort order
+            m_rowsOrCols.Insert(rowOrCol, n);
+            m_attrs.Insert(attr, n);
         }
         // nothing to remove
     }
     else // we have an attribute for this row or column
     {
-        size_t n = (size_t)i;
-
         // notice that this code works correctly even when the old attribute is
         // the same as the new one: as we own of it, we must call DecRef() on
         // it in any case and this won't result in destruction of the new
@@ -1130,6 +1146,423 @@ void wxGridRowOrColAttrData::UpdateAttrRowsOrCols( size_t pos, int numRowsOrCols
     }
 }
 
+// ----------------------------------------------------------------------------
+// wxGridCellAttrMerger
+// ----------------------------------------------------------------------------
+
+void wxGridCellAttrMerger::Add(wxGridCellAttr *attr)
+{
+    if ( !attr )
+        return;
+
+    if ( !m_attr )
+    {
+        // use the first attribute as is, we may not need to merge anything
+        m_attr = attr;
+        return;
+    }
+
+    if ( attr == m_attr )
+    {
+        // nothing to merge, but we still must release the reference we own
+        attr->DecRef();
+        return;
+    }
+
+    if ( !m_merged )
+    {
+        wxGridCellAttr * const first = m_attr;
+
+        m_attr = new wxGridCellAttr;
+        m_attr->SetKind(wxGridCellAttr::Merged);
+        m_attr->MergeWith(first);
+        first->DecRef();
+
+        m_merged = true;
+    }
+
+    // the attributes with higher priority were added first and MergeWith()
+    // only sets the values which are not set yet, so order is preserved
+    m_attr->MergeWith(attr);
+    attr->DecRef();
+}
+
+// ----------------------------------------------------------------------------
+// wxGridBlockAttrData
+// ----------------------------------------------------------------------------
+
+wxGridBlockAttrData::~wxGridBlockAttrData()
+{
+    for ( size_t n = 0; n < m_blocks.size(); n++ )
+    {
+        wxSafeDecRef(m_blocks[n].attr);
+    }
+}
+
+void
+wxGridBlockAttrData::SetAttr(wxGridCellAttr *attr,
+                             const wxGridBlockCoords& block)
+{
+    const wxGridBlockCoords coords = block.Canonicalize();
+
+    // Remove the attribute previously set for exactly the same block, if any:
+    // the new one will be added at the end as it has the highest priority.
+    wxGridBlockCoordsToIndexMap::iterator it = m_blockIndices.find(coords);
+    if ( it != m_blockIndices.end() )
+    {
+        // as in wxGridRowOrColAttrData::SetAttr(), this works even if the
+        // old attribute is the same as the new one
+        Block& old = m_blocks[it->second];
+        old.attr->DecRef();
+        old.attr = NULL;
+        m_numRemoved++;
+
+        m_blockIndices.erase(it);
+    }
+
+    if ( attr && coords.GetTopRow() >= 0 && coords.GetLeftCol() >= 0 )
+    {
+        m_blockIndices[coords] = m_blocks.size();
+
+        Block b;
+        b.coords = coords;
+        b.attr = attr;
+        m_blocks.push_back(b);
+    }
+    else
+    {
+        wxSafeDecRef(attr);
+    }
+
+    // The removed blocks are only erased from time to time, to avoid shifting
+    // all the following ones whenever an attribute is replaced.
+    if ( m_numRemoved > m_blocks.size() / 2 )
+        Compact();
+
+    // Don't rebuild the index immediately as this could be very expensive
+    // when many blocks are set one after another.
+    m_indexValid = false;
+}
+
+void wxGridBlockAttrData::Compact()
+{
+    m_blockIndices.clear();
+
+    size_t numBlocks = 0;
+    for ( size_t n = 0; n < m_blocks.size(); n++ )
+    {
+        if ( !m_blocks[n].attr )
+            continue;
+
+        // If several blocks have the same coordinates, which can happen after
+        // deleting rows or columns, the last one is found by SetAttr().
+        m_blockIndices[m_blocks[n].coords] = numBlocks;
+        m_blocks[numBlocks++] = m_blocks[n];
+    }
+
+    m_blocks.resize(numBlocks);
+    m_numRemoved = 0;
+}
+
+size_t wxGridBlockAttrData::FindSegment(int row) const
+{
+    // Find the last segment starting at or before this row.
+    size_t lo = 0,
+           hi = m_rowStarts.size();
+    while ( lo < hi )
+    {
+        const size_t mid = (lo + hi) / 2;
+        if ( m_rowStarts[mid] <= row )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo ? lo - 1 : m_rowStarts.size();
+}
+
+void wxGridBlockAttrData::BuildIndex() const
+{
+    m_rowStarts.clear();
+    m_nodeOffsets.clear();
+    m_entries.clear();
+
+    m_indexValid = true;
+
+    // The segments start at the first row of each block and just after its
+    // last row.
+    for ( size_t n = 0; n < m_blocks.size(); n++ )
+    {
+        if ( !m_blocks[n].attr )
+            continue;
+
+        const wxGridBlockCoords& coords = m_blocks[n].coords;
+        m_rowStarts.push_back(coords.GetTopRow());
+        m_rowStarts.push_back(coords.GetBottomRow() + 1);
+    }
+
+    if ( m_rowStarts.empty() )
+        return;
+
+    wxVectorSort(m_rowStarts);
+
+    size_t numStarts = 0;
+    for ( size_t n = 0; n < m_rowStarts.size(); n++ )
+    {
+        if ( !numStarts || m_rowStarts[numStarts - 1] != m_rowStarts[n] )
+            m_rowStarts[numStarts++] = m_rowStarts[n];
+    }
+    m_rowStarts.resize(numStarts);
+
+    // The last start only ends the last segment, so there is one leaf less.
+    // The leaves of the segment tree are the nodes from numLeaves to
+    // 2*numLeaves - 1 and the parent of the node N is N/2.
+    const size_t numLeaves = numStarts - 1;
+
+    // Add the blocks in the order of their left column, so that the entries
+    // of each node are sorted by it.
+    wxVector<wxLongLong_t> order;
+    order.reserve(m_blocks.size() - m_numRemoved);
+    for ( size_t n = 0; n < m_blocks.size(); n++ )
+    {
+        if ( m_blocks[n].attr )
+        {
+            order.push_back(
+                (static_cast<wxLongLong_t>(m_blocks[n].coords.GetLeftCol()) << 32) |
+                    static_cast<wxLongLong_t>(n));
+        }
+    }
+
+    wxVectorSort(order);
+
+    // Count the entries of each node first, to compute their offsets, and
+    // then fill them. Each block is stored in the nodes covering exactly its
+    // rows, i.e. at most 2 nodes at each level of the tree.
+    m_nodeOffsets.resize(2*numLeaves + 1, 0);
+    for ( int pass = 0; pass < 2; pass++ )
+    {
+        wxVector<size_t> fill;
+        if ( pass == 1 )
+        {
+            for ( size_t node = 0; node < 2*numLeaves; node++ )
+                m_nodeOffsets[node + 1] += m_nodeOffsets[node];
+
+            m_entries.resize(m_nodeOffsets[2*numLeaves]);
+            fill.assign(m_nodeOffsets.begin(), m_nodeOffsets.end() - 1);
+        }
+
+        for ( size_t n = 0; n < order.size(); n++ )
+        {
+            const size_t block = static_cast<size_t>(order[n] & 0xffffffff);
+            const wxGridBlockCoords& coords = m_blocks[block].coords;
+
+            size_t lo = FindSegment(coords.GetTopRow()) + numLeaves,
+                   hi = FindSegment(coords.GetBottomRow() + 1) + numLeaves;
+            for ( ; lo < hi; lo /= 2, hi /= 2 )
+            {
+                size_t nodes[2];
+                size_t numNodes = 0;
+                if ( lo & 1 )
+                    nodes[numNodes++] = lo++;
+                if ( hi & 1 )
+                    nodes[numNodes++] = --hi;
+
+                for ( size_t i = 0; i < numNodes; i++ )
+                {
+                    if ( pass == 0 )
+                    {
+                        m_nodeOffsets[nodes[i] + 1]++;
+                        continue;
+                    }
+
+                    IndexEntry& e = m_entries[fill[nodes[i]]++];
+                    e.leftCol = coords.GetLeftCol();
+                    e.rightCol = coords.GetRightCol();
+                    e.block = block;
+                }
+            }
+        }
+    }
+
+    for ( size_t node = 1; node < 2*numLeaves; node++ )
+        BuildMaxRight(m_nodeOffsets[node], m_nodeOffsets[node + 1]);
+}
+
+// The entries of each node form an implicit balanced binary search tree, with
+// the middle entry of each range being the root of the tree of this range.
+// Storing the maximal right column of each tree in its root allows skipping
+// the trees without any entries containing the given column when searching.
+int wxGridBlockAttrData::BuildMaxRight(size_t lo, size_t hi) const
+{
+    if ( lo >= hi )
+        return -1;
+
+    const size_t mid = lo + (hi - lo) / 2;
+
+    IndexEntry& e = m_entries[mid];
+    e.maxRight = wxMax(e.rightCol,
+                       wxMax(BuildMaxRight(lo, mid), BuildMaxRight(mid + 1, hi)));
+
+    return e.maxRight;
+}
+
+void
+wxGridBlockAttrData::FindBlocks(size_t lo, size_t hi, size_t end, int col) const
+{
+    if ( lo >= hi || lo >= end )
+        return;
+
+    const size_t mid = lo + (hi - lo) / 2;
+
+    const IndexEntry& e = m_entries[mid];
+    if ( e.maxRight < col )
+        return;
+
+    FindBlocks(lo, mid, end, col);
+
+    // All entries after the end start after this column.
+    if ( mid < end )
+    {
+        if ( col <= e.rightCol )
+            m_found.push_back(e.block);
+
+        FindBlocks(mid + 1, hi, end, col);
+    }
+}
+
+void
+wxGridBlockAttrData::GetAttrs(int row, int col,
+                              wxGridCellAttrMerger& merger) const
+{
+    if ( m_blocks.empty() )
+        return;
+
+    if ( !m_indexValid )
+        BuildIndex();
+
+    // Note that the row after the last start doesn't belong to any segment.
+    const size_t seg = FindSegment(row);
+    if ( seg + 1 >= m_rowStarts.size() )
+        return;
+
+    // The blocks containing this row are those stored in the leaf of its
+    // segment and all of its ancestors.
+    m_found.clear();
+
+    const size_t numLeaves = m_rowStarts.size() - 1;
+    for ( size_t node = seg + numLeaves; node; node /= 2 )
+    {
+        const size_t lo = m_nodeOffsets[node],
+                     hi = m_nodeOffsets[node + 1];
+
+        // Find the end of the entries starting at or before this column.
+        size_t end = lo,
+               last = hi;
+        while ( end < last )
+        {
+            const size_t mid = (end + last) / 2;
+            if ( m_entries[mid].leftCol <= col )
+                end = mid + 1;
+            else
+                last = mid;
+        }
+
+        FindBlocks(lo, hi, end, col);
+    }
+
+    // The most recently added blocks have the highest priority.
+    wxVectorSort(m_found);
+
+    for ( size_t n = m_found.size(); n > 0; n-- )
+    {
+        wxGridCellAttr* const attr = m_blocks[m_found[n - 1]].attr;
+        attr->IncRef();
+        merger.Add(attr);
+    }
+}
+
+void wxGridBlockAttrData::UpdateAttrRows( size_t pos, int numRows )
+{
+    UpdateAttrRowsOrCols(pos, numRows, true);
+}
+
+void wxGridBlockAttrData::UpdateAttrCols( size_t pos, int numCols )
+{
+    UpdateAttrRowsOrCols(pos, numCols, false);
+}
+
+void
+wxGridBlockAttrData::UpdateAttrRowsOrCols( size_t pos,
+                                           int numRowsOrCols,
+                                           bool rows )
+{
+    if ( !numRowsOrCols )
+        return;
+
+    const int start = static_cast<int>(pos);
+
+    for ( size_t n = 0; n < m_blocks.size(); n++ )
+    {
+        if ( !m_blocks[n].attr )
+            continue;
+
+        wxGridBlockCoords& coords = m_blocks[n].coords;
+
+        int first = rows ? coords.GetTopRow() : coords.GetLeftCol();
+        int last = rows ? coords.GetBottomRow() : coords.GetRightCol();
+
+        if ( numRowsOrCols > 0 )
+        {
+            // Inserting inside the block makes it grow, inserting before it
+            // moves it.
+            if ( first >= start )
+                first += numRowsOrCols;
+            if ( last >= start )
+                last += numRowsOrCols;
+        }
+        else // deleting
+        {
+            const int end = start - numRowsOrCols;
+
+            if ( first >= end )
+                first += numRowsOrCols;
+            else if ( first > start )
+                first = start;
+
+            if ( last >= end )
+                last += numRowsOrCols;
+            else if ( last >= start )
+                last = start - 1;
+
+            if ( last < first )
+            {
+                // all rows or columns of this block were deleted
+                m_blocks[n].attr->DecRef();
+                m_blocks[n].attr = NULL;
+                m_numRemoved++;
+                continue;
+            }
+        }
+
+        if ( rows )
+        {
+            coords.SetTopRow(first);
+            coords.SetBottomRow(last);
+        }
+        else
+        {
+            coords.SetLeftCol(first);
+            coords.SetRightCol(last);
+        }
+    }
+
+    // The coordinates of the blocks changed, so the map from them must be
+    // recreated anyhow.
+    Compact();
+
+    m_indexValid = false;
+}
+
 // ----------------------------------------------------------------------------
 // wxGridCellAttrProvider
 // ----------------------------------------------------------------------------
@@ -1158,62 +1591,16 @@ wxGridCellAttr *wxGridCellAttrProvider::GetAttr(int row, int col,
         switch (kind)
         {
             case (wxGridCellAttr::Any):
-                // Get cached merge attributes.
-                // Currently not used as no cache implemented as not mutable
-                // attr = m_data->m_mergeAttr.GetAttr(row, col);
-                if (!attr)
                 {
-                    // Basically implement old version.
-                    // Also check merge cache, so we don't have to re-merge every time..
-                    wxGridCellAttr *attrcell = m_data->m_cellAttrs.GetAttr(row, col);
-                    wxGridCellAttr *attrrow = m_data->m_rowAttrs.GetAttr(row);
-                    wxGridCellAttr *attrcol = m_data->m_colAttrs.GetAttr(col);
-
-                    if ((attrcell != attrrow) && (attrrow != attrcol) && (attrcell != attrcol))
-                    {
-                        // Two or more are non NULL
-                        attr = new wxGridCellAttr;
-                        attr->SetKind(wxGridCellAttr::Merged);
-
-                        // Order is important..
-                        if (attrcell)
-                        {
-                            attr->MergeWith(attrcell);
-                            attrcell->DecRef();
-                        }
-                        if (attrcol)
-                        {
-                            attr->MergeWith(attrcol);
-                            attrcol->DecRef();
-                        }
-                        if (attrrow)
-                        {
-                            attr->MergeWith(attrrow);
-                            attrrow->DecRef();
-                        }
-
-                        // store merge attr if cache implemented
-                        //attr->IncRef();
-                        //m_data->m_mergeAttr.SetAttr(attr, row, col);
-                    }
-                    else
-                    {
-                        // one or none is non null return it or null.
-                        if (attrrow)
-                            attr = attrrow;
-                        if (attrcol)
-                        {
-                            if (attr)
-                                attr->DecRef();
-                            attr = attrcol;
-                        }
-                        if (attrcell)
-                        {
-                            if (attr)
-                                attr->DecRef();
-                            attr = attrcell;
-                        }
-                    }
+                    // The attributes are merged in the order of their
+                    // priority: cell, blocks, column and then row ones.
+                    wxGridCellAttrMerger merger;
+                    merger.Add(m_data->m_cellAttrs.GetAttr(row, col));
+                    m_data->m_blockAttrs.GetAttrs(row, col, merger);
+                    merger.Add(m_data->m_colAttrs.GetAttr(col));
+                    merger.Add(m_data->m_rowAttrs.GetAttr(row));
+
+                    attr = merger.Get();
                 }
                 break;
 
@@ -1249,6 +1636,15 @@ void wxGridCellAttrProvider::SetAttr(wxGridCellAttr *attr,
     m_data->m_cellAttrs.SetAttr(attr, row, col);
 }
 
+void wxGridCellAttrProvider::SetBlockAttr(wxGridCellAttr *attr,
+                                          const wxGridBlockCoords& block)
+{
+    if ( !m_data )
+        InitData();
+
+    m_data->m_blockAttrs.SetAttr(attr, block);
+}
+
 void wxGridCellAttrProvider::SetRowAttr(wxGridCellAttr *attr, int row)
 {
     if ( !m_data )
@@ -1271,6 +1667,8 @@ void wxGridCellAttrProvider::UpdateAttrRows( size_t pos, int numRows )
     {
         m_data->m_cellAttrs.UpdateAttrRows( pos, numRows );
 
+        m_data->m_blockAttrs.UpdateAttrRows( pos, numRows );
+
         m_data->m_rowAttrs.UpdateAttrRowsOrCols( pos, numRows );
     }
 }
@@ -1281,6 +1679,8 @@ void wxGridCellAttrProvider::UpdateAttrCols( size_t pos, int numCols )
     {
         m_data->m_cellAttrs.UpdateAttrCols( pos, numCols );
 
+        m_data->m_blockAttrs.UpdateAttrCols( pos, numCols );
+
         m_data->m_colAttrs.UpdateAttrRowsOrCols( pos, numCols );
     }
 }
@@ -1559,6 +1959,23 @@ void wxGridTableBase::SetAttr(wxGridCellAttr* attr, int row, int col)
     }
 }
 
+void wxGridTableBase::SetBlockAttr(wxGridCellAttr *attr,
+                                   const wxGridBlockCoords& block)
+{
+    if ( m_attrProvider )
+    {
+        if ( attr )
+            attr->SetKind(wxGridCellAttr::Cell);
+        m_attrProvider->SetBlockAttr(attr, block);
+    }
+    else
+    {
+        // as we take ownership of the pointer and don't store it, we must
+        // free it now
+        wxSafeDecRef(attr);
+    }
+}
+
 void wxGridTableBase::SetRowAttr(wxGridCellAttr *attr, int row)
 {
     if ( m_attrProvider )
@@ -1763,30 +2180,280 @@ wxGridTableMessage::wxGridTableMessage( wxGridTableBase *table, int id,
 
 //////////////////////////////////////////////////////////////////////
 //
-// A basic grid table for string data. An object of this class will
-// created by wxGrid if you don't specify an alternative table class.
+// Base class for the grid tables storing their values and labels in memory.
 //
 
-WX_DEFINE_OBJARRAY(wxGridStringArray)
-
-wxIMPLEMENT_DYNAMIC_CLASS(wxGridStringTable, wxGridTableBase);
+wxIMPLEMENT_ABSTRACT_CLASS(wxGridMemoryTableBase, wxGridTableBase);
 
-wxGridStringTable::wxGridStringTable()
-        : wxGridTableBase()
+bool wxGridMemoryTableBase::InsertRows( size_t pos, size_t numRows )
 {
-    m_numCols = 0;
-}
+    if ( pos >= static_cast<size_t>(GetNumberRows()) )
+    {
+        return AppendRows( numRows );
+    }
 
-wxGridStringTable::wxGridStringTable( int numRows, int numCols )
-        : wxGridTableBase()
-{
-    m_numCols = numCols;
+    DoInsertRows( pos, numRows );
 
-    m_data.Alloc( numRows );
+    if ( GetView() )
+    {
+        wxGridTableMessage msg( this,
+                                wxGRIDTABLE_NOTIFY_ROWS_INSERTED,
+                                pos,
+                                numRows );
 
-    wxArrayString sa;
-    sa.Alloc( numCols );
-    sa.Add( wxEmptyString, numCols );
+        GetView()->ProcessTableMessage( msg );
+    }
+
+    return true;
+}
+
+bool wxGridMemoryTableBase::AppendRows( size_t numRows )
+{
+    DoInsertRows( GetNumberRows(), numRows );
+
+    if ( GetView() )
+    {
+        wxGridTableMessage msg( this,
+                                wxGRIDTABLE_NOTIFY_ROWS_APPENDED,
+                                numRows );
+
+        GetView()->ProcessTableMessage( msg );
+    }
+
+    return true;
+}
+
+bool wxGridMemoryTableBase::DeleteRows( size_t pos, size_t numRows )
+{
+    const size_t curNumRows = GetNumberRows();
+
+    if ( pos >= curNumRows )
+    {
+        wxFAIL_MSG( wxString::Format
+                    (
+                        wxT("Called %s::DeleteRows(pos=%lu, N=%lu)\nPos value is invalid for present table with %lu rows"),
+                        GetClassInfo()->GetClassName(),
+                        (unsigned long)pos,
+                        (unsigned long)numRows,
+                        (unsigned long)curNumRows
+                    ) );
+
+        return false;
+    }
+
+    if ( numRows > curNumRows - pos )
+    {
+        numRows = curNumRows - pos;
+    }
+
+    DoDeleteRows( pos, numRows );
+
+    if ( GetView() )
+    {
+        wxGridTableMessage msg( this,
+                                wxGRIDTABLE_NOTIFY_ROWS_DELETED,
+                                pos,
+                                numRows );
+
+        GetView()->ProcessTableMessage( msg );
+    }
+
+    return true;
+}
+
+bool wxGridMemoryTableBase::InsertCols( size_t pos, size_t numCols )
+{
+    if ( pos >= static_cast<size_t>(GetNumberCols()) )
+    {
+        return AppendCols( numCols );
+    }
+
+    if ( !m_colLabels.IsEmpty() )
+    {
+        m_colLabels.Insert( wxEmptyString, pos, numCols );
+
+        for ( size_t i = pos; i < pos + numCols; i++ )
+            m_colLabels[i] = wxGridTableBase::GetColLabelValue( i );
+    }
+
+    DoInsertCols( pos, numCols );
+
+    if ( GetView() )
+    {
+        wxGridTableMessage msg( this,
+                                wxGRIDTABLE_NOTIFY_COLS_INSERTED,
+                                pos,
+                                numCols );
+
+        GetView()->ProcessTableMessage( msg );
+    }
+
+    return true;
+}
+
+bool wxGridMemoryTableBase::AppendCols( size_t numCols )
+{
+    DoInsertCols( GetNumberCols(), numCols );
+
+    if ( GetView() )
+    {
+        wxGridTableMessage msg( this,
+                                wxGRIDTABLE_NOTIFY_COLS_APPENDED,
+                                numCols );
+
+        GetView()->ProcessTableMessage( msg );
+    }
+
+    return true;
+}
+
+bool wxGridMemoryTableBase::DeleteCols( size_t pos, size_t numCols )
+{
+    const size_t curNumCols = GetNumberCols();
+
+    if ( pos >= curNumCols )
+    {
+        wxFAIL_MSG( wxString::Format
+                    (
+                        wxT("Called %s::DeleteCols(pos=%lu, N=%lu)\nPos value is invalid for present table with %lu cols"),
+                        GetClassInfo()->GetClassName(),
+                        (unsigned long)pos,
+                        (unsigned long)numCols,
+                        (unsigned long)curNumCols
+                    ) );
+        return false;
+    }
+
+    int colID;
+    if ( GetView() )
+        colID = GetView()->GetColAt( pos );
+    else
+        colID = pos;
+
+    if ( numCols > curNumCols - colID )
+    {
+        numCols = curNumCols - colID;
+    }
+
+    if ( !m_colLabels.IsEmpty() )
+    {
+        // m_colLabels stores just as many elements as it needs, e.g. if only
+        // the label of the first column had been set it would have only one
+        // element and not numCols, so account for it
+        int numRemaining = m_colLabels.size() - colID;
+        if (numRemaining > 0)
+            m_colLabels.RemoveAt( colID, wxMin(numCols, numRemaining) );
+    }
+
+    DoDeleteCols( colID, numCols );
+
+    if ( GetView() )
+    {
+        wxGridTableMessage msg( this,
+                                wxGRIDTABLE_NOTIFY_COLS_DELETED,
+                                pos,
+                                numCols );
+
+        GetView()->ProcessTableMessage( msg );
+    }
+
+    return true;
+}
+
+wxString wxGridMemoryTableBase::GetRowLabelValue( int row )
+{
+    if ( row > (int)(m_rowLabels.GetCount()) - 1 )
+    {
+        // using default label
+        //
+        return wxGridTableBase::GetRowLabelValue( row );
+    }
+    else
+    {
+        return m_rowLabels[row];
+    }
+}
+
+wxString wxGridMemoryTableBase::GetColLabelValue( int col )
+{
+    if ( col > (int)(m_colLabels.GetCount()) - 1 )
+    {
+        // using default label
+        //
+        return wxGridTableBase::GetColLabelValue( col );
+    }
+    else
+    {
+        return m_colLabels[col];
+    }
+}
+
+void wxGridMemoryTableBase::SetRowLabelValue( int row, const wxString& value )
+{
+    if ( row > (int)(m_rowLabels.GetCount()) - 1 )
+    {
+        int n = m_rowLabels.GetCount();
+        int i;
+
+        for ( i = n; i <= row; i++ )
+        {
+            m_rowLabels.Add( wxGridTableBase::GetRowLabelValue(i) );
+        }
+    }
+
+    m_rowLabels[row] = value;
+}
+
+void wxGridMemoryTableBase::SetColLabelValue( int col, const wxString& value )
+{
+    if ( col > (int)(m_colLabels.GetCount()) - 1 )
+    {
+        int n = m_colLabels.GetCount();
+        int i;
+
+        for ( i = n; i <= col; i++ )
+        {
+            m_colLabels.Add( wxGridTableBase::GetColLabelValue(i) );
+        }
+    }
+
+    m_colLabels[col] = value;
+}
+
+void wxGridMemoryTableBase::SetCornerLabelValue( const wxString& value )
+{
+    m_cornerLabel = value;
+}
+
+wxString wxGridMemoryTableBase::GetCornerLabelValue() const
+{
+    return m_cornerLabel;
+}
+
+//////////////////////////////////////////////////////////////////////
+//
+// A basic grid table for string data. An object of this class will
+// created by wxGrid if you don't specify an alternative table class.
+//
+
+WX_DEFINE_OBJARRAY(wxGridStringArray)
+
+wxIMPLEMENT_DYNAMIC_CLASS(wxGridStringTable, wxGridMemoryTableBase);
+
+wxGridStringTable::wxGridStringTable()
+{
+    m_numCols = 0;
+}
+
+wxGridStringTable::wxGridStringTable( int numRows, int numCols )
+{
+    m_numCols = numCols;
+
+    m_data.Alloc( numRows );
+
+    wxArrayString sa;
+    sa.Alloc( numCols );
+    sa.Add( wxEmptyString, numCols );
 
     m_data.Add( sa, numRows );
 }
@@ -1831,297 +2498,653 @@ void wxGridStringTable::Clear()
     }
 }
 
-bool wxGridStringTable::InsertRows( size_t pos, size_t numRows )
+void wxGridStringTable::DoInsertRows( size_t pos, size_t numRows )
 {
+    wxArrayString sa;
+    if ( m_numCols > 0 )
+    {
+        sa.Alloc( m_numCols );
+        sa.Add( wxEmptyString, m_numCols );
+    }
+
     if ( pos >= m_data.size() )
+        m_data.Add( sa, numRows );
+    else
+        m_data.Insert( sa, pos, numRows );
+}
+
+void wxGridStringTable::DoDeleteRows( size_t pos, size_t numRows )
+{
+    if ( numRows >= m_data.size() )
     {
-        return AppendRows( numRows );
+        m_data.Clear();
+    }
+    else
+    {
+        m_data.RemoveAt( pos, numRows );
     }
+}
 
-    wxArrayString sa;
-    sa.Alloc( m_numCols );
-    sa.Add( wxEmptyString, m_numCols );
-    m_data.Insert( sa, pos, numRows );
+void wxGridStringTable::DoInsertCols( size_t pos, size_t numCols )
+{
+    for ( size_t row = 0; row < m_data.size(); row++ )
+    {
+        if ( pos >= static_cast<size_t>(m_numCols) )
+        {
+            m_data[row].Add( wxEmptyString, numCols );
+        }
+        else
+        {
+            for ( size_t col = pos; col < pos + numCols; col++ )
+            {
+                m_data[row].Insert( wxEmptyString, col );
+            }
+        }
+    }
 
-    if ( GetView() )
+    m_numCols += numCols;
+}
+
+void wxGridStringTable::DoDeleteCols( size_t pos, size_t numCols )
+{
+    size_t row;
+
+    const size_t curNumRows = m_data.GetCount();
+
+    if ( numCols >= static_cast<size_t>(m_numCols) )
     {
-        wxGridTableMessage msg( this,
-                                wxGRIDTABLE_NOTIFY_ROWS_INSERTED,
-                                pos,
-                                numRows );
+        for ( row = 0; row < curNumRows; row++ )
+        {
+            m_data[row].Clear();
+        }
 
-        GetView()->ProcessTableMessage( msg );
+        m_numCols = 0;
     }
+    else // something will be left
+    {
+        for ( row = 0; row < curNumRows; row++ )
+        {
+            m_data[row].RemoveAt( pos, numCols );
+        }
 
-    return true;
+        m_numCols -= numCols;
+    }
 }
 
-bool wxGridStringTable::AppendRows( size_t numRows )
+//////////////////////////////////////////////////////////////////////
+//
+// A grid table storing the values of each column using the representation
+// corresponding to the type of this column.
+//
+
+namespace
 {
-    wxArrayString sa;
-    if ( m_numCols > 0 )
+
+// Conversions between the string representation of the values and the values
+// themselves used by the columns of wxGridTypedTable.
+inline wxString FormatTypedTableValue(long value)
+{
+    return wxString::Format(wxS("%ld"), value);
+}
+
+inline wxString FormatTypedTableValue(double value)
+{
+    return wxString::Format(wxS("%.15g"), value);
+}
+
+inline wxString FormatTypedTableValue(bool value)
+{
+    return value ? wxString(wxS("1")) : wxString();
+}
+
+inline void ParseTypedTableValue(const wxString& s, long& value)
+{
+    if ( !s.ToLong(&value) )
+        value = 0;
+}
+
+inline void ParseTypedTableValue(const wxString& s, double& value)
+{
+    if ( !s.ToDouble(&value) )
+        value = 0.;
+}
+
+inline void ParseTypedTableValue(const wxString& s, bool& value)
+{
+#if wxUSE_CHECKBOX
+    if ( wxGridCellBoolEditor::IsTrueValue(s) )
     {
-        sa.Alloc( m_numCols );
-        sa.Add( wxEmptyString, m_numCols );
+        value = true;
+        return;
     }
+#endif // wxUSE_CHECKBOX
 
-    m_data.Add( sa, numRows );
+    value = s == wxS("1");
+}
 
-    if ( GetView() )
+// Conversions between the types of the values of the numeric columns.
+template <typename T, typename U>
+inline void AssignTypedTableValue(T& to, U from)
+{
+    to = static_cast<T>(from);
+}
+
+// Converting NaN or a value out of long range to long is undefined, so map
+// NaN to 0 and clamp the other values instead.
+inline void AssignTypedTableValue(long& to, double from)
+{
+    if ( wxIsNaN(from) )
+        to = 0;
+    else if ( from <= static_cast<double>(LONG_MIN) )
+        to = LONG_MIN;
+    else if ( from >= static_cast<double>(LONG_MAX) )
+        to = LONG_MAX;
+    else
+        to = static_cast<long>(from);
+}
+
+inline const wxChar* GetTypedTableTypeName(long) { return wxGRID_VALUE_NUMBER; }
+inline const wxChar* GetTypedTableTypeName(double) { return wxGRID_VALUE_FLOAT; }
+inline const wxChar* GetTypedTableTypeName(bool) { return wxGRID_VALUE_BOOL; }
+
+} // anonymous namespace
+
+// Base class for all columns of wxGridTypedTable: it implements access to the
+// values of all types in terms of their string representation, which is
+// appropriate for the string columns, while the numeric columns override all
+// these functions to avoid the conversions.
+class wxGridTypedTableColumn
+{
+public:
+    explicit wxGridTypedTableColumn(const wxString& typeName)
+        : m_typeName(typeName)
     {
-        wxGridTableMessage msg( this,
-                                wxGRIDTABLE_NOTIFY_ROWS_APPENDED,
-                                numRows );
+    }
 
-        GetView()->ProcessTableMessage( msg );
+    virtual ~wxGridTypedTableColumn() { }
+
+    // Return the full type name, possibly including the parameters.
+    const wxString& GetTypeName() const { return m_typeName; }
+
+    // Return true if the values can be retrieved as the given type without
+    // converting them from string.
+    virtual bool CanGetAs(const wxString& typeName) const
+    {
+        return typeName == wxGRID_VALUE_STRING;
     }
 
-    return true;
+    virtual void InsertRows(size_t pos, size_t numRows) = 0;
+    virtual void DeleteRows(size_t pos, size_t numRows) = 0;
+    virtual void ClearValues() = 0;
+
+    virtual bool IsEmpty(size_t row) const = 0;
+
+    virtual wxString GetString(size_t row) const = 0;
+    virtual void SetString(size_t row, const wxString& value) = 0;
+
+    virtual long GetLong(size_t row) const
+    {
+        long value;
+        ParseTypedTableValue(GetString(row), value);
+        return value;
+    }
+
+    virtual double GetDouble(size_t row) const
+    {
+        double value;
+        ParseTypedTableValue(GetString(row), value);
+        return value;
+    }
+
+    virtual bool GetBool(size_t row) const
+    {
+        bool value;
+        ParseTypedTableValue(GetString(row), value);
+        return value;
+    }
+
+    virtual void SetLong(size_t row, long value)
+        { SetString(row, FormatTypedTableValue(value)); }
+    virtual void SetDouble(size_t row, double value)
+        { SetString(row, FormatTypedTableValue(value)); }
+    virtual void SetBool(size_t row, bool value)
+        { SetString(row, FormatTypedTableValue(value)); }
+
+    // Set the value in the given row to the value of the same row of another
+    // column, converting it to our type.
+    virtual void CopyValue(size_t row, const wxGridTypedTableColumn& from)
+    {
+        SetString(row, from.GetString(row));
+    }
+
+private:
+    const wxString m_typeName;
+
+    wxDECLARE_NO_COPY_CLASS(wxGridTypedTableColumn);
+};
+
+namespace
+{
+
+inline void
+GetTypedTableValue(const wxGridTypedTableColumn& col, size_t row, long& value)
+{
+    value = col.GetLong(row);
 }
 
-bool wxGridStringTable::DeleteRows( size_t pos, size_t numRows )
+inline void
+GetTypedTableValue(const wxGridTypedTableColumn& col, size_t row, double& value)
 {
-    size_t curNumRows = m_data.GetCount();
+    value = col.GetDouble(row);
+}
 
-    if ( pos >= curNumRows )
+inline void
+GetTypedTableValue(const wxGridTypedTableColumn& col, size_t row, bool& value)
+{
+    value = col.GetBool(row);
+}
+
+// Column storing numbers or booleans.
+template <typename T>
+class wxGridTypedTableNumericColumn : public wxGridTypedTableColumn
+{
+public:
+    wxGridTypedTableNumericColumn(const wxString& typeName, size_t numRows)
+        : wxGridTypedTableColumn(typeName),
+          m_values(numRows, T())
     {
-        wxFAIL_MSG( wxString::Format
-                    (
-                        wxT("Called wxGridStringTable::DeleteRows(pos=%lu, N=%lu)\nPos value is invalid for present table with %lu rows"),
-                        (unsigned long)pos,
-                        (unsigned long)numRows,
-                        (unsigned long)curNumRows
-                    ) );
+    }
+
+    virtual bool CanGetAs(const wxString& typeName) const wxOVERRIDE
+    {
+        return typeName == GetTypedTableTypeName(T()) ||
+                wxGridTypedTableColumn::CanGetAs(typeName);
+    }
+
+    virtual void InsertRows(size_t pos, size_t numRows) wxOVERRIDE
+    {
+        m_values.insert(m_values.begin() + pos, numRows, T());
+    }
 
+    virtual void DeleteRows(size_t pos, size_t numRows) wxOVERRIDE
+    {
+        m_values.erase(m_values.begin() + pos,
+                       m_values.begin() + pos + numRows);
+    }
+
+    virtual void ClearValues() wxOVERRIDE
+    {
+        for ( size_t n = 0; n < m_values.size(); n++ )
+            m_values[n] = T();
+    }
+
+    virtual bool IsEmpty(size_t WXUNUSED(row)) const wxOVERRIDE
+    {
         return false;
     }
 
-    if ( numRows > curNumRows - pos )
+    virtual wxString GetString(size_t row) const wxOVERRIDE
     {
-        numRows = curNumRows - pos;
+        return FormatTypedTableValue(static_cast<T>(m_values[row]));
     }
 
-    if ( numRows >= curNumRows )
+    virtual void SetString(size_t row, const wxString& value) wxOVERRIDE
     {
-        m_data.Clear();
+        T v;
+        ParseTypedTableValue(value, v);
+        m_values[row] = v;
     }
-    else
+
+    virtual long GetLong(size_t row) const wxOVERRIDE
     {
-        m_data.RemoveAt( pos, numRows );
+        long value;
+        AssignTypedTableValue(value, static_cast<T>(m_values[row]));
+        return value;
     }
 
-    if ( GetView() )
+    virtual double GetDouble(size_t row) const wxOVERRIDE
+        { return static_cast<double>(m_values[row]); }
+    virtual bool GetBool(size_t row) const wxOVERRIDE
+        { return m_values[row] != 0; }
+
+    virtual void SetLong(size_t row, long value) wxOVERRIDE
+        { m_values[row] = static_cast<T>(value); }
+    virtual void SetDouble(size_t row, double value) wxOVERRIDE
     {
-        wxGridTableMessage msg( this,
-                                wxGRIDTABLE_NOTIFY_ROWS_DELETED,
-                                pos,
-                                numRows );
+        T v;
+        AssignTypedTableValue(v, value);
+        m_values[row] = v;
+    }
 
-        GetView()->ProcessTableMessage( msg );
+    virtual void SetBool(size_t row, bool value) wxOVERRIDE
+        { m_values[row] = static_cast<T>(value); }
+
+    virtual void CopyValue(size_t row, const wxGridTypedTableColumn& from) wxOVERRIDE
+    {
+        T value;
+        GetTypedTableValue(from, row, value);
+        m_values[row] = value;
     }
 
-    return true;
-}
+private:
+    wxVector<T> m_values;
+};
 
-bool wxGridStringTable::InsertCols( size_t pos, size_t numCols )
+// Column storing arbitrary strings.
+class wxGridTypedTableStringColumn : public wxGridTypedTableColumn
 {
-    if ( pos >= static_cast<size_t>(m_numCols) )
+public:
+    wxGridTypedTableStringColumn(const wxString& typeName, size_t numRows)
+        : wxGridTypedTableColumn(typeName),
+          m_values(numRows, wxString())
     {
-        return AppendCols( numCols );
     }
 
-    if ( !m_colLabels.IsEmpty() )
+    virtual void InsertRows(size_t pos, size_t numRows) wxOVERRIDE
     {
-        m_colLabels.Insert( wxEmptyString, pos, numCols );
+        m_values.insert(m_values.begin() + pos, numRows, wxString());
+    }
 
-        for ( size_t i = pos; i < pos + numCols; i++ )
-            m_colLabels[i] = wxGridTableBase::GetColLabelValue( i );
+    virtual void DeleteRows(size_t pos, size_t numRows) wxOVERRIDE
+    {
+        m_values.erase(m_values.begin() + pos,
+                       m_values.begin() + pos + numRows);
     }
 
-    for ( size_t row = 0; row < m_data.size(); row++ )
+    virtual void ClearValues() wxOVERRIDE
+    {
+        for ( size_t n = 0; n < m_values.size(); n++ )
+            m_values[n].clear();
+    }
+
+    virtual bool IsEmpty(size_t row) const wxOVERRIDE
+        { return m_values[row].empty(); }
+
+    virtual wxString GetString(size_t row) const wxOVERRIDE
+        { return m_values[row]; }
+
+    virtual void SetString(size_t row, const wxString& value) wxOVERRIDE
+        { m_values[row] = value; }
+
+private:
+    wxVector<wxString> m_values;
+};
+
+// Column storing strings from a, usually small, set of possible values, such
+// as the values of wxGRID_VALUE_CHOICE columns: each distinct string is only
+// stored once and the column only contains the indices of the strings.
+class wxGridTypedTableInternedColumn : public wxGridTypedTableColumn
+{
+public:
+    wxGridTypedTableInternedColumn(const wxString& typeName, size_t numRows)
+        : wxGridTypedTableColumn(typeName),
+          m_values(numRows, 0)
     {
-        for ( size_t col = pos; col < pos + numCols; col++ )
+        ResetStrings();
+    }
+
+    virtual void InsertRows(size_t pos, size_t numRows) wxOVERRIDE
+    {
+        m_values.insert(m_values.begin() + pos, numRows, 0);
+    }
+
+    virtual void DeleteRows(size_t pos, size_t numRows) wxOVERRIDE
+    {
+        m_values.erase(m_values.begin() + pos,
+                       m_values.begin() + pos + numRows);
+    }
+
+    virtual void ClearValues() wxOVERRIDE
+    {
+        for ( size_t n = 0; n < m_values.size(); n++ )
+            m_values[n] = 0;
+
+        ResetStrings();
+    }
+
+    virtual bool IsEmpty(size_t row) const wxOVERRIDE
+        { return m_values[row] == 0; }
+
+    virtual wxString GetString(size_t row) const wxOVERRIDE
+        { return m_strings[m_values[row]]; }
+
+    virtual void SetString(size_t row, const wxString& value) wxOVERRIDE
+    {
+        wxStringToNumHashMap::const_iterator it = m_indices.find(value);
+        if ( it != m_indices.end() )
         {
-            m_data[row].Insert( wxEmptyString, col );
+            m_values[row] = static_cast<unsigned>(it->second);
+            return;
         }
-    }
 
-    m_numCols += numCols;
+        // Notice that we never remove the strings which are not used any
+        // more, this is fine as long as the number of distinct values in the
+        // column remains small, which is the intended use case.
+        const unsigned index = static_cast<unsigned>(m_strings.size());
+        m_strings.push_back(value);
+        m_indices[value] = index;
 
-    if ( GetView() )
+        m_values[row] = index;
+    }
+
+private:
+    void ResetStrings()
     {
-        wxGridTableMessage msg( this,
-                                wxGRIDTABLE_NOTIFY_COLS_INSERTED,
-                                pos,
-                                numCols );
+        // The empty string always has index 0.
+        m_strings.clear();
+        m_strings.push_back(wxString());
+
+        m_indices.clear();
+        m_indices[wxString()] = 0;
+    }
+
+    // All the distinct strings used in this column.
+    wxArrayString m_strings;
+
+    // Map from the strings to their indices in m_strings.
+    wxStringToNumHashMap m_indices;
+
+    // The indices of the strings in m_strings for all rows.
+    wxVector<unsigned> m_values;
+};
+
+// Create the column with the given type.
+wxGridTypedTableColumn*
+CreateTypedTableColumn(const wxString& typeName, size_t numRows)
+{
+    // Ignore the parameters of the type, if any, they are only used by the
+    // renderer and editor.
+    const wxString type = typeName.BeforeFirst(wxS(':'));
+
+    if ( type == wxGRID_VALUE_NUMBER )
+        return new wxGridTypedTableNumericColumn<long>(typeName, numRows);
+    if ( type == wxGRID_VALUE_FLOAT )
+        return new wxGridTypedTableNumericColumn<double>(typeName, numRows);
+    if ( type == wxGRID_VALUE_BOOL )
+        return new wxGridTypedTableNumericColumn<bool>(typeName, numRows);
+    if ( type == wxGRID_VALUE_CHOICE )
+        return new wxGridTypedTableInternedColumn(typeName, numRows);
+
+    return new wxGridTypedTableStringColumn(typeName, numRows);
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// wxGridTypedTable
+// ----------------------------------------------------------------------------
+
+wxIMPLEMENT_DYNAMIC_CLASS(wxGridTypedTable, wxGridMemoryTableBase);
+
+wxGridTypedTable::wxGridTypedTable()
+{
+    m_numRows = 0;
+}
+
+wxGridTypedTable::wxGridTypedTable( int numRows, int numCols,
+                                    const wxString& typeName )
+{
+    m_numRows = numRows;
+
+    m_cols.reserve( numCols );
+    for ( int col = 0; col < numCols; col++ )
+        m_cols.push_back( CreateTypedTableColumn(typeName, numRows) );
+}
+
+wxGridTypedTable::~wxGridTypedTable()
+{
+    for ( size_t col = 0; col < m_cols.size(); col++ )
+        delete m_cols[col];
+}
+
+void wxGridTypedTable::SetColType( int col, const wxString& typeName )
+{
+    wxCHECK_RET( col >= 0 && col < GetNumberCols(),
+                 wxT("invalid column index in wxGridTypedTable") );
+
+    wxGridTypedTableColumn* const
+        column = CreateTypedTableColumn(typeName, m_numRows);
+
+    const wxGridTypedTableColumn& old = *m_cols[col];
+    for ( int row = 0; row < m_numRows; row++ )
+        column->CopyValue(row, old);
+
+    delete m_cols[col];
+    m_cols[col] = column;
+}
 
-        GetView()->ProcessTableMessage( msg );
-    }
+wxString wxGridTypedTable::GetColType( int col ) const
+{
+    wxCHECK_MSG( col >= 0 && col < static_cast<int>(m_cols.size()),
+                 wxString(),
+                 wxT("invalid column index in wxGridTypedTable") );
 
-    return true;
+    return m_cols[col]->GetTypeName();
 }
 
-bool wxGridStringTable::AppendCols( size_t numCols )
+wxGridTypedTableColumn* wxGridTypedTable::GetColumn( int row, int col ) const
 {
-    for ( size_t row = 0; row < m_data.size(); row++ )
-    {
-        m_data[row].Add( wxEmptyString, numCols );
-    }
+    wxCHECK_MSG( (row >= 0 && row < m_numRows) &&
+                 (col >= 0 && col < static_cast<int>(m_cols.size())),
+                 NULL,
+                 wxT("invalid row or column index in wxGridTypedTable") );
 
-    m_numCols += numCols;
+    return m_cols[col];
+}
 
-    if ( GetView() )
-    {
-        wxGridTableMessage msg( this,
-                                wxGRIDTABLE_NOTIFY_COLS_APPENDED,
-                                numCols );
+wxString wxGridTypedTable::GetValue( int row, int col )
+{
+    wxGridTypedTableColumn* const column = GetColumn(row, col);
 
-        GetView()->ProcessTableMessage( msg );
-    }
+    return column ? column->GetString(row) : wxString();
+}
 
-    return true;
+void wxGridTypedTable::SetValue( int row, int col, const wxString& value )
+{
+    wxGridTypedTableColumn* const column = GetColumn(row, col);
+    if ( column )
+        column->SetString(row, value);
 }
 
-bool wxGridStringTable::DeleteCols( size_t pos, size_t numCols )
+bool wxGridTypedTable::IsEmptyCell( int row, int col )
 {
-    size_t row;
+    wxGridTypedTableColumn* const column = GetColumn(row, col);
 
-    size_t curNumRows = m_data.GetCount();
-    size_t curNumCols = m_numCols;
+    return !column || column->IsEmpty(row);
+}
 
-    if ( pos >= curNumCols )
-    {
-        wxFAIL_MSG( wxString::Format
-                    (
-                        wxT("Called wxGridStringTable::DeleteCols(pos=%lu, N=%lu)\nPos value is invalid for present table with %lu cols"),
-                        (unsigned long)pos,
-                        (unsigned long)numCols,
-                        (unsigned long)curNumCols
-                    ) );
-        return false;
-    }
+wxString wxGridTypedTable::GetTypeName( int WXUNUSED(row), int col )
+{
+    return GetColType(col);
+}
 
-    int colID;
-    if ( GetView() )
-        colID = GetView()->GetColAt( pos );
-    else
-        colID = pos;
+bool wxGridTypedTable::CanGetValueAs( int row, int col,
+                                      const wxString& typeName )
+{
+    wxGridTypedTableColumn* const column = GetColumn(row, col);
 
-    if ( numCols > curNumCols - colID )
-    {
-        numCols = curNumCols - colID;
-    }
+    return column && column->CanGetAs(typeName);
+}
 
-    if ( !m_colLabels.IsEmpty() )
-    {
-        // m_colLabels stores just as many elements as it needs, e.g. if only
-        // the label of the first column had been set it would have only one
-        // element and not numCols, so account for it
-        int numRemaining = m_colLabels.size() - colID;
-        if (numRemaining > 0)
-            m_colLabels.RemoveAt( colID, wxMin(numCols, numRemaining) );
-    }
+long wxGridTypedTable::GetValueAsLong( int row, int col )
+{
+    wxGridTypedTableColumn* const column = GetColumn(row, col);
 
-    if ( numCols >= curNumCols )
-    {
-        for ( row = 0; row < curNumRows; row++ )
-        {
-            m_data[row].Clear();
-        }
+    return column ? column->GetLong(row) : 0;
+}
 
-        m_numCols = 0;
-    }
-    else // something will be left
-    {
-        for ( row = 0; row < curNumRows; row++ )
-        {
-            m_data[row].RemoveAt( colID, numCols );
-        }
+double wxGridTypedTable::GetValueAsDouble( int row, int col )
+{
+    wxGridTypedTableColumn* const column = GetColumn(row, col);
 
-        m_numCols -= numCols;
-    }
+    return column ? column->GetDouble(row) : 0.;
+}
 
-    if ( GetView() )
-    {
-        wxGridTableMessage msg( this,
-                                wxGRIDTABLE_NOTIFY_COLS_DELETED,
-                                pos,
-                                numCols );
+bool wxGridTypedTable::GetValueAsBool( int row, int col )
+{
+    wxGridTypedTableColumn* const column = GetColumn(row, col);
 
-        GetView()->ProcessTableMessage( msg );
-    }
+    return column && column->GetBool(row);
+}
 
-    return true;
+void wxGridTypedTable::SetValueAsLong( int row, int col, long value )
+{
+    wxGridTypedTableColumn* const column = GetColumn(row, col);
+    if ( column )
+        column->SetLong(row, value);
 }
 
-wxString wxGridStringTable::GetRowLabelValue( int row )
+void wxGridTypedTable::SetValueAsDouble( int row, int col, double value )
 {
-    if ( row > (int)(m_rowLabels.GetCount()) - 1 )
-    {
-        // using default label
-        //
-        return wxGridTableBase::GetRowLabelValue( row );
-    }
-    else
-    {
-        return m_rowLabels[row];
-    }
+    wxGridTypedTableColumn* const column = GetColumn(row, col);
+    if ( column )
+        column->SetDouble(row, value);
 }
 
-wxString wxGridStringTable::GetColLabelValue( int col )
+void wxGridTypedTable::SetValueAsBool( int row, int col, bool value )
 {
-    if ( col > (int)(m_colLabels.GetCount()) - 1 )
-    {
-        // using default label
-        //
-        return wxGridTableBase::GetColLabelValue( col );
-    }
-    else
-    {
-        return m_colLabels[col];
-    }
+    wxGridTypedTableColumn* const column = GetColumn(row, col);
+    if ( column )
+        column->SetBool(row, value);
 }
 
-void wxGridStringTable::SetRowLabelValue( int row, const wxString& value )
+void wxGridTypedTable::Clear()
 {
-    if ( row > (int)(m_rowLabels.GetCount()) - 1 )
-    {
-        int n = m_rowLabels.GetCount();
-        int i;
+    for ( size_t col = 0; col < m_cols.size(); col++ )
+        m_cols[col]->ClearValues();
+}
 
-        for ( i = n; i <= row; i++ )
-        {
-            m_rowLabels.Add( wxGridTableBase::GetRowLabelValue(i) );
-        }
-    }
+void wxGridTypedTable::DoInsertRows( size_t pos, size_t numRows )
+{
+    for ( size_t col = 0; col < m_cols.size(); col++ )
+        m_cols[col]->InsertRows( pos, numRows );
 
-    m_rowLabels[row] = value;
+    m_numRows += numRows;
 }
 
-void wxGridStringTable::SetColLabelValue( int col, const wxString& value )
+void wxGridTypedTable::DoDeleteRows( size_t pos, size_t numRows )
 {
-    if ( col > (int)(m_colLabels.GetCount()) - 1 )
-    {
-        int n = m_colLabels.GetCount();
-        int i;
-
-        for ( i = n; i <= col; i++ )
-        {
-            m_colLabels.Add( wxGridTableBase::GetColLabelValue(i) );
-        }
-    }
+    for ( size_t col = 0; col < m_cols.size(); col++ )
+        m_cols[col]->DeleteRows( pos, numRows );
 
-    m_colLabels[col] = value;
+    m_numRows -= numRows;
 }
 
-void wxGridStringTable::SetCornerLabelValue( const wxString& value )
+void wxGridTypedTable::DoInsertCols( size_t pos, size_t numCols )
 {
-    m_cornerLabel = value;
+    for ( size_t col = pos; col < pos + numCols; col++ )
+    {
+        m_cols.insert( m_cols.begin() + col,
+                       CreateTypedTableColumn(wxGRID_VALUE_STRING, m_numRows) );
+    }
 }
 
-wxString wxGridStringTable::GetCornerLabelValue() const
+void wxGridTypedTable::DoDeleteCols( size_t pos, size_t numCols )
 {
-    return m_cornerLabel;
+    for ( size_t col = pos; col < pos + numCols; col++ )
+        delete m_cols[col];
+
+    m_cols.erase( m_cols.begin() + pos, m_cols.begin() + pos + numCols );
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -2917,9 +3940,9 @@ wxGrid::SetTable(wxGridTableBase *table,
 
         // kill row and column size arrays
         m_colWidths.Empty();
-        m_colRights.Empty();
+        m_colRights.Clear();
         m_rowHeights.Empty();
-        m_rowBottoms.Empty();
+        m_rowBottoms.Clear();
     }
 
     if (table)
@@ -3083,36 +4106,19 @@ void wxGrid::Init()
 void wxGrid::InitRowHeights()
 {
     m_rowHeights.Empty();
-    m_rowBottoms.Empty();
-
     m_rowHeights.Alloc( m_numRows );
-    m_rowBottoms.Alloc( m_numRows );
-
     m_rowHeights.Add( m_defaultRowHeight, m_numRows );
 
-    int rowBottom = 0;
-    for ( int i = 0; i < m_numRows; i++ )
-    {
-        rowBottom += m_defaultRowHeight;
-        m_rowBottoms.Add( rowBottom );
-    }
+    m_rowBottoms.Rebuild( m_rowHeights );
 }
 
 void wxGrid::InitColWidths()
 {
     m_colWidths.Empty();
-    m_colRights.Empty();
-
     m_colWidths.Alloc( m_numCols );
-    m_colRights.Alloc( m_numCols );
-
     m_colWidths.Add( m_defaultColWidth, m_numCols );
 
-    for ( int i = 0; i < m_numCols; i++ )
-    {
-        int colRight = ( GetColPos( i ) + 1 ) * m_defaultColWidth;
-        m_colRights.Add( colRight );
-    }
+    m_colRights.Rebuild( m_colWidths, m_colAt );
 }
 
 int wxGrid::GetColWidth(int col) const
@@ -3129,13 +4135,13 @@ int wxGrid::GetColLeft(int col) const
     if ( m_colRights.IsEmpty() )
         return GetColPos( col ) * m_defaultColWidth;
 
-    return m_colRights[col] - GetColWidth(col);
+    return GetColRight(col) - GetColWidth(col);
 }
 
 int wxGrid::GetColRight(int col) const
 {
     return m_colRights.IsEmpty() ? (GetColPos( col ) + 1) * m_defaultColWidth
-                                 : m_colRights[col];
+                                 : m_colRights.GetEnd( GetColPos( col ) );
 }
 
 int wxGrid::GetRowHeight(int row) const
@@ -3153,13 +4159,13 @@ int wxGrid::GetRowTop(int row) const
     if ( m_rowBottoms.IsEmpty() )
         return row * m_defaultRowHeight;
 
-    return m_rowBottoms[row] - GetRowHeight(row);
+    return m_rowBottoms.GetEnd(row) - GetRowHeight(row);
 }
 
 int wxGrid::GetRowBottom(int row) const
 {
     return m_rowBottoms.IsEmpty() ? (row + 1) * m_defaultRowHeight
-                                  : m_rowBottoms[row];
+                                  : m_rowBottoms.GetEnd(row);
 }
 
 void wxGrid::CalcDimensions()
@@ -3306,17 +4312,7 @@ bool wxGrid::Redimension( wxGridTableMessage& msg )
             if ( !m_rowHeights.IsEmpty() )
             {
                 m_rowHeights.Insert( m_defaultRowHeight, pos, numRows );
-                m_rowBottoms.Insert( 0, pos, numRows );
-
-                int bottom = 0;
-                if ( pos > 0 )
-                    bottom = m_rowBottoms[pos - 1];
-
-                for ( i = pos; i < m_numRows; i++ )
-                {
-                    bottom += GetRowHeight(i);
-                    m_rowBottoms[i] = bottom;
-                }
+                m_rowBottoms.Rebuild( m_rowHeights, pos );
             }
 
             UpdateCurrentCellOnRedim();
@@ -3344,17 +4340,7 @@ bool wxGrid::Redimension( wxGridTableMessage& msg )
             if ( !m_rowHeights.IsEmpty() )
             {
                 m_rowHeights.Add( m_defaultRowHeight, numRows );
-                m_rowBottoms.Add( 0, numRows );
-
-                int bottom = 0;
-                if ( oldNumRows > 0 )
-                    bottom = m_rowBottoms[oldNumRows - 1];
-
-                for ( i = oldNumRows; i < m_numRows; i++ )
-                {
-                    bottom += GetRowHeight(i);
-                    m_rowBottoms[i] = bottom;
-                }
+                m_rowBottoms.Rebuild( m_rowHeights, oldNumRows );
             }
 
             UpdateCurrentCellOnRedim();
@@ -3376,14 +4362,7 @@ bool wxGrid::Redimension( wxGridTableMessage& msg )
             if ( !m_rowHeights.IsEmpty() )
             {
                 m_rowHeights.RemoveAt( pos, numRows );
-                m_rowBottoms.RemoveAt( pos, numRows );
-
-                int h = 0;
-                for ( i = 0; i < m_numRows; i++ )
-                {
-                    h += GetRowHeight(i);
-                    m_rowBottoms[i] = h;
-                }
+                m_rowBottoms.Rebuild( m_rowHeights, pos );
             }
 
             UpdateCurrentCellOnRedim();
@@ -3445,20 +4424,7 @@ bool wxGrid::Redimension( wxGridTableMessage& msg )
             if ( !m_colWidths.IsEmpty() )
             {
                 m_colWidths.Insert( m_defaultColWidth, pos, numCols );
-                m_colRights.Insert( 0, pos, numCols );
-
-                int right = 0;
-                if ( pos > 0 )
-                    right = m_colRights[GetColAt( pos - 1 )];
-
-                int colPos;
-                for ( colPos = pos; colPos < m_numCols; colPos++ )
-                {
-                    i = GetColAt( colPos );
-
-                    right += GetColWidth(i);
-                    m_colRights[i] = right;
-                }
+                m_colRights.Rebuild( m_colWidths, m_colAt, pos );
             }
 
             UpdateCurrentCellOnRedim();
@@ -3497,20 +4463,7 @@ bool wxGrid::Redimension( wxGridTableMessage& msg )
             if ( !m_colWidths.IsEmpty() )
             {
                 m_colWidths.Add( m_defaultColWidth, numCols );
-                m_colRights.Add( 0, numCols );
-
-                int right = 0;
-                if ( oldNumCols > 0 )
-                    right = m_colRights[GetColAt( oldNumCols - 1 )];
-
-                int colPos;
-                for ( colPos = oldNumCols; colPos < m_numCols; colPos++ )
-                {
-                    i = GetColAt( colPos );
-
-                    right += GetColWidth(i);
-                    m_colRights[i] = right;
-                }
+                m_colRights.Rebuild( m_colWidths, m_colAt, oldNumCols );
             }
 
             // Notice that this must be called after updating m_colWidths above
@@ -3555,17 +4508,7 @@ bool wxGrid::Redimension( wxGridTableMessage& msg )
             if ( !m_colWidths.IsEmpty() )
             {
                 m_colWidths.RemoveAt( pos, numCols );
-                m_colRights.RemoveAt( pos, numCols );
-
-                int w = 0;
-                int colPos;
-                for ( colPos = 0; colPos < m_numCols; colPos++ )
-                {
-                    i = GetColAt( colPos );
-
-                    w += GetColWidth(i);
-                    m_colRights[i] = w;
-                }
+                m_colRights.Rebuild( m_colWidths, m_colAt, pos );
             }
 
             UpdateCurrentCellOnRedim();
@@ -5154,18 +6097,7 @@ void wxGrid::RefreshAfterColPosChange()
     // same and it's easy to do
     if ( !m_colWidths.empty() )
     {
-        int colRight = 0;
-        for ( int colPos = 0; colPos < m_numCols; colPos++ )
-        {
-            int colID = GetColAt( colPos );
-
-            // Ignore the currently hidden columns.
-            const int width = m_colWidths[colID];
-            if ( width > 0 )
-                colRight += width;
-
-            m_colRights[colID] = colRight;
-        }
+        m_colRights.Rebuild( m_colWidths, m_colAt );
     }
 
     // and make the changes visible
@@ -5766,7 +6698,6 @@ void wxGrid::OnDPIChanged(wxDPIChangedEvent& event)
     // inside InitPixelFields() above).
     if ( !m_rowHeights.empty() )
     {
-        int total = 0;
         for ( unsigned i = 0; i < m_rowHeights.size(); ++i )
         {
             int height = m_rowHeights[i];
@@ -5776,11 +6707,11 @@ void wxGrid::OnDPIChanged(wxDPIChangedEvent& event)
                 continue;
 
             height = height * event.GetNewDPI().x / event.GetOldDPI().x;
-            total += height;
 
             m_rowHeights[i] = height;
-            m_rowBottoms[i] = total;
         }
+
+        m_rowBottoms.Rebuild( m_rowHeights );
     }
 
     // Similarly for columns, except that here we need to update the native
@@ -5790,7 +6721,6 @@ void wxGrid::OnDPIChanged(wxDPIChangedEvent& event)
         colHeader = m_useNativeHeader ? GetGridColHeader() : NULL;
     if ( !m_colWidths.empty() )
     {
-        int total = 0;
         for ( unsigned i = 0; i < m_colWidths.size(); ++i )
         {
             int width = m_colWidths[i];
@@ -5799,13 +6729,19 @@ void wxGrid::OnDPIChanged(wxDPIChangedEvent& event)
                 continue;
 
             width = width * event.GetNewDPI().x / event.GetOldDPI().x;
-            total += width;
 
             m_colWidths[i] = width;
-            m_colRights[i] = total;
+        }
+
+        m_colRights.Rebuild( m_colWidths, m_colAt );
 
-            if ( colHeader )
-                colHeader->UpdateColumn(i);
+        if ( colHeader )
+        {
+            for ( unsigned i = 0; i < m_colWidths.size(); ++i )
+            {
+                if ( m_colWidths[i] > 0 )
+                    colHeader->UpdateColumn(i);
+            }
         }
     }
     else if ( colHeader )
@@ -7760,9 +8696,8 @@ wxGridCellCoords wxGrid::XYToCell(int x, int y, wxGridWindow *gridWindow) const
 }
 
 // compute row or column from some (unscrolled) coordinate value, using either
-// m_defaultRowHeight/m_defaultColWidth or binary search on array of
-// m_rowBottoms/m_colRights to do it quickly in O(log n) time.
-// NOTE: This may not work correctly for reordered columns.
+// m_defaultRowHeight/m_defaultColWidth or m_rowBottoms/m_colRights to do it
+// quickly in O(log n) time.
 int wxGrid::PosToLinePos(int coord,
                          bool clipToMinMax,
                          const wxGridOperations& oper,
@@ -7781,8 +8716,8 @@ int wxGrid::PosToLinePos(int coord,
 
     // check for the simplest case: if we have no explicit line sizes
     // configured, then we already know the line this position falls in
-    const wxArrayInt& lineEnds = oper.GetLineEnds(this);
-    if ( lineEnds.empty() )
+    const wxGridLineEnds& lineEnds = oper.GetLineEnds(this);
+    if ( lineEnds.IsEmpty() )
     {
         if ( maxPos < (numLines + minPos) )
             return maxPos;
@@ -7790,45 +8725,22 @@ int wxGrid::PosToLinePos(int coord,
         return clipToMinMax ? numLines + minPos - 1 : -1;
     }
 
-    // binary search is quite efficient and we can't really make any assumptions
-    // on where to start here since row and columns could be of size 0 if they are
-    // hidden. While this could be made more efficient, some profiling will be
-    // necessary to determine if it really is a performance bottleneck
+    // we can't make any assumptions about the position of the line here as
+    // rows and columns could be of any size, including 0 if they are hidden,
+    // so find it in the tree of line ends
     maxPos = numLines + minPos - 1;
 
-    // check if the position is beyond the last column
-    const int lineAtMaxPos = oper.GetLineAt(this, maxPos);
-    if ( coord >= lineEnds[lineAtMaxPos] )
+    const int pos = static_cast<int>(lineEnds.FindPos(coord));
+
+    // check if the position is beyond the last line of this window
+    if ( pos > maxPos )
         return clipToMinMax ? maxPos : wxNOT_FOUND;
 
     // or before the first one
-    const int lineAt0 = oper.GetLineAt(this, minPos);
-    if ( coord < oper.GetLineStartPos(this, lineAt0) )
+    if ( pos < minPos )
         return clipToMinMax ? minPos : wxNOT_FOUND;
-    else if ( coord < lineEnds[lineAt0] )
-        return minPos;
-
-    // finally do perform the binary search
-    while ( minPos < maxPos )
-    {
-        wxCHECK_MSG( lineEnds[oper.GetLineAt(this, minPos)] <= coord &&
-                        coord < lineEnds[oper.GetLineAt(this, maxPos)],
-                     -1,
-                     "wxGrid: internal error in PosToLinePos()" );
-
-        if ( coord >= lineEnds[oper.GetLineAt(this, maxPos - 1)] )
-            return maxPos;
-        else
-            maxPos--;
-
-        const int median = minPos + (maxPos - minPos + 1) / 2;
-        if ( coord < lineEnds[oper.GetLineAt(this, median)] )
-            maxPos = median;
-        else
-            minPos = median;
-    }
 
-    return maxPos;
+    return pos;
 }
 
 int
@@ -9498,6 +10410,19 @@ void wxGrid::SetAttr(int row, int col, wxGridCellAttr *attr)
     }
 }
 
+void wxGrid::SetBlockAttr(const wxGridBlockCoords& block, wxGridCellAttr *attr)
+{
+    if ( CanHaveAttributes() )
+    {
+        m_table->SetBlockAttr(attr, block);
+        ClearAttrCache();
+    }
+    else
+    {
+        wxSafeDecRef(attr);
+    }
+}
+
 void wxGrid::SetRowAttr(int row, wxGridCellAttr *attr)
 {
     if ( CanHaveAttributes() )
@@ -9749,7 +10674,7 @@ void wxGrid::SetDefaultRowSize( int height, bool resizeExistingRows )
         // arrays (which also allows us to take advantage of
         // some speed optimisations)
         m_rowHeights.Empty();
-        m_rowBottoms.Empty();
+        m_rowBottoms.Clear();
         CalcDimensions();
     }
 }
@@ -9850,10 +10775,7 @@ void wxGrid::DoSetRowSize( int row, int height )
     if ( !diff )
         return;
 
-    for ( int i = row; i < m_numRows; i++ )
-    {
-        m_rowBottoms[i] += diff;
-    }
+    m_rowBottoms.Update(row, diff);
 
     InvalidateBestSize();
 
@@ -9959,7 +10881,7 @@ void wxGrid::SetDefaultColSize( int width, bool resizeExistingCols )
         // arrays (which also allows us to take advantage of
         // some speed optimisations)
         m_colWidths.Empty();
-        m_colRights.Empty();
+        m_colRights.Clear();
 
         CalcDimensions();
     }
@@ -10040,10 +10962,7 @@ void wxGrid::DoSetColSize( int col, int width )
     }
     //else: will be refreshed when the header is redrawn
 
-    for ( int colPos = GetColPos(col); colPos < m_numCols; colPos++ )
-    {
-        m_colRights[GetColAt(colPos)] += diff;
-    }
+    m_colRights.Update(GetColPos(col), diff);
 
     InvalidateBestSize();
 
@@ -10582,20 +11501,18 @@ wxSize wxGrid::DoGetBestSize() const
     {
         size.x += m_defaultColWidth*m_numCols;
     }
-    else
+    else if ( m_numCols )
     {
-        for ( int col = 0; col < m_numCols; col++ )
-            size.x += GetColWidth(col);
+        size.x += m_colRights.GetEnd(m_numCols - 1);
     }
 
     if ( m_rowHeights.empty() )
     {
         size.y += m_defaultRowHeight*m_numRows;
     }
-    else
+    else if ( m_numRows )
     {
-        for ( int row = 0; row < m_numRows; row++ )
-            size.y += GetRowHeight(row);
+        size.y += m_rowBottoms.GetEnd(m_numRows - 1);
     }
 
     return size + GetWindowBorderSize();
@@ -11130,6 +12047,114 @@ int wxGridSizesInfo::GetSize(unsigned pos) const
     return it->second;
 }
 
+// ----------------------------------------------------------------------------
+// wxGridLineEnds
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Return the lowest non-zero bit of the given (1-based) index in the tree.
+inline size_t LowestBit(size_t n)
+{
+    return n & (~n + 1);
+}
+
+} // anonymous namespace
+
+void wxGridLineEnds::DoRebuild(const wxArrayInt& sizes,
+                               const wxArrayInt* order,
+                               size_t from)
+{
+    const size_t count = sizes.size();
+
+    if ( from > m_tree.size() )
+        from = m_tree.size();
+    if ( from > count )
+        from = count;
+
+    // Notice that this only uses the elements before "from", so it must be
+    // done before modifying the tree.
+    const int sumBefore = GetSum(from);
+
+    m_tree.resize(count);
+
+    // Below we use 1-based indices, as usual for Fenwick trees, so the element
+    // with index i is stored in m_tree[i - 1].
+    for ( size_t i = from + 1; i <= count; i++ )
+    {
+        const int size = sizes[order ? (*order)[i - 1] : i - 1];
+
+        // Negative sizes are used for the hidden lines.
+        m_tree[i - 1] = size > 0 ? size : 0;
+    }
+
+    // Accumulate the sizes in linear time by adding each element to the
+    // element whose range contains its own one. After doing this, all the
+    // elements after "from" contain the sum of the part of their range
+    // which is after "from" too.
+    for ( size_t i = from + 1; i <= count; i++ )
+    {
+        const size_t parent = i + LowestBit(i);
+        if ( parent <= count )
+            m_tree[parent - 1] += m_tree[i - 1];
+    }
+
+    // And now add the sizes of the lines before "from" to the (few) elements
+    // whose range starts before it.
+    if ( from )
+    {
+        for ( size_t i = from + 1; i <= count; i++ )
+        {
+            const size_t start = i - LowestBit(i);
+            if ( start < from )
+                m_tree[i - 1] += sumBefore - GetSum(start);
+        }
+    }
+}
+
+void wxGridLineEnds::Update(size_t pos, int diff)
+{
+    for ( size_t i = pos + 1; i <= m_tree.size(); i += LowestBit(i) )
+        m_tree[i - 1] += diff;
+}
+
+int wxGridLineEnds::GetSum(size_t count) const
+{
+    wxASSERT_MSG( count <= m_tree.size(), "invalid line position" );
+
+    int sum = 0;
+    for ( size_t i = count; i > 0; i -= LowestBit(i) )
+        sum += m_tree[i - 1];
+
+    return sum;
+}
+
+size_t wxGridLineEnds::FindPos(int coord) const
+{
+    const size_t count = m_tree.size();
+
+    size_t step = 1;
+    while ( step <= count / 2 )
+        step *= 2;
+
+    // Find the greatest number of lines with the total size not exceeding the
+    // given coordinate by descending the tree: this works because all the
+    // sizes are non-negative.
+    size_t pos = 0;
+    for ( ; step; step /= 2 )
+    {
+        const size_t next = pos + step;
+        if ( next <= count && m_tree[next - 1] <= coord )
+        {
+            pos = next;
+            coord -= m_tree[next - 1];
+        }
+    }
+
+    return pos;
+}
+
 // ----------------------------------------------------------------------------
 // drop target
 // ----------------------------------------------------------------------------
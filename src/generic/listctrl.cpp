@@ -113,9 +113,6 @@ static const int MARGIN_AROUND_CHECKBOX = 5;
 // arrays/list implementations
 // ----------------------------------------------------------------------------
 
-#include "wx/listimpl.cpp"
-WX_DEFINE_LIST(wxListItemDataList)
-
 #include "wx/listimpl.cpp"
 WX_DEFINE_LIST(wxListHeaderDataList)
 
@@ -419,6 +416,13 @@ inline bool wxListLineData::IsVirtual() const
     return m_owner->IsVirtual();
 }
 
+wxListLineData::~wxListLineData()
+{
+    for ( size_t n = 0; n < m_items.size(); n++ )
+        m_owner->DestroyItemData(m_items[n]);
+    delete m_gi;
+}
+
 wxListLineData::wxListLineData( wxListMainWindow *owner )
 {
     m_owner = owner;
@@ -436,10 +440,8 @@ wxListLineData::wxListLineData( wxListMainWindow *owner )
 
 void wxListLineData::CalculateSize( wxDC *dc, int spacing )
 {
-    wxListItemDataList::compatibility_iterator node = m_items.GetFirst();
-    wxCHECK_RET( node, wxT("no subitems at all??") );
-
-    wxListItemData *item = node->GetData();
+    wxListItemData *item = GetItemData(0);
+    wxCHECK_RET( item, wxT("no subitems at all??") );
 
     wxString s;
     wxCoord lw, lh;
@@ -538,10 +540,8 @@ void wxListLineData::CalculateSize( wxDC *dc, int spacing )
 
 void wxListLineData::SetPosition( int x, int y, int spacing )
 {
-    wxListItemDataList::compatibility_iterator node = m_items.GetFirst();
-    wxCHECK_RET( node, wxT("no subitems at all??") );
-
-    wxListItemData *item = node->GetData();
+    wxListItemData *item = GetItemData(0);
+    wxCHECK_RET( item, wxT("no subitems at all??") );
 
     switch ( GetMode() )
     {
@@ -606,25 +606,24 @@ void wxListLineData::SetPosition( int x, int y, int spacing )
 
 void wxListLineData::InitItems( int num )
 {
+    m_items.reserve(num);
     for (int i = 0; i < num; i++)
-        m_items.Append( new wxListItemData(m_owner) );
+        m_items.push_back( m_owner->CreateItemData() );
 }
 
 void wxListLineData::SetItem( int index, const wxListItem &info )
 {
-    wxListItemDataList::compatibility_iterator node = m_items.Item( index );
-    wxCHECK_RET( node, wxT("invalid column index in SetItem") );
+    wxListItemData *item = GetItemData(index);
+    wxCHECK_RET( item, wxT("invalid column index in SetItem") );
 
-    wxListItemData *item = node->GetData();
     item->SetItem( info );
 }
 
 void wxListLineData::GetItem( int index, wxListItem &info ) const
 {
-    wxListItemDataList::compatibility_iterator node = m_items.Item( index );
-    if (node)
+    wxListItemData *item = GetItemData(index);
+    if (item)
     {
-        wxListItemData *item = node->GetData();
         item->GetItem( info );
     }
 }
@@ -633,10 +632,9 @@ wxString wxListLineData::GetText(int index) const
 {
     wxString s;
 
-    wxListItemDataList::compatibility_iterator node = m_items.Item( index );
-    if (node)
+    wxListItemData *item = GetItemData(index);
+    if (item)
     {
-        wxListItemData *item = node->GetData();
         s = item->GetText();
     }
 
@@ -645,47 +643,42 @@ wxString wxListLineData::GetText(int index) const
 
 void wxListLineData::SetText( int index, const wxString& s )
 {
-    wxListItemDataList::compatibility_iterator node = m_items.Item( index );
-    if (node)
+    wxListItemData *item = GetItemData(index);
+    if (item)
     {
-        wxListItemData *item = node->GetData();
         item->SetText( s );
     }
 }
 
 void wxListLineData::SetImage( int index, int image )
 {
-    wxListItemDataList::compatibility_iterator node = m_items.Item( index );
-    wxCHECK_RET( node, wxT("invalid column index in SetImage()") );
+    wxListItemData *item = GetItemData(index);
+    wxCHECK_RET( item, wxT("invalid column index in SetImage()") );
 
-    wxListItemData *item = node->GetData();
     item->SetImage(image);
 }
 
 int wxListLineData::GetImage( int index ) const
 {
-    wxListItemDataList::compatibility_iterator node = m_items.Item( index );
-    wxCHECK_MSG( node, -1, wxT("invalid column index in GetImage()") );
+    wxListItemData *item = GetItemData(index);
+    wxCHECK_MSG( item, -1, wxT("invalid column index in GetImage()") );
 
-    wxListItemData *item = node->GetData();
     return item->GetImage();
 }
 
 wxItemAttr *wxListLineData::GetAttr() const
 {
-    wxListItemDataList::compatibility_iterator node = m_items.GetFirst();
-    wxCHECK_MSG( node, NULL, wxT("invalid column index in GetAttr()") );
+    wxListItemData *item = GetItemData(0);
+    wxCHECK_MSG( item, NULL, wxT("invalid column index in GetAttr()") );
 
-    wxListItemData *item = node->GetData();
     return item->GetAttr();
 }
 
 void wxListLineData::SetAttr(wxItemAttr *attr)
 {
-    wxListItemDataList::compatibility_iterator node = m_items.GetFirst();
-    wxCHECK_RET( node, wxT("invalid column index in SetAttr()") );
+    wxListItemData *item = GetItemData(0);
+    wxCHECK_RET( item, wxT("invalid column index in SetAttr()") );
 
-    wxListItemData *item = node->GetData();
     item->SetAttr(attr);
 }
 
@@ -769,12 +762,11 @@ void wxListLineData::ApplyAttributes(wxDC *dc,
 
 void wxListLineData::Draw(wxDC *dc, bool current)
 {
-    wxListItemDataList::compatibility_iterator node = m_items.GetFirst();
-    wxCHECK_RET( node, wxT("no subitems at all??") );
+    wxListItemData *item = GetItemData(0);
+    wxCHECK_RET( item, wxT("no subitems at all??") );
 
     ApplyAttributes(dc, m_gi->m_rectHighlight, IsHighlighted(), current);
 
-    wxListItemData *item = node->GetData();
     if (item->HasImage())
     {
         // centre the image inside our rectangle, this looks nicer when items
@@ -825,12 +817,10 @@ void wxListLineData::DrawInReportMode( wxDC *dc,
         x += cbSize.GetWidth() + (2 * MARGIN_AROUND_CHECKBOX);
     }
 
-    size_t col = 0;
-    for ( wxListItemDataList::compatibility_iterator node = m_items.GetFirst();
-          node;
-          node = node->GetNext(), col++ )
+    const size_t count = m_items.size();
+    for ( size_t col = 0; col < count; col++ )
     {
-        wxListItemData *item = node->GetData();
+        wxListItemData *item = m_items[col];
 
         int width = m_owner->GetColumnWidth(col);
         if (col == 0 && m_owner->HasCheckBoxes())
@@ -1592,6 +1582,7 @@ void wxListMainWindow::Init()
     m_renameTimer = new wxListRenameTimer( this );
     m_findTimer = NULL;
     m_findBell = 0;  // default is to not ring bell at all
+    m_findIndexEnabled = false;
     m_textctrlWrapper = NULL;
 
     m_current =
@@ -1702,14 +1693,14 @@ wxListLineData *wxListMainWindow::GetDummyLine() const
     // control changed as it would have the incorrect number of fields
     // otherwise
     if ( !m_lines.empty() &&
-            m_lines[0]->m_items.GetCount() != (size_t)GetColumnCount() )
+            m_lines[0]->m_items.size() != (size_t)GetColumnCount() )
     {
-        self->m_lines.Clear();
+        self->ClearLines();
     }
 
     if ( m_lines.empty() )
     {
-        wxListLineData *line = new wxListLineData(self);
+        wxListLineData *line = self->CreateLineData();
         self->m_lines.push_back(line);
 
         // don't waste extra memory -- there never going to be anything
@@ -1779,10 +1770,9 @@ wxRect wxListMainWindow::GetLineLabelRect(size_t line) const
 
     int image_x = 0;
     wxListLineData *data = GetLine(line);
-    wxListItemDataList::compatibility_iterator node = data->m_items.GetFirst();
-    if (node)
+    wxListItemData *item = data->GetItemData(0);
+    if (item)
     {
-        wxListItemData *item = node->GetData();
         if ( item->HasImage() )
         {
             int ix, iy;
@@ -2461,6 +2451,14 @@ void wxListMainWindow::EnableBellOnNoMatch( bool on )
     m_findBell = on;
 }
 
+void wxListMainWindow::EnableFindIndex( bool enable )
+{
+    m_findIndexEnabled = enable;
+
+    // the index will be built when it's used for the first time
+    m_findIndex.Clear();
+}
+
 void wxListMainWindow::OnMouse( wxMouseEvent &event )
 {
 #ifdef __WXMAC__
@@ -3426,11 +3424,9 @@ public:
     virtual void UpdateWithRow(int row) wxOVERRIDE
     {
         wxListLineData *line = m_listmain->GetLine( row );
-        wxListItemDataList::compatibility_iterator n = line->m_items.Item( GetColumn() );
-
-        wxCHECK_RET( n, wxS("no subitem?") );
+        wxListItemData* const itemData = line->GetItemData(GetColumn());
 
-        wxListItemData* const itemData = n->GetData();
+        wxCHECK_RET( itemData, wxS("no subitem?") );
 
         wxListItem item;
         itemData->GetItem(item);
@@ -3466,6 +3462,11 @@ void wxListMainWindow::SetColumnWidth( int col, int width )
     {
         wxListCtrlMaxWidthCalculator calculator(this, col);
 
+        // Getting the items of a virtual control may be slow, so don't try to
+        // check too many of them.
+        if ( IsVirtual() )
+            calculator.LimitRowsToCheck();
+
         calculator.UpdateWithWidth(AUTOSIZE_COL_MARGIN);
 
         if ( width == wxLIST_AUTOSIZE_USEHEADER )
@@ -3565,6 +3566,9 @@ void wxListMainWindow::SetItem( wxListItem &item )
         wxListLineData *line = GetLine((size_t)id);
         line->SetItem( item.m_col, item );
 
+        if ( item.m_col == 0 && (item.m_mask & wxLIST_MASK_TEXT) )
+            InvalidateFindIndex();
+
         // Set item state if user wants
         if ( item.m_mask & wxLIST_MASK_STATE )
             SetItemState( item.m_itemId, item.m_state, item.m_state );
@@ -3576,10 +3580,7 @@ void wxListMainWindow::SetItem( wxListItem &item )
 
             wxColWidthInfo* const pWidthInfo = m_aColWidths.Item(item.m_col);
             if ( width > pWidthInfo->nMaxWidth )
-            {
                 pWidthInfo->nMaxWidth = width;
-                pWidthInfo->bNeedsUpdate = true;
-            }
         }
     }
 
@@ -4300,15 +4301,11 @@ void wxListMainWindow::DeleteItem( long lindex )
         //  mark the Column Max Width cache as dirty if the items in the line
         //  we're deleting contain the Max Column Width
         wxListLineData * const line = GetLine(index);
-        wxListItemDataList::compatibility_iterator n;
         wxListItem      item;
 
         for (size_t i = 0; i < m_columns.GetCount(); i++)
         {
-            n = line->m_items.Item( i );
-            wxListItemData* itemData;
-            itemData = n->GetData();
-            itemData->GetItem(item);
+            line->GetItemData(i)->GetItem(item);
 
             int itemWidth;
             itemWidth = GetItemWidthWithImage(&item);
@@ -4330,8 +4327,10 @@ void wxListMainWindow::DeleteItem( long lindex )
     }
     else
     {
-        delete m_lines[index];
+        DestroyLineData(m_lines[index]);
         m_lines.erase( m_lines.begin() + index );
+
+        InvalidateFindIndex();
     }
 
     // we need to refresh the (vert) scrollbar as the number of items changed
@@ -4375,13 +4374,16 @@ void wxListMainWindow::DeleteColumn( int col )
             //  6. Call DeleteColumn().
             // So we need to check for this as otherwise we would simply crash
             // if this happens.
-            if ( line->m_items.GetCount() <= static_cast<unsigned>(col) )
+            if ( line->m_items.size() <= static_cast<unsigned>(col) )
                 continue;
 
-            wxListItemDataList::compatibility_iterator n = line->m_items.Item( col );
-            delete n->GetData();
-            line->m_items.Erase(n);
+            DestroyItemData(line->m_items[col]);
+            line->m_items.erase(line->m_items.begin() + col);
         }
+
+        // the items are searched by the text of the first column
+        if ( col == 0 )
+            InvalidateFindIndex();
     }
 
     if ( InReportView() )   //  we only cache max widths when in Report View
@@ -4431,7 +4433,16 @@ void wxListMainWindow::DoDeleteAllItems()
     if ( InReportView() )
         ResetVisibleLinesRange();
 
-    m_lines.Clear();
+    ClearLines();
+    InvalidateFindIndex();
+}
+
+void wxListMainWindow::ClearLines()
+{
+    for ( size_t n = 0; n < m_lines.size(); n++ )
+        DestroyLineData(m_lines[n]);
+
+    m_lines.clear();
 }
 
 void wxListMainWindow::DeleteAllItems()
@@ -4593,13 +4604,10 @@ void wxListMainWindow::InsertItem( wxListItem &item )
         int width = GetItemWidthWithImage(&item);
         item.SetWidth(width);
         if (width > pWidthInfo->nMaxWidth)
-        {
             pWidthInfo->nMaxWidth = width;
-            pWidthInfo->bNeedsUpdate = true;
-        }
     }
 
-    wxListLineData *line = new wxListLineData(this);
+    wxListLineData *line = CreateLineData();
 
     line->SetItem( item.m_col, item );
     if ( item.m_mask & wxLIST_MASK_IMAGE )
@@ -4617,6 +4625,7 @@ void wxListMainWindow::InsertItem( wxListItem &item )
     }
 
     m_lines.insert( m_lines.begin() + id, line );
+    InvalidateFindIndex();
 
     m_dirty = true;
 
@@ -4631,6 +4640,76 @@ void wxListMainWindow::InsertItem( wxListItem &item )
     RefreshLines(id, GetItemCount() - 1);
 }
 
+long wxListMainWindow::InsertItems(size_t id,
+                                   const wxArrayString& labels,
+                                   int image)
+{
+    wxCHECK_MSG( !IsVirtual(), -1, wxT("can't be used with virtual control") );
+
+    const size_t count = labels.size();
+    if ( !count )
+        return -1;
+
+    if ( id > GetItemCount() )
+        id = GetItemCount();
+
+    m_dirty = true;
+
+    wxListItem item;
+    item.m_mask = wxLIST_MASK_TEXT;
+    if ( image != -1 )
+    {
+        item.m_mask |= wxLIST_MASK_IMAGE;
+        item.m_image = image;
+    }
+
+    if ( InReportView() )
+    {
+        ResetVisibleLinesRange();
+
+        // Measuring all the new items would take longer than inserting them,
+        // so just let the column width be recomputed when it's needed.
+        if ( !m_aColWidths.empty() )
+            m_aColWidths.Item(0)->bNeedsUpdate = true;
+
+        if ( m_small_image_list && image != -1 )
+        {
+            int imageWidth, imageHeight;
+            m_small_image_list->GetSize(image, imageWidth, imageHeight);
+
+            if ( imageHeight > m_lineHeight )
+                m_lineHeight = 0;
+        }
+    }
+
+    // Allocate the memory for all the new lines and their items at once.
+    m_linePool.Reserve(count);
+    m_itemDataPool.Reserve(count * (InReportView() ? GetColumnCount() : 1));
+
+    m_lines.insert(m_lines.begin() + id, count, NULL);
+    InvalidateFindIndex();
+    for ( size_t n = 0; n < count; n++ )
+    {
+        wxListLineData * const line = CreateLineData();
+
+        item.m_itemId = id + n;
+        item.m_text = labels[n];
+        line->SetItem(0, item);
+
+        m_lines[id + n] = line;
+    }
+
+    if ( HasCurrent() && m_current >= id )
+        m_current += count;
+
+    for ( size_t n = 0; n < count; n++ )
+        SendNotify(id + n, wxEVT_LIST_INSERT_ITEM);
+
+    RefreshLines(id, GetItemCount() - 1);
+
+    return id;
+}
+
 long wxListMainWindow::InsertColumn( long col, const wxListItem &item )
 {
     long idx = -1;
@@ -4666,12 +4745,15 @@ long wxListMainWindow::InsertColumn( long col, const wxListItem &item )
             for ( size_t i = 0; i < m_lines.size(); i++ )
             {
                 wxListLineData * const line = GetLine(i);
-                wxListItemData * const data = new wxListItemData(this);
+                wxListItemData * const data = CreateItemData();
                 if ( insert )
-                    line->m_items.Insert(col, data);
+                    line->m_items.insert(line->m_items.begin() + col, data);
                 else
-                    line->m_items.Append(data);
+                    line->m_items.push_back(data);
             }
+
+            if ( idx == 0 )
+                InvalidateFindIndex();
         }
 
         // invalidate it as it has to be recalculated
@@ -4683,9 +4765,6 @@ long wxListMainWindow::InsertColumn( long col, const wxListItem &item )
 int wxListMainWindow::GetItemWidthWithImage(wxListItem * item)
 {
     int width = 0;
-    wxClientDC dc(this);
-
-    dc.SetFont( GetFont() );
 
     if (item->GetImage() != -1)
     {
@@ -4695,11 +4774,7 @@ int wxListMainWindow::GetItemWidthWithImage(wxListItem * item)
     }
 
     if (!item->GetText().empty())
-    {
-        wxCoord w;
-        dc.GetTextExtent( item->GetText(), &w, NULL );
-        width += w;
-    }
+        width += GetTextExtent(item->GetText()).x;
 
     return width;
 }
@@ -4739,6 +4814,7 @@ void wxListMainWindow::SortItems( wxListCtrlCompare fn, wxIntPtr data )
     ResetCurrent();
 
     std::sort(m_lines.begin(), m_lines.end(), wxListLineComparator(fn, data));
+    InvalidateFindIndex();
 
     m_dirty = true;
 }
@@ -4838,6 +4914,23 @@ wxListMainWindow::PrefixFindItem(size_t idParent,
         itemid += 1;
     }
 
+    // the labels of virtual items can change at any moment, so we can't use
+    // the index for them
+    if ( m_findIndexEnabled && !IsVirtual() )
+    {
+        if ( m_findIndex.IsEmpty() )
+        {
+            const size_t count = GetItemCount();
+            m_findIndex.Reserve(count);
+            for ( size_t n = 0; n < count; n++ )
+                m_findIndex.Add(GetLine(n)->GetText(0), n);
+            m_findIndex.Finish();
+        }
+
+        // this finds the items in the same order as the loops below
+        return m_findIndex.Find(prefix, itemid);
+    }
+
     // look for the item starting with the given prefix after it
     while ( ( itemid < (size_t)GetItemCount() ) &&
             !GetLine(itemid)->GetText(0).Lower().StartsWith(prefix) )
@@ -5561,6 +5654,15 @@ long wxGenericListCtrl::InsertItem( long index, const wxString &label, int image
     return InsertItem( info );
 }
 
+long wxGenericListCtrl::InsertItems( long index,
+                                     const wxArrayString& labels,
+                                     int imageIndex )
+{
+    wxCHECK_MSG( index >= 0, -1, wxT("invalid item index") );
+
+    return m_mainWin->InsertItems( index, labels, imageIndex );
+}
+
 long wxGenericListCtrl::DoInsertColumn( long col, const wxListItem &item )
 {
     wxCHECK_MSG( InReportView(), -1, wxT("can't add column in non report mode") );
@@ -5815,6 +5917,16 @@ void wxGenericListCtrl::EnableBellOnNoMatch( bool on )
     m_mainWin->EnableBellOnNoMatch(on);
 }
 
+void wxGenericListCtrl::EnableFindIndex( bool enable )
+{
+    m_mainWin->EnableFindIndex(enable);
+}
+
+bool wxGenericListCtrl::HasFindIndex() const
+{
+    return m_mainWin->HasFindIndex();
+}
+
 // Generic wxListCtrl is more or less a container for two other
 // windows which drawings are done upon. These are namely
 // 'm_headerWin' and 'm_mainWin'.
@@ -189,27 +189,22 @@ unsigned int RowRanges::CountTo(unsigned int row) const
 // HeightCache
 // ----------------------------------------------------------------------------
 
+int HeightCache::GetSumBefore(unsigned int row) const
+{
+    int sum = 0;
+    for ( unsigned int i = row; i > 0; i &= i - 1 )
+        sum += m_tree[i - 1];
+
+    return sum;
+}
+
 bool HeightCache::GetLineInfo(unsigned int row, int &start, int &height)
 {
-    int y = 0;
-    bool found = false;
-    HeightToRowRangesMap::iterator it;
-    for (it = m_heightToRowRange.begin(); it != m_heightToRowRange.end(); ++it)
-    {
-        int rowHeight = it->first;
-        RowRanges* rowRanges = it->second;
-        if (rowRanges->Has(row))
-        {
-            height = rowHeight;
-            found = true;
-        }
-        y += rowHeight * (rowRanges->CountTo(row));
-    }
-    if (found)
-    {
-        start = y;
-    }
-    return found;
+    if ( !GetLineHeight(row, height) )
+        return false;
+
+    start = GetSumBefore(row);
+    return true;
 }
 
 bool HeightCache::GetLineStart(unsigned int row, int &start)
@@ -220,109 +215,91 @@ bool HeightCache::GetLineStart(unsigned int row, int &start)
 
 bool HeightCache::GetLineHeight(unsigned int row, int &height)
 {
-    HeightToRowRangesMap::iterator it;
-    for (it = m_heightToRowRange.begin(); it != m_heightToRowRange.end(); ++it)
-    {
-        int rowHeight = it->first;
-        RowRanges* rowRanges = it->second;
-        if (rowRanges->Has(row))
-        {
-            height = rowHeight;
-            return true;
-        }
-    }
-    return false;
+    if ( row >= m_heights.size() || m_heights[row] < 0 )
+        return false;
+
+    height = m_heights[row];
+    return true;
 }
 
 bool HeightCache::GetLineAt(int y, unsigned int &row)
 {
-    unsigned int total = 0;
-    HeightToRowRangesMap::iterator it;
-    for (it = m_heightToRowRange.begin(); it != m_heightToRowRange.end(); ++it)
-    {
-        RowRanges* rowRanges = it->second;
-        total += rowRanges->CountAll();
-    }
+    if ( y < 0 )
+        return false;
 
-    if (total == 0)
-    {
+    const size_t count = m_tree.size();
+    if ( !count )
         return false;
-    }
 
-    int lo = 0;
-    int hi = total;
-    int start, height;
-    while (lo < hi)
-    {
-        int mid = (lo + hi) / 2;
-        if (GetLineInfo(mid, start, height))
-        {
-            if (start + height <= y)
-            {
-                lo = mid + 1;
-            }
-            else
-            {
-                hi = mid;
-            }
-        }
-        else
-        {
-            // should never happen, except the HeightCache has gaps which is an
-            // invalid state
-            return false;
-        }
-    }
-    if (GetLineInfo(lo, start, height))
+    size_t mask = 1;
+    while ( mask <= count / 2 )
+        mask <<= 1;
+
+    // Find the number of rows ending before y by descending the tree.
+    size_t pos = 0;
+    int rest = y;
+    for ( ; mask; mask >>= 1 )
     {
-        if (y < start)
+        const size_t next = pos + mask;
+        if ( next <= count && m_tree[next - 1] <= rest )
         {
-            // given y point is before the first row
-            return false;
+            pos = next;
+            rest -= m_tree[next - 1];
         }
-        row = lo;
-        return true;
     }
-    else
-    {
-        // given y point is after the last row
+
+    // The given y point is after the last row or the height of the row
+    // containing it is unknown, which should never happen, except if the
+    // HeightCache has gaps, which is an invalid state.
+    if ( pos == count || m_heights[pos] < 0 )
         return false;
-    }
+
+    row = pos;
+    return true;
 }
 
 void HeightCache::Put(unsigned int row, int height)
 {
-    RowRanges *rowRanges = m_heightToRowRange[height];
-    if (rowRanges == NULL)
+    wxCHECK_RET( height >= 0, "invalid row height" );
+
+    // Append the rows with unknown heights before the given one if necessary:
+    // the element of the tree corresponding to the new row is the sum of the
+    // heights of all the rows in its range, which can be computed from the
+    // elements already in the tree.
+    while ( m_heights.size() <= row )
     {
-        rowRanges = new RowRanges();
-        m_heightToRowRange[height] = rowRanges;
+        const unsigned int i = m_heights.size() + 1;
+        const unsigned int first = i - (i & (~i + 1));
+
+        m_heights.push_back(-1);
+        m_tree.push_back(GetSumBefore(i - 1) - GetSumBefore(first));
     }
-    rowRanges->Add(row);
+
+    const int oldHeight = m_heights[row] < 0 ? 0 : m_heights[row];
+    m_heights[row] = height;
+
+    const int diff = height - oldHeight;
+    if ( !diff )
+        return;
+
+    const size_t count = m_tree.size();
+    for ( size_t i = row + 1; i <= count; i += i & (~i + 1) )
+        m_tree[i - 1] += diff;
 }
 
 void HeightCache::Remove(unsigned int row)
 {
-    HeightToRowRangesMap::iterator it;
-    for (it = m_heightToRowRange.begin(); it != m_heightToRowRange.end(); ++it)
+    // The elements of the tree before this row only depend on the heights of
+    // the preceding rows, so the tree remains valid after truncating it.
+    if ( row < m_heights.size() )
     {
-        RowRanges* rowRanges = it->second;
-        rowRanges->Remove(row);
+        m_heights.erase(m_heights.begin() + row, m_heights.end());
+        m_tree.erase(m_tree.begin() + row, m_tree.end());
     }
 }
 
 void HeightCache::Clear()
 {
-    HeightToRowRangesMap::iterator it;
-    for (it = m_heightToRowRange.begin(); it != m_heightToRowRange.end(); ++it)
-    {
-        RowRanges* rowRanges = it->second;
-        delete rowRanges;
-    }
-    m_heightToRowRange.clear();
-}
-
-HeightCache::~HeightCache()
-{
-    Clear();
+    m_heights.clear();
+    m_tree.clear();
 }
@@ -18,6 +18,9 @@
 
 #include "wx/wxprec.h"
 
+#ifndef WX_PRECOMP
+    #include "wx/utils.h"
+#endif // WX_PRECOMP
 
 #include "wx/selstore.h"
 
@@ -27,249 +30,469 @@
 
 const unsigned wxSelectionStore::NO_SELECTION = static_cast<unsigned>(-1);
 
+namespace
+{
+
+// 100 is hardcoded but it shouldn't matter much: the important thing is that
+// we don't refresh everything when really few (e.g. 1 or 2) items change state
+const unsigned MANY_ITEMS = 100;
+
+} // anonymous namespace
+
 // ----------------------------------------------------------------------------
-// tests
+// tree of ranges
 // ----------------------------------------------------------------------------
 
-bool wxSelectionStore::IsSelected(unsigned item) const
+struct wxSelectionStore::Node
 {
-    bool isSel = m_itemsSel.Index(item) != wxNOT_FOUND;
+    Node(const Range& range_, unsigned priority_)
+        : range(range_), shift(0), priority(priority_),
+          left(NULL), right(NULL)
+    {
+    }
 
-    // if the default state is to be selected, being in m_itemsSel means that
-    // the item is not selected, so we have to inverse the logic
-    return m_defaultState ? !isSel : isSel;
+    // The range is correct once the shifts of all the parent nodes have been
+    // applied to it.
+    Range range;
+
+    // The shift not applied to the ranges in the subtrees of this node yet.
+    // It is unsigned as it is added modulo 2^32, so it can be negative too.
+    unsigned shift;
+
+    // The priority of the parent node is never less than this one.
+    unsigned priority;
+
+    Node* left;
+    Node* right;
+};
+
+wxSelectionStore::Node* wxSelectionStore::NewNode(const Range& range)
+{
+    // Use xorshift algorithm for generating the priorities, it is more than
+    // good enough for balancing the tree.
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+
+    return new Node(range, m_seed);
 }
 
-// ----------------------------------------------------------------------------
-// Select*()
-// ----------------------------------------------------------------------------
+/* static */
+void wxSelectionStore::DeleteTree(Node* node)
+{
+    if ( !node )
+        return;
 
-bool wxSelectionStore::SelectItem(unsigned item, bool select)
+    DeleteTree(node->left);
+    DeleteTree(node->right);
+    delete node;
+}
+
+/* static */
+void wxSelectionStore::AddShift(Node* node, unsigned shift)
 {
-    // search for the item ourselves as like this we get the index where to
-    // insert it later if needed, so we do only one search in the array instead
-    // of two (adding item to a sorted array requires a search)
-    size_t index = m_itemsSel.IndexForInsert(item);
-    bool isSel = index < m_itemsSel.GetCount() && m_itemsSel[index] == item;
+    if ( !node )
+        return;
+
+    node->range.from += shift;
+    node->range.to += shift;
+    node->shift += shift;
+}
 
-    if ( select != m_defaultState )
+/* static */
+void wxSelectionStore::PushShift(Node* node)
+{
+    if ( node->shift )
     {
-        if ( !isSel )
-        {
-            m_itemsSel.AddAt(item, index);
+        AddShift(node->left, node->shift);
+        AddShift(node->right, node->shift);
+        node->shift = 0;
+    }
+}
 
-            return true;
-        }
+/* static */
+void wxSelectionStore::Split(Node* node, unsigned item, bool byEnd,
+                             Node*& left, Node*& right)
+{
+    if ( !node )
+    {
+        left =
+        right = NULL;
+        return;
+    }
+
+    PushShift(node);
+
+    if ( (byEnd ? node->range.to : node->range.from) < item )
+    {
+        Split(node->right, item, byEnd, node->right, right);
+        left = node;
+    }
+    else
+    {
+        Split(node->left, item, byEnd, left, node->left);
+        right = node;
+    }
+}
+
+/* static */
+wxSelectionStore::Node* wxSelectionStore::Merge(Node* left, Node* right)
+{
+    if ( !left )
+        return right;
+    if ( !right )
+        return left;
+
+    if ( left->priority >= right->priority )
+    {
+        PushShift(left);
+        left->right = Merge(left->right, right);
+        return left;
     }
-    else // reset to default state
+    else
     {
-        if ( isSel )
+        PushShift(right);
+        right->left = Merge(left, right->left);
+        return right;
+    }
+}
+
+/* static */
+void wxSelectionStore::ExtractRanges(Node* node, Ranges& ranges)
+{
+    if ( !node )
+        return;
+
+    PushShift(node);
+
+    ExtractRanges(node->left, ranges);
+    ranges.push_back(node->range);
+    ExtractRanges(node->right, ranges);
+
+    delete node;
+}
+
+wxSelectionStore::Node* wxSelectionStore::MakeTree(const Ranges& ranges)
+{
+    Node* tree = NULL;
+    for ( size_t n = 0; n < ranges.size(); n++ )
+        tree = Merge(tree, NewNode(ranges[n]));
+
+    return tree;
+}
+
+bool wxSelectionStore::FindRange(unsigned item, Range& range) const
+{
+    bool found = false;
+
+    // We can't apply the pending shifts in this const function, so just
+    // accumulate them while descending the tree.
+    unsigned shift = 0;
+    for ( const Node* node = m_root; node; )
+    {
+        const unsigned to = node->range.to + shift;
+        const bool goLeft = to > item;
+        if ( goLeft )
         {
-            m_itemsSel.RemoveAt(index);
-            return true;
+            range = Range(node->range.from + shift, to);
+            found = true;
         }
+
+        shift += node->shift;
+        node = goLeft ? node->left : node->right;
     }
 
-    return false;
+    return found;
 }
 
-bool wxSelectionStore::SelectRange(unsigned itemFrom, unsigned itemTo,
-                                   bool select,
-                                   wxArrayInt *itemsChanged)
+unsigned wxSelectionStore::GetRangesEnd() const
+{
+    unsigned end = 0,
+             shift = 0;
+    for ( const Node* node = m_root; node; node = node->right )
+    {
+        end = node->range.to + shift;
+        shift += node->shift;
+    }
+
+    return end;
+}
+
+// ----------------------------------------------------------------------------
+// ranges helpers
+// ----------------------------------------------------------------------------
+
+unsigned wxSelectionStore::SetExceptions(unsigned from, unsigned to, bool add,
+                                         wxArrayInt*& itemsChanged)
 {
-    // 100 is hardcoded but it shouldn't matter much: the important thing is
-    // that we don't refresh everything when really few (e.g. 1 or 2) items
-    // change state
-    static const unsigned MANY_ITEMS = 100;
+    if ( from >= to )
+        return 0;
 
-    wxASSERT_MSG( itemFrom <= itemTo, wxT("should be in order") );
+    // Remember the sub-ranges of items changing their state.
+    Ranges changed;
 
-    // are we going to have more [un]selected items than the other ones?
-    if ( itemTo - itemFrom > m_count/2 )
+    // Detach the ranges affected by this change from the tree: when adding,
+    // these are the ranges overlapping or adjacent to the new one, which will
+    // be merged with it, and when removing, the ranges overlapping it.
+    Node *left, *middle, *right;
+    Split(m_root, add ? from : from + 1, true, left, middle);
+    Split(middle, add ? to + 1 : to, false, middle, right);
+
+    Ranges affected;
+    ExtractRanges(middle, affected);
+
+    Ranges replacement;
+    if ( add )
     {
-        if ( select != m_defaultState )
+        // The gaps between the ranges merged with the new one are the new
+        // exceptions.
+        Range merged(from, to);
+        unsigned pos = from;
+        for ( size_t n = 0; n < affected.size(); n++ )
         {
-            // the default state now becomes the same as 'select'
-            m_defaultState = select;
-
-            // so all the old selections (which had state select) shouldn't be
-            // selected any more, but all the other ones should
-            wxSelectedIndices selOld = m_itemsSel;
-            m_itemsSel.Empty();
-
-            // TODO: it should be possible to optimize the searches a bit
-            //       knowing the possible range
-
-            unsigned item;
-            for ( item = 0; item < itemFrom; item++ )
-            {
-                if ( selOld.Index(item) == wxNOT_FOUND )
-                    m_itemsSel.Add(item);
-            }
-
-            for ( item = itemTo + 1; item < m_count; item++ )
-            {
-                if ( selOld.Index(item) == wxNOT_FOUND )
-                    m_itemsSel.Add(item);
-            }
-
-            // many items (> half) changed state
-            itemsChanged = NULL;
+            const Range& r = affected[n];
+            if ( r.from > pos )
+                changed.push_back(Range(pos, r.from));
+            if ( r.to > pos )
+                pos = r.to;
+
+            if ( r.from < merged.from )
+                merged.from = r.from;
+            if ( r.to > merged.to )
+                merged.to = r.to;
         }
-        else // select == m_defaultState
+
+        if ( pos < to )
+            changed.push_back(Range(pos, to));
+
+        replacement.push_back(merged);
+    }
+    else if ( !affected.empty() ) // remove
+    {
+        // The parts of the ranges inside the given one are removed, but the
+        // parts outside of it remain.
+        for ( size_t n = 0; n < affected.size(); n++ )
         {
-            // get the inclusive range of items between itemFrom and itemTo
-            size_t count = m_itemsSel.GetCount(),
-                   start = m_itemsSel.IndexForInsert(itemFrom),
-                   end = m_itemsSel.IndexForInsert(itemTo);
-
-            if ( start == count || m_itemsSel[start] < itemFrom )
-            {
-                start++;
-            }
-
-            if ( end == count || m_itemsSel[end] > itemTo )
-            {
-                end--;
-            }
-
-            if ( start <= end )
-            {
-                // delete all of them (from end to avoid changing indices)
-                for ( int i = end; i >= (int)start; i-- )
-                {
-                    if ( itemsChanged )
-                    {
-                        if ( itemsChanged->GetCount() > MANY_ITEMS )
-                        {
-                            // stop counting (see comment below)
-                            itemsChanged = NULL;
-                        }
-                        else
-                        {
-                            itemsChanged->Add(m_itemsSel[i]);
-                        }
-                    }
-
-                    m_itemsSel.RemoveAt(i);
-                }
-            }
+            const Range& r = affected[n];
+            changed.push_back(Range(wxMax(r.from, from), wxMin(r.to, to)));
         }
+
+        if ( affected.front().from < from )
+            replacement.push_back(Range(affected.front().from, from));
+        if ( affected.back().to > to )
+            replacement.push_back(Range(to, affected.back().to));
     }
-    else // "few" items change state
+
+    m_root = Merge(Merge(left, MakeTree(replacement)), right);
+
+    unsigned numChanged = 0;
+    for ( size_t n = 0; n < changed.size(); n++ )
     {
-        if ( itemsChanged )
+        const Range& r = changed[n];
+        numChanged += r.to - r.from;
+
+        if ( !itemsChanged )
+            continue;
+
+        if ( itemsChanged->size() + r.to - r.from > MANY_ITEMS )
         {
-            itemsChanged->Empty();
+            // stop counting them, we'll just eat gobs of memory for nothing
+            // at all - faster to refresh everything in this case
+            itemsChanged = NULL;
+            continue;
         }
 
-        // just add the items to the selection
-        for ( unsigned item = itemFrom; item <= itemTo; item++ )
+        for ( unsigned item = r.from; item < r.to; item++ )
+            itemsChanged->Add(item);
+    }
+
+    if ( add )
+        m_numExceptions += numChanged;
+    else
+        m_numExceptions -= numChanged;
+
+    return numChanged;
+}
+
+void wxSelectionStore::AppendComplement(const Ranges& ranges,
+                                        unsigned from, unsigned to,
+                                        Ranges& complement)
+{
+    unsigned pos = from;
+    for ( size_t n = 0; n < ranges.size() && pos < to; n++ )
+    {
+        const Range& r = ranges[n];
+        if ( r.to <= pos )
+            continue;
+
+        if ( r.from > pos )
         {
-            if ( SelectItem(item, select) && itemsChanged )
-            {
-                itemsChanged->Add(item);
-
-                if ( itemsChanged->GetCount() > MANY_ITEMS )
-                {
-                    // stop counting them, we'll just eat gobs of memory
-                    // for nothing at all - faster to refresh everything in
-                    // this case
-                    itemsChanged = NULL;
-                }
-            }
+            const unsigned end = wxMin(r.from, to);
+            complement.push_back(Range(pos, end));
+            m_numExceptions += end - pos;
         }
+
+        if ( r.to > pos )
+            pos = r.to;
     }
 
-    // we set it to NULL if there are many items changing state
-    return itemsChanged != NULL;
+    if ( pos < to )
+    {
+        complement.push_back(Range(pos, to));
+        m_numExceptions += to - pos;
+    }
 }
 
 // ----------------------------------------------------------------------------
-// callbacks
+// tests
 // ----------------------------------------------------------------------------
 
-void wxSelectionStore::OnItemsInserted(unsigned item, unsigned numItems)
+bool wxSelectionStore::IsSelected(unsigned item) const
+{
+    Range r;
+    bool isSel = FindRange(item, r) && r.from <= item;
+
+    // if the default state is to be selected, being in a range means that
+    // the item is not selected, so we have to inverse the logic
+    return m_defaultState ? !isSel : isSel;
+}
+
+// ----------------------------------------------------------------------------
+// Select*()
+// ----------------------------------------------------------------------------
+
+bool wxSelectionStore::SelectItem(unsigned item, bool select)
 {
-    const size_t count = m_itemsSel.GetCount();
+    wxArrayInt* itemsChanged = NULL;
+    return SetExceptions(item, item + 1, select != m_defaultState,
+                         itemsChanged) != 0;
+}
 
-    size_t idx = m_itemsSel.IndexForInsert(item);
+bool wxSelectionStore::SelectRange(unsigned itemFrom, unsigned itemTo,
+                                   bool select,
+                                   wxArrayInt *itemsChanged)
+{
+    wxASSERT_MSG( itemFrom <= itemTo, wxT("should be in order") );
 
-    for ( size_t i = idx; i < count; i++ )
+    if ( itemsChanged )
     {
-        m_itemsSel[i] += numItems;
+        itemsChanged->Empty();
     }
 
-    if ( m_defaultState )
+    // are we going to have more [un]selected items than the other ones?
+    if ( itemTo - itemFrom > m_count/2 && select != m_defaultState )
     {
-        // All newly inserted items are not selected, so if the default state
-        // is to be selected, we need to manually add them to the deselected
-        // items indices.
-        for ( unsigned n = item; n < item + numItems; n++ )
-        {
-            m_itemsSel.AddAt(n, idx++);
-        }
+        // the default state now becomes the same as 'select'
+        m_defaultState = select;
+
+        // so all the old exceptions outside of the range are not exceptions
+        // any more, but all the other items outside of it are
+        Ranges rangesOld;
+        ExtractRanges(m_root, rangesOld);
+        m_numExceptions = 0;
+
+        Ranges rangesNew;
+        AppendComplement(rangesOld, 0, itemFrom, rangesNew);
+        AppendComplement(rangesOld, itemTo + 1, m_count, rangesNew);
+
+        m_root = MakeTree(rangesNew);
+
+        // many items (> half) changed state
+        itemsChanged = NULL;
+    }
+    else
+    {
+        SetExceptions(itemFrom, itemTo + 1, select != m_defaultState,
+                      itemsChanged);
     }
 
-    m_count += numItems;
+    // we set it to NULL if there are many items changing state
+    return itemsChanged != NULL;
 }
 
-void wxSelectionStore::OnItemDelete(unsigned item)
+// ----------------------------------------------------------------------------
+// callbacks
+// ----------------------------------------------------------------------------
+
+void wxSelectionStore::OnItemsInserted(unsigned item, unsigned numItems)
 {
-    size_t count = m_itemsSel.GetCount(),
-           i = m_itemsSel.IndexForInsert(item);
+    // detach the ranges after the insertion point and the range containing
+    // it, if any
+    Node *left, *containing, *right;
+    Split(m_root, item + 1, true, left, right);
+    Split(right, item, false, containing, right);
+
+    // shift all the ranges after it
+    AddShift(right, numItems);
 
-    if ( i < count && m_itemsSel[i] == item )
+    // and split the range containing the insertion point
+    if ( containing )
     {
-        // this item itself was in m_itemsSel, remove it from there
-        m_itemsSel.RemoveAt(i);
+        const Range r = containing->range;
+        delete containing;
 
-        count--;
+        left = Merge(left, NewNode(Range(r.from, item)));
+        right = Merge(NewNode(Range(item + numItems, r.to + numItems)), right);
     }
 
-    // and adjust the index of all which follow it
-    while ( i < count )
-    {
-        // all following elements must be greater than the one we deleted
-        wxASSERT_MSG( m_itemsSel[i] > item, wxT("logic error") );
+    m_root = Merge(left, right);
 
-        m_itemsSel[i++]--;
+    m_count += numItems;
+
+    if ( m_defaultState )
+    {
+        // All newly inserted items are not selected, so if the default state
+        // is to be selected, we need to manually add them to the deselected
+        // items indices.
+        wxArrayInt* itemsChanged = NULL;
+        SetExceptions(item, item + numItems, true, itemsChanged);
     }
+}
 
-    m_count--;
+void wxSelectionStore::OnItemDelete(unsigned item)
+{
+    OnItemsDeleted(item, 1);
 }
 
 bool wxSelectionStore::OnItemsDeleted(unsigned item, unsigned numItems)
 {
-    bool anyDeletedInSelItems = false,
-         allDeletedInSelItems = true;
+    // forget about the deleted items
+    wxArrayInt* itemsChanged = NULL;
+    const unsigned numDeletedExceptions =
+        SetExceptions(item, item + numItems, false, itemsChanged);
 
-    size_t i = m_itemsSel.IndexForInsert(item);
+    // and adjust the indices of all the items following them
+    Node *left, *right;
+    Split(m_root, item + 1, true, left, right);
 
-    const unsigned firstAfterDeleted = item + numItems;
-    while ( i < m_itemsSel.size() )
-    {
-        if ( m_itemsSel[i] < firstAfterDeleted )
-        {
-            // This item is going to be deleted, so remove it from the
-            // selected indices entirely. Notice that we do not update i here
-            // as it now refers to the next element.
-            m_itemsSel.RemoveAt(i);
+    AddShift(right, -numItems);
 
-            anyDeletedInSelItems = true;
-        }
-        else
-        {
-            // This item remains, just update its index.
-            m_itemsSel[i++] -= numItems;
+    // the last range before the deleted items and the first one after them
+    // may become adjacent, in which case they must be merged
+    Node *last, *first;
+    Split(left, item, true, left, last);
+    Split(right, item + 1, false, first, right);
 
-            allDeletedInSelItems = false;
-        }
+    if ( last && first )
+    {
+        const Range r(last->range.from, first->range.to);
+        delete last;
+        delete first;
+
+        left = Merge(left, NewNode(r));
+    }
+    else
+    {
+        left = Merge(left, last);
+        right = Merge(first, right);
     }
 
+    m_root = Merge(left, right);
+
     m_count -= numItems;
 
-    return m_defaultState ? allDeletedInSelItems : anyDeletedInSelItems;
+    return m_defaultState ? numDeletedExceptions < numItems
+                          : numDeletedExceptions > 0;
 }
 
 
@@ -277,13 +500,11 @@ void wxSelectionStore::SetItemCount(unsigned count)
 {
     // forget about all items whose indices are now invalid if the size
     // decreased
-    if ( count < m_count )
+    const unsigned end = GetRangesEnd();
+    if ( count < end )
     {
-        for ( size_t i = m_itemsSel.GetCount(); i > 0; i-- )
-        {
-            if ( m_itemsSel[i - 1] >= count )
-                m_itemsSel.RemoveAt(i - 1);
-        }
+        wxArrayInt* itemsChanged = NULL;
+        SetExceptions(count, end, false, itemsChanged);
     }
 
     // remember the new number of items
@@ -303,28 +524,33 @@ unsigned wxSelectionStore::GetFirstSelectedItem(IterationState& cookie) const
 
 unsigned wxSelectionStore::GetNextSelectedItem(IterationState& cookie) const
 {
+    // The cookie is just the first item which may be selected.
+    if ( cookie >= m_count )
+        return NO_SELECTION;
+
+    unsigned item = cookie;
+
+    Range r;
+    const bool found = FindRange(item, r);
     if ( m_defaultState )
     {
-        // We have no choice but to iterate over all items in this case. It
-        // shouldn't be that bad in practice because (almost) all items are
-        // supposed to be selected if m_defaultState == true anyhow.
-        for ( unsigned item = cookie; ; item++ )
-        {
-            if ( item >= m_count )
-                return NO_SELECTION;
-
-            if ( IsSelected(item) )
-            {
-                cookie = item + 1;
-                return item;
-            }
-        }
+        // Skip the range of unselected items containing this one, if any: as
+        // the ranges are never adjacent, the item after it is selected.
+        if ( found && r.from <= item )
+            item = r.to;
+
+        if ( item >= m_count )
+            return NO_SELECTION;
     }
-    else // Simple case when we directly have the selected items.
+    else // Find the first range of selected items after this one.
     {
-        if ( cookie >= m_itemsSel.size() )
+        if ( !found )
             return NO_SELECTION;
 
-        return m_itemsSel[cookie++];
+        if ( r.from > item )
+            item = r.from;
     }
+
+    cookie = item + 1;
+    return item;
 }
@@ -33,9 +33,12 @@
 #endif
 
 #include "wx/generic/treectlg.h"
+#include "wx/hashmap.h"
 #include "wx/imaglist.h"
 #include "wx/itemattr.h"
 
+#include "wx/generic/private/prefixfind.h"
+
 #include "wx/renderer.h"
 
 #ifdef __WXMAC__
@@ -132,6 +135,56 @@ private:
     wxDECLARE_NO_COPY_CLASS(wxTreeFindTimer);
 };
 
+WX_DECLARE_VOIDPTR_HASH_MAP(size_t, wxTreeItemPositionMap);
+
+// index of the labels of all items used by wxGenericTreeCtrl::FindItem(), the
+// positions of the items are their indices in the order of GetNext()
+class wxTreeFindIndex
+{
+public:
+    wxTreeFindIndex() { }
+
+    void Clear()
+    {
+        m_index.Clear();
+        m_items.clear();
+        m_positions.clear();
+    }
+
+    bool IsEmpty() const { return m_items.empty(); }
+
+    void Add(wxGenericTreeItem *item, const wxString& label)
+    {
+        const size_t pos = m_items.size();
+        m_index.Add(label, pos);
+        m_items.push_back(item);
+        m_positions[item] = pos;
+    }
+
+    void Finish() { m_index.Finish(); }
+
+    // return the position of the item or (size_t)-1 if it's not indexed
+    size_t GetPosition(wxGenericTreeItem *item) const
+    {
+        wxTreeItemPositionMap::const_iterator it = m_positions.find(item);
+        return it == m_positions.end() ? (size_t)-1 : it->second;
+    }
+
+    wxGenericTreeItem *GetItem(size_t pos) const { return m_items[pos]; }
+
+    size_t Find(const wxString& prefix, size_t start) const
+    {
+        return m_index.Find(prefix, start);
+    }
+
+private:
+    wxPrefixFindIndex m_index;
+    wxVector<wxGenericTreeItem *> m_items;
+    wxTreeItemPositionMap m_positions;
+
+    wxDECLARE_NO_COPY_CLASS(wxTreeFindIndex);
+};
+
 // a tree item
 class WXDLLEXPORT wxGenericTreeItem
 {
@@ -395,6 +448,48 @@ IsDescendantOf(const wxGenericTreeItem *parent, const wxGenericTreeItem *item)
     return false;
 }
 
+// find the index of the item among the children of its parent, which must be
+// shown and have up to date positions, using binary search on their positions
+static size_t
+GetIndexInParent(wxGenericTreeItem *item)
+{
+    const wxArrayGenericTreeItems& siblings = item->GetParent()->GetChildren();
+
+    // find the last sibling starting before or at the item position
+    size_t lo = 0,
+           hi = siblings.GetCount();
+    while ( lo < hi )
+    {
+        const size_t mid = (lo + hi) / 2;
+        if ( siblings[mid]->GetY() <= item->GetY() )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    // this can only fail if several items have the same position, which
+    // shouldn't happen, but fall back to the linear search just in case
+    if ( lo && siblings[lo - 1] == item )
+        return lo - 1;
+
+    return siblings.Index(item);
+}
+
+// move the item and all its visible descendants vertically
+static void
+ShiftItemPositions(wxGenericTreeItem *item, int dy)
+{
+    item->SetY(item->GetY() + dy);
+
+    if ( !item->IsExpanded() )
+        return;
+
+    wxArrayGenericTreeItems& children = item->GetChildren();
+    const size_t count = children.GetCount();
+    for ( size_t n = 0; n < count; n++ )
+        ShiftItemPositions(children[n], dy);
+}
+
 // -----------------------------------------------------------------------------
 // wxTreeRenameTimer (internal)
 // -----------------------------------------------------------------------------
@@ -756,8 +851,32 @@ wxGenericTreeItem *wxGenericTreeItem::HitTest(const wxPoint& point,
     }
 
     // evaluate children
+    size_t first = 0;
     size_t count = m_children.GetCount();
-    for ( size_t n = 0; n < count; n++ )
+    if ( !theCtrl->m_dirty && count )
+    {
+        // The positions are up to date, so only the last child starting above
+        // the point and its own children can contain it: find it using binary
+        // search instead of checking all the children.
+        size_t lo = 0,
+               hi = count;
+        while ( lo < hi )
+        {
+            const size_t mid = (lo + hi) / 2;
+            if ( m_children[mid]->GetY() <= point.y )
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        if ( !lo )
+            return NULL;
+
+        first = lo - 1;
+        count = lo;
+    }
+
+    for ( size_t n = first; n < count; n++ )
     {
         wxGenericTreeItem *res = m_children[n]->HitTest( point,
                                                          theCtrl,
@@ -950,6 +1069,10 @@ void wxGenericTreeCtrl::Init()
 
     m_dropEffectAboveItem = false;
 
+    m_childrenOnDemand = false;
+
+    m_findIndex = NULL;
+
     m_dndEffect = NoEffect;
     m_dndEffectItem = NULL;
 
@@ -996,6 +1119,7 @@ wxGenericTreeCtrl::~wxGenericTreeCtrl()
 
     delete m_renameTimer;
     delete m_findTimer;
+    delete m_findIndex;
 
     if (m_ownsImageListButtons)
         delete m_imageListButtons;
@@ -1100,6 +1224,9 @@ void wxGenericTreeCtrl::SetWindowStyleFlag(long styles)
     // none of the parents has updatable styles
     m_windowStyle = styles;
     m_dirty = true;
+
+    // the hidden root is not included in the index
+    InvalidateFindIndex();
 }
 
 // -----------------------------------------------------------------------------
@@ -1168,6 +1295,7 @@ wxGenericTreeCtrl::SetItemText(const wxTreeItemId& item, const wxString& text)
 
     wxGenericTreeItem *pItem = (wxGenericTreeItem*) item.m_pItem;
     pItem->SetText(text);
+    InvalidateFindIndex();
     pItem->CalculateSize(this);
     RefreshLine(pItem);
 }
@@ -1573,6 +1701,17 @@ void wxGenericTreeCtrl::ResetFindState()
         m_findBell = 1;
 }
 
+// add the item and all its children to the index in the order of GetNext()
+static void AddToFindIndex(wxTreeFindIndex& index, wxGenericTreeItem *item)
+{
+    index.Add(item, item->GetText());
+
+    const wxArrayGenericTreeItems& children = item->GetChildren();
+    const size_t count = children.GetCount();
+    for ( size_t n = 0; n < count; n++ )
+        AddToFindIndex(index, children[n]);
+}
+
 // find the first item starting with the given prefix after the given item
 wxTreeItemId wxGenericTreeCtrl::FindItem(const wxTreeItemId& idParent,
                                          const wxString& prefixOrig) const
@@ -1582,6 +1721,41 @@ wxTreeItemId wxGenericTreeCtrl::FindItem(const wxTreeItemId& idParent,
     // would be too bothersome
     wxString prefix = prefixOrig.Lower();
 
+    if ( m_findIndex && m_anchor )
+    {
+        if ( m_findIndex->IsEmpty() )
+        {
+            if ( HasFlag(wxTR_HIDE_ROOT) )
+            {
+                const wxArrayGenericTreeItems& children = m_anchor->GetChildren();
+                for ( size_t n = 0; n < children.GetCount(); n++ )
+                    AddToFindIndex(*m_findIndex, children[n]);
+            }
+            else
+            {
+                AddToFindIndex(*m_findIndex, m_anchor);
+            }
+
+            m_findIndex->Finish();
+        }
+
+        // this finds the same item as the loops below: the one after the
+        // given item (or the given item itself when continuing the search)
+        // or, if there is none, the first one before it
+        const size_t posParent =
+            m_findIndex->GetPosition((wxGenericTreeItem*)idParent.m_pItem);
+
+        size_t start = 0;
+        if ( posParent != (size_t)-1 )
+            start = prefix.length() == 1 ? posParent + 1 : posParent;
+
+        const size_t pos = m_findIndex->Find(prefix, start);
+        if ( pos == (size_t)-1 || (prefix.length() == 1 && pos == posParent) )
+            return wxTreeItemId();
+
+        return m_findIndex->GetItem(pos);
+    }
+
     // determine the starting point: we shouldn't take the current item (this
     // allows to switch between two items starting with the same letter just by
     // pressing it) but we shouldn't jump to the next one if the user is
@@ -1644,7 +1818,10 @@ wxTreeItemId wxGenericTreeCtrl::DoInsertItem(const wxTreeItemId& parentId,
         return AddRoot(text, image, selImage, data);
     }
 
-    m_dirty = true;     // do this first so stuff below doesn't cause flicker
+    // Adding children to a collapsed item which already has a button doesn't
+    // change anything on screen, so don't recalculate all the positions then.
+    if ( parent->IsExpanded() || !parent->HasPlus() )
+        m_dirty = true; // do this first so stuff below doesn't cause flicker
 
     wxGenericTreeItem *item =
         new wxGenericTreeItem( parent, text, image, selImage, data );
@@ -1656,6 +1833,7 @@ wxTreeItemId wxGenericTreeCtrl::DoInsertItem(const wxTreeItemId& parentId,
 
     parent->Insert( item, previous == (size_t)-1 ? parent->GetChildren().size()
                                                  : previous );
+    InvalidateFindIndex();
 
     InvalidateBestSize();
     return item;
@@ -1672,6 +1850,7 @@ wxTreeItemId wxGenericTreeCtrl::AddRoot(const wxString& text,
 
     m_anchor = new wxGenericTreeItem(NULL, text,
                                    image, selImage, data);
+    InvalidateFindIndex();
     if ( data != NULL )
     {
         data->m_pItem = m_anchor;
@@ -1725,10 +1904,34 @@ wxTreeItemId wxGenericTreeCtrl::DoInsertAfter(const wxTreeItemId& parentId,
 
 void wxGenericTreeCtrl::SendDeleteEvent(wxGenericTreeItem *item)
 {
+    // this is called for all the items being deleted, so it's the simplest
+    // place to ensure that we don't keep pointers to them in the index
+    InvalidateFindIndex();
+
     wxTreeEvent event(wxEVT_TREE_DELETE_ITEM, this, item);
     GetEventHandler()->ProcessEvent( event );
 }
 
+void wxGenericTreeCtrl::InvalidateFindIndex()
+{
+    if ( m_findIndex )
+        m_findIndex->Clear();
+}
+
+void wxGenericTreeCtrl::EnableFindIndex(bool enable)
+{
+    if ( enable )
+    {
+        // the index will be built when it's used for the first time
+        if ( !m_findIndex )
+            m_findIndex = new wxTreeFindIndex;
+    }
+    else
+    {
+        wxDELETE(m_findIndex);
+    }
+}
+
 // Don't leave edit or selection on a child which is about to disappear
 void wxGenericTreeCtrl::ChildrenClosing(wxGenericTreeItem* item)
 {
@@ -1878,7 +2081,7 @@ void wxGenericTreeCtrl::Expand(const wxTreeItemId& itemId)
     item->Expand();
     if ( !IsFrozen() )
     {
-        CalculatePositions();
+        CalculateSubtreePositions(item);
 
         RefreshSubtree(item);
     }
@@ -1919,6 +2122,18 @@ void wxGenericTreeCtrl::Collapse(const wxTreeItemId& itemId)
     ChildrenClosing(item);
     item->Collapse();
 
+    // Delete the children before sending wxEVT_TREE_ITEM_COLLAPSED as its
+    // handler may delete the item itself, so it can't be used after it.
+    if ( m_childrenOnDemand && item->HasChildren() )
+    {
+        // The children will be added again when the item is expanded, but
+        // keep showing the button allowing to do it.
+        item->SetHasPlus();
+        item->DeleteChildren(this);
+
+        InvalidateBestSize();
+    }
+
 #if 0  // TODO why should items be collapsed recursively?
     wxArrayGenericTreeItems& children = item->GetChildren();
     size_t count = children.GetCount();
@@ -1928,7 +2143,7 @@ void wxGenericTreeCtrl::Collapse(const wxTreeItemId& itemId)
     }
 #endif
 
-    CalculatePositions();
+    CalculateSubtreePositions(item);
 
     RefreshSubtree(item);
 
@@ -2373,6 +2588,8 @@ void wxGenericTreeCtrl::SortChildren(const wxTreeItemId& itemId)
         s_treeBeingSorted = this;
         children.Sort(tree_ctrl_compare_func);
         s_treeBeingSorted = NULL;
+
+        InvalidateFindIndex();
     }
     //else: don't make the tree dirty as nothing changed
 }
@@ -4020,6 +4237,84 @@ void wxGenericTreeCtrl::CalculatePositions()
     CalculateLevel( m_anchor, dc, 0, y ); // start recursion
 }
 
+void wxGenericTreeCtrl::CalculateSubtreePositions(wxGenericTreeItem *item)
+{
+    // We can only reuse the existing positions if they are up to date and the
+    // item is shown, otherwise we don't even know where it is.
+    bool canReuse = !m_dirty && item != m_anchor;
+    int level = 0;
+    for ( wxGenericTreeItem *parent = item->GetParent();
+          parent && canReuse;
+          parent = parent->GetParent() )
+    {
+        if ( !parent->IsExpanded() )
+            canReuse = false;
+
+        level++;
+    }
+
+    if ( !canReuse )
+    {
+        CalculatePositions();
+        return;
+    }
+
+    // Find the indices of the item and its ancestors among their siblings:
+    // they are needed to find the items following the subtree. Notice that
+    // this must be done before changing the positions in it.
+    wxVector<size_t> indices;
+    indices.reserve(level);
+    for ( wxGenericTreeItem *i = item; i->GetParent(); i = i->GetParent() )
+        indices.push_back(GetIndexInParent(i));
+
+    // Find the first item after this item subtree to check how much did the
+    // subtree height change.
+    wxGenericTreeItem *next = NULL;
+    size_t depth = 0;
+    for ( wxGenericTreeItem *i = item; i->GetParent() && !next; i = i->GetParent() )
+    {
+        const wxArrayGenericTreeItems& siblings = i->GetParent()->GetChildren();
+        const size_t index = indices[depth++];
+        if ( index + 1 < siblings.GetCount() )
+            next = siblings[index + 1];
+    }
+
+    wxClientDC dc(this);
+    PrepareDC( dc );
+
+    dc.SetFont( m_normalFont );
+    dc.SetPen( m_dottedPen );
+
+    const int lineHeight = m_lineHeight;
+
+    int y = item->GetY();
+    CalculateLevel( item, dc, level, y );
+
+    // If a new item was higher than all the existing ones, all of them become
+    // higher too, unless they use their own heights.
+    if ( m_lineHeight != lineHeight && !HasFlag(wxTR_HAS_VARIABLE_ROW_HEIGHT) )
+    {
+        CalculatePositions();
+        return;
+    }
+
+    if ( !next || y == next->GetY() )
+        return;
+
+    // Move all the items after the subtree: notice that this still takes
+    // time proportional to their number, but is much faster than measuring
+    // them again.
+    const int dy = y - next->GetY();
+    depth = 0;
+    for ( wxGenericTreeItem *i = item; i->GetParent(); i = i->GetParent() )
+    {
+        const wxArrayGenericTreeItems& siblings = i->GetParent()->GetChildren();
+        const size_t count = siblings.GetCount();
+        for ( size_t n = indices[depth++] + 1; n < count; n++ )
+            ShiftItemPositions(siblings[n], dy);
+    }
+}
+
 void wxGenericTreeCtrl::Refresh(bool eraseBackground, const wxRect *rect)
 {
     if ( !IsFrozen() )
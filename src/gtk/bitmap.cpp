@@ -609,14 +609,13 @@ wxBitmap::wxBitmap(const wxImage& image, int depth, double scale)
 
     guchar* dst = gdk_pixbuf_get_pixels(pixbuf_dst);
     const int dstStride = gdk_pixbuf_get_rowstride(pixbuf_dst);
-    CopyImageData(dst, gdk_pixbuf_get_n_channels(pixbuf_dst), dstStride, src, 3, 3 * w, w, h);
-
     if (depth == 32 && alpha)
     {
-        for (int j = 0; j < h; j++, dst += dstStride)
-            for (int i = 0; i < w; i++)
-                dst[i * 4 + 3] = *alpha++;
+        // convert directly to the pixbuf format
+        image.GetInterleavedData(wxIMAGE_PIXEL_FORMAT_RGBA, dst, dstStride);
     }
+    else
+        CopyImageData(dst, gdk_pixbuf_get_n_channels(pixbuf_dst), dstStride, src, 3, 3 * w, w, h);
     if (image.HasMask())
     {
         const guchar r = image.GetMaskRed();
@@ -740,9 +739,15 @@ bool wxBitmap::CreateFromImageAsPixbuf(const wxImage& image)
     // Copy the data:
     const unsigned char* in = image.GetData();
     unsigned char *out = gdk_pixbuf_get_pixels(pixbuf);
-    unsigned char *alpha = image.GetAlpha();
 
-    int rowpad = gdk_pixbuf_get_rowstride(pixbuf) - 4 * width;
+    const int rowstride = gdk_pixbuf_get_rowstride(pixbuf);
+    if (image.HasAlpha())
+    {
+        // convert directly to the pixbuf format
+        return image.GetInterleavedData(wxIMAGE_PIXEL_FORMAT_RGBA, out, rowstride);
+    }
+
+    int rowpad = rowstride - 4 * width;
 
     for (int y = 0; y < height; y++, out += rowpad)
     {
@@ -751,8 +756,7 @@ bool wxBitmap::CreateFromImageAsPixbuf(const wxImage& image)
             out[0] = in[0];
             out[1] = in[1];
             out[2] = in[2];
-            if (alpha)
-                out[3] = *alpha++;
+            out[3] = 0xff;
         }
     }
 
@@ -37,11 +37,31 @@
 // wxTextMeasure implementation
 // ============================================================================
 
+extern "C" {
+static void notify_gtk_xft_dpi(GObject*, GParamSpec*, void*)
+{
+    // the extents of all strings change when the resolution does
+    wxTextMeasureBase::ClearCache();
+}
+}
+
 void wxTextMeasure::Init()
 {
     m_context = NULL;
     m_layout = NULL;
 
+    static bool s_connected = false;
+    if ( !s_connected )
+    {
+        GtkSettings* const settings = gtk_settings_get_default();
+        if ( settings )
+        {
+            g_signal_connect(settings, "notify::gtk-xft-dpi",
+                G_CALLBACK(notify_gtk_xft_dpi), NULL);
+            s_connected = true;
+        }
+    }
+
 #ifndef __WXGTK3__
     m_wdc = NULL;
 
@@ -54,6 +74,10 @@ void wxTextMeasure::Init()
         if ( ci->IsKindOf(wxCLASSINFO(wxWindowDCImpl)))
         {
             m_useDCImpl = false;
+
+            // The text is measured using the Pango context of the window, so
+            // the results only depend on the font, as for the windows.
+            m_useCache = true;
         }
     }
 #endif // GTK+ < 3
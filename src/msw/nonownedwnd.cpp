@@ -36,6 +36,7 @@
 #include "wx/dynlib.h"
 #include "wx/scopedptr.h"
 #include "wx/msw/missing.h"
+#include "wx/private/textmeasure.h"
 
 // ============================================================================
 // wxNonOwnedWindow implementation
@@ -270,6 +271,10 @@ bool wxNonOwnedWindow::HandleDPIChange(const wxSize& newDPI, const wxRect& newRe
 
     if ( newDPI != m_activeDPI )
     {
+        // the extents of the strings measured at the old resolution can't be
+        // reused any longer
+        wxTextMeasureBase::ClearCache();
+
         MSWUpdateOnDPIChange(m_activeDPI, newDPI);
         m_activeDPI = newDPI;
     }
@@ -0,0 +1,219 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/events.cpp
+// Purpose:     Events-related benchmarks
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/app.h"
+#include "wx/event.h"
+#include "wx/thread.h"
+#include "wx/vector.h"
+
+#include "bench.h"
+
+namespace
+{
+
+// the number of handlers in the chain used by the dispatch benchmarks and the
+// number of event types bound in each of them
+const int NUM_HANDLERS = 5;
+const int NUM_BOUND_TYPES = 200;
+
+wxEventType gs_eventTypes[NUM_BOUND_TYPES];
+wxEvtHandler *gs_handlers[NUM_HANDLERS] = { NULL };
+
+class DispatchHandler : public wxEvtHandler
+{
+public:
+    DispatchHandler() { }
+
+    void OnEvent(wxEvent& event) { event.Skip(); }
+};
+
+bool DispatchInit()
+{
+    for ( int n = 0; n < NUM_BOUND_TYPES; n++ )
+        gs_eventTypes[n] = wxNewEventType();
+
+    // Chain the handlers, as if they were the windows from the one receiving
+    // the event to its top level parent, and bind many event types in all of
+    // them, but the first type only in the last one.
+    for ( int n = 0; n < NUM_HANDLERS; n++ )
+    {
+        DispatchHandler* const handler = new DispatchHandler;
+        for ( int i = 0; i < NUM_BOUND_TYPES; i++ )
+        {
+            if ( i == 0 && n != NUM_HANDLERS - 1 )
+                continue;
+
+            handler->Connect(gs_eventTypes[i],
+                             wxEventHandler(DispatchHandler::OnEvent));
+        }
+
+        if ( n )
+            gs_handlers[n - 1]->SetNextHandler(handler);
+        gs_handlers[n] = handler;
+    }
+
+    return true;
+}
+
+void DispatchDone()
+{
+    for ( int n = 0; n < NUM_HANDLERS; n++ )
+    {
+        delete gs_handlers[n];
+        gs_handlers[n] = NULL;
+    }
+}
+
+// queue many events with a few different ids and process all of them
+bool QueueAndProcessEvents(bool coalesce)
+{
+    wxEvtHandler handler;
+    if ( coalesce )
+        handler.EnableEventsCoalescing(wxEVT_THREAD);
+
+    for ( int n = 0; n < 1000; n++ )
+        wxQueueEvent(&handler, new wxThreadEvent(wxEVT_THREAD, n % 10));
+
+    int count = 0;
+    while ( wxTheApp->HasPendingEvents() )
+    {
+        wxTheApp->ProcessPendingEvents();
+        count++;
+    }
+
+    return count != 0;
+}
+
+} // anonymous namespace
+
+// Dispatch an event handled only by the last handler in the chain.
+BENCHMARK_FUNC_WITH_INIT(DispatchEventChain, DispatchInit, DispatchDone)
+{
+    wxThreadEvent event(gs_eventTypes[0]);
+    for ( int n = 0; n < 100; n++ )
+        gs_handlers[0]->ProcessEvent(event);
+
+    return true;
+}
+
+// Dispatch an event not handled by any handler in the chain.
+BENCHMARK_FUNC_WITH_INIT(DispatchEventUnhandled, DispatchInit, DispatchDone)
+{
+    wxThreadEvent event(wxEVT_NULL);
+    for ( int n = 0; n < 100; n++ )
+        gs_handlers[0]->ProcessEvent(event);
+
+    return true;
+}
+
+#if wxUSE_THREADS
+
+namespace
+{
+
+// the number of events queued by each thread
+const int NUM_EVENTS = 10000;
+
+// handler counting the events it processes
+class CountingHandler : public wxEvtHandler
+{
+public:
+    CountingHandler() : m_count(0)
+    {
+        Bind(wxEVT_THREAD, &CountingHandler::OnThreadEvent, this);
+    }
+
+    int GetCount() const { return m_count; }
+
+private:
+    void OnThreadEvent(wxThreadEvent& WXUNUSED(event)) { m_count++; }
+
+    int m_count;
+};
+
+// thread queuing the given number of events for the handler
+class ProducerThread : public wxThread
+{
+public:
+    explicit ProducerThread(wxEvtHandler* handler)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_handler(handler)
+    {
+    }
+
+protected:
+    virtual void *Entry() wxOVERRIDE
+    {
+        for ( int n = 0; n < NUM_EVENTS; n++ )
+            wxQueueEvent(m_handler, new wxThreadEvent());
+
+        return NULL;
+    }
+
+private:
+    wxEvtHandler* const m_handler;
+
+    wxDECLARE_NO_COPY_CLASS(ProducerThread);
+};
+
+} // anonymous namespace
+
+// Queue events from the number of threads given by the numeric parameter while
+// processing them in the main thread.
+BENCHMARK_FUNC(QueueEventThreads)
+{
+    long numThreads = Bench::GetNumericParameter();
+    if ( numThreads <= 0 )
+        numThreads = 1;
+
+    CountingHandler handler;
+
+    wxVector<ProducerThread*> threads;
+    for ( long n = 0; n < numThreads; n++ )
+    {
+        ProducerThread* const thread = new ProducerThread(&handler);
+        if ( thread->Run() != wxTHREAD_NO_ERROR )
+        {
+            delete thread;
+            break;
+        }
+
+        threads.push_back(thread);
+    }
+
+    const int total = threads.size()*NUM_EVENTS;
+    while ( handler.GetCount() < total )
+    {
+        if ( !wxTheApp->HasPendingEvents() )
+            wxThread::Yield();
+
+        wxTheApp->ProcessPendingEvents();
+    }
+
+    for ( size_t n = 0; n < threads.size(); n++ )
+    {
+        threads[n]->Wait();
+        delete threads[n];
+    }
+
+    return !threads.empty();
+}
+
+#endif // wxUSE_THREADS
+
+// Queue events in the main thread and process them.
+BENCHMARK_FUNC(QueueEventMain)
+{
+    return QueueAndProcessEvents(false);
+}
+
+// Same as above, but with only the last event with each of the ids processed.
+BENCHMARK_FUNC(QueueEventCoalesced)
+{
+    return QueueAndProcessEvents(true);
+}
@@ -0,0 +1,129 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/grid.cpp
+// Purpose:     wxGrid benchmarks
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/app.h"
+#include "wx/bitmap.h"
+#include "wx/dcmemory.h"
+#include "wx/grid.h"
+
+#include "bench.h"
+
+#if wxUSE_GRID
+
+namespace
+{
+
+const int NUM_ROWS = 100000;
+const int NUM_COLS = 10;
+
+// the number of rows rendered by GridRender benchmark
+const int NUM_VISIBLE_ROWS = 50;
+
+wxGrid *gs_grid = NULL;
+
+wxGridCellAttr *CreateColourAttr(const wxColour& colour)
+{
+    wxGridCellAttr * const attr = new wxGridCellAttr;
+    attr->SetBackgroundColour(colour);
+    return attr;
+}
+
+bool GridInit()
+{
+    gs_grid = new wxGrid(wxTheApp->GetTopWindow(), wxID_ANY);
+    gs_grid->CreateGrid(NUM_ROWS, NUM_COLS);
+
+    // Style the whole grid: alternate the colours of big ranges of rows, then
+    // highlight some columns in some of these ranges, and finally use
+    // different attributes for some individual rows, columns and cells.
+    const wxColour colours[] = { *wxWHITE, *wxLIGHT_GREY, *wxCYAN, *wxYELLOW };
+
+    for ( int row = 0; row < NUM_ROWS; row += 1000 )
+    {
+        gs_grid->SetBlockAttr
+                 (
+                    wxGridBlockCoords(row, 0, row + 999, NUM_COLS - 1),
+                    CreateColourAttr(colours[(row / 1000) % 2])
+                 );
+
+        gs_grid->SetBlockAttr
+                 (
+                    wxGridBlockCoords(row + 100, 3, row + 899, 5),
+                    CreateColourAttr(colours[2 + (row / 1000) % 2])
+                 );
+    }
+
+    for ( int row = 0; row < NUM_ROWS; row += 100 )
+        gs_grid->SetRowAttr(row, CreateColourAttr(*wxGREEN));
+
+    gs_grid->SetColAttr(NUM_COLS - 1, CreateColourAttr(*wxRED));
+
+    for ( int row = 0; row < NUM_ROWS; row += 7 )
+        gs_grid->SetAttr(row, row % NUM_COLS, CreateColourAttr(*wxBLUE));
+
+    return true;
+}
+
+void GridDone()
+{
+    delete gs_grid;
+    gs_grid = NULL;
+}
+
+// return the first row to use for the next iteration of the benchmark, so
+// that all of the grid is used when running it many times
+int GetNextFirstRow()
+{
+    static int s_firstRow = 0;
+
+    s_firstRow += 997;
+    if ( s_firstRow + NUM_VISIBLE_ROWS >= NUM_ROWS )
+        s_firstRow = 0;
+
+    return s_firstRow;
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC_WITH_INIT(GridAttrLookup, GridInit, GridDone)
+{
+    wxGridTableBase * const table = gs_grid->GetTable();
+
+    const int firstRow = GetNextFirstRow();
+
+    bool ok = true;
+    for ( int row = firstRow; row < firstRow + NUM_VISIBLE_ROWS; row++ )
+    {
+        for ( int col = 0; col < NUM_COLS; col++ )
+        {
+            wxGridCellAttrPtr attr = table->GetAttrPtr(row, col, wxGridCellAttr::Any);
+            if ( !attr )
+                ok = false;
+        }
+    }
+
+    return ok;
+}
+
+BENCHMARK_FUNC_WITH_INIT(GridRender, GridInit, GridDone)
+{
+    static wxBitmap s_bitmap(800, 600);
+
+    wxMemoryDC dc(s_bitmap);
+
+    const int firstRow = GetNextFirstRow();
+
+    gs_grid->Render(dc, wxPoint(0, 0), wxDefaultSize,
+                    wxGridCellCoords(firstRow, 0),
+                    wxGridCellCoords(firstRow + NUM_VISIBLE_ROWS - 1,
+                                     NUM_COLS - 1));
+
+    return true;
+}
+
+#endif // wxUSE_GRID
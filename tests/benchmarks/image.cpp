@@ -90,3 +90,112 @@ BENCHMARK_FUNC(ShrinkHighQuality)
 {
     return GetTestImage().Scale(50, 50, wxIMAGE_QUALITY_HIGH).IsOk();
 }
+
+// Return a big (2000*2000) image, with or without alpha, to be used by the
+// resampling and blur benchmarks.
+static const wxImage& GetBigTestImage(bool withAlpha)
+{
+    static wxImage s_images[2];
+
+    wxImage& image = s_images[withAlpha];
+    if ( !image.IsOk() )
+    {
+        const int size = 2000;
+
+        image = GetTestImage().Scale(size, size, wxIMAGE_QUALITY_NEAREST);
+        if ( withAlpha )
+        {
+            image.InitAlpha();
+
+            unsigned char* alpha = image.GetAlpha();
+            for ( int n = 0; n < size*size; n++ )
+                alpha[n] = static_cast<unsigned char>(n % 256);
+        }
+    }
+
+    return image;
+}
+
+BENCHMARK_FUNC(ShrinkBigBilinear)
+{
+    return GetBigTestImage(false).Scale(256, 256, wxIMAGE_QUALITY_BILINEAR).IsOk();
+}
+
+BENCHMARK_FUNC(ShrinkBigBicubic)
+{
+    return GetBigTestImage(false).Scale(256, 256, wxIMAGE_QUALITY_BICUBIC).IsOk();
+}
+
+BENCHMARK_FUNC(ShrinkBigBox)
+{
+    return GetBigTestImage(false).Scale(256, 256, wxIMAGE_QUALITY_BOX_AVERAGE).IsOk();
+}
+
+BENCHMARK_FUNC(ShrinkBigBilinearAlpha)
+{
+    return GetBigTestImage(true).Scale(256, 256, wxIMAGE_QUALITY_BILINEAR).IsOk();
+}
+
+BENCHMARK_FUNC(ShrinkBigBicubicAlpha)
+{
+    return GetBigTestImage(true).Scale(256, 256, wxIMAGE_QUALITY_BICUBIC).IsOk();
+}
+
+BENCHMARK_FUNC(ShrinkBigBoxAlpha)
+{
+    return GetBigTestImage(true).Scale(256, 256, wxIMAGE_QUALITY_BOX_AVERAGE).IsOk();
+}
+
+BENCHMARK_FUNC(EnlargeBicubic)
+{
+    return GetTestImage().Scale(1000, 1000, wxIMAGE_QUALITY_BICUBIC).IsOk();
+}
+
+BENCHMARK_FUNC(EnlargeBilinear)
+{
+    return GetTestImage().Scale(1000, 1000, wxIMAGE_QUALITY_BILINEAR).IsOk();
+}
+
+// Blur benchmarks use the radius given by the numeric parameter, so run them
+// with e.g. "-p 1", "-p 16" and "-p 64" to check that the time taken doesn't
+// depend on it.
+BENCHMARK_FUNC(BlurHorizontal)
+{
+    return GetBigTestImage(false).BlurHorizontal(Bench::GetNumericParameter()).IsOk();
+}
+
+BENCHMARK_FUNC(BlurVertical)
+{
+    return GetBigTestImage(false).BlurVertical(Bench::GetNumericParameter()).IsOk();
+}
+
+BENCHMARK_FUNC(Blur)
+{
+    return GetBigTestImage(false).Blur(Bench::GetNumericParameter()).IsOk();
+}
+
+BENCHMARK_FUNC(GaussianBlur)
+{
+    return GetBigTestImage(false).GaussianBlur(Bench::GetNumericParameter()).IsOk();
+}
+
+// These benchmarks use fixed radius values from the 1..64 range.
+BENCHMARK_FUNC(BlurRadius1)
+{
+    return GetBigTestImage(false).Blur(1).IsOk();
+}
+
+BENCHMARK_FUNC(BlurRadius8)
+{
+    return GetBigTestImage(false).Blur(8).IsOk();
+}
+
+BENCHMARK_FUNC(BlurRadius32)
+{
+    return GetBigTestImage(false).Blur(32).IsOk();
+}
+
+BENCHMARK_FUNC(BlurRadius64)
+{
+    return GetBigTestImage(false).Blur(64).IsOk();
+}
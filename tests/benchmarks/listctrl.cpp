@@ -0,0 +1,78 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/listctrl.cpp
+// Purpose:     wxGenericListCtrl benchmarks
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets development team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/app.h"
+#include "wx/arrstr.h"
+#include "wx/listctrl.h"
+#include "wx/generic/listctrl.h"
+
+#include "bench.h"
+
+#if wxUSE_LISTCTRL
+
+namespace
+{
+
+// the number of items inserted by each iteration of the benchmarks
+const int NUM_ITEMS = 100000;
+
+wxGenericListCtrl *gs_list = NULL;
+wxArrayString gs_labels;
+
+bool ListCtrlInit()
+{
+    gs_list = new wxGenericListCtrl(wxTheApp->GetTopWindow(), wxID_ANY,
+                                    wxDefaultPosition, wxDefaultSize,
+                                    wxLC_REPORT);
+    gs_list->AppendColumn("Name");
+    gs_list->AppendColumn("Value");
+
+    gs_labels.reserve(NUM_ITEMS);
+    for ( int n = 0; n < NUM_ITEMS; n++ )
+        gs_labels.push_back(wxString::Format("Item %d", n));
+
+    return true;
+}
+
+void ListCtrlDone()
+{
+    delete gs_list;
+    gs_list = NULL;
+
+    gs_labels.clear();
+}
+
+} // anonymous namespace
+
+// Both benchmarks include the time needed to delete all the items, as freeing
+// the memory used by them is as important as allocating it.
+
+BENCHMARK_FUNC_WITH_INIT(ListCtrlInsertItem, ListCtrlInit, ListCtrlDone)
+{
+    for ( int n = 0; n < NUM_ITEMS; n++ )
+        gs_list->InsertItem(n, gs_labels[n]);
+
+    const bool ok = gs_list->GetItemCount() == NUM_ITEMS;
+
+    gs_list->DeleteAllItems();
+
+    return ok;
+}
+
+BENCHMARK_FUNC_WITH_INIT(ListCtrlInsertItems, ListCtrlInit, ListCtrlDone)
+{
+    gs_list->InsertItems(0, gs_labels);
+
+    const bool ok = gs_list->GetItemCount() == NUM_ITEMS;
+
+    gs_list->DeleteAllItems();
+
+    return ok;
+}
+
+#endif // wxUSE_LISTCTRL
@@ -17,9 +17,8 @@
 
 #include "wx/app.h"
 #include "wx/dataview.h"
-#ifdef __WXGTK__
-    #include "wx/stopwatch.h"
-#endif // __WXGTK__
+#include "wx/scopedptr.h"
+#include "wx/stopwatch.h"
 
 #include "testableframe.h"
 #include "asserthelper.h"
@@ -381,6 +380,412 @@ TEST_CASE_METHOD(SingleSelectDataViewCtrlTestCase,
     CHECK( m_dvc->GetChildCount(wxDataViewItem()) == 0 );
 }
 
+#ifdef wxHAS_GENERIC_DATAVIEWCTRL
+
+namespace
+{
+
+// Class providing access to the functions mapping items to rows.
+class RowDataViewTreeCtrl : public wxDataViewTreeCtrl
+{
+public:
+    explicit RowDataViewTreeCtrl(wxWindow* parent)
+        : wxDataViewTreeCtrl(parent, wxID_ANY)
+    {
+    }
+
+    using wxDataViewTreeCtrl::GetItemByRow;
+    using wxDataViewTreeCtrl::GetRowByItem;
+};
+
+// Append the items visible in the given control under the given parent, in
+// the order in which they appear in it, to the provided array.
+void
+GetVisibleItems(wxDataViewTreeCtrl* dvc,
+                const wxDataViewItem& parent,
+                wxDataViewItemArray& items)
+{
+    const int count = dvc->GetChildCount(parent);
+    for ( int n = 0; n < count; n++ )
+    {
+        const wxDataViewItem item = dvc->GetNthChild(parent, n);
+        items.push_back(item);
+
+        if ( dvc->IsExpanded(item) )
+            GetVisibleItems(dvc, item, items);
+    }
+}
+
+// Check that the rows of all visible items are as expected.
+void CheckRows(RowDataViewTreeCtrl* dvc)
+{
+    wxDataViewItemArray items;
+    GetVisibleItems(dvc, wxDataViewItem(), items);
+
+    for ( size_t n = 0; n < items.size(); n++ )
+    {
+        INFO("Row " << n);
+        CHECK( dvc->GetRowByItem(items[n]) == static_cast<int>(n) );
+        CHECK( dvc->GetItemByRow(n) == items[n] );
+    }
+
+    CHECK( !dvc->GetItemByRow(items.size()).IsOk() );
+}
+
+} // anonymous namespace
+
+TEST_CASE("wxDVC::RowByItem", "[wxDataViewCtrl][row]")
+{
+    RowDataViewTreeCtrl* const
+        dvc = new RowDataViewTreeCtrl(wxTheApp->GetTopWindow());
+    wxScopedPtr<RowDataViewTreeCtrl> deleteDVC(dvc);
+
+    // Create enough children to use the index of items in the control.
+    wxDataViewItemArray containers;
+    for ( int n = 0; n < 50; n++ )
+    {
+        const wxDataViewItem
+            container = dvc->AppendContainer(wxDataViewItem(),
+                                             wxString::Format("container %d", n));
+        containers.push_back(container);
+
+        for ( int m = 0; m < 20; m++ )
+        {
+            const wxDataViewItem
+                child = dvc->AppendContainer(container,
+                                             wxString::Format("child %d", m));
+            dvc->AppendItem(child, "grandchild");
+        }
+    }
+
+    CheckRows(dvc);
+
+    SECTION("Expand")
+    {
+        dvc->Expand(containers[0]);
+        dvc->Expand(containers[25]);
+        dvc->Expand(containers[49]);
+        CheckRows(dvc);
+
+        dvc->Expand(dvc->GetNthChild(containers[25], 10));
+        CheckRows(dvc);
+
+        dvc->Collapse(containers[0]);
+        CheckRows(dvc);
+
+        dvc->Collapse(containers[25]);
+        CheckRows(dvc);
+
+        dvc->Expand(containers[25]);
+        CheckRows(dvc);
+    }
+
+    SECTION("Modify")
+    {
+        dvc->Expand(containers[10]);
+        dvc->Expand(containers[20]);
+
+        dvc->InsertItem(containers[10], dvc->GetNthChild(containers[10], 5),
+                        "inserted");
+        dvc->PrependItem(wxDataViewItem(), "first");
+        CheckRows(dvc);
+
+        dvc->DeleteItem(dvc->GetNthChild(containers[10], 0));
+        dvc->DeleteItem(containers[15]);
+        CheckRows(dvc);
+
+        dvc->DeleteChildren(containers[20]);
+        CheckRows(dvc);
+    }
+}
+
+namespace
+{
+
+class RowDataViewListCtrl : public wxDataViewListCtrl
+{
+public:
+    explicit RowDataViewListCtrl(wxWindow* parent)
+        : wxDataViewListCtrl(parent, wxID_ANY)
+    {
+    }
+
+    using wxDataViewListCtrl::GetRowByItem;
+};
+
+} // anonymous namespace
+
+TEST_CASE("wxDVC::Batch", "[wxDataViewCtrl][sort]")
+{
+    RowDataViewListCtrl* const
+        dvc = new RowDataViewListCtrl(wxTheApp->GetTopWindow());
+    wxScopedPtr<RowDataViewListCtrl> deleteDVC(dvc);
+
+    dvc->AppendTextColumn("Text");
+
+    const int count = 10;
+    for ( int n = 0; n < count; n++ )
+    {
+        wxVector<wxVariant> values;
+        values.push_back(wxString::Format("%03d", n));
+        dvc->AppendItem(values);
+    }
+
+    dvc->GetColumn(0)->SetSortOrder(true);
+    dvc->GetModel()->Resort();
+
+    const wxDataViewItem item0 = dvc->RowToItem(0);
+    const wxDataViewItem item1 = dvc->RowToItem(1);
+    const wxDataViewItem item2 = dvc->RowToItem(2);
+
+    wxDataViewModel* const model = dvc->GetModel();
+    model->BeginBatch();
+    CHECK( model->GetBatchCount() == 1 );
+
+    dvc->SetTextValue("100", 0, 0);
+    dvc->SetTextValue("050", 1, 0);
+
+    // The items are not moved until the end of the batch.
+    CHECK( dvc->GetRowByItem(item0) == 0 );
+    CHECK( dvc->GetRowByItem(item1) == 1 );
+
+    // Adding items during the batch is still possible.
+    wxVector<wxVariant> values;
+    values.push_back("010");
+    dvc->AppendItem(values);
+
+    model->EndBatch();
+    CHECK( model->GetBatchCount() == 0 );
+
+    CHECK( dvc->GetRowByItem(item2) == 0 );
+    CHECK( dvc->GetRowByItem(item1) == count - 1 );
+    CHECK( dvc->GetRowByItem(item0) == count );
+    CHECK( dvc->GetRowByItem(dvc->RowToItem(count)) == count - 2 );
+}
+
+namespace
+{
+
+// Flat model whose items are just numbers, counting GetChildren() calls.
+class CountingModel : public wxDataViewModel
+{
+public:
+    CountingModel() : m_numGetChildren(0) { }
+
+    // Insert the item with the given number without notifying about it.
+    wxDataViewItem Insert(size_t pos, unsigned value)
+    {
+        m_values.insert(m_values.begin() + pos, value);
+        return GetItem(pos);
+    }
+
+    wxDataViewItem GetItem(size_t pos) const
+    {
+        return wxDataViewItem(wxUIntToPtr(m_values[pos]));
+    }
+
+    size_t GetCount() const { return m_values.size(); }
+
+    virtual unsigned int GetColumnCount() const wxOVERRIDE { return 1; }
+
+    virtual wxString GetColumnType(unsigned int WXUNUSED(col)) const wxOVERRIDE
+    {
+        return "string";
+    }
+
+    virtual void GetValue(wxVariant& variant,
+                          const wxDataViewItem& item,
+                          unsigned int WXUNUSED(col)) const wxOVERRIDE
+    {
+        variant = wxString::Format("%u", wxPtrToUInt(item.GetID()));
+    }
+
+    virtual bool SetValue(const wxVariant& WXUNUSED(variant),
+                          const wxDataViewItem& WXUNUSED(item),
+                          unsigned int WXUNUSED(col)) wxOVERRIDE
+    {
+        return false;
+    }
+
+    virtual wxDataViewItem
+    GetParent(const wxDataViewItem& WXUNUSED(item)) const wxOVERRIDE
+    {
+        return wxDataViewItem();
+    }
+
+    virtual bool IsContainer(const wxDataViewItem& item) const wxOVERRIDE
+    {
+        return !item.IsOk();
+    }
+
+    virtual unsigned int GetChildren(const wxDataViewItem& item,
+                                     wxDataViewItemArray& children) const wxOVERRIDE
+    {
+        m_numGetChildren++;
+
+        if ( item.IsOk() )
+            return 0;
+
+        for ( size_t n = 0; n < m_values.size(); n++ )
+            children.push_back(GetItem(n));
+
+        return children.size();
+    }
+
+    mutable int m_numGetChildren;
+
+private:
+    wxVector<unsigned> m_values;
+};
+
+class RowDataViewCtrl : public wxDataViewCtrl
+{
+public:
+    explicit RowDataViewCtrl(wxWindow* parent)
+        : wxDataViewCtrl(parent, wxID_ANY)
+    {
+    }
+
+    using wxDataViewCtrl::GetRowByItem;
+};
+
+} // anonymous namespace
+
+TEST_CASE("wxDVC::BatchAdd", "[wxDataViewCtrl][batch]")
+{
+    RowDataViewCtrl* const dvc = new RowDataViewCtrl(wxTheApp->GetTopWindow());
+    wxScopedPtr<RowDataViewCtrl> deleteDVC(dvc);
+
+    CountingModel* const model = new CountingModel;
+    for ( unsigned n = 0; n < 10; n++ )
+        model->Insert(n, 2*n + 1);
+
+    dvc->AssociateModel(model);
+    model->DecRef();
+    dvc->AppendTextColumn("Value", 0);
+
+    // Add the items between all the existing ones and after them.
+    wxDataViewItemArray items;
+    for ( unsigned n = 0; n < 10; n++ )
+        items.push_back(model->Insert(2*n + 1, 2*n + 2));
+
+    const unsigned count = 1000;
+    for ( unsigned n = 21; n <= count; n++ )
+        items.push_back(model->Insert(model->GetCount(), n));
+
+    // All of them are added at once, instead of getting the children from the
+    // model and inserting the row for each of them.
+    model->m_numGetChildren = 0;
+    CHECK( model->ItemsAdded(wxDataViewItem(), items) );
+    CHECK( model->m_numGetChildren == 1 );
+
+    for ( unsigned n = 0; n < count; n++ )
+        CHECK( dvc->GetRowByItem(model->GetItem(n)) == static_cast<int>(n) );
+
+    // Inside a batch, the items are only added when it ends.
+    const wxDataViewItem item = model->Insert(0, count + 1);
+
+    model->BeginBatch();
+    CHECK( model->ItemAdded(wxDataViewItem(), item) );
+    CHECK( dvc->GetRowByItem(item) == -1 );
+    model->EndBatch();
+
+    CHECK( dvc->GetRowByItem(item) == 0 );
+    CHECK( dvc->GetRowByItem(model->GetItem(count)) == static_cast<int>(count) );
+}
+
+TEST_CASE("wxDVC::IncrementalColumnWidths", "[wxDataViewCtrl][width]")
+{
+    wxDataViewListCtrl* const
+        dvc = new wxDataViewListCtrl(wxTheApp->GetTopWindow(), wxID_ANY);
+    wxScopedPtr<wxDataViewListCtrl> deleteDVC(dvc);
+
+    wxDataViewColumn* const
+        column = dvc->AppendTextColumn("", wxDATAVIEW_CELL_INERT,
+                                       wxCOL_WIDTH_AUTOSIZE);
+
+    wxVector<wxVariant> values;
+    values.push_back("x");
+    dvc->AppendItem(values);
+
+    const int widthShort = column->GetWidth();
+
+    // Adding an item only makes the column wider if the item is wider.
+    dvc->AppendItem(values);
+    CHECK( column->GetWidth() == widthShort );
+
+    values[0] = "This is a much longer text";
+    dvc->AppendItem(values);
+
+    const int widthLong = column->GetWidth();
+    CHECK( widthLong > widthShort );
+
+    // In incremental mode the width doesn't shrink after deleting the item...
+    CHECK( dvc->EnableIncrementalColumnWidths() );
+    dvc->DeleteItem(2);
+    CHECK( column->GetWidth() == widthLong );
+
+    // ... but grows when the item is changed to be wider.
+    dvc->SetTextValue("This is an even longer text than before", 0, 0);
+    CHECK( column->GetWidth() > widthLong );
+
+    // And it is recomputed when the incremental mode is turned off.
+    dvc->SetTextValue("x", 0, 0);
+    CHECK( dvc->EnableIncrementalColumnWidths(false) );
+    CHECK( column->GetWidth() == widthShort );
+}
+
+#if wxUSE_THREADS
+
+TEST_CASE("wxDVC::BackgroundSorting", "[wxDataViewCtrl][sort]")
+{
+    RowDataViewListCtrl* const
+        dvc = new RowDataViewListCtrl(wxTheApp->GetTopWindow());
+    wxScopedPtr<RowDataViewListCtrl> deleteDVC(dvc);
+
+    dvc->AppendTextColumn("Text");
+    dvc->EnableBackgroundSorting(10);
+
+    const int count = 100;
+    for ( int n = 0; n < count; n++ )
+    {
+        wxVector<wxVariant> values;
+        values.push_back(wxString::Format("%03d", (n * 37) % count));
+        dvc->AppendItem(values);
+    }
+
+    dvc->GetColumn(0)->SetSortOrder(false);
+    dvc->GetModel()->Resort();
+
+    // The item with the biggest value must become the first one when sorting
+    // is done.
+    const wxDataViewItem itemLast = dvc->RowToItem(27);
+    REQUIRE( dvc->GetTextValue(27, 0) == "099" );
+
+    wxStopWatch sw;
+    while ( dvc->GetRowByItem(itemLast) != 0 )
+    {
+        if ( sw.Time() > 10000 )
+        {
+            FAIL("Timed out waiting for background sorting");
+            break;
+        }
+
+        wxYield();
+    }
+
+    // Notice that the rows used by the store don't change when sorting.
+    for ( int n = 0; n < count; n++ )
+    {
+        CHECK( dvc->GetRowByItem(dvc->RowToItem(n)) ==
+                count - 1 - wxAtoi(dvc->GetTextValue(n, 0)) );
+    }
+}
+
+#endif // wxUSE_THREADS
+
+#endif // wxHAS_GENERIC_DATAVIEWCTRL
+
 TEST_CASE_METHOD(MultiColumnsDataViewCtrlTestCase,
                  "wxDVC::AppendTextColumn",
                  "[wxDataViewCtrl][column]")
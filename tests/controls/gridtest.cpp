@@ -28,6 +28,9 @@
 
 #include "waitforpaint.h"
 
+#include <limits.h>
+#include <limits>
+
 namespace
 {
 
@@ -1076,6 +1079,71 @@ TEST_CASE_METHOD(GridTestCase, "Grid::ColumnVisibility", "[grid]")
     CHECK( m_grid->IsColShown(1) );
 }
 
+TEST_CASE_METHOD(GridTestCase, "Grid::LineSizes", "[grid]")
+{
+    // Don't let the grid lines reduce the cell rectangles.
+    m_grid->EnableGridLines(false);
+
+    const int h = m_grid->GetDefaultRowSize();
+
+    m_grid->SetRowSize(2, 2*h);
+    m_grid->HideRow(4);
+
+    CHECK( m_grid->CellToRect(3, 0).y == 4*h );
+    CHECK( m_grid->CellToRect(4, 0).y == 5*h );
+    CHECK( m_grid->CellToRect(4, 0).GetBottom() + 1 == 5*h );
+    CHECK( m_grid->CellToRect(5, 0).y == 5*h );
+    CHECK( m_grid->CellToRect(9, 0).GetBottom() + 1 == 10*h );
+
+    CHECK( m_grid->YToRow(2*h) == 2 );
+    CHECK( m_grid->YToRow(4*h - 1) == 2 );
+    CHECK( m_grid->YToRow(5*h) == 5 );
+    CHECK( m_grid->YToRow(10*h) == wxNOT_FOUND );
+    CHECK( m_grid->YToRow(10*h, true) == 9 );
+
+    m_grid->InsertRows(1, 2);
+
+    CHECK( m_grid->CellToRect(4, 0).y == 4*h );
+    CHECK( m_grid->CellToRect(4, 0).GetBottom() + 1 == 6*h );
+    CHECK( !m_grid->IsRowShown(6) );
+    CHECK( m_grid->YToRow(6*h) == 7 );
+    CHECK( m_grid->CellToRect(11, 0).GetBottom() + 1 == 12*h );
+
+    m_grid->DeleteRows(0, 3);
+
+    CHECK( m_grid->CellToRect(1, 0).y == h );
+    CHECK( m_grid->CellToRect(1, 0).GetBottom() + 1 == 3*h );
+    CHECK( m_grid->YToRow(3*h) == 2 );
+    CHECK( m_grid->YToRow(4*h) == 4 );
+    CHECK( m_grid->CellToRect(8, 0).GetBottom() + 1 == 9*h );
+
+    m_grid->SetRowSize(1, h);
+    CHECK( m_grid->CellToRect(8, 0).GetBottom() + 1 == 8*h );
+
+    const int w = m_grid->GetDefaultColSize();
+
+    m_grid->AppendCols(2);
+    m_grid->SetColSize(0, 2*w);
+
+    wxArrayInt neworder;
+    neworder.push_back(1);
+    neworder.push_back(3);
+    neworder.push_back(2);
+    neworder.push_back(0);
+
+    m_grid->SetColumnsOrder(neworder);
+
+    CHECK( m_grid->CellToRect(0, 1).GetRight() + 1 == w );
+    CHECK( m_grid->CellToRect(0, 0).x == 3*w );
+    CHECK( m_grid->CellToRect(0, 0).GetRight() + 1 == 5*w );
+    CHECK( m_grid->XToCol(w) == 3 );
+    CHECK( m_grid->XToCol(4*w) == 0 );
+
+    m_grid->SetColSize(3, 0);
+    CHECK( m_grid->XToCol(w) == 2 );
+    CHECK( m_grid->CellToRect(0, 0).x == 2*w );
+}
+
 TEST_CASE_METHOD(GridTestCase, "Grid::LineFormatting", "[grid]")
 {
     CHECK(m_grid->GridLinesEnabled());
@@ -1755,6 +1823,151 @@ TEST_CASE_METHOD(GridTestCase, "Grid::CellAttribute", "[attr][cell][grid]")
     }
 }
 
+TEST_CASE_METHOD(GridTestCase, "Grid::BlockAttribute", "[attr][grid]")
+{
+    const wxColour defColour = m_grid->GetDefaultCellBackgroundColour();
+
+    wxGridCellAttr* attr = new wxGridCellAttr;
+    attr->SetBackgroundColour(*wxRED);
+    m_grid->SetBlockAttr(wxGridBlockCoords(2, 0, 5, 0), attr);
+
+    CHECK( m_grid->GetCellBackgroundColour(1, 0) == defColour );
+    CHECK( m_grid->GetCellBackgroundColour(2, 0) == *wxRED );
+    CHECK( m_grid->GetCellBackgroundColour(5, 0) == *wxRED );
+    CHECK( m_grid->GetCellBackgroundColour(6, 0) == defColour );
+    CHECK( m_grid->GetCellBackgroundColour(3, 1) == defColour );
+
+    // Block attributes are not cell attributes.
+    CHECK( m_grid->GetCellAttrCount() == 0 );
+
+    SECTION("Priority")
+    {
+        // The block set last has priority over the previous ones.
+        attr = new wxGridCellAttr;
+        attr->SetBackgroundColour(*wxGREEN);
+        attr->SetTextColour(*wxBLUE);
+        m_grid->SetBlockAttr(wxGridBlockCoords(4, 1, 3, 0), attr);
+
+        CHECK( m_grid->GetCellBackgroundColour(2, 0) == *wxRED );
+        CHECK( m_grid->GetCellBackgroundColour(3, 0) == *wxGREEN );
+        CHECK( m_grid->GetCellBackgroundColour(4, 1) == *wxGREEN );
+        CHECK( m_grid->GetCellBackgroundColour(5, 0) == *wxRED );
+
+        // Cell attributes have priority over the block ones, which have
+        // priority over the row and column ones, but the values not set in
+        // the attributes with higher priority are still inherited.
+        m_grid->SetCellBackgroundColour(3, 0, *wxYELLOW);
+
+        attr = new wxGridCellAttr;
+        attr->SetBackgroundColour(*wxCYAN);
+        attr->SetTextColour(*wxBLACK);
+        m_grid->SetRowAttr(5, attr);
+
+        CHECK( m_grid->GetCellBackgroundColour(3, 0) == *wxYELLOW );
+        CHECK( m_grid->GetCellTextColour(3, 0) == *wxBLUE );
+        CHECK( m_grid->GetCellBackgroundColour(5, 0) == *wxRED );
+        CHECK( m_grid->GetCellTextColour(5, 0) == *wxBLACK );
+        CHECK( m_grid->GetCellBackgroundColour(5, 1) == *wxCYAN );
+    }
+
+    SECTION("Replace")
+    {
+        attr = new wxGridCellAttr;
+        attr->SetBackgroundColour(*wxGREEN);
+        m_grid->SetBlockAttr(wxGridBlockCoords(2, 0, 5, 0), attr);
+        CHECK( m_grid->GetCellBackgroundColour(3, 0) == *wxGREEN );
+
+        m_grid->SetBlockAttr(wxGridBlockCoords(2, 0, 5, 0), NULL);
+        CHECK( m_grid->GetCellBackgroundColour(3, 0) == defColour );
+    }
+
+    SECTION("Overlapping")
+    {
+        m_grid->AppendCols(8);
+
+        // Overlapping blocks in different rows and columns, with the blocks
+        // using the odd rows or columns being set again at the end.
+        for ( int n = 0; n < 8; n++ )
+        {
+            attr = new wxGridCellAttr;
+            attr->SetBackgroundColour(wxColour(n, 0, 0));
+            m_grid->SetBlockAttr(wxGridBlockCoords(n, n, n + 2, n + 2), attr);
+        }
+
+        for ( int n = 1; n < 8; n += 2 )
+        {
+            attr = new wxGridCellAttr;
+            attr->SetBackgroundColour(wxColour(n, 1, 0));
+            m_grid->SetBlockAttr(wxGridBlockCoords(n, n, n + 2, n + 2), attr);
+        }
+
+        for ( int row = 0; row < 10; row++ )
+        {
+            for ( int col = 0; col < 10; col++ )
+            {
+                wxColour expected = defColour;
+                if ( col == 0 && row >= 2 && row <= 5 )
+                    expected = *wxRED;
+
+                // The odd blocks have priority, then the most recent ones.
+                int found = -1;
+                for ( int n = 0; n < 8; n++ )
+                {
+                    if ( row < n || row > n + 2 || col < n || col > n + 2 )
+                        continue;
+
+                    if ( found == -1 || n % 2 || found % 2 == 0 )
+                        found = n;
+                }
+
+                if ( found != -1 )
+                    expected = wxColour(found, found % 2, 0);
+
+                INFO("row=" << row << ", col=" << col);
+                CHECK( m_grid->GetCellBackgroundColour(row, col) == expected );
+            }
+        }
+    }
+
+    SECTION("Rows")
+    {
+        m_grid->InsertRows(0, 2);
+        CHECK( m_grid->GetCellBackgroundColour(3, 0) == defColour );
+        CHECK( m_grid->GetCellBackgroundColour(4, 0) == *wxRED );
+        CHECK( m_grid->GetCellBackgroundColour(7, 0) == *wxRED );
+        CHECK( m_grid->GetCellBackgroundColour(8, 0) == defColour );
+
+        // Inserting inside the block extends it.
+        m_grid->InsertRows(5, 1);
+        CHECK( m_grid->GetCellBackgroundColour(5, 0) == *wxRED );
+        CHECK( m_grid->GetCellBackgroundColour(8, 0) == *wxRED );
+        CHECK( m_grid->GetCellBackgroundColour(9, 0) == defColour );
+
+        // Deleting a part of the block shrinks it.
+        m_grid->DeleteRows(2, 4);
+        CHECK( m_grid->GetCellBackgroundColour(1, 0) == defColour );
+        CHECK( m_grid->GetCellBackgroundColour(2, 0) == *wxRED );
+        CHECK( m_grid->GetCellBackgroundColour(4, 0) == *wxRED );
+        CHECK( m_grid->GetCellBackgroundColour(5, 0) == defColour );
+
+        // And deleting all of it removes it.
+        m_grid->DeleteRows(2, 3);
+        for ( int row = 0; row < m_grid->GetNumberRows(); ++row )
+            CHECK( m_grid->GetCellBackgroundColour(row, 0) == defColour );
+    }
+
+    SECTION("Cols")
+    {
+        m_grid->InsertCols(0);
+        CHECK( m_grid->GetCellBackgroundColour(3, 0) == defColour );
+        CHECK( m_grid->GetCellBackgroundColour(3, 1) == *wxRED );
+
+        m_grid->DeleteCols(1);
+        CHECK( m_grid->GetCellBackgroundColour(3, 0) == defColour );
+        CHECK( m_grid->GetCellBackgroundColour(3, 1) == defColour );
+    }
+}
+
 #define CHECK_MULTICELL() CHECK_THAT( *m_grid, HasMulticellOnly(multi) )
 
 #define CHECK_NO_MULTICELL() CHECK_THAT( *m_grid, HasEmptyGrid() )
@@ -2071,6 +2284,92 @@ std::ostream& operator<<(std::ostream& os, const wxGridBlockCoords& block) {
     return os;
 }
 
+TEST_CASE_METHOD(GridTestCase, "Grid::TypedTable", "[grid][table]")
+{
+    wxGridTypedTable* const table = new wxGridTypedTable(3, 4);
+    table->SetColType(0, wxGRID_VALUE_NUMBER);
+    table->SetColType(1, "double:6,2");
+    table->SetColType(2, wxGRID_VALUE_BOOL);
+    table->SetColType(3, wxGRID_VALUE_CHOICE);
+
+    m_grid->AssignTable(table);
+
+    CHECK( m_grid->GetNumberRows() == 3 );
+    CHECK( m_grid->GetNumberCols() == 4 );
+
+    CHECK( table->GetTypeName(0, 0) == wxGRID_VALUE_NUMBER );
+    CHECK( table->GetTypeName(0, 1) == "double:6,2" );
+    CHECK( table->CanGetValueAs(0, 1, wxGRID_VALUE_FLOAT) );
+    CHECK( !table->CanGetValueAs(0, 1, wxGRID_VALUE_NUMBER) );
+    CHECK( table->CanGetValueAs(0, 2, wxGRID_VALUE_STRING) );
+
+    table->SetValueAsLong(0, 0, 17);
+    CHECK( table->GetValueAsLong(0, 0) == 17 );
+    CHECK( table->GetValue(0, 0) == "17" );
+
+    table->SetValue(1, 0, "-5");
+    CHECK( table->GetValueAsLong(1, 0) == -5 );
+
+    table->SetValueAsDouble(0, 1, 0.25);
+    CHECK( table->GetValueAsDouble(0, 1) == 0.25 );
+    CHECK( m_grid->GetCellValue(0, 1) == "0.25" );
+
+    table->SetValueAsBool(1, 2, true);
+    CHECK( table->GetValueAsBool(1, 2) );
+    CHECK( !table->GetValueAsBool(0, 2) );
+    CHECK( table->GetValue(1, 2) == "1" );
+
+    table->SetValue(0, 3, "red");
+    table->SetValue(1, 3, "green");
+    table->SetValue(2, 3, "red");
+    CHECK( table->GetValue(2, 3) == "red" );
+    CHECK( table->IsEmptyCell(1, 1) == false );
+
+    // Inserting rows must keep the existing values.
+    m_grid->InsertRows(1, 2);
+    CHECK( m_grid->GetNumberRows() == 5 );
+    CHECK( table->GetValueAsLong(0, 0) == 17 );
+    CHECK( table->GetValueAsLong(1, 0) == 0 );
+    CHECK( table->GetValueAsLong(3, 0) == -5 );
+    CHECK( table->GetValue(3, 3) == "green" );
+    CHECK( table->IsEmptyCell(1, 3) );
+
+    m_grid->DeleteRows(0, 2);
+    CHECK( table->GetValueAsLong(1, 0) == -5 );
+    CHECK( table->GetValueAsBool(1, 2) );
+
+    // Changing the column type converts the values.
+    table->SetColType(0, wxGRID_VALUE_STRING);
+    CHECK( table->GetValue(1, 0) == "-5" );
+    table->SetColType(0, wxGRID_VALUE_FLOAT);
+    CHECK( table->GetValueAsDouble(1, 0) == -5. );
+
+    // Converting doubles which can't be represented as long must not crash.
+    table->SetValueAsDouble(0, 0, 1e300);
+    CHECK( table->GetValueAsLong(0, 0) == LONG_MAX );
+    table->SetValueAsDouble(0, 0, -1e300);
+    CHECK( table->GetValueAsLong(0, 0) == LONG_MIN );
+    table->SetValueAsDouble(0, 0, std::numeric_limits<double>::quiet_NaN());
+    CHECK( table->GetValueAsLong(0, 0) == 0 );
+
+    table->SetColLabelValue(2, "Bool");
+    m_grid->InsertCols(0, 1);
+    CHECK( table->GetColLabelValue(3) == "Bool" );
+
+    m_grid->AppendCols(1);
+    CHECK( table->GetColType(4) == wxGRID_VALUE_STRING );
+
+    m_grid->DeleteCols(0, 2);
+    CHECK( table->GetColType(0) == "double:6,2" );
+    CHECK( table->GetColLabelValue(1) == "Bool" );
+
+    table->Clear();
+    CHECK( table->GetValue(1, 1) == "" );
+    CHECK( table->IsEmptyCell(1, 1) == false );
+    CHECK( table->GetValue(1, 2) == "" );
+    CHECK( table->IsEmptyCell(1, 2) );
+}
+
 TEST_CASE("GridBlockCoords::Canonicalize", "[grid]")
 {
     const wxGridBlockCoords block =
@@ -21,6 +21,7 @@
 #endif // WX_PRECOMP
 
 #include "wx/listctrl.h"
+#include "wx/generic/listctrl.h"
 #include "wx/artprov.h"
 #include "wx/imaglist.h"
 #include "listbasetest.h"
@@ -48,15 +49,20 @@ private:
         WXUISIM_TEST( ColumnClick );
         WXUISIM_TEST( ColumnDrag );
         CPPUNIT_TEST( SubitemRect );
+        CPPUNIT_TEST( InsertItems );
+        WXUISIM_TEST( FindIndex );
     CPPUNIT_TEST_SUITE_END();
 
     void EditLabel();
     void SubitemRect();
+    void InsertItems();
 #if wxUSE_UIACTIONSIMULATOR
     // Column events are only supported in wxListCtrl currently so we test them
     // here rather than in ListBaseTest
     void ColumnClick();
     void ColumnDrag();
+
+    void FindIndex();
 #endif // wxUSE_UIACTIONSIMULATOR
 
     wxListCtrl *m_list;
@@ -139,7 +145,100 @@ void ListCtrlTestCase::SubitemRect()
     CHECK(rectLabel.GetRight() == rectItem.GetRight());
 }
 
+void ListCtrlTestCase::InsertItems()
+{
+    // This function only exists in the generic version.
+    wxGenericListCtrl* const list =
+        new wxGenericListCtrl(wxTheApp->GetTopWindow(), wxID_ANY,
+                              wxDefaultPosition, wxDefaultSize, wxLC_REPORT);
+    list->InsertColumn(0, "Column 0");
+    list->InsertColumn(1, "Column 1");
+
+    list->InsertItem(0, "first");
+    list->InsertItem(1, "last");
+
+    wxArrayString labels;
+    labels.push_back("a");
+    labels.push_back("b");
+    labels.push_back("c");
+
+    EventCounter inserted(list, wxEVT_LIST_INSERT_ITEM);
+
+    CHECK( list->InsertItems(1, labels) == 1 );
+    CHECK( inserted.GetCount() == 3 );
+    CHECK( list->GetItemCount() == 5 );
+    CHECK( list->GetItemText(0) == "first" );
+    CHECK( list->GetItemText(1) == "a" );
+    CHECK( list->GetItemText(3) == "c" );
+    CHECK( list->GetItemText(4) == "last" );
+
+    // The new items must have all the columns.
+    list->SetItem(2, 1, "b1");
+    CHECK( list->GetItemText(2, 1) == "b1" );
+
+    // Inserting after the end appends the items.
+    CHECK( list->InsertItems(100, labels) == 5 );
+    CHECK( list->GetItemCount() == 8 );
+    CHECK( list->GetItemText(7) == "c" );
+
+    CHECK( list->InsertItems(0, wxArrayString()) == -1 );
+    CHECK( list->GetItemCount() == 8 );
+
+    list->DeleteColumn(0);
+    CHECK( list->GetItemText(2) == "b1" );
+
+    list->DeleteAllItems();
+    CHECK( list->GetItemCount() == 0 );
+
+    DeleteTestWindow(list);
+}
+
 #if wxUSE_UIACTIONSIMULATOR
+void ListCtrlTestCase::FindIndex()
+{
+    // This function only exists in the generic version.
+    wxGenericListCtrl* const list =
+        new wxGenericListCtrl(wxTheApp->GetTopWindow(), wxID_ANY,
+                              wxDefaultPosition, wxDefaultSize, wxLC_REPORT);
+    list->EnableFindIndex();
+    CHECK( list->HasFindIndex() );
+
+    list->InsertColumn(0, "Column 0");
+    list->InsertItem(0, "alpha");
+    list->InsertItem(1, "bravo");
+    list->InsertItem(2, "charlie");
+
+    const int state = wxLIST_STATE_FOCUSED | wxLIST_STATE_SELECTED;
+    list->SetItemState(0, state, state);
+
+    wxUIActionSimulator sim;
+
+    list->SetFocus();
+    wxYield();
+
+    sim.Char('c');
+    wxYield();
+    CHECK( list->GetNextItem(-1, wxLIST_NEXT_ALL, wxLIST_STATE_FOCUSED) == 2 );
+
+    // The items are searched by the text of their first column, so inserting
+    // a new one must update the index: none of the items matches any more.
+    list->SetItemState(0, state, state);
+    list->InsertColumn(0, "Column 1");
+
+    sim.Char('c');
+    wxYield();
+    CHECK( list->GetNextItem(-1, wxLIST_NEXT_ALL, wxLIST_STATE_FOCUSED) == 0 );
+
+    // And deleting it must update it again.
+    list->DeleteColumn(0);
+
+    sim.Char('c');
+    wxYield();
+    CHECK( list->GetNextItem(-1, wxLIST_NEXT_ALL, wxLIST_STATE_FOCUSED) == 2 );
+
+    DeleteTestWindow(list);
+}
+
 void ListCtrlTestCase::ColumnDrag()
 {
     EventCounter begindrag(m_list, wxEVT_LIST_COL_BEGIN_DRAG);
@@ -53,6 +53,7 @@ private:
         CPPUNIT_TEST( Iteration );
         CPPUNIT_TEST( Parent );
         CPPUNIT_TEST( CollapseExpand );
+        CPPUNIT_TEST( OnDemandChildren );
         CPPUNIT_TEST( AssignImageList );
         CPPUNIT_TEST( Focus );
         CPPUNIT_TEST( Bold );
@@ -81,6 +82,7 @@ private:
     void Iteration();
     void Parent();
     void CollapseExpand();
+    void OnDemandChildren();
     void AssignImageList();
     void Focus();
     void Bold();
@@ -533,6 +535,102 @@ void TreeCtrlTestCase::CollapseExpand()
     CPPUNIT_ASSERT(!m_tree->IsExpanded(m_root));
 }
 
+#ifdef wxHAS_GENERIC_TREECTRL
+
+namespace
+{
+
+// adds the children of the items being expanded
+class OnDemandChildrenHandler
+{
+public:
+    OnDemandChildrenHandler() : m_count(0) { }
+
+    void OnExpanding(wxTreeEvent& event)
+    {
+        wxTreeCtrl* const tree = wxStaticCast(event.GetEventObject(), wxTreeCtrl);
+        const wxTreeItemId item = event.GetItem();
+        if ( !tree->GetChildrenCount(item, false) )
+        {
+            for ( int n = 0; n < 3; n++ )
+                tree->AppendItem(item, wxString::Format("child %d", n));
+
+            m_count++;
+        }
+
+        event.Skip();
+    }
+
+    // deletes the item which was collapsed
+    void OnCollapsed(wxTreeEvent& event)
+    {
+        wxTreeCtrl* const tree = wxStaticCast(event.GetEventObject(), wxTreeCtrl);
+        tree->Delete(event.GetItem());
+    }
+
+    int GetCount() const { return m_count; }
+
+private:
+    int m_count;
+};
+
+} // anonymous namespace
+
+#endif // wxHAS_GENERIC_TREECTRL
+
+void TreeCtrlTestCase::OnDemandChildren()
+{
+#ifdef wxHAS_GENERIC_TREECTRL
+    OnDemandChildrenHandler handler;
+    m_tree->Bind(wxEVT_TREE_ITEM_EXPANDING,
+                 &OnDemandChildrenHandler::OnExpanding, &handler);
+
+    m_tree->EnableOnDemandChildren();
+    CPPUNIT_ASSERT( m_tree->HasOnDemandChildren() );
+
+    m_tree->Collapse(m_child1);
+    CPPUNIT_ASSERT_EQUAL( 0, m_tree->GetChildrenCount(m_child1, false) );
+    CPPUNIT_ASSERT( m_tree->ItemHasChildren(m_child1) );
+
+    // The items after the collapsed one must have moved up.
+    wxRect rect1, rect2;
+    CPPUNIT_ASSERT( m_tree->GetBoundingRect(m_child1, rect1) );
+    CPPUNIT_ASSERT( m_tree->GetBoundingRect(m_child2, rect2) );
+    CPPUNIT_ASSERT_EQUAL( rect1.GetBottom() + 1, rect2.GetTop() );
+
+    m_tree->Expand(m_child1);
+    CPPUNIT_ASSERT_EQUAL( 1, handler.GetCount() );
+    CPPUNIT_ASSERT_EQUAL( 3, m_tree->GetChildrenCount(m_child1, false) );
+
+    // And down again after expanding it.
+    wxTreeItemIdValue cookie;
+    const wxTreeItemId last = m_tree->GetLastChild(m_child1);
+    wxRect rectLast;
+    CPPUNIT_ASSERT( m_tree->GetBoundingRect(last, rectLast) );
+    CPPUNIT_ASSERT( m_tree->GetBoundingRect(m_child2, rect2) );
+    CPPUNIT_ASSERT_EQUAL( rectLast.GetBottom() + 1, rect2.GetTop() );
+
+    int flags = 0;
+    CPPUNIT_ASSERT_EQUAL( m_child2, m_tree->HitTest(rect2.GetTopLeft(), flags) );
+    CPPUNIT_ASSERT_EQUAL( m_tree->GetFirstChild(m_child1, cookie),
+                          m_tree->HitTest(wxPoint(rect1.x, rect1.GetBottom() + 1),
+                                          flags) );
+
+    m_tree->EnableOnDemandChildren(false);
+    m_tree->Collapse(m_child1);
+    CPPUNIT_ASSERT_EQUAL( 3, m_tree->GetChildrenCount(m_child1, false) );
+
+    // The item may be deleted by wxEVT_TREE_ITEM_COLLAPSED handler.
+    m_tree->EnableOnDemandChildren();
+    m_tree->Expand(m_child1);
+    m_tree->Bind(wxEVT_TREE_ITEM_COLLAPSED,
+                 &OnDemandChildrenHandler::OnCollapsed, &handler);
+    m_tree->Collapse(m_child1);
+    CPPUNIT_ASSERT_EQUAL( 1, m_tree->GetChildrenCount(m_root, false) );
+    CPPUNIT_ASSERT_EQUAL( m_child2, m_tree->GetFirstChild(m_root, cookie) );
+#endif // wxHAS_GENERIC_TREECTRL
+}
+
 void TreeCtrlTestCase::AssignImageList()
 {
     wxSize size(16, 16);
@@ -13,7 +13,10 @@
 #include "testprec.h"
 
 
+#include "wx/app.h"
+#include "wx/atomic.h"
 #include "wx/event.h"
+#include "wx/thread.h"
 
 // ----------------------------------------------------------------------------
 // test events and their handlers
@@ -507,6 +510,210 @@ TEST_CASE("Event::UnbindFromHandler", "[event][bind][unbind]")
     handler.ProcessEvent(e);
 }
 
+// Helper for BindMany() test recording the order in which it was called.
+class OrderRecorder
+{
+public:
+    OrderRecorder(wxVector<int>& order, int n) : m_order(order), m_n(n) { }
+
+    void operator()(MyEvent& e)
+    {
+        m_order.push_back(m_n);
+        e.Skip();
+    }
+
+private:
+    wxVector<int>& m_order;
+    int m_n;
+};
+
+TEST_CASE("Event::BindMany", "[event][bind][unbind]")
+{
+    // Bind enough handlers for wxEvtHandler to use its index of them.
+    MyHandler handler;
+    wxVector<int> order;
+
+    for ( int n = 0; n < 100; n++ )
+    {
+        handler.Bind(wxEVT_IDLE, &MyHandler::OnIdle, &handler, n);
+
+        if ( n % 10 == 0 )
+            handler.Bind(MyEventType, OrderRecorder(order, n));
+    }
+
+    MyEvent e;
+    handler.ProcessEvent(e);
+
+    REQUIRE( order.size() == 10 );
+    for ( int n = 0; n < 10; n++ )
+        CHECK( order[n] == 90 - 10*n );
+
+    // Unbinding from the handler must work with many handlers too.
+    Handler1 h1;
+    handler.Bind(MyEventType, &Handler1::OnDontCall, &h1);
+
+    Handler2 h2(handler, h1);
+    handler.Bind(MyEventType, &Handler2::OnUnbind, &h2);
+
+    order.clear();
+    handler.ProcessEvent(e);
+    CHECK( order.size() == 10 );
+
+    // And the handlers bound after pruning the unbound ones must be found.
+    handler.Unbind(MyEventType, &Handler2::OnUnbind, &h2);
+    for ( int n = 0; n < 50; n++ )
+        handler.Unbind(wxEVT_IDLE, &MyHandler::OnIdle, &handler, n);
+
+    order.clear();
+    handler.ProcessEvent(e);
+    CHECK( order.size() == 10 );
+
+    handler.Bind(MyEventType, OrderRecorder(order, 1000));
+
+    order.clear();
+    handler.ProcessEvent(e);
+    REQUIRE( order.size() == 11 );
+    CHECK( order[0] == 1000 );
+    CHECK( order[10] == 0 );
+
+    g_called.Reset();
+    wxIdleEvent idle;
+    idle.SetId(99);
+    handler.ProcessEvent(idle);
+    CHECK( g_called.method );
+
+    g_called.Reset();
+    idle.SetId(10);
+    handler.ProcessEvent(idle);
+    CHECK( !g_called.method );
+}
+
+// Helper for Coalescing() test recording the values of the events it gets.
+class ThreadEventRecorder : public wxEvtHandler
+{
+public:
+    ThreadEventRecorder()
+    {
+        Bind(wxEVT_THREAD, &ThreadEventRecorder::OnThreadEvent, this);
+    }
+
+    wxVector<int> m_values;
+
+private:
+    void OnThreadEvent(wxThreadEvent& e) { m_values.push_back(e.GetInt()); }
+};
+
+TEST_CASE("Event::Coalescing", "[event][queue]")
+{
+    ThreadEventRecorder handler;
+    CHECK( !handler.IsEventsCoalescingEnabled(wxEVT_THREAD) );
+
+    handler.EnableEventsCoalescing(wxEVT_THREAD);
+    CHECK( handler.IsEventsCoalescingEnabled(wxEVT_THREAD) );
+
+    // Only the last event with the given id must be processed, but in the
+    // position of the first one.
+    for ( int n = 0; n < 10; n++ )
+    {
+        wxThreadEvent* const e = new wxThreadEvent(wxEVT_THREAD, n % 2);
+        e->SetInt(n);
+        handler.QueueEvent(e);
+    }
+
+    wxTheApp->ProcessPendingEvents();
+
+    REQUIRE( handler.m_values.size() == 2 );
+    CHECK( handler.m_values[0] == 8 );
+    CHECK( handler.m_values[1] == 9 );
+
+    // The events queued after processing the previous ones are not affected.
+    handler.m_values.clear();
+    wxThreadEvent* const e = new wxThreadEvent();
+    e->SetInt(17);
+    handler.QueueEvent(e);
+
+    wxTheApp->ProcessPendingEvents();
+
+    REQUIRE( handler.m_values.size() == 1 );
+    CHECK( handler.m_values[0] == 17 );
+
+    // And nothing is coalesced after disabling it.
+    handler.m_values.clear();
+    handler.EnableEventsCoalescing(wxEVT_THREAD, false);
+    CHECK( !handler.IsEventsCoalescingEnabled(wxEVT_THREAD) );
+
+    for ( int n = 0; n < 3; n++ )
+        handler.QueueEvent(new wxThreadEvent());
+
+    wxTheApp->ProcessPendingEvents();
+
+    CHECK( handler.m_values.size() == 3 );
+}
+
+#if wxUSE_THREADS
+
+// Helpers for DeleteWhileQueuing() test: an event counting its instances and
+// a thread queuing many of them.
+class CountedEvent : public wxThreadEvent
+{
+public:
+    CountedEvent() { wxAtomicInc(ms_count); }
+    CountedEvent(const CountedEvent& e) : wxThreadEvent(e) { wxAtomicInc(ms_count); }
+    virtual ~CountedEvent() { wxAtomicDec(ms_count); }
+
+    virtual wxEvent *Clone() const wxOVERRIDE { return new CountedEvent(*this); }
+
+    static wxAtomicInt ms_count;
+};
+
+wxAtomicInt CountedEvent::ms_count = 0;
+
+class QueuingThread : public wxThread
+{
+public:
+    QueuingThread(wxEvtHandler& handler, int count)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_handler(handler),
+          m_count(count)
+    {
+    }
+
+    virtual ExitCode Entry() wxOVERRIDE
+    {
+        for ( int n = 0; n < m_count; n++ )
+            m_handler.QueueEvent(new CountedEvent());
+
+        return 0;
+    }
+
+private:
+    wxEvtHandler& m_handler;
+    const int m_count;
+};
+
+TEST_CASE("Event::DeleteWhileQueuing", "[event][queue]")
+{
+    wxEvtHandler handler;
+
+    QueuingThread thread(handler, 100000);
+    REQUIRE( thread.Run() == wxTHREAD_NO_ERROR );
+
+    // Delete the pending events while the other thread is queuing them: the
+    // events queued while we're doing it must not be lost.
+    while ( thread.IsRunning() )
+        wxTheApp->DeletePendingEvents();
+
+    thread.Wait();
+
+    // All the remaining events must be processed now, i.e. the handler must
+    // still be in the list of the handlers with pending events if it has any.
+    wxTheApp->ProcessPendingEvents();
+
+    CHECK( wxAtomicGet(CountedEvent::ms_count) == 0 );
+}
+
+#endif // wxUSE_THREADS
+
 // This is a compilation-time-only test: just check that a class inheriting
 // from wxEvtHandler non-publicly can use Bind() with its method, this used to
 // result in compilation errors.
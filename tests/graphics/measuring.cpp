@@ -30,6 +30,8 @@
 #include "wx/dcps.h"
 #include "wx/metafile.h"
 
+#include "wx/private/textmeasure.h"
+
 #include "asserthelper.h"
 
 // ----------------------------------------------------------------------------
@@ -128,6 +130,47 @@ TEST_CASE("wxWindow::GetTextExtent", "[window][text-extent]")
     GetTextExtentTester<wxWindow> testWin(*win);
 }
 
+TEST_CASE("wxWindow::GetTextExtentCache", "[window][text-extent]")
+{
+    wxWindow* const win = wxTheApp->GetTopWindow();
+
+    wxTextMeasureBase::ClearCache();
+
+    size_t hits, misses;
+    wxTextMeasureBase::GetCacheStats(&hits, &misses);
+
+    const wxSize size = win->GetTextExtent("Cached");
+
+    size_t hits2, misses2;
+    wxTextMeasureBase::GetCacheStats(&hits2, &misses2);
+
+    // Measuring the same string again must return the same result.
+    CHECK( win->GetTextExtent("Cached") == size );
+
+    // But it may be measured differently if the descent is needed too.
+    int w, h, descent = -1;
+    win->GetTextExtent("Cached", &w, &h, &descent);
+    CHECK( wxSize(w, h) == size );
+    CHECK( descent >= 0 );
+
+    // The same string in a different font must be measured again.
+    const wxFont fontBig = win->GetFont().Scaled(2);
+    win->GetTextExtent("Cached", &w, &h, NULL, NULL, &fontBig);
+    CHECK( w > size.x );
+
+#if !wxUSE_GENERIC_TEXTMEASURE
+    // With the native implementation, wxWindow::GetTextExtent() uses the
+    // cache, so check that it was really used.
+    CHECK( hits2 == hits );
+    CHECK( misses2 == misses + 1 );
+
+    size_t hits3, misses3;
+    wxTextMeasureBase::GetCacheStats(&hits3, &misses3);
+    CHECK( hits3 == hits2 + 1 );
+    CHECK( misses3 == misses2 + 2 );
+#endif // !wxUSE_GENERIC_TEXTMEASURE
+}
+
 TEST_CASE("wxDC::GetPartialTextExtent", "[dc][text-extent][partial]")
 {
     wxClientDC dc(wxTheApp->GetTopWindow());
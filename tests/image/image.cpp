@@ -2108,6 +2108,470 @@ TEST_CASE("wxImage::InitAlpha", "[image][initalpha]")
     }
 }
 
+// Straightforward implementation of the box blur used to check the results
+// of the optimized one.
+static wxImage BlurReference(const wxImage& image, int radius, bool horizontal)
+{
+    const int w = image.GetWidth();
+    const int h = image.GetHeight();
+    const int area = 2*radius + 1;
+
+    wxImage result(w, h);
+    if ( image.HasAlpha() )
+        result.SetAlpha();
+
+    for ( int y = 0; y < h; y++ )
+    {
+        for ( int x = 0; x < w; x++ )
+        {
+            int sum[4] = { 0, 0, 0, 0 };
+            for ( int k = -radius; k <= radius; k++ )
+            {
+                const int xs = horizontal ? wxMin(wxMax(x + k, 0), w - 1) : x;
+                const int ys = horizontal ? y : wxMin(wxMax(y + k, 0), h - 1);
+
+                sum[0] += image.GetRed(xs, ys);
+                sum[1] += image.GetGreen(xs, ys);
+                sum[2] += image.GetBlue(xs, ys);
+                if ( image.HasAlpha() )
+                    sum[3] += image.GetAlpha(xs, ys);
+            }
+
+            result.SetRGB(x, y, sum[0] / area, sum[1] / area, sum[2] / area);
+            if ( image.HasAlpha() )
+                result.SetAlpha(x, y, sum[3] / area);
+        }
+    }
+
+    return result;
+}
+
+TEST_CASE("wxImage::Blur", "[image][blur]")
+{
+    wxImage image;
+    REQUIRE( image.LoadFile("horse.bmp") );
+    image.InitAlpha();
+    unsigned char* const alpha = image.GetAlpha();
+    for ( int n = 0; n < image.GetWidth()*image.GetHeight(); n++ )
+        alpha[n] = static_cast<unsigned char>(n % 251);
+
+    // Use radius bigger than the image size too.
+    const int radii[] = { 0, 1, 3, 17, 64, 500 };
+    for ( size_t n = 0; n < WXSIZEOF(radii); n++ )
+    {
+        const int radius = radii[n];
+        INFO("Radius " << radius);
+
+        CHECK_THAT( image.BlurHorizontal(radius),
+                    RGBASameAs(BlurReference(image, radius, true)) );
+        CHECK_THAT( image.BlurVertical(radius),
+                    RGBASameAs(BlurReference(image, radius, false)) );
+    }
+}
+
+TEST_CASE("wxImage::GaussianBlur", "[image][blur]")
+{
+    // Blurring a uniform image must not change it.
+    wxImage uniform(50, 40);
+    uniform.SetRGB(wxRect(0, 0, 50, 40), 100, 150, 200);
+    CHECK_THAT( uniform.GaussianBlur(5), RGBSameAs(uniform) );
+
+    // Zero standard deviation means no blur at all.
+    wxImage image;
+    REQUIRE( image.LoadFile("horse.bmp") );
+    CHECK_THAT( image.GaussianBlur(0), RGBSameAs(image) );
+
+    // A single white point should spread symmetrically around its position.
+    wxImage point(41, 41);
+    point.SetRGB(20, 20, 255, 255, 255);
+
+    const wxImage blurred = point.GaussianBlur(3);
+    CHECK( blurred.GetRed(20, 20) > blurred.GetRed(22, 20) );
+    CHECK( blurred.GetRed(22, 20) > blurred.GetRed(25, 20) );
+    CHECK( blurred.GetRed(18, 20) == blurred.GetRed(22, 20) );
+    CHECK( blurred.GetRed(20, 18) == blurred.GetRed(20, 22) );
+    CHECK( blurred.GetRed(20, 40) == 0 );
+}
+
+TEST_CASE("wxImage::SetMaxThreads", "[image][threads]")
+{
+    wxImage image;
+    REQUIRE( image.LoadFile("horse.bmp") );
+
+    // Make the image big enough for several threads to be really used.
+    image = image.Scale(800, 800);
+    image.InitAlpha();
+    unsigned char* const alpha = image.GetAlpha();
+    for ( int n = 0; n < 800*800; n++ )
+        alpha[n] = static_cast<unsigned char>(n % 253);
+
+    // Perform all the operations using the current (default) number of
+    // threads and then with multiple threads: the results must be the same.
+    wxImage results[2][10];
+    for ( int i = 0; i < 2; i++ )
+    {
+        wxImage* const res = results[i];
+        res[0] = image.Scale(300, 200, wxIMAGE_QUALITY_NEAREST);
+        res[1] = image.Scale(300, 200, wxIMAGE_QUALITY_BILINEAR);
+        res[2] = image.Scale(300, 200, wxIMAGE_QUALITY_BICUBIC);
+        res[3] = image.Scale(300, 200, wxIMAGE_QUALITY_BOX_AVERAGE);
+        res[4] = image.Scale(1000, 1200, wxIMAGE_QUALITY_BICUBIC);
+        res[5] = image.Blur(7);
+        res[6] = image.Rotate(0.5, wxPoint(400, 400), true);
+        res[7] = image.Rotate(0.5, wxPoint(400, 400), false);
+        res[8] = image.ConvertToGreyscale();
+        res[9] = image.Copy();
+        res[9].RotateHue(0.3);
+
+        wxImage::SetMaxThreads(4);
+    }
+
+    wxImage::SetMaxThreads(1);
+
+    for ( int n = 0; n < 10; n++ )
+    {
+        INFO("Operation #" << n);
+        CHECK_THAT( results[1][n], RGBASameAs(results[0][n]) );
+    }
+}
+
+#if wxUSE_LIBJPEG
+
+TEST_CASE("wxImage::LoadScaledJPEG", "[image][jpeg]")
+{
+    if ( !wxImage::FindHandler(wxBITMAP_TYPE_JPEG) )
+        wxImage::AddHandler(new wxJPEGHandler);
+
+    wxImage full;
+    REQUIRE( full.LoadFile("horse.jpg") );
+
+    const int width = full.GetWidth();
+    const int height = full.GetHeight();
+
+    // Check that the image is scaled by a power of 2 to fit in the given size.
+    const int maxWidths[] = { width, width - 1, width / 4, width / 8, 1 };
+    const int expected[] = { 1, 2, 4, 8, width };
+    for ( size_t n = 0; n < WXSIZEOF(maxWidths); n++ )
+    {
+        INFO("Max width " << maxWidths[n]);
+
+        wxImage image;
+        image.SetOption(wxIMAGE_OPTION_MAX_WIDTH, maxWidths[n]);
+        REQUIRE( image.LoadFile("horse.jpg") );
+
+        CHECK( image.GetWidth() <= maxWidths[n] );
+        CHECK( image.GetWidth() == width / expected[n] );
+        CHECK( image.GetHeight() == height / expected[n] );
+
+        if ( expected[n] != 1 )
+        {
+            CHECK( image.GetOptionInt(wxIMAGE_OPTION_ORIGINAL_WIDTH) == width );
+            CHECK( image.GetOptionInt(wxIMAGE_OPTION_ORIGINAL_HEIGHT) == height );
+        }
+    }
+
+    wxImage image;
+    image.SetOption(wxIMAGE_OPTION_MAX_HEIGHT, height / 2);
+    REQUIRE( image.LoadFile("horse.jpg") );
+    CHECK( image.GetSize() == wxSize(width / 2, height / 2) );
+
+    // The image decoded at the smaller scale should be similar to the full
+    // size one scaled down.
+    CHECK_THAT( image, RGBSimilarTo(full.Scale(width / 2, height / 2,
+                                               wxIMAGE_QUALITY_BOX_AVERAGE),
+                                    64) );
+}
+
+#endif // wxUSE_LIBJPEG
+
+TEST_CASE("wxImage::GetInterleavedData", "[image][interleaved]")
+{
+    wxImage image(2, 1);
+    image.SetRGB(0, 0, 0x10, 0x20, 0x30);
+    image.SetRGB(1, 0, 0xff, 0x80, 0x00);
+
+    // Without alpha, all pixels are opaque.
+    unsigned char rgba[8];
+    REQUIRE( image.GetInterleavedData(wxIMAGE_PIXEL_FORMAT_RGBA, rgba) );
+    CHECK( rgba[0] == 0x10 );
+    CHECK( rgba[1] == 0x20 );
+    CHECK( rgba[2] == 0x30 );
+    CHECK( rgba[3] == 0xff );
+    CHECK( rgba[7] == 0xff );
+
+    // Modifying the image data directly is taken into account.
+    image.InitAlpha();
+    image.GetAlpha()[1] = 0x80;
+
+    REQUIRE( image.GetInterleavedData(wxIMAGE_PIXEL_FORMAT_RGBA, rgba) );
+    CHECK( rgba[3] == 0xff );
+    CHECK( rgba[4] == 0xff );
+    CHECK( rgba[5] == 0x80 );
+    CHECK( rgba[6] == 0x00 );
+    CHECK( rgba[7] == 0x80 );
+
+    wxUint32 argb[2];
+    REQUIRE( image.GetInterleavedData(wxIMAGE_PIXEL_FORMAT_BGRA_PREMULTIPLIED,
+                                      reinterpret_cast<unsigned char*>(argb)) );
+    CHECK( argb[0] == 0xff102030 );
+    CHECK( argb[1] == 0x80804000 );
+
+    // Check that the rows are stored at the given stride.
+    image.Resize(wxSize(1, 2), wxPoint(0, 0));
+    image.SetRGB(0, 1, 0x01, 0x02, 0x03);
+
+    unsigned char rows[16];
+    memset(rows, 0xcc, sizeof(rows));
+    REQUIRE( image.GetInterleavedData(wxIMAGE_PIXEL_FORMAT_RGBA, rows, 8) );
+    CHECK( rows[0] == 0x10 );
+    CHECK( rows[4] == 0xcc );
+    CHECK( rows[8] == 0x01 );
+    CHECK( rows[10] == 0x03 );
+    CHECK( rows[12] == 0xcc );
+
+    WX_ASSERT_FAILS_WITH_ASSERT(
+        image.GetInterleavedData(wxIMAGE_PIXEL_FORMAT_RGBA, rows, 2) );
+}
+
+// Row consumer reassembling the image from its rows.
+class ImageRowCollector : public wxImageRowConsumer
+{
+public:
+    explicit ImageRowCollector(int maxRows = -1)
+        : m_maxRows(maxRows), m_nextRow(0)
+    {
+    }
+
+    virtual bool OnStart(int width, int height, bool hasAlpha) wxOVERRIDE
+    {
+        m_image.Create(width, height, false);
+        if ( hasAlpha )
+            m_image.SetAlpha();
+
+        return true;
+    }
+
+    virtual bool OnRow(int y,
+                       const unsigned char* rgb,
+                       const unsigned char* alpha) wxOVERRIDE
+    {
+        // Rows must be passed in order.
+        CHECK( y == m_nextRow++ );
+
+        const int width = m_image.GetWidth();
+        memcpy(m_image.GetData() + 3*y*width, rgb, 3*width);
+
+        CHECK( !alpha == !m_image.HasAlpha() );
+        if ( alpha && m_image.HasAlpha() )
+            memcpy(m_image.GetAlpha() + y*width, alpha, width);
+
+        return m_maxRows == -1 || m_nextRow < m_maxRows;
+    }
+
+    const wxImage& GetImage() const { return m_image; }
+    int GetRowCount() const { return m_nextRow; }
+
+private:
+    const int m_maxRows;
+    int m_nextRow;
+    wxImage m_image;
+};
+
+TEST_CASE("wxImage::LoadRows", "[image][rows]")
+{
+    if ( !wxImage::FindHandler(wxBITMAP_TYPE_PNG) )
+        wxImage::AddHandler(new wxPNGHandler);
+    if ( !wxImage::FindHandler(wxBITMAP_TYPE_ICO) )
+        wxImage::AddHandler(new wxICOHandler);
+#if wxUSE_LIBJPEG
+    if ( !wxImage::FindHandler(wxBITMAP_TYPE_JPEG) )
+        wxImage::AddHandler(new wxJPEGHandler);
+#endif // wxUSE_LIBJPEG
+#if wxUSE_LIBTIFF
+    if ( !wxImage::FindHandler(wxBITMAP_TYPE_TIFF) )
+        wxImage::AddHandler(new wxTIFFHandler);
+#endif // wxUSE_LIBTIFF
+
+    const char* const files[] =
+    {
+        "horse.bmp",
+        "horse.png",
+        "horse.ico",
+#if wxUSE_LIBJPEG
+        "horse.jpg",
+#endif // wxUSE_LIBJPEG
+#if wxUSE_LIBTIFF
+        "horse.tif",
+#endif // wxUSE_LIBTIFF
+        "image/horse_grey.bmp",
+        "image/horse_grey_flipped.bmp",
+        "image/horse_rle8.bmp",
+        "image/horse_rle4_flipped.bmp",
+        "image/paste_input_overlay_transparent_border_semitransparent_circle.png",
+    };
+
+    for ( size_t n = 0; n < WXSIZEOF(files); n++ )
+    {
+        INFO("File " << files[n]);
+
+        wxImage expected;
+        REQUIRE( expected.LoadFile(files[n]) );
+
+        ImageRowCollector collector;
+        REQUIRE( wxImage::LoadRows(collector, files[n]) );
+        REQUIRE( collector.GetRowCount() == expected.GetHeight() );
+
+        const wxImage& image = collector.GetImage();
+        REQUIRE( image.GetSize() == expected.GetSize() );
+
+        // The mask is passed as alpha and the alpha may be present even if
+        // LoadFile() dropped it because all pixels were opaque.
+        if ( expected.HasMask() )
+            expected.InitAlpha();
+        if ( image.HasAlpha() && !expected.HasAlpha() )
+        {
+            expected.SetAlpha();
+            memset(expected.GetAlpha(), wxIMAGE_ALPHA_OPAQUE,
+                   expected.GetWidth()*expected.GetHeight());
+        }
+
+        CHECK( image.HasAlpha() == expected.HasAlpha() );
+        CHECK_THAT( image, RGBASameAs(expected) );
+
+        // Check that loading can be cancelled.
+        wxLogNull noLog;
+        ImageRowCollector cancelling(10);
+        CHECK( !wxImage::LoadRows(cancelling, files[n]) );
+        CHECK( cancelling.GetRowCount() == 10 );
+    }
+}
+
+#if wxUSE_THREADS
+
+#include "wx/imageloader.h"
+#include "wx/stopwatch.h"
+
+namespace
+{
+
+// Collects the events sent by wxImageLoader.
+class ImageLoadedCollector : public wxEvtHandler
+{
+public:
+    ImageLoadedCollector()
+    {
+        Bind(wxEVT_IMAGE_LOADED, &ImageLoadedCollector::OnLoaded, this);
+    }
+
+    // Dispatch the events until the given number of them is received or the
+    // timeout (in milliseconds) expires.
+    bool WaitFor(size_t count, long timeout = 10000)
+    {
+        wxStopWatch sw;
+        while ( m_events.size() < count )
+        {
+            if ( sw.Time() > timeout )
+                return false;
+
+            wxYield();
+            wxMilliSleep(5);
+        }
+
+        return true;
+    }
+
+    size_t GetCount() const { return m_events.size(); }
+    const wxImageLoadedEvent& Get(size_t n) const { return m_events[n]; }
+
+private:
+    void OnLoaded(wxImageLoadedEvent& event)
+    {
+        m_events.push_back(event);
+    }
+
+    wxVector<wxImageLoadedEvent> m_events;
+
+    wxDECLARE_NO_COPY_CLASS(ImageLoadedCollector);
+};
+
+} // anonymous namespace
+
+TEST_CASE("wxImageLoader", "[image][loader]")
+{
+    if ( !wxImage::FindHandler(wxBITMAP_TYPE_PNG) )
+        wxImage::AddHandler(new wxPNGHandler);
+
+    ImageLoadedCollector collector;
+
+    SECTION("Load")
+    {
+        wxImageLoader loader(&collector);
+
+        const int idBMP = loader.Load("horse.bmp");
+        const int idPNG = loader.Load("horse.png", 0, wxBITMAP_TYPE_PNG);
+        const int idBad = loader.Load("no-such-file.png");
+        CHECK( idBMP > 0 );
+        CHECK( idPNG > 0 );
+        CHECK( idBad > 0 );
+
+        REQUIRE( collector.WaitFor(3) );
+
+        for ( size_t n = 0; n < collector.GetCount(); n++ )
+        {
+            const wxImageLoadedEvent& event = collector.Get(n);
+            const int id = event.GetRequestId();
+            if ( id == idBMP || id == idPNG )
+            {
+                wxImage expected(event.GetFileName());
+                REQUIRE( event.IsOk() );
+                CHECK_THAT( event.GetImage(), RGBSameAs(expected) );
+            }
+            else
+            {
+                CHECK( id == idBad );
+                CHECK( event.GetFileName() == "no-such-file.png" );
+                CHECK( !event.IsOk() );
+            }
+        }
+    }
+
+    SECTION("Priority")
+    {
+        wxImageLoader loader(&collector, 1);
+
+        for ( int n = 0; n < 5; n++ )
+            loader.Load("horse.png");
+        const int idHigh = loader.Load("horse.bmp", 10);
+
+        REQUIRE( collector.WaitFor(6) );
+
+        // The only request which could have run before the high priority one
+        // is the first one, if it had already started.
+        CHECK( (collector.Get(0).GetRequestId() == idHigh ||
+                collector.Get(1).GetRequestId() == idHigh) );
+    }
+
+    SECTION("Cancel")
+    {
+        wxImageLoader loader(&collector, 1);
+
+        int ids[5];
+        for ( int n = 0; n < 5; n++ )
+            ids[n] = loader.Load("horse.png");
+
+        CHECK( loader.Cancel(ids[2]) );
+        CHECK( !loader.Cancel(ids[2]) );
+
+        loader.CancelAll();
+        CHECK( loader.GetPendingCount() == 0 );
+
+        // No events should be received for the cancelled requests.
+        CHECK( !collector.WaitFor(1, 500) );
+    }
+}
+
+#endif // wxUSE_THREADS
+
 /*
     TODO: add lots of more tests to wxImage functions
 */
@@ -166,3 +166,181 @@ TEST_CASE_METHOD(SelStoreTest, "wxSelectionStore::InsertInSelected", "[selstore]
     CHECK( !m_store.IsSelected(3) );
     CHECK( m_store.GetSelectedCount() == NUM_ITEMS );
 }
+
+TEST_CASE("wxSelectionStore::Ranges", "[selstore]")
+{
+    // Use a huge number of items: this would take a lot of time and memory if
+    // the items were stored individually.
+    const unsigned count = 10000000;
+
+    wxSelectionStore store;
+    store.SetItemCount(count);
+
+    wxArrayInt itemsChanged;
+    CHECK( !store.SelectRange(0, count - 1, true, &itemsChanged) );
+    CHECK( store.GetSelectedCount() == count );
+
+    CHECK( !store.SelectRange(1000, count - 1000, false, &itemsChanged) );
+    CHECK( store.GetSelectedCount() == 1999 );
+    CHECK( store.IsSelected(999) );
+    CHECK( !store.IsSelected(1000) );
+    CHECK( store.IsSelected(count - 999) );
+
+    // Selecting a few items returns them.
+    CHECK( store.SelectRange(1998, 2001, true, &itemsChanged) );
+    REQUIRE( itemsChanged.size() == 4 );
+    CHECK( itemsChanged[0] == 1998 );
+    CHECK( itemsChanged[3] == 2001 );
+
+    // Selecting the already selected items doesn't change anything.
+    CHECK( store.SelectRange(1999, 2000, true, &itemsChanged) );
+    CHECK( itemsChanged.empty() );
+    CHECK( !store.SelectItem(2000) );
+
+    // Iterating skips over the unselected items quickly.
+    wxSelectionStore::IterationState cookie;
+    CHECK( store.GetFirstSelectedItem(cookie) == 0 );
+    for ( unsigned n = 1; n < 1000; n++ )
+        CHECK( store.GetNextSelectedItem(cookie) == n );
+    CHECK( store.GetNextSelectedItem(cookie) == 1998 );
+    for ( unsigned n = 1999; n <= 2001; n++ )
+        CHECK( store.GetNextSelectedItem(cookie) == n );
+    CHECK( store.GetNextSelectedItem(cookie) == count - 999 );
+
+    // Inserting and deleting items shifts the ranges.
+    store.OnItemsInserted(1, count);
+    CHECK( store.GetSelectedCount() == 2003 );
+    CHECK( store.IsSelected(0) );
+    CHECK( !store.IsSelected(1) );
+    CHECK( !store.IsSelected(count) );
+    CHECK( store.IsSelected(count + 1) );
+    CHECK( store.IsSelected(count + 1998) );
+
+    CHECK( store.OnItemsDeleted(0, count + 1000) );
+    CHECK( store.GetSelectedCount() == 1003 );
+    CHECK( !store.IsSelected(997) );
+    CHECK( store.IsSelected(998) );
+    CHECK( store.IsSelected(1001) );
+    CHECK( !store.IsSelected(1002) );
+
+    // Deleting the unselected items between two selected ranges merges them.
+    CHECK( !store.OnItemsDeleted(1002, count - 3001) );
+    CHECK( store.GetSelectedCount() == 1003 );
+    CHECK( store.GetFirstSelectedItem(cookie) == 998 );
+    for ( unsigned n = 999; n < 2001; n++ )
+        CHECK( store.GetNextSelectedItem(cookie) == n );
+    CHECK( store.GetNextSelectedItem(cookie) == wxSelectionStore::NO_SELECTION );
+}
+
+TEST_CASE("wxSelectionStore::ManyRanges", "[selstore]")
+{
+    // Select every other item to create many ranges: inserting or deleting
+    // items would take a lot of time if all of them had to be shifted.
+    const unsigned count = 1000000;
+
+    wxSelectionStore store;
+    store.SetItemCount(count);
+
+    for ( unsigned n = 0; n < count; n += 2 )
+        store.SelectItem(n);
+    CHECK( store.GetSelectedCount() == count / 2 );
+
+    for ( unsigned n = 0; n < 10000; n++ )
+        store.OnItemsInserted(1, 2);
+    CHECK( store.GetSelectedCount() == count / 2 );
+    CHECK( store.IsSelected(0) );
+    CHECK( !store.IsSelected(1) );
+    CHECK( !store.IsSelected(20001) );
+    CHECK( store.IsSelected(20002) );
+    CHECK( store.IsSelected(count + 19998) );
+
+    for ( unsigned n = 0; n < 10000; n++ )
+        CHECK( !store.OnItemsDeleted(1, 2) );
+    CHECK( store.GetSelectedCount() == count / 2 );
+    CHECK( !store.IsSelected(1) );
+    CHECK( store.IsSelected(2) );
+    CHECK( store.IsSelected(count - 2) );
+
+    // Deleting an unselected item between two selected ones merges them.
+    CHECK( !store.OnItemsDeleted(1, 1) );
+    CHECK( store.GetSelectedCount() == count / 2 );
+    CHECK( store.IsSelected(1) );
+    CHECK( !store.IsSelected(2) );
+
+    wxSelectionStore::IterationState cookie;
+    CHECK( store.GetFirstSelectedItem(cookie) == 0 );
+    CHECK( store.GetNextSelectedItem(cookie) == 1 );
+    CHECK( store.GetNextSelectedItem(cookie) == 3 );
+}
+
+TEST_CASE("wxSelectionStore::Random", "[selstore]")
+{
+    // Compare the results with a trivial implementation after performing
+    // random operations on the store.
+    const unsigned count = 200;
+
+    wxSelectionStore store;
+    store.SetItemCount(count);
+
+    wxVector<bool> selected(count, false);
+
+    srand(17);
+    for ( int n = 0; n < 1000; n++ )
+    {
+        const unsigned from = rand() % selected.size(),
+                       to = from + rand() % (selected.size() - from);
+        const bool select = rand() % 2 == 0;
+
+        switch ( rand() % 4 )
+        {
+            case 0:
+                store.SelectItem(from, select);
+                selected[from] = select;
+                break;
+
+            case 1:
+                store.SelectRange(from, to, select);
+                for ( unsigned i = from; i <= to; i++ )
+                    selected[i] = select;
+                break;
+
+            case 2:
+                store.OnItemsInserted(from, to - from + 1);
+                selected.insert(selected.begin() + from, to - from + 1, false);
+                break;
+
+            case 3:
+                if ( selected.size() > count / 2 )
+                {
+                    store.OnItemsDeleted(from, to - from + 1);
+                    selected.erase(selected.begin() + from,
+                                   selected.begin() + to + 1);
+                }
+                break;
+        }
+
+        unsigned numSelected = 0;
+        for ( unsigned i = 0; i < selected.size(); i++ )
+        {
+            if ( store.IsSelected(i) != selected[i] )
+                FAIL("Wrong state of item " << i << " after step " << n);
+
+            if ( selected[i] )
+                numSelected++;
+        }
+
+        REQUIRE( store.GetSelectedCount() == numSelected );
+
+        wxSelectionStore::IterationState cookie;
+        unsigned numIterated = 0;
+        for ( unsigned item = store.GetFirstSelectedItem(cookie);
+              item != wxSelectionStore::NO_SELECTION;
+              item = store.GetNextSelectedItem(cookie) )
+        {
+            REQUIRE( selected[item] );
+            numIterated++;
+        }
+
+        REQUIRE( numIterated == numSelected );
+    }
+}
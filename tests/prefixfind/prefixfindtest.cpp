@@ -0,0 +1,116 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        tests/prefixfind/prefixfindtest.cpp
+// Purpose:     unit tests for the index used by the generic list and tree
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+#include "testprec.h"
+
+
+#ifndef WX_PRECOMP
+#endif
+
+#include "wx/generic/private/prefixfind.h"
+
+// ----------------------------------------------------------------------------
+// tests
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// simple implementation of wxPrefixFindIndex::Find() used for comparison
+size_t
+LinearFind(const wxArrayString& labels, const wxString& prefix, size_t start)
+{
+    const size_t count = labels.size();
+    for ( size_t n = start; n < count; n++ )
+    {
+        if ( labels[n].Lower().StartsWith(prefix) )
+            return n;
+    }
+
+    for ( size_t n = 0; n < start && n < count; n++ )
+    {
+        if ( labels[n].Lower().StartsWith(prefix) )
+            return n;
+    }
+
+    return static_cast<size_t>(-1);
+}
+
+} // anonymous namespace
+
+TEST_CASE("wxPrefixFindIndex::Find", "[listctrl][treectrl][prefixfind]")
+{
+    wxArrayString labels;
+    labels.push_back("Beta");
+    labels.push_back("alpha");
+    labels.push_back("");
+    labels.push_back("Alphabet");
+    labels.push_back("gamma");
+    labels.push_back("ALPHA");
+    labels.push_back("b");
+
+    wxPrefixFindIndex index;
+    CHECK( index.IsEmpty() );
+
+    for ( size_t n = 0; n < labels.size(); n++ )
+        index.Add(labels[n], n);
+    index.Finish();
+
+    CHECK( !index.IsEmpty() );
+
+    const size_t notFound = static_cast<size_t>(-1);
+
+    CHECK( index.Find("a", 0) == 1 );
+    CHECK( index.Find("a", 2) == 3 );
+    CHECK( index.Find("a", 4) == 5 );
+    CHECK( index.Find("a", 6) == 1 );
+    CHECK( index.Find("a", 7) == 1 );
+
+    CHECK( index.Find("alpha", 2) == 3 );
+    CHECK( index.Find("alphab", 4) == 3 );
+    CHECK( index.Find("alphabets", 0) == notFound );
+
+    CHECK( index.Find("b", 1) == 6 );
+    CHECK( index.Find("be", 1) == 0 );
+
+    CHECK( index.Find("x", 0) == notFound );
+    CHECK( index.Find("", 0) == notFound );
+
+    index.Clear();
+    CHECK( index.IsEmpty() );
+    CHECK( index.Find("a", 0) == notFound );
+}
+
+TEST_CASE("wxPrefixFindIndex::Compare", "[listctrl][treectrl][prefixfind]")
+{
+    // Check that the index finds the same items as the linear search for
+    // many different labels sharing the same prefixes.
+    wxArrayString labels;
+    for ( int n = 0; n < 1000; n++ )
+        labels.push_back(wxString::Format("%c%d", 'a' + (n * 7) % 5, n % 37));
+
+    wxPrefixFindIndex index;
+    for ( size_t n = 0; n < labels.size(); n++ )
+        index.Add(labels[n], n);
+    index.Finish();
+
+    const char* const prefixes[] = { "a", "b", "e", "f", "c1", "d3", "e36", "b99" };
+    for ( size_t n = 0; n < WXSIZEOF(prefixes); n++ )
+    {
+        const wxString prefix(prefixes[n]);
+        for ( size_t start = 0; start <= labels.size(); start += 13 )
+        {
+            INFO( "prefix \"" << prefix << "\" starting from " << start );
+            CHECK( index.Find(prefix, start) == LinearFind(labels, prefix, start) );
+        }
+    }
+}
@@ -17,6 +17,8 @@
 #ifndef WX_PRECOMP
 #endif
 
+#include "wx/stopwatch.h"
+
 #include "wx/generic/private/rowheightcache.h"
 
 // ----------------------------------------------------------------------------
@@ -270,3 +272,123 @@ TEST_CASE("RowHeightCacheTestCase::TestHeightCache", "[dataview][heightcache]")
     CHECK(hc.GetLineAt(22180, row) == false);
     CHECK(row == 666);
 }
+
+// ----------------------------------------------------------------------------
+// TestHeightCacheLarge
+// ----------------------------------------------------------------------------
+TEST_CASE("RowHeightCacheTestCase::TestHeightCacheLarge", "[dataview][heightcache]")
+{
+    // Use heights of 20, 30 and 40 pixels for the consecutive rows, so that
+    // the start of the row can be easily computed.
+    static const unsigned int NUM_ROWS = 1000000;
+
+    struct Rows
+    {
+        static int GetHeight(unsigned int row)
+        {
+            return 20 + 10 * (row % 3);
+        }
+
+        static int GetStart(unsigned int row)
+        {
+            const int full = row / 3;
+            int start = 90 * full;
+            for ( unsigned int r = 3 * full; r < row; r++ )
+                start += GetHeight(r);
+            return start;
+        }
+    };
+
+    HeightCache hc;
+
+    for (unsigned int i = 0; i < NUM_ROWS; i++)
+    {
+        hc.Put(i, Rows::GetHeight(i));
+    }
+
+    int start = 0;
+    int height = 0;
+    unsigned int row = 0;
+
+    // Checking every row individually would result in too many assertions,
+    // so just remember the first row for which the results are wrong.
+    unsigned int firstWrong = NUM_ROWS;
+    for (unsigned int i = 0; i < NUM_ROWS && firstWrong == NUM_ROWS; i += 7)
+    {
+        if ( !hc.GetLineInfo(i, start, height) ||
+                start != Rows::GetStart(i) ||
+                height != Rows::GetHeight(i) ||
+                !hc.GetLineAt(start + height - 1, row) ||
+                row != i )
+        {
+            firstWrong = i;
+        }
+    }
+
+    CHECK(firstWrong == NUM_ROWS);
+
+    // Invalidate the rows in the middle and put them back with other heights.
+    hc.Remove(NUM_ROWS / 2);
+    CHECK(hc.GetLineAt(Rows::GetStart(NUM_ROWS / 2), row) == false);
+
+    for (unsigned int i = NUM_ROWS / 2; i < NUM_ROWS; i++)
+    {
+        hc.Put(i, 10);
+    }
+
+    const int middle = Rows::GetStart(NUM_ROWS / 2);
+    for (unsigned int i = NUM_ROWS / 2; i < NUM_ROWS && firstWrong == NUM_ROWS; i += 7)
+    {
+        if ( !hc.GetLineStart(i, start) ||
+                start != middle + 10 * static_cast<int>(i - NUM_ROWS / 2) ||
+                !hc.GetLineAt(start, row) ||
+                row != i )
+        {
+            firstWrong = i;
+        }
+    }
+
+    CHECK(firstWrong == NUM_ROWS);
+
+    // All the operations must take logarithmic time, so doing the same number
+    // of lookups in this cache and in a much smaller one must take comparable
+    // time, while it would be ~1000 times longer if they took linear time.
+    // Use a big margin to avoid spurious failures on loaded machines.
+    const unsigned int NUM_SMALL_ROWS = 1000;
+
+    HeightCache hcSmall;
+    for (unsigned int i = 0; i < NUM_SMALL_ROWS; i++)
+    {
+        hcSmall.Put(i, Rows::GetHeight(i));
+    }
+
+    struct Lookups
+    {
+        // Return the time taken by the lookups in microseconds.
+        static long Time(HeightCache& cache, unsigned int numRows)
+        {
+            static const unsigned int NUM_LOOKUPS = 100000;
+
+            int start = 0;
+            unsigned int row = 0;
+
+            wxStopWatch sw;
+            for (unsigned int i = 0; i < NUM_LOOKUPS; i++)
+            {
+                // Spread the lookups over all the rows.
+                const unsigned int n = (i * 7919u) % numRows;
+                cache.GetLineStart(n, start);
+                cache.GetLineAt(start, row);
+            }
+
+            return sw.TimeInMicro().ToLong();
+        }
+    };
+
+    const long timeSmall = Lookups::Time(hcSmall, NUM_SMALL_ROWS);
+    const long timeLarge = Lookups::Time(hc, NUM_ROWS);
+
+    INFO("Small cache: " << timeSmall << "us, "
+         "large cache: " << timeLarge << "us");
+    CHECK(timeLarge < 50 * wxMax(timeSmall, 1000L));
+}
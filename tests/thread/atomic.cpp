@@ -105,6 +105,9 @@ void AtomicTestCase::TestNoThread()
 
     CPPUNIT_ASSERT( int1 == ITERATIONS_NUM );
     CPPUNIT_ASSERT( int2 == -ITERATIONS_NUM );
+
+    CPPUNIT_ASSERT_EQUAL( ITERATIONS_NUM, wxAtomicGet(int1) );
+    CPPUNIT_ASSERT_EQUAL( -ITERATIONS_NUM, wxAtomicGet(int2) );
 }
 
 void AtomicTestCase::TestDecReturn()
@@ -20,6 +20,7 @@
 #endif // WX_PRECOMP
 
 #include "wx/msgqueue.h"
+#include "wx/vector.h"
 
 // ----------------------------------------------------------------------------
 // test class
@@ -67,15 +68,39 @@ private:
         Queue        m_queue;
     };
 
+    // This thread receives exactly msgCount messages from the given queue,
+    // either one by one or in batches of at most maxBatch messages, and
+    // checks that they are the consecutive integers starting from 0.
+    class ConsumerThread : public wxThread
+    {
+    public:
+        ConsumerThread(Queue& queue, int msgCount, size_t maxBatch)
+           : wxThread(wxTHREAD_JOINABLE),
+             m_queue(queue), m_msgCount(msgCount), m_maxBatch(maxBatch)
+        {}
+
+        // thread execution starts here
+        virtual void *Entry() wxOVERRIDE;
+
+    private:
+        Queue&       m_queue;
+        int          m_msgCount;
+        size_t       m_maxBatch;
+    };
+
     WX_DEFINE_ARRAY_PTR(MyThread *, ArrayThread);
 
     CPPUNIT_TEST_SUITE( QueueTestCase );
         CPPUNIT_TEST( TestReceive );
         CPPUNIT_TEST( TestReceiveTimeout );
+        CPPUNIT_TEST( TestBounded );
+        CPPUNIT_TEST( TestBatch );
     CPPUNIT_TEST_SUITE_END();
 
     void TestReceive();
     void TestReceiveTimeout();
+    void TestBounded();
+    void TestBatch();
 
     wxDECLARE_NO_COPY_CLASS(QueueTestCase);
 };
@@ -164,6 +189,72 @@ void QueueTestCase::TestReceiveTimeout()
     delete thread1;
 }
 
+// this function checks that posting to a full bounded queue doesn't add the
+// message to it or blocks until there is space for it
+void QueueTestCase::TestBounded()
+{
+    Queue queue(2);
+    CPPUNIT_ASSERT_EQUAL( 2, (int)queue.GetCapacity() );
+
+    CPPUNIT_ASSERT_EQUAL( wxMSGQUEUE_NO_ERROR, queue.TryPost(0) );
+    CPPUNIT_ASSERT_EQUAL( wxMSGQUEUE_NO_ERROR, queue.TryPost(1) );
+    CPPUNIT_ASSERT_EQUAL( wxMSGQUEUE_FULL, queue.TryPost(2) );
+
+    const int msgCount = 1000;
+
+    ConsumerThread thread(queue, msgCount, 0);
+    CPPUNIT_ASSERT_EQUAL( wxTHREAD_NO_ERROR, thread.Run() );
+
+    for ( int i = 2; i < msgCount; ++i )
+    {
+        CPPUNIT_ASSERT_EQUAL( wxMSGQUEUE_NO_ERROR, queue.Post(i) );
+    }
+
+    CPPUNIT_ASSERT_EQUAL( (wxThread::ExitCode)wxMSGQUEUE_NO_ERROR,
+                          thread.Wait() );
+}
+
+// this function checks that the messages posted in batches are received in
+// the same order, both with the unbounded and bounded queues
+void QueueTestCase::TestBatch()
+{
+    const int msgs[] = { 0, 1, 2, 3, 4 };
+
+    Queue unbounded;
+    CPPUNIT_ASSERT_EQUAL( wxMSGQUEUE_NO_ERROR,
+                          unbounded.PostMany(msgs, msgs + WXSIZEOF(msgs)) );
+
+    wxVector<int> received;
+    CPPUNIT_ASSERT_EQUAL( wxMSGQUEUE_NO_ERROR, unbounded.ReceiveMany(received, 2) );
+    CPPUNIT_ASSERT_EQUAL( 2, (int)received.size() );
+
+    CPPUNIT_ASSERT_EQUAL( wxMSGQUEUE_NO_ERROR, unbounded.ReceiveMany(received) );
+    CPPUNIT_ASSERT_EQUAL( (int)WXSIZEOF(msgs), (int)received.size() );
+    for ( size_t n = 0; n < received.size(); ++n )
+    {
+        CPPUNIT_ASSERT_EQUAL( msgs[n], received[n] );
+    }
+
+    // The batch is bigger than the queue capacity, so it has to be posted in
+    // several parts while the consumer thread empties the queue.
+    const int msgCount = 1000;
+
+    wxVector<int> batch;
+    for ( int i = 0; i < msgCount; ++i )
+        batch.push_back(i);
+
+    Queue bounded(10);
+
+    ConsumerThread thread(bounded, msgCount, 7);
+    CPPUNIT_ASSERT_EQUAL( wxTHREAD_NO_ERROR, thread.Run() );
+
+    CPPUNIT_ASSERT_EQUAL( wxMSGQUEUE_NO_ERROR,
+                          bounded.PostMany(batch.begin(), batch.end()) );
+
+    CPPUNIT_ASSERT_EQUAL( (wxThread::ExitCode)wxMSGQUEUE_NO_ERROR,
+                          thread.Wait() );
+}
+
 // every thread tries to read exactly m_maxMsgCount messages from its queue
 // following the waiting strategy specified in m_type. If it succeeds then it
 // returns 0. Otherwise it returns the error code - one of wxMessageQueueError.
@@ -214,3 +305,37 @@ void *QueueTestCase::MyThread::Entry()
 
     return (wxThread::ExitCode)wxMSGQUEUE_NO_ERROR;
 }
+
+void *QueueTestCase::ConsumerThread::Entry()
+{
+    int messagesReceived = 0;
+    while ( messagesReceived < m_msgCount )
+    {
+        wxVector<int> msgs;
+
+        if ( m_maxBatch )
+        {
+            if ( m_queue.ReceiveMany(msgs, m_maxBatch) != wxMSGQUEUE_NO_ERROR )
+                return (wxThread::ExitCode)wxMSGQUEUE_MISC_ERROR;
+
+            if ( msgs.empty() || msgs.size() > m_maxBatch )
+                return (wxThread::ExitCode)wxMSGQUEUE_MISC_ERROR;
+        }
+        else
+        {
+            int msg = -1;
+            if ( m_queue.Receive(msg) != wxMSGQUEUE_NO_ERROR )
+                return (wxThread::ExitCode)wxMSGQUEUE_MISC_ERROR;
+
+            msgs.push_back(msg);
+        }
+
+        for ( size_t n = 0; n < msgs.size(); ++n )
+        {
+            if ( msgs[n] != messagesReceived++ )
+                return (wxThread::ExitCode)wxMSGQUEUE_MISC_ERROR;
+        }
+    }
+
+    return (wxThread::ExitCode)wxMSGQUEUE_NO_ERROR;
+}
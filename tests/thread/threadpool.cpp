@@ -0,0 +1,252 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        tests/thread/threadpool.cpp
+// Purpose:     wxThreadPool unit tests
+// Created:     2026-10-17
+// Copyright:   (c) 2026 wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+#include "testprec.h"
+
+
+#ifndef WX_PRECOMP
+    #include "wx/app.h"
+#endif // WX_PRECOMP
+
+#include "wx/atomic.h"
+#include "wx/thread.h"
+#include "wx/threadpool.h"
+
+// ----------------------------------------------------------------------------
+// test tasks
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// task computing the sum of the numbers in the given range
+class SumTask : public wxThreadPoolTask
+{
+public:
+    SumTask(int from, int to) : m_from(from), m_to(to), m_sum(0) { }
+
+    virtual void Run() wxOVERRIDE
+    {
+        for ( int n = m_from; n < m_to; n++ )
+            m_sum += n;
+    }
+
+    long GetSum() const { return m_sum; }
+
+private:
+    const int m_from,
+              m_to;
+    long m_sum;
+};
+
+// task computing Fibonacci numbers recursively using subtasks
+class FibTask : public wxThreadPoolTask
+{
+public:
+    FibTask(wxThreadPool& pool, int n) : m_pool(pool), m_n(n), m_result(0) { }
+
+    virtual void Run() wxOVERRIDE
+    {
+        if ( m_n < 2 )
+        {
+            m_result = m_n;
+            return;
+        }
+
+        wxThreadPoolFuture f1 = m_pool.Submit(new FibTask(m_pool, m_n - 1));
+        wxThreadPoolFuture f2 = m_pool.Submit(new FibTask(m_pool, m_n - 2));
+
+        f1.Wait();
+        f2.Wait();
+
+        m_result = static_cast<FibTask*>(f1.GetTask())->m_result +
+                   static_cast<FibTask*>(f2.GetTask())->m_result;
+    }
+
+    long GetResult() const { return m_result; }
+
+private:
+    wxThreadPool& m_pool;
+    const int m_n;
+    long m_result;
+};
+
+// task waiting until the semaphore is posted
+class BlockingTask : public wxThreadPoolTask
+{
+public:
+    explicit BlockingTask(wxSemaphore& sem) : m_sem(sem) { }
+
+    virtual void Run() wxOVERRIDE { m_sem.Wait(); }
+
+private:
+    wxSemaphore& m_sem;
+};
+
+// task appending its number to the vector shared by all tasks and counting
+// the calls to its OnDone()
+class OrderTask : public wxThreadPoolTask
+{
+public:
+    OrderTask(wxVector<int>& order, int n, int& doneCount)
+        : m_order(order), m_n(n), m_doneCount(doneCount)
+    {
+    }
+
+    virtual void Run() wxOVERRIDE { m_order.push_back(m_n); }
+
+    virtual void OnDone() wxOVERRIDE
+    {
+        CHECK( wxThread::IsMain() );
+        m_doneCount++;
+    }
+
+private:
+    wxVector<int>& m_order;
+    const int m_n;
+    int& m_doneCount;
+};
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// tests themselves
+// ----------------------------------------------------------------------------
+
+TEST_CASE("wxThreadPool::Submit", "[thread][threadpool]")
+{
+    wxThreadPool pool(4);
+    REQUIRE( pool.GetThreadCount() == 4 );
+
+    wxVector<wxThreadPoolFuture> futures;
+    for ( int n = 0; n < 100; n++ )
+        futures.push_back(pool.Submit(new SumTask(n*1000, (n + 1)*1000)));
+
+    pool.WaitAll();
+    CHECK( pool.GetPendingCount() == 0 );
+
+    long sum = 0;
+    for ( size_t n = 0; n < futures.size(); n++ )
+    {
+        REQUIRE( futures[n].IsDone() );
+        CHECK( !futures[n].IsCancelled() );
+        CHECK( futures[n].Wait() );
+
+        sum += static_cast<SumTask*>(futures[n].GetTask())->GetSum();
+    }
+
+    CHECK( sum == 100000L*99999/2 );
+}
+
+TEST_CASE("wxThreadPool::Subtasks", "[thread][threadpool]")
+{
+    wxThreadPool pool(4);
+
+    // This also checks that waiting for the subtasks from the pool threads
+    // doesn't deadlock even if there are many more tasks than threads.
+    wxThreadPoolFuture f = pool.Submit(new FibTask(pool, 15));
+    REQUIRE( f.Wait() );
+
+    CHECK( static_cast<FibTask*>(f.GetTask())->GetResult() == 610 );
+}
+
+TEST_CASE("wxThreadPool::Cancel", "[thread][threadpool]")
+{
+    wxThreadPool pool(1);
+    wxSemaphore sem;
+
+    wxThreadPoolFuture blocking = pool.Submit(new BlockingTask(sem));
+
+    wxThreadPoolFuture f1 = pool.Submit(new SumTask(0, 10));
+    wxThreadPoolFuture f2 = pool.Submit(new SumTask(0, 20));
+    wxThreadPoolFuture f3 = pool.SubmitAfter(f2, new SumTask(0, 30));
+
+    // The blocking task may or may not have started yet, but the others
+    // certainly didn't.
+    CHECK( f2.Cancel() );
+    CHECK( f2.IsCancelled() );
+
+    // Cancelling a task also cancels the tasks to run after it.
+    CHECK( f3.IsDone() );
+    CHECK( f3.IsCancelled() );
+    CHECK( !f3.Wait() );
+
+    sem.Post();
+    CHECK( blocking.Wait() );
+    CHECK( !blocking.Cancel() );
+
+    REQUIRE( f1.Wait() );
+    CHECK( static_cast<SumTask*>(f1.GetTask())->GetSum() == 45 );
+
+    pool.WaitAll();
+
+    // Check that CancelAll() cancels all the pending tasks.
+    blocking = pool.Submit(new BlockingTask(sem));
+    f1 = pool.Submit(new SumTask(0, 10));
+    f2 = pool.Submit(new SumTask(0, 20));
+
+    pool.CancelAll();
+    CHECK( f1.IsCancelled() );
+    CHECK( f2.IsCancelled() );
+
+    sem.Post();
+    pool.WaitAll();
+    CHECK( blocking.IsDone() );
+}
+
+TEST_CASE("wxThreadPool::SubmitAfter", "[thread][threadpool]")
+{
+    wxThreadPool pool(4);
+
+    wxVector<int> order;
+    int doneCount = 0;
+
+    wxThreadPoolFuture f = pool.Submit(new OrderTask(order, 0, doneCount),
+                                       wxTheApp);
+    for ( int n = 1; n < 10; n++ )
+        f = pool.SubmitAfter(f, new OrderTask(order, n, doneCount), wxTheApp);
+
+    REQUIRE( f.Wait() );
+
+    REQUIRE( order.size() == 10 );
+    for ( int n = 0; n < 10; n++ )
+        CHECK( order[n] == n );
+
+    // Submitting a task after an already finished one runs it immediately.
+    f = pool.SubmitAfter(f, new OrderTask(order, 10, doneCount), wxTheApp);
+    REQUIRE( f.Wait() );
+    CHECK( order.size() == 11 );
+
+    // OnDone() must be called in the main thread.
+    CHECK( doneCount == 0 );
+    wxTheApp->ProcessPendingEvents();
+    CHECK( doneCount == 11 );
+}
+
+TEST_CASE("wxThreadPool::Destroy", "[thread][threadpool]")
+{
+    wxSemaphore sem;
+    wxThreadPoolFuture blocking,
+                       pending;
+
+    {
+        wxThreadPool pool(1);
+        blocking = pool.Submit(new BlockingTask(sem));
+        pending = pool.Submit(new SumTask(0, 10));
+
+        // Let the blocking task finish only once the pool is being destroyed.
+        sem.Post();
+    }
+
+    CHECK( blocking.IsDone() );
+    CHECK( pending.IsDone() );
+}